@@ -119,6 +119,8 @@ const wlmcfg_enum_desc_t wlmaker_action_desc[] = {
 
     WLMCFG_ENUM("RootMenu", WLMAKER_ACTION_ROOT_MENU),
 
+    WLMCFG_ENUM("LogLauncherStats", WLMAKER_ACTION_LOG_LAUNCHER_STATS),
+
     WLMCFG_ENUM("SwitchToVT1", WLMAKER_ACTION_SWITCH_TO_VT1),
     WLMCFG_ENUM("SwitchToVT2", WLMAKER_ACTION_SWITCH_TO_VT2),
     WLMCFG_ENUM("SwitchToVT3", WLMAKER_ACTION_SWITCH_TO_VT3),
@@ -357,6 +359,10 @@ void wlmaker_action_execute(wlmaker_server_t *server_ptr,
         }
         break;
 
+    case WLMAKER_ACTION_LOG_LAUNCHER_STATS:
+        wl_signal_emit(&server_ptr->launcher_stats_event, NULL);
+        break;
+
     case WLMAKER_ACTION_SWITCH_TO_VT1:
     case WLMAKER_ACTION_SWITCH_TO_VT2:
     case WLMAKER_ACTION_SWITCH_TO_VT3:
@@ -58,6 +58,8 @@ typedef enum {
 
     WLMAKER_ACTION_ROOT_MENU,
 
+    WLMAKER_ACTION_LOG_LAUNCHER_STATS,
+
     // Note: Keep these numbered consecutively.
     WLMAKER_ACTION_SWITCH_TO_VT1,
     WLMAKER_ACTION_SWITCH_TO_VT2,
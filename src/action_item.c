@@ -78,8 +78,6 @@ wlmaker_action_item_t *wlmaker_action_item_create(
     wlmtk_element_extend(
         wlmtk_menu_item_element(&action_item_ptr->super_menu_item),
         &_wlmaker_action_item_element_vmt);
-    // TODO(kaeser@gubbe.ch): Should not be required!
-    action_item_ptr->super_menu_item.width = style_ptr->width;
 
     if (!wlmtk_menu_item_set_text(
             &action_item_ptr->super_menu_item,
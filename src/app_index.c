@@ -0,0 +1,1236 @@
+/* ========================================================================= */
+/**
+ * @file app_index.c
+ *
+ * @copyright
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/// mkostemp(3) and getline(3) are GNU extensions, need this macro.
+#define _GNU_SOURCE
+
+#include "app_index.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <ftw.h>
+#include <inttypes.h>
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <wayland-server-core.h>
+
+#include "toolkit/toolkit.h"
+
+/* == Declarations ========================================================= */
+
+/** State of the application index. */
+struct _wlmaker_app_index_t {
+    /** Directories holding `.desktop` files, in order of precedence. */
+    char                      **dirs_ptr;
+    /** Number of directories. */
+    size_t                    dirs;
+    /** Path of the persisted index, or NULL. */
+    char                      *cache_path_ptr;
+
+    /** Entries, as @ref wlmaker_app_index_entry_t, keyed by path. */
+    bs_avltree_t              *tree_ptr;
+    /** Number of `.desktop` files parsed. For tests. */
+    size_t                    parsed;
+
+    /** File descriptor of inotify(7), or -1. */
+    int                       inotify_fd;
+    /** Watch descriptor for each of `dirs_ptr`, or -1 if not watched. */
+    int                       *watch_descriptors_ptr;
+    /** Event source for `inotify_fd`. */
+    struct wl_event_source    *wl_event_source_ptr;
+};
+
+/** An entry of the index: A `.desktop` file. */
+typedef struct {
+    /** Node of @ref wlmaker_app_index_t::tree_ptr. */
+    bs_avltree_node_t         avlnode;
+    /** Path of the `.desktop` file. The key. */
+    char                      *path_ptr;
+    /** Desktop file ID: The basename. Points into `path_ptr`. */
+    const char                *id_ptr;
+    /** Index into @ref wlmaker_app_index_t::dirs_ptr. */
+    size_t                    dir_idx;
+    /** Modification time of the file, when parsed. */
+    struct timespec           mtime;
+    /** Whether the application is to be shown. */
+    bool                      visible;
+    /** The application. */
+    wlmaker_app_t             app;
+} wlmaker_app_index_entry_t;
+
+static bool _wlmaker_app_index_scan(wlmaker_app_index_t *app_index_ptr);
+static bool _wlmaker_app_index_update_file(
+    wlmaker_app_index_t *app_index_ptr,
+    size_t dir_idx,
+    const char *name_ptr,
+    bs_avltree_t *cached_tree_ptr);
+static wlmaker_app_index_entry_t *_wlmaker_app_index_parse(
+    const char *path_ptr,
+    size_t dir_idx,
+    const struct timespec *mtime_ptr);
+static void _wlmaker_app_index_decode_value(char *value_ptr, bool exec);
+static void _wlmaker_app_index_load(
+    wlmaker_app_index_t *app_index_ptr,
+    bs_avltree_t *tree_ptr);
+static void _wlmaker_app_index_store(wlmaker_app_index_t *app_index_ptr);
+static bool _wlmaker_app_index_watch(
+    wlmaker_app_index_t *app_index_ptr,
+    struct wl_event_loop *wl_event_loop_ptr);
+static int _wlmaker_app_index_handle_inotify(
+    int fd,
+    uint32_t mask,
+    void *ud_ptr);
+static char *_wlmaker_app_index_default_dirs(void);
+static bool _wlmaker_app_index_is_desktop_file(const char *name_ptr);
+
+static wlmaker_app_index_entry_t *_wlmaker_app_index_entry_create(
+    const char *path_ptr,
+    size_t dir_idx,
+    const struct timespec *mtime_ptr,
+    bool visible,
+    const wlmaker_app_t *app_ptr);
+static void _wlmaker_app_index_entry_destroy(
+    wlmaker_app_index_entry_t *entry_ptr);
+static int _wlmaker_app_index_node_cmp(
+    const bs_avltree_node_t *node_ptr,
+    const void *key_ptr);
+static void _wlmaker_app_index_node_destroy(bs_avltree_node_t *node_ptr);
+static int _wlmaker_app_index_id_cmp(const void *a_ptr, const void *b_ptr);
+static int _wlmaker_app_index_name_cmp(const void *a_ptr, const void *b_ptr);
+
+/* == Data ================================================================= */
+
+/** First line of the persisted index. Identifies the format. */
+static const char *_wlmaker_app_index_magic_ptr = "WLMAPPS1";
+/** Name of the persisted index within the cache directory. */
+static const char *_wlmaker_app_index_cache_name_ptr = "applications.idx";
+
+/** Events watched for, on each directory. */
+static const uint32_t _wlmaker_app_index_inotify_mask =
+    IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO;
+
+/** An XDG main category, and the title of its menu. */
+typedef struct {
+    /** Name of the main category, as listed in `Categories`. */
+    const char                *category_ptr;
+    /** Title of the menu. */
+    const char                *title_ptr;
+} wlmaker_app_category_t;
+
+/** XDG main categories. The 'Other' category is implied. */
+static const wlmaker_app_category_t _wlmaker_app_main_categories[] = {
+    { "AudioVideo", "Multimedia" },
+    { "Development", "Development" },
+    { "Education", "Education" },
+    { "Game", "Games" },
+    { "Graphics", "Graphics" },
+    { "Network", "Internet" },
+    { "Office", "Office" },
+    { "Science", "Science" },
+    { "Settings", "Settings" },
+    { "System", "System" },
+    { "Utility", "Utilities" },
+    { NULL, NULL }  // Sentinel.
+};
+
+/** Title of the menu for applications without a main category. */
+static const char *_wlmaker_app_other_title_ptr = "Other";
+
+const char *wlmaker_app_categories[] = {
+    "Multimedia", "Development", "Education", "Games", "Graphics",
+    "Internet", "Office", "Science", "Settings", "System", "Utilities",
+    "Other", NULL
+};
+
+/* == Exported methods ===================================================== */
+
+/* ------------------------------------------------------------------------- */
+wlmaker_app_index_t *wlmaker_app_index_create(
+    const char **dirs_ptr,
+    const char *cache_path_ptr,
+    struct wl_event_loop *wl_event_loop_ptr)
+{
+    wlmaker_app_index_t *app_index_ptr = logged_calloc(
+        1, sizeof(wlmaker_app_index_t));
+    if (NULL == app_index_ptr) return NULL;
+    app_index_ptr->inotify_fd = -1;
+
+    // Copies the directories into a NULL-terminated array.
+    char *default_dirs_ptr = NULL;
+    if (NULL == dirs_ptr) {
+        default_dirs_ptr = _wlmaker_app_index_default_dirs();
+        if (NULL == default_dirs_ptr) {
+            wlmaker_app_index_destroy(app_index_ptr);
+            return NULL;
+        }
+    }
+    size_t dirs = 0;
+    if (NULL != dirs_ptr) {
+        while (NULL != dirs_ptr[dirs]) ++dirs;
+    } else {
+        for (const char *c_ptr = default_dirs_ptr; '\0' != *c_ptr; ++c_ptr) {
+            if ('\n' == *c_ptr) ++dirs;
+        }
+    }
+    app_index_ptr->dirs_ptr = logged_calloc(dirs + 1, sizeof(char*));
+    app_index_ptr->watch_descriptors_ptr = logged_calloc(
+        dirs + 1, sizeof(int));
+    if (NULL == app_index_ptr->dirs_ptr ||
+        NULL == app_index_ptr->watch_descriptors_ptr) {
+        if (NULL != default_dirs_ptr) free(default_dirs_ptr);
+        wlmaker_app_index_destroy(app_index_ptr);
+        return NULL;
+    }
+    char *next_ptr = default_dirs_ptr;
+    for (size_t i = 0; i < dirs; ++i) {
+        app_index_ptr->watch_descriptors_ptr[i] = -1;
+        if (NULL != dirs_ptr) {
+            app_index_ptr->dirs_ptr[i] = logged_strdup(dirs_ptr[i]);
+        } else {
+            char *dir_ptr = next_ptr;
+            next_ptr = strchr(next_ptr, '\n');
+            *next_ptr++ = '\0';
+            app_index_ptr->dirs_ptr[i] = logged_strdup(dir_ptr);
+        }
+        if (NULL == app_index_ptr->dirs_ptr[i]) {
+            if (NULL != default_dirs_ptr) free(default_dirs_ptr);
+            wlmaker_app_index_destroy(app_index_ptr);
+            return NULL;
+        }
+        app_index_ptr->dirs = i + 1;
+    }
+    if (NULL != default_dirs_ptr) free(default_dirs_ptr);
+
+    char path[PATH_MAX];
+    if (NULL == cache_path_ptr &&
+        wlmtk_util_cache_dir(path, sizeof(path)) &&
+        strlen(path) + 1 + strlen(_wlmaker_app_index_cache_name_ptr) <
+        sizeof(path)) {
+        strcat(path, "/");
+        strcat(path, _wlmaker_app_index_cache_name_ptr);
+        cache_path_ptr = path;
+    }
+    if (NULL != cache_path_ptr) {
+        app_index_ptr->cache_path_ptr = logged_strdup(cache_path_ptr);
+        if (NULL == app_index_ptr->cache_path_ptr) {
+            wlmaker_app_index_destroy(app_index_ptr);
+            return NULL;
+        }
+    }
+
+    app_index_ptr->tree_ptr = bs_avltree_create(
+        _wlmaker_app_index_node_cmp, _wlmaker_app_index_node_destroy);
+    if (NULL == app_index_ptr->tree_ptr) {
+        wlmaker_app_index_destroy(app_index_ptr);
+        return NULL;
+    }
+
+    // Watch before scanning: Changes during the scan are not missed.
+    if (NULL != wl_event_loop_ptr &&
+        !_wlmaker_app_index_watch(app_index_ptr, wl_event_loop_ptr)) {
+        wlmaker_app_index_destroy(app_index_ptr);
+        return NULL;
+    }
+    if (!_wlmaker_app_index_scan(app_index_ptr)) {
+        wlmaker_app_index_destroy(app_index_ptr);
+        return NULL;
+    }
+    return app_index_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmaker_app_index_destroy(wlmaker_app_index_t *app_index_ptr)
+{
+    if (NULL != app_index_ptr->wl_event_source_ptr) {
+        wl_event_source_remove(app_index_ptr->wl_event_source_ptr);
+        app_index_ptr->wl_event_source_ptr = NULL;
+    }
+    if (0 <= app_index_ptr->inotify_fd) {
+        close(app_index_ptr->inotify_fd);
+        app_index_ptr->inotify_fd = -1;
+    }
+
+    if (NULL != app_index_ptr->tree_ptr) {
+        bs_avltree_destroy(app_index_ptr->tree_ptr);
+        app_index_ptr->tree_ptr = NULL;
+    }
+    if (NULL != app_index_ptr->cache_path_ptr) {
+        free(app_index_ptr->cache_path_ptr);
+        app_index_ptr->cache_path_ptr = NULL;
+    }
+    if (NULL != app_index_ptr->watch_descriptors_ptr) {
+        free(app_index_ptr->watch_descriptors_ptr);
+        app_index_ptr->watch_descriptors_ptr = NULL;
+    }
+    if (NULL != app_index_ptr->dirs_ptr) {
+        for (size_t i = 0; i < app_index_ptr->dirs; ++i) {
+            free(app_index_ptr->dirs_ptr[i]);
+        }
+        free(app_index_ptr->dirs_ptr);
+        app_index_ptr->dirs_ptr = NULL;
+    }
+    free(app_index_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmaker_app_index_for_each(
+    wlmaker_app_index_t *app_index_ptr,
+    wlmaker_app_index_callback_t callback,
+    void *ud_ptr)
+{
+    size_t size = bs_avltree_size(app_index_ptr->tree_ptr);
+    if (0 == size) return;
+    wlmaker_app_index_entry_t **entries_ptr = logged_calloc(
+        size, sizeof(wlmaker_app_index_entry_t*));
+    if (NULL == entries_ptr) return;
+
+    size_t entries = 0;
+    for (bs_avltree_node_t *avlnode_ptr = bs_avltree_min(
+             app_index_ptr->tree_ptr);
+         NULL != avlnode_ptr;
+         avlnode_ptr = bs_avltree_node_next(
+             app_index_ptr->tree_ptr, avlnode_ptr)) {
+        entries_ptr[entries++] = BS_CONTAINER_OF(
+            avlnode_ptr, wlmaker_app_index_entry_t, avlnode);
+    }
+
+    // The directory of highest precedence wins, also if hidden there.
+    qsort(entries_ptr, entries, sizeof(wlmaker_app_index_entry_t*),
+          _wlmaker_app_index_id_cmp);
+    size_t visible = 0;
+    for (size_t i = 0; i < entries; ++i) {
+        if (0 < i && 0 == strcmp(entries_ptr[i - 1]->id_ptr,
+                                 entries_ptr[i]->id_ptr)) continue;
+        if (!entries_ptr[i]->visible) continue;
+        entries_ptr[visible++] = entries_ptr[i];
+    }
+
+    qsort(entries_ptr, visible, sizeof(wlmaker_app_index_entry_t*),
+          _wlmaker_app_index_name_cmp);
+    for (size_t i = 0; i < visible; ++i) {
+        callback(&entries_ptr[i]->app, ud_ptr);
+    }
+    free(entries_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+const char *wlmaker_app_category(const wlmaker_app_t *app_ptr)
+{
+    for (const char *c_ptr = app_ptr->categories_ptr; '\0' != *c_ptr; ) {
+        size_t len = strcspn(c_ptr, ";");
+        for (const wlmaker_app_category_t *mc_ptr =
+                 &_wlmaker_app_main_categories[0];
+             NULL != mc_ptr->category_ptr;
+             ++mc_ptr) {
+            if (len == strlen(mc_ptr->category_ptr) &&
+                0 == strncmp(c_ptr, mc_ptr->category_ptr, len)) {
+                return mc_ptr->title_ptr;
+            }
+        }
+        c_ptr += len;
+        if (';' == *c_ptr) ++c_ptr;
+    }
+    return _wlmaker_app_other_title_ptr;
+}
+
+/* == Local (static) methods =============================================== */
+
+/* ------------------------------------------------------------------------- */
+/**
+ * (Re-)scans all directories. Entries of files that did not change since
+ * they were persisted or last parsed are kept, others are parsed. Stores
+ * the index, if it changed.
+ *
+ * @param app_index_ptr
+ *
+ * @return true on success.
+ */
+bool _wlmaker_app_index_scan(wlmaker_app_index_t *app_index_ptr)
+{
+    // Entries are looked up from the current and the persisted index, and
+    // moved into the new tree. What remains there, is gone.
+    bs_avltree_t *cached_tree_ptr = app_index_ptr->tree_ptr;
+    if (0 == bs_avltree_size(cached_tree_ptr)) {
+        _wlmaker_app_index_load(app_index_ptr, cached_tree_ptr);
+    }
+    app_index_ptr->tree_ptr = bs_avltree_create(
+        _wlmaker_app_index_node_cmp, _wlmaker_app_index_node_destroy);
+    if (NULL == app_index_ptr->tree_ptr) {
+        app_index_ptr->tree_ptr = cached_tree_ptr;
+        return false;
+    }
+
+    size_t parsed = app_index_ptr->parsed;
+    for (size_t i = 0; i < app_index_ptr->dirs; ++i) {
+        DIR *dir_ptr = opendir(app_index_ptr->dirs_ptr[i]);
+        if (NULL == dir_ptr) continue;
+        struct dirent *dirent_ptr;
+        while (NULL != (dirent_ptr = readdir(dir_ptr))) {
+            if (!_wlmaker_app_index_is_desktop_file(dirent_ptr->d_name)) {
+                continue;
+            }
+            _wlmaker_app_index_update_file(
+                app_index_ptr, i, dirent_ptr->d_name, cached_tree_ptr);
+        }
+        closedir(dir_ptr);
+    }
+
+    bool changed = (parsed != app_index_ptr->parsed ||
+                    0 < bs_avltree_size(cached_tree_ptr));
+    bs_avltree_destroy(cached_tree_ptr);
+    if (changed) _wlmaker_app_index_store(app_index_ptr);
+    bs_log(BS_INFO, "Indexed %zu applications, parsed %zu.",
+           bs_avltree_size(app_index_ptr->tree_ptr),
+           app_index_ptr->parsed - parsed);
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Updates the entry of the file `name_ptr` in the directory `dir_idx`.
+ *
+ * Re-uses the entry from `cached_tree_ptr` if the file did not change, and
+ * parses it otherwise. Removes the entry if the file is gone.
+ *
+ * @param app_index_ptr
+ * @param dir_idx
+ * @param name_ptr
+ * @param cached_tree_ptr     Tree to move unchanged entries from. May be
+ *                            @ref wlmaker_app_index_t::tree_ptr itself.
+ *
+ * @return true if the entry changed.
+ */
+bool _wlmaker_app_index_update_file(
+    wlmaker_app_index_t *app_index_ptr,
+    size_t dir_idx,
+    const char *name_ptr,
+    bs_avltree_t *cached_tree_ptr)
+{
+    char path[PATH_MAX];
+    int rv = snprintf(path, sizeof(path), "%s/%s",
+                      app_index_ptr->dirs_ptr[dir_idx], name_ptr);
+    if (0 > rv || (size_t)rv >= sizeof(path)) return false;
+
+    wlmaker_app_index_entry_t *entry_ptr = NULL;
+    bs_avltree_node_t *avlnode_ptr = bs_avltree_delete(cached_tree_ptr, path);
+    if (NULL != avlnode_ptr) {
+        entry_ptr = BS_CONTAINER_OF(
+            avlnode_ptr, wlmaker_app_index_entry_t, avlnode);
+    }
+
+    struct stat stat_buf;
+    if (0 != stat(path, &stat_buf)) {
+        if (NULL == entry_ptr) return false;
+        _wlmaker_app_index_entry_destroy(entry_ptr);
+        return true;
+    }
+    if (NULL != entry_ptr &&
+        (entry_ptr->dir_idx != dir_idx ||
+         entry_ptr->mtime.tv_sec != stat_buf.st_mtim.tv_sec ||
+         entry_ptr->mtime.tv_nsec != stat_buf.st_mtim.tv_nsec)) {
+        _wlmaker_app_index_entry_destroy(entry_ptr);
+        entry_ptr = NULL;
+    }
+
+    bool changed = false;
+    if (NULL == entry_ptr) {
+        entry_ptr = _wlmaker_app_index_parse(path, dir_idx, &stat_buf.st_mtim);
+        ++app_index_ptr->parsed;
+        changed = true;
+        if (NULL == entry_ptr) return changed;
+    }
+    bs_avltree_insert(app_index_ptr->tree_ptr, entry_ptr->path_ptr,
+                      &entry_ptr->avlnode, false);
+    return changed;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Parses the `[Desktop Entry]` group of the `.desktop` file at `path_ptr`.
+ *
+ * Only the non-localized keys are used. Entries that are not of type
+ * `Application`, are `Hidden`, `NoDisplay`, restricted by `OnlyShowIn`, or
+ * lack `Name` or `Exec` are created as not visible.
+ *
+ * @param path_ptr
+ * @param dir_idx
+ * @param mtime_ptr
+ *
+ * @return The entry, or NULL on error.
+ */
+wlmaker_app_index_entry_t *_wlmaker_app_index_parse(
+    const char *path_ptr,
+    size_t dir_idx,
+    const struct timespec *mtime_ptr)
+{
+    wlmaker_app_t app = {};
+    bool application = false, hidden = false;
+
+    FILE *file_ptr = fopen(path_ptr, "re");
+    if (NULL == file_ptr) {
+        bs_log(BS_WARNING | BS_ERRNO, "Failed fopen(%s, \"re\")", path_ptr);
+        return NULL;
+    }
+    bool in_desktop_entry = false;
+    char *line_ptr = NULL;
+    size_t line_size = 0;
+    while (0 <= getline(&line_ptr, &line_size, file_ptr)) {
+        line_ptr[strcspn(line_ptr, "\r\n")] = '\0';
+        if ('[' == line_ptr[0]) {
+            in_desktop_entry = (0 == strcmp(line_ptr, "[Desktop Entry]"));
+            continue;
+        }
+        if (!in_desktop_entry) continue;
+
+        char *value_ptr = strchr(line_ptr, '=');
+        if (NULL == value_ptr) continue;
+        *value_ptr++ = '\0';
+        char *key_ptr = line_ptr;
+        key_ptr[strcspn(key_ptr, " \t")] = '\0';
+        value_ptr += strspn(value_ptr, " \t");
+
+        char **target_ptr_ptr = NULL;
+        if (0 == strcmp(key_ptr, "Type")) {
+            application = (0 == strcmp(value_ptr, "Application"));
+        } else if (0 == strcmp(key_ptr, "NoDisplay") ||
+                   0 == strcmp(key_ptr, "Hidden")) {
+            if (0 == strcmp(value_ptr, "true")) hidden = true;
+        } else if (0 == strcmp(key_ptr, "OnlyShowIn")) {
+            hidden = true;
+        } else if (0 == strcmp(key_ptr, "Name")) {
+            target_ptr_ptr = &app.name_ptr;
+        } else if (0 == strcmp(key_ptr, "Exec")) {
+            target_ptr_ptr = &app.exec_ptr;
+        } else if (0 == strcmp(key_ptr, "Icon")) {
+            target_ptr_ptr = &app.icon_ptr;
+        } else if (0 == strcmp(key_ptr, "Categories")) {
+            target_ptr_ptr = &app.categories_ptr;
+        }
+        if (NULL != target_ptr_ptr && NULL == *target_ptr_ptr) {
+            _wlmaker_app_index_decode_value(
+                value_ptr, target_ptr_ptr == &app.exec_ptr);
+            *target_ptr_ptr = logged_strdup(value_ptr);
+        }
+    }
+    if (NULL != line_ptr) free(line_ptr);
+    fclose(file_ptr);
+
+    bool visible = (application && !hidden &&
+                    NULL != app.name_ptr && '\0' != *app.name_ptr &&
+                    NULL != app.exec_ptr && '\0' != *app.exec_ptr);
+    wlmaker_app_index_entry_t *entry_ptr = _wlmaker_app_index_entry_create(
+        path_ptr, dir_idx, mtime_ptr, visible, &app);
+    if (NULL != app.name_ptr) free(app.name_ptr);
+    if (NULL != app.exec_ptr) free(app.exec_ptr);
+    if (NULL != app.icon_ptr) free(app.icon_ptr);
+    if (NULL != app.categories_ptr) free(app.categories_ptr);
+    return entry_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Decodes the escape sequences of a value, in place. For `Exec`, removes the
+ * field codes: No files or URLs are passed when launching from the menu.
+ * Tabs are replaced by spaces, for the persisted index.
+ *
+ * @param value_ptr
+ * @param exec
+ */
+void _wlmaker_app_index_decode_value(char *value_ptr, bool exec)
+{
+    char *dest_ptr = value_ptr;
+    for (const char *src_ptr = value_ptr; '\0' != *src_ptr; ++src_ptr) {
+        if ('\\' == src_ptr[0] && '\0' != src_ptr[1]) {
+            switch (*++src_ptr) {
+            case 's': *dest_ptr++ = ' '; break;
+            case 'n': *dest_ptr++ = ' '; break;
+            case 't': *dest_ptr++ = ' '; break;
+            case 'r': break;
+            default: *dest_ptr++ = *src_ptr; break;
+            }
+        } else if (exec && '%' == src_ptr[0] && '\0' != src_ptr[1]) {
+            if ('%' == *++src_ptr) *dest_ptr++ = '%';
+        } else {
+            *dest_ptr++ = '\t' == *src_ptr ? ' ' : *src_ptr;
+        }
+    }
+    *dest_ptr = '\0';
+
+    // Field codes may leave trailing whitespace.
+    while (dest_ptr > value_ptr && ' ' == dest_ptr[-1]) *--dest_ptr = '\0';
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Loads the persisted index into `tree_ptr`. Not fatal on failure: Files
+ * are then parsed again.
+ *
+ * The format has one line per `.desktop` file, with tab-separated fields:
+ * directory index, mtime seconds, mtime nanoseconds, visibility, path,
+ * name, command line, icon and categories.
+ *
+ * @param app_index_ptr
+ * @param tree_ptr
+ */
+void _wlmaker_app_index_load(
+    wlmaker_app_index_t *app_index_ptr,
+    bs_avltree_t *tree_ptr)
+{
+    if (NULL == app_index_ptr->cache_path_ptr) return;
+    FILE *file_ptr = fopen(app_index_ptr->cache_path_ptr, "re");
+    if (NULL == file_ptr) return;
+
+    char *line_ptr = NULL;
+    size_t line_size = 0;
+    if (0 > getline(&line_ptr, &line_size, file_ptr) ||
+        0 != strncmp(line_ptr, _wlmaker_app_index_magic_ptr,
+                     strlen(_wlmaker_app_index_magic_ptr))) {
+        bs_log(BS_WARNING, "Ignoring %s: Unknown format.",
+               app_index_ptr->cache_path_ptr);
+        if (NULL != line_ptr) free(line_ptr);
+        fclose(file_ptr);
+        return;
+    }
+
+    while (0 <= getline(&line_ptr, &line_size, file_ptr)) {
+        line_ptr[strcspn(line_ptr, "\n")] = '\0';
+        char *fields[9];
+        size_t field = 0;
+        for (char *c_ptr = line_ptr; field < 9; ++field) {
+            fields[field] = c_ptr;
+            c_ptr = strchr(c_ptr, '\t');
+            if (NULL == c_ptr) break;
+            *c_ptr++ = '\0';
+        }
+        if (8 != field) continue;
+
+        char *end_ptr;
+        size_t dir_idx = strtoul(fields[0], &end_ptr, 10);
+        struct timespec mtime = {
+            .tv_sec = strtoll(fields[1], NULL, 10),
+            .tv_nsec = strtol(fields[2], NULL, 10)
+        };
+        if (dir_idx >= app_index_ptr->dirs || '\0' != *end_ptr) continue;
+        wlmaker_app_t app = {
+            .name_ptr = fields[5],
+            .exec_ptr = fields[6],
+            .icon_ptr = fields[7],
+            .categories_ptr = fields[8]
+        };
+        wlmaker_app_index_entry_t *entry_ptr = _wlmaker_app_index_entry_create(
+            fields[4], dir_idx, &mtime, '1' == fields[3][0], &app);
+        if (NULL == entry_ptr) break;
+        if (!bs_avltree_insert(tree_ptr, entry_ptr->path_ptr,
+                               &entry_ptr->avlnode, false)) {
+            _wlmaker_app_index_entry_destroy(entry_ptr);
+        }
+    }
+    if (NULL != line_ptr) free(line_ptr);
+    fclose(file_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Persists the index, through a temporary file that is renamed into place.
+ * Not fatal on failure: The files are then parsed again on next start.
+ *
+ * @param app_index_ptr
+ */
+void _wlmaker_app_index_store(wlmaker_app_index_t *app_index_ptr)
+{
+    if (NULL == app_index_ptr->cache_path_ptr) return;
+    char tmp_path[PATH_MAX];
+    int rv = snprintf(tmp_path, sizeof(tmp_path), "%s.XXXXXX",
+                      app_index_ptr->cache_path_ptr);
+    if (0 > rv || (size_t)rv >= sizeof(tmp_path)) return;
+    int fd = mkostemp(tmp_path, O_CLOEXEC);
+    if (0 > fd) {
+        bs_log(BS_WARNING | BS_ERRNO, "Failed mkostemp(%s, O_CLOEXEC)",
+               tmp_path);
+        return;
+    }
+    FILE *file_ptr = fdopen(fd, "w");
+    if (NULL == file_ptr) {
+        bs_log(BS_WARNING | BS_ERRNO, "Failed fdopen(%d, \"w\")", fd);
+        close(fd);
+        unlink(tmp_path);
+        return;
+    }
+
+    fprintf(file_ptr, "%s\n", _wlmaker_app_index_magic_ptr);
+    for (bs_avltree_node_t *avlnode_ptr = bs_avltree_min(
+             app_index_ptr->tree_ptr);
+         NULL != avlnode_ptr;
+         avlnode_ptr = bs_avltree_node_next(
+             app_index_ptr->tree_ptr, avlnode_ptr)) {
+        wlmaker_app_index_entry_t *entry_ptr = BS_CONTAINER_OF(
+            avlnode_ptr, wlmaker_app_index_entry_t, avlnode);
+        fprintf(file_ptr, "%zu\t%"PRId64"\t%ld\t%d\t%s\t%s\t%s\t%s\t%s\n",
+                entry_ptr->dir_idx,
+                (int64_t)entry_ptr->mtime.tv_sec,
+                entry_ptr->mtime.tv_nsec,
+                entry_ptr->visible ? 1 : 0,
+                entry_ptr->path_ptr,
+                entry_ptr->app.name_ptr,
+                entry_ptr->app.exec_ptr,
+                entry_ptr->app.icon_ptr,
+                entry_ptr->app.categories_ptr);
+    }
+    bool written = !ferror(file_ptr);
+    if (0 != fclose(file_ptr)) written = false;
+
+    if (!written || 0 != rename(tmp_path, app_index_ptr->cache_path_ptr)) {
+        bs_log(BS_WARNING | BS_ERRNO, "Failed to write %s",
+               app_index_ptr->cache_path_ptr);
+        unlink(tmp_path);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Sets up inotify(7) watches on all existing directories, and registers
+ * the inotify file descriptor with the event loop.
+ *
+ * @param app_index_ptr
+ * @param wl_event_loop_ptr
+ *
+ * @return true on success.
+ */
+bool _wlmaker_app_index_watch(
+    wlmaker_app_index_t *app_index_ptr,
+    struct wl_event_loop *wl_event_loop_ptr)
+{
+    app_index_ptr->inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (0 > app_index_ptr->inotify_fd) {
+        bs_log(BS_ERROR | BS_ERRNO, "Failed inotify_init1(IN_NONBLOCK | "
+               "IN_CLOEXEC)");
+        return false;
+    }
+
+    // Directories that do not exist are not watched.
+    for (size_t i = 0; i < app_index_ptr->dirs; ++i) {
+        app_index_ptr->watch_descriptors_ptr[i] = inotify_add_watch(
+            app_index_ptr->inotify_fd,
+            app_index_ptr->dirs_ptr[i],
+            _wlmaker_app_index_inotify_mask);
+        if (0 > app_index_ptr->watch_descriptors_ptr[i] && ENOENT != errno) {
+            bs_log(BS_WARNING | BS_ERRNO, "Failed inotify_add_watch(%d, %s, "
+                   "0x%"PRIx32")", app_index_ptr->inotify_fd,
+                   app_index_ptr->dirs_ptr[i],
+                   _wlmaker_app_index_inotify_mask);
+        }
+    }
+
+    app_index_ptr->wl_event_source_ptr = wl_event_loop_add_fd(
+        wl_event_loop_ptr,
+        app_index_ptr->inotify_fd,
+        WL_EVENT_READABLE,
+        _wlmaker_app_index_handle_inotify,
+        app_index_ptr);
+    if (NULL == app_index_ptr->wl_event_source_ptr) {
+        bs_log(BS_ERROR, "Failed wl_event_loop_add_fd(%p, %d, ...)",
+               wl_event_loop_ptr, app_index_ptr->inotify_fd);
+        return false;
+    }
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Handles inotify(7) events: Updates the entries of the files concerned,
+ * and stores the index if it changed.
+ *
+ * @param fd
+ * @param mask
+ * @param ud_ptr
+ *
+ * @return 0.
+ */
+int _wlmaker_app_index_handle_inotify(
+    int fd,
+    __UNUSED__ uint32_t mask,
+    void *ud_ptr)
+{
+    wlmaker_app_index_t *app_index_ptr = ud_ptr;
+    char buf[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+    bool changed = false, overflow = false;
+
+    ssize_t len;
+    while (0 < (len = read(fd, buf, sizeof(buf)))) {
+        for (const char *c_ptr = buf; c_ptr < buf + len;
+             c_ptr += sizeof(struct inotify_event) +
+                 ((const struct inotify_event*)c_ptr)->len) {
+            const struct inotify_event *event_ptr = (const void*)c_ptr;
+            if (0 != (event_ptr->mask & IN_Q_OVERFLOW)) overflow = true;
+            if (0 == event_ptr->len ||
+                !_wlmaker_app_index_is_desktop_file(event_ptr->name)) {
+                continue;
+            }
+            for (size_t i = 0; i < app_index_ptr->dirs; ++i) {
+                if (app_index_ptr->watch_descriptors_ptr[i] !=
+                    event_ptr->wd) continue;
+                if (_wlmaker_app_index_update_file(
+                        app_index_ptr, i, event_ptr->name,
+                        app_index_ptr->tree_ptr)) changed = true;
+                break;
+            }
+        }
+    }
+    if (0 > len && EAGAIN != errno && EINTR != errno) {
+        bs_log(BS_WARNING | BS_ERRNO, "Failed read(%d, %p, %zu)",
+               fd, buf, sizeof(buf));
+    }
+
+    // Events were lost: Re-scan. Unchanged entries are kept.
+    if (overflow) {
+        _wlmaker_app_index_scan(app_index_ptr);
+    } else if (changed) {
+        _wlmaker_app_index_store(app_index_ptr);
+    }
+    return 0;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Returns the XDG directories for `.desktop` files: `applications` in
+ * `$XDG_DATA_HOME` and in each of `$XDG_DATA_DIRS`.
+ *
+ * @return The directories, each terminated by '\n'. Must be free()-ed.
+ */
+char *_wlmaker_app_index_default_dirs(void)
+{
+    const char *home_ptr = getenv("HOME");
+    const char *data_home_ptr = getenv("XDG_DATA_HOME");
+    const char *data_dirs_ptr = getenv("XDG_DATA_DIRS");
+    if (NULL == data_dirs_ptr || '\0' == *data_dirs_ptr) {
+        data_dirs_ptr = "/usr/local/share:/usr/share";
+    }
+
+    size_t size = strlen(data_dirs_ptr) * 2 + 64 + PATH_MAX;
+    for (const char *c_ptr = data_dirs_ptr; '\0' != *c_ptr; ++c_ptr) {
+        if (':' == *c_ptr) size += sizeof("/applications\n");
+    }
+    char *dirs_ptr = logged_calloc(1, size);
+    if (NULL == dirs_ptr) return NULL;
+
+    size_t pos = 0;
+    if (NULL != data_home_ptr && '/' == *data_home_ptr) {
+        pos = bs_strappendf(dirs_ptr, size, pos, "%.*s/applications\n",
+                            PATH_MAX / 2, data_home_ptr);
+    } else if (NULL != home_ptr) {
+        pos = bs_strappendf(dirs_ptr, size, pos,
+                            "%.*s/.local/share/applications\n",
+                            PATH_MAX / 2, home_ptr);
+    }
+    for (const char *c_ptr = data_dirs_ptr; '\0' != *c_ptr; ) {
+        size_t len = strcspn(c_ptr, ":");
+        // Only absolute paths are valid.
+        if ('/' == *c_ptr) {
+            pos = bs_strappendf(dirs_ptr, size, pos, "%.*s/applications\n",
+                                (int)len, c_ptr);
+        }
+        c_ptr += len;
+        if (':' == *c_ptr) ++c_ptr;
+    }
+    return dirs_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Returns whether `name_ptr` is the name of a `.desktop` file. */
+bool _wlmaker_app_index_is_desktop_file(const char *name_ptr)
+{
+    size_t len = strlen(name_ptr);
+    return (len > 8 && '.' != name_ptr[0] &&
+            0 == strcmp(name_ptr + len - 8, ".desktop"));
+}
+
+/* ------------------------------------------------------------------------- */
+/** Creates an entry. Copies all strings; NULL strings become empty. */
+wlmaker_app_index_entry_t *_wlmaker_app_index_entry_create(
+    const char *path_ptr,
+    size_t dir_idx,
+    const struct timespec *mtime_ptr,
+    bool visible,
+    const wlmaker_app_t *app_ptr)
+{
+    wlmaker_app_index_entry_t *entry_ptr = logged_calloc(
+        1, sizeof(wlmaker_app_index_entry_t));
+    if (NULL == entry_ptr) return NULL;
+    entry_ptr->dir_idx = dir_idx;
+    entry_ptr->mtime = *mtime_ptr;
+    entry_ptr->visible = visible;
+
+    entry_ptr->path_ptr = logged_strdup(path_ptr);
+    entry_ptr->app.name_ptr = logged_strdup(
+        NULL != app_ptr->name_ptr ? app_ptr->name_ptr : "");
+    entry_ptr->app.exec_ptr = logged_strdup(
+        NULL != app_ptr->exec_ptr ? app_ptr->exec_ptr : "");
+    entry_ptr->app.icon_ptr = logged_strdup(
+        NULL != app_ptr->icon_ptr ? app_ptr->icon_ptr : "");
+    entry_ptr->app.categories_ptr = logged_strdup(
+        NULL != app_ptr->categories_ptr ? app_ptr->categories_ptr : "");
+    if (NULL == entry_ptr->path_ptr ||
+        NULL == entry_ptr->app.name_ptr ||
+        NULL == entry_ptr->app.exec_ptr ||
+        NULL == entry_ptr->app.icon_ptr ||
+        NULL == entry_ptr->app.categories_ptr) {
+        _wlmaker_app_index_entry_destroy(entry_ptr);
+        return NULL;
+    }
+    const char *slash_ptr = strrchr(entry_ptr->path_ptr, '/');
+    entry_ptr->id_ptr = NULL != slash_ptr ? slash_ptr + 1 : entry_ptr->path_ptr;
+    return entry_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Destroys the entry. */
+void _wlmaker_app_index_entry_destroy(wlmaker_app_index_entry_t *entry_ptr)
+{
+    if (NULL != entry_ptr->app.categories_ptr) {
+        free(entry_ptr->app.categories_ptr);
+    }
+    if (NULL != entry_ptr->app.icon_ptr) free(entry_ptr->app.icon_ptr);
+    if (NULL != entry_ptr->app.exec_ptr) free(entry_ptr->app.exec_ptr);
+    if (NULL != entry_ptr->app.name_ptr) free(entry_ptr->app.name_ptr);
+    if (NULL != entry_ptr->path_ptr) free(entry_ptr->path_ptr);
+    free(entry_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Comparator for @ref wlmaker_app_index_t::tree_ptr: By path. */
+int _wlmaker_app_index_node_cmp(
+    const bs_avltree_node_t *node_ptr,
+    const void *key_ptr)
+{
+    return strcmp(
+        BS_CONTAINER_OF(node_ptr, wlmaker_app_index_entry_t,
+                        avlnode)->path_ptr,
+        key_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Node destructor for @ref wlmaker_app_index_t::tree_ptr. */
+void _wlmaker_app_index_node_destroy(bs_avltree_node_t *node_ptr)
+{
+    _wlmaker_app_index_entry_destroy(
+        BS_CONTAINER_OF(node_ptr, wlmaker_app_index_entry_t, avlnode));
+}
+
+/* ------------------------------------------------------------------------- */
+/** Orders entries by desktop file ID, then directory precedence. */
+int _wlmaker_app_index_id_cmp(const void *a_ptr, const void *b_ptr)
+{
+    const wlmaker_app_index_entry_t *e1_ptr =
+        *(wlmaker_app_index_entry_t* const*)a_ptr;
+    const wlmaker_app_index_entry_t *e2_ptr =
+        *(wlmaker_app_index_entry_t* const*)b_ptr;
+    int rv = strcmp(e1_ptr->id_ptr, e2_ptr->id_ptr);
+    if (0 != rv) return rv;
+    if (e1_ptr->dir_idx != e2_ptr->dir_idx) {
+        return e1_ptr->dir_idx < e2_ptr->dir_idx ? -1 : 1;
+    }
+    return 0;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Orders entries by application name, then desktop file ID. */
+int _wlmaker_app_index_name_cmp(const void *a_ptr, const void *b_ptr)
+{
+    const wlmaker_app_index_entry_t *e1_ptr =
+        *(wlmaker_app_index_entry_t* const*)a_ptr;
+    const wlmaker_app_index_entry_t *e2_ptr =
+        *(wlmaker_app_index_entry_t* const*)b_ptr;
+    int rv = strcasecmp(e1_ptr->app.name_ptr, e2_ptr->app.name_ptr);
+    if (0 != rv) return rv;
+    return strcmp(e1_ptr->id_ptr, e2_ptr->id_ptr);
+}
+
+/* == Unit tests =========================================================== */
+
+static void test_parse(bs_test_t *test_ptr);
+static void test_persist(bs_test_t *test_ptr);
+static void test_watch(bs_test_t *test_ptr);
+
+const bs_test_case_t wlmaker_app_index_test_cases[] = {
+    { 1, "parse", test_parse },
+    { 1, "persist", test_persist },
+    { 1, "watch", test_watch },
+    { 0, NULL, NULL }
+};
+
+/** Test fixture: A temporary directory with two application directories. */
+typedef struct {
+    /** The temporary directory. */
+    char                      dir[64];
+    /** Application directories, NULL-terminated. */
+    const char                *dirs_ptr[3];
+    /** First application directory. */
+    char                      apps1[128];
+    /** Second application directory, of lower precedence. */
+    char                      apps2[128];
+    /** Path of the persisted index. */
+    char                      cache_path[PATH_MAX];
+    /** Names of the applications, as reported by for_each. */
+    char                      names[256];
+} wlmaker_app_index_test_fixture_t;
+
+/* ------------------------------------------------------------------------- */
+/** Writes `content_ptr` into the file `dir_ptr`/`name_ptr`. */
+static bool _wlmaker_app_index_test_write(
+    const char *dir_ptr,
+    const char *name_ptr,
+    const char *content_ptr)
+{
+    char path[PATH_MAX];
+    snprintf(path, sizeof(path), "%s/%s", dir_ptr, name_ptr);
+    FILE *file_ptr = fopen(path, "w");
+    if (NULL == file_ptr) return false;
+    fputs(content_ptr, file_ptr);
+    return 0 == fclose(file_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Sets up the fixture. */
+static bool _wlmaker_app_index_test_setup(
+    wlmaker_app_index_test_fixture_t *f_ptr)
+{
+    *f_ptr = (wlmaker_app_index_test_fixture_t){
+        .dir = "/tmp/wlmaker_app_index_test_XXXXXX" };
+    if (NULL == mkdtemp(f_ptr->dir)) return false;
+    snprintf(f_ptr->apps1, sizeof(f_ptr->apps1), "%s/apps1", f_ptr->dir);
+    snprintf(f_ptr->apps2, sizeof(f_ptr->apps2), "%s/apps2", f_ptr->dir);
+    snprintf(f_ptr->cache_path, sizeof(f_ptr->cache_path),
+             "%s/applications.idx", f_ptr->dir);
+    f_ptr->dirs_ptr[0] = f_ptr->apps1;
+    f_ptr->dirs_ptr[1] = f_ptr->apps2;
+    f_ptr->dirs_ptr[2] = NULL;
+    return (0 == mkdir(f_ptr->apps1, 0700) &&
+            0 == mkdir(f_ptr->apps2, 0700) &&
+            _wlmaker_app_index_test_write(
+                f_ptr->apps1, "term.desktop",
+                "[Desktop Entry]\n"
+                "Type=Application\n"
+                "Name=Terminal\n"
+                "Name[de]=Konsole\n"
+                "Exec=foot --title\\sT %U\n"
+                "Icon=utilities-terminal\n"
+                "Categories=System;TerminalEmulator;\n"
+                "\n"
+                "[Desktop Action new]\n"
+                "Name=New Window\n") &&
+            _wlmaker_app_index_test_write(
+                f_ptr->apps1, "hidden.desktop",
+                "[Desktop Entry]\n"
+                "Type=Application\n"
+                "Name=Hidden\n"
+                "Exec=hidden\n"
+                "NoDisplay=true\n") &&
+            _wlmaker_app_index_test_write(
+                f_ptr->apps2, "term.desktop",
+                "[Desktop Entry]\n"
+                "Type=Application\n"
+                "Name=Overridden\n"
+                "Exec=overridden\n") &&
+            _wlmaker_app_index_test_write(
+                f_ptr->apps2, "browser.desktop",
+                "[Desktop Entry]\n"
+                "Type=Application\n"
+                "Name=browser\n"
+                "Exec=browser 100%%\n"
+                "Categories=Network;WebBrowser\n") &&
+            _wlmaker_app_index_test_write(
+                f_ptr->apps2, "link.desktop",
+                "[Desktop Entry]\n"
+                "Type=Link\n"
+                "Name=Link\n"
+                "URL=https://example.com\n"));
+}
+
+/* ------------------------------------------------------------------------- */
+/** Callback for nftw(3): Removes the file or directory. */
+static int _wlmaker_app_index_test_remove(
+    const char *path_ptr,
+    __UNUSED__ const struct stat *stat_ptr,
+    __UNUSED__ int type,
+    __UNUSED__ struct FTW *ftw_ptr)
+{
+    return remove(path_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Callback for @ref wlmaker_app_index_for_each: Appends the name. */
+static void _wlmaker_app_index_test_append_name(
+    const wlmaker_app_t *app_ptr,
+    void *ud_ptr)
+{
+    wlmaker_app_index_test_fixture_t *f_ptr = ud_ptr;
+    size_t len = strlen(f_ptr->names);
+    snprintf(f_ptr->names + len, sizeof(f_ptr->names) - len, "%s%s",
+             0 < len ? "," : "", app_ptr->name_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Callback for @ref wlmaker_app_index_for_each: Verifies 'Terminal'. */
+static void _wlmaker_app_index_test_verify(
+    const wlmaker_app_t *app_ptr,
+    void *ud_ptr)
+{
+    bs_test_t *test_ptr = ud_ptr;
+    if (0 == strcmp(app_ptr->name_ptr, "Terminal")) {
+        BS_TEST_VERIFY_STREQ(test_ptr, "foot --title T", app_ptr->exec_ptr);
+        BS_TEST_VERIFY_STREQ(test_ptr, "utilities-terminal",
+                             app_ptr->icon_ptr);
+        BS_TEST_VERIFY_STREQ(test_ptr, "System",
+                             wlmaker_app_category(app_ptr));
+    } else {
+        BS_TEST_VERIFY_STREQ(test_ptr, "browser", app_ptr->name_ptr);
+        BS_TEST_VERIFY_STREQ(test_ptr, "browser 100%", app_ptr->exec_ptr);
+        BS_TEST_VERIFY_STREQ(test_ptr, "", app_ptr->icon_ptr);
+        BS_TEST_VERIFY_STREQ(test_ptr, "Internet",
+                             wlmaker_app_category(app_ptr));
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/** Parses `.desktop` files: Visibility, precedence, decoding and order. */
+void test_parse(bs_test_t *test_ptr)
+{
+    wlmaker_app_index_test_fixture_t f;
+    BS_TEST_VERIFY_TRUE_OR_RETURN(test_ptr, _wlmaker_app_index_test_setup(&f));
+
+    wlmaker_app_index_t *app_index_ptr = wlmaker_app_index_create(
+        f.dirs_ptr, NULL, NULL);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, app_index_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 5, app_index_ptr->parsed);
+
+    wlmaker_app_index_for_each(
+        app_index_ptr, _wlmaker_app_index_test_append_name, &f);
+    BS_TEST_VERIFY_STREQ(test_ptr, "browser,Terminal", f.names);
+    wlmaker_app_index_for_each(
+        app_index_ptr, _wlmaker_app_index_test_verify, test_ptr);
+
+    wlmaker_app_t app = { .categories_ptr = "Utility;Game" };
+    BS_TEST_VERIFY_STREQ(test_ptr, "Utilities", wlmaker_app_category(&app));
+    app.categories_ptr = "GTK;Games";
+    BS_TEST_VERIFY_STREQ(test_ptr, "Other", wlmaker_app_category(&app));
+
+    wlmaker_app_index_destroy(app_index_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, nftw(f.dir, _wlmaker_app_index_test_remove,
+                                        16, FTW_DEPTH | FTW_PHYS));
+}
+
+/* ------------------------------------------------------------------------- */
+/** Persists the index, and only parses changed files on re-creation. */
+void test_persist(bs_test_t *test_ptr)
+{
+    wlmaker_app_index_test_fixture_t f;
+    BS_TEST_VERIFY_TRUE_OR_RETURN(test_ptr, _wlmaker_app_index_test_setup(&f));
+
+    wlmaker_app_index_t *app_index_ptr = wlmaker_app_index_create(
+        f.dirs_ptr, f.cache_path, NULL);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, app_index_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 5, app_index_ptr->parsed);
+    wlmaker_app_index_destroy(app_index_ptr);
+
+    // Unchanged: Nothing is parsed.
+    app_index_ptr = wlmaker_app_index_create(f.dirs_ptr, f.cache_path, NULL);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, app_index_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, app_index_ptr->parsed);
+    wlmaker_app_index_for_each(
+        app_index_ptr, _wlmaker_app_index_test_append_name, &f);
+    BS_TEST_VERIFY_STREQ(test_ptr, "browser,Terminal", f.names);
+    wlmaker_app_index_for_each(
+        app_index_ptr, _wlmaker_app_index_test_verify, test_ptr);
+    wlmaker_app_index_destroy(app_index_ptr);
+
+    // One file changed, one removed: Only the changed one is parsed.
+    BS_TEST_VERIFY_TRUE(test_ptr, _wlmaker_app_index_test_write(
+        f.apps2, "browser.desktop",
+        "[Desktop Entry]\n"
+        "Type=Application\n"
+        "Name=Browser\n"
+        "Exec=browser\n"));
+    char path[PATH_MAX];
+    snprintf(path, sizeof(path), "%s/term.desktop", f.apps1);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, unlink(path));
+    app_index_ptr = wlmaker_app_index_create(f.dirs_ptr, f.cache_path, NULL);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, app_index_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, app_index_ptr->parsed);
+    f.names[0] = '\0';
+    wlmaker_app_index_for_each(
+        app_index_ptr, _wlmaker_app_index_test_append_name, &f);
+    BS_TEST_VERIFY_STREQ(test_ptr, "Browser,Overridden", f.names);
+    wlmaker_app_index_destroy(app_index_ptr);
+
+    BS_TEST_VERIFY_EQ(test_ptr, 0, nftw(f.dir, _wlmaker_app_index_test_remove,
+                                        16, FTW_DEPTH | FTW_PHYS));
+}
+
+/* ------------------------------------------------------------------------- */
+/** Updates the index incrementally, through inotify. */
+void test_watch(bs_test_t *test_ptr)
+{
+    wlmaker_app_index_test_fixture_t f;
+    BS_TEST_VERIFY_TRUE_OR_RETURN(test_ptr, _wlmaker_app_index_test_setup(&f));
+    struct wl_event_loop *wl_event_loop_ptr = wl_event_loop_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, wl_event_loop_ptr);
+
+    wlmaker_app_index_t *app_index_ptr = wlmaker_app_index_create(
+        f.dirs_ptr, f.cache_path, wl_event_loop_ptr);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, app_index_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 5, app_index_ptr->parsed);
+
+    // Adds an application, and removes the override of another.
+    BS_TEST_VERIFY_TRUE(test_ptr, _wlmaker_app_index_test_write(
+        f.apps2, "editor.desktop",
+        "[Desktop Entry]\n"
+        "Type=Application\n"
+        "Name=Editor\n"
+        "Exec=editor %F\n"));
+    char path[PATH_MAX];
+    snprintf(path, sizeof(path), "%s/term.desktop", f.apps1);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, unlink(path));
+    BS_TEST_VERIFY_EQ(
+        test_ptr, 0, wl_event_loop_dispatch(wl_event_loop_ptr, 1000));
+
+    wlmaker_app_index_for_each(
+        app_index_ptr, _wlmaker_app_index_test_append_name, &f);
+    BS_TEST_VERIFY_STREQ(test_ptr, "browser,Editor,Overridden", f.names);
+    BS_TEST_VERIFY_EQ(test_ptr, 6, app_index_ptr->parsed);
+    wlmaker_app_index_destroy(app_index_ptr);
+
+    // The update was persisted.
+    app_index_ptr = wlmaker_app_index_create(f.dirs_ptr, f.cache_path, NULL);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, app_index_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, app_index_ptr->parsed);
+    wlmaker_app_index_destroy(app_index_ptr);
+
+    wl_event_loop_destroy(wl_event_loop_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, nftw(f.dir, _wlmaker_app_index_test_remove,
+                                        16, FTW_DEPTH | FTW_PHYS));
+}
+
+/* == End of app_index.c =================================================== */
@@ -0,0 +1,125 @@
+/* ========================================================================= */
+/**
+ * @file app_index.h
+ *
+ * @copyright
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __APP_INDEX_H__
+#define __APP_INDEX_H__
+
+#include <libbase/libbase.h>
+
+/** Forward declaration: Index of installed applications. */
+typedef struct _wlmaker_app_index_t wlmaker_app_index_t;
+
+/** Forward declaration. */
+struct wl_event_loop;
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+/** An application, as described by its XDG `.desktop` file. */
+typedef struct {
+    /** Name of the application. */
+    char                      *name_ptr;
+    /** Command line, with field codes removed. */
+    char                      *exec_ptr;
+    /** Icon name or path. Empty if none. */
+    char                      *icon_ptr;
+    /** Semicolon-separated list of categories. Empty if none. */
+    char                      *categories_ptr;
+} wlmaker_app_t;
+
+/**
+ * Callback for @ref wlmaker_app_index_for_each.
+ *
+ * @param app_ptr             The application. Owned by the index, and valid
+ *                            only for the duration of the call.
+ * @param ud_ptr
+ */
+typedef void (*wlmaker_app_index_callback_t)(
+    const wlmaker_app_t *app_ptr,
+    void *ud_ptr);
+
+/**
+ * Creates the index of installed applications.
+ *
+ * Parses each `.desktop` file once, and persists the result at
+ * `cache_path_ptr`. On later calls, only files with a changed mtime are
+ * parsed again. With an event loop, the directories are watched through
+ * inotify(7), and the index is updated incrementally.
+ *
+ * @param dirs_ptr            NULL-terminated array of directories holding
+ *                            `.desktop` files, in order of precedence. NULL
+ *                            for `applications` in `$XDG_DATA_HOME` and in
+ *                            each of `$XDG_DATA_DIRS`.
+ * @param cache_path_ptr      Path of the persisted index. NULL for
+ *                            `applications.idx` in @ref wlmtk_util_cache_dir.
+ * @param wl_event_loop_ptr   Event loop for watching the directories, or
+ *                            NULL to not watch.
+ *
+ * @return Pointer to the index, or NULL on error.
+ */
+wlmaker_app_index_t *wlmaker_app_index_create(
+    const char **dirs_ptr,
+    const char *cache_path_ptr,
+    struct wl_event_loop *wl_event_loop_ptr);
+
+/**
+ * Destroys the index.
+ *
+ * @param app_index_ptr
+ */
+void wlmaker_app_index_destroy(wlmaker_app_index_t *app_index_ptr);
+
+/**
+ * Calls `callback` for each application to be shown, in order of name.
+ *
+ * Hidden applications are skipped. Of applications with the same desktop
+ * file ID, only the one from the directory of highest precedence is used.
+ *
+ * @param app_index_ptr
+ * @param callback
+ * @param ud_ptr
+ */
+void wlmaker_app_index_for_each(
+    wlmaker_app_index_t *app_index_ptr,
+    wlmaker_app_index_callback_t callback,
+    void *ud_ptr);
+
+/**
+ * Returns the menu category of the application: The title of the first XDG
+ * main category it lists, eg. "Internet" for `Network`. Or "Other".
+ *
+ * @param app_ptr
+ *
+ * @return Pointer to a static string.
+ */
+const char *wlmaker_app_category(const wlmaker_app_t *app_ptr);
+
+/** Titles of all menu categories, in menu order. NULL-terminated. */
+extern const char *wlmaker_app_categories[];
+
+/** Unit test cases. */
+extern const bs_test_case_t wlmaker_app_index_test_cases[];
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif /* __APP_INDEX_H__ */
+/* == End of app_index.h =================================================== */
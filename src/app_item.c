@@ -0,0 +1,179 @@
+/* ========================================================================= */
+/**
+ * @file app_item.c
+ *
+ * @copyright
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "app_item.h"
+
+#include <inttypes.h>
+
+#include "subprocess_spawn.h"
+
+/* == Declarations ========================================================= */
+
+/** State of a menu item that launches an application. */
+struct _wlmaker_app_item_t {
+    /** Superclass: a menu item. */
+    wlmtk_menu_item_t         super_menu_item;
+
+    /** Command line to start when clicked. */
+    char                      *cmdline_ptr;
+    /** Back-link to @ref wlmaker_server_t, for the subprocess monitor. */
+    wlmaker_server_t          *server_ptr;
+};
+
+static void _wlmaker_app_item_element_destroy(
+    wlmtk_element_t *element_ptr);
+static void _wlmaker_app_item_clicked(
+    wlmtk_menu_item_t *menu_item_ptr);
+
+/* == Data ================================================================= */
+
+/** Virtual method table for the application-launching menu item. */
+static const wlmtk_menu_item_vmt_t _wlmaker_app_item_vmt = {
+    .clicked = _wlmaker_app_item_clicked
+};
+/** Virtual method table for the menu item's element superclass. */
+static const wlmtk_element_vmt_t _wlmaker_app_item_element_vmt = {
+    .destroy = _wlmaker_app_item_element_destroy
+};
+
+/* == Exported methods ===================================================== */
+
+/* ------------------------------------------------------------------------- */
+wlmaker_app_item_t *wlmaker_app_item_create(
+    const char *text_ptr,
+    const wlmtk_menu_item_style_t *style_ptr,
+    const char *cmdline_ptr,
+    wlmaker_server_t *server_ptr,
+    wlmtk_env_t *env_ptr)
+{
+    wlmaker_app_item_t *app_item_ptr = logged_calloc(
+        1, sizeof(wlmaker_app_item_t));
+    if (NULL == app_item_ptr) return NULL;
+    app_item_ptr->server_ptr = server_ptr;
+    app_item_ptr->cmdline_ptr = logged_strdup(cmdline_ptr);
+    if (NULL == app_item_ptr->cmdline_ptr) {
+        wlmaker_app_item_destroy(app_item_ptr);
+        return NULL;
+    }
+
+    if (!wlmtk_menu_item_init(
+            &app_item_ptr->super_menu_item,
+            style_ptr,
+            env_ptr)) {
+        wlmaker_app_item_destroy(app_item_ptr);
+        return NULL;
+    }
+    wlmtk_menu_item_extend(
+        &app_item_ptr->super_menu_item,
+        &_wlmaker_app_item_vmt);
+    wlmtk_element_extend(
+        wlmtk_menu_item_element(&app_item_ptr->super_menu_item),
+        &_wlmaker_app_item_element_vmt);
+
+    if (!wlmtk_menu_item_set_text(
+            &app_item_ptr->super_menu_item,
+            text_ptr)) {
+        wlmaker_app_item_destroy(app_item_ptr);
+        return NULL;
+    }
+
+    return app_item_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmaker_app_item_destroy(wlmaker_app_item_t *app_item_ptr)
+{
+    wlmtk_menu_item_fini(&app_item_ptr->super_menu_item);
+    if (NULL != app_item_ptr->cmdline_ptr) {
+        free(app_item_ptr->cmdline_ptr);
+        app_item_ptr->cmdline_ptr = NULL;
+    }
+    free(app_item_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+wlmtk_menu_item_t *wlmaker_app_item_menu_item(
+    wlmaker_app_item_t *app_item_ptr)
+{
+    return &app_item_ptr->super_menu_item;
+}
+
+/* == Local (static) methods =============================================== */
+
+/* ------------------------------------------------------------------------- */
+/** Implements @ref wlmtk_element_vmt_t::destroy. Routes to instance's dtor. */
+void _wlmaker_app_item_element_destroy(
+    wlmtk_element_t *element_ptr)
+{
+    wlmaker_app_item_t *app_item_ptr = BS_CONTAINER_OF(
+        element_ptr, wlmaker_app_item_t,
+        super_menu_item.super_buffer.super_element);
+    wlmaker_app_item_destroy(app_item_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Implements @ref wlmtk_menu_item_vmt_t::clicked. Starts the application.
+ *
+ * The subprocess is handed to the monitor, for logging its output and
+ * reaping it. It is not tracked any further.
+ */
+void _wlmaker_app_item_clicked(wlmtk_menu_item_t *menu_item_ptr)
+{
+    wlmaker_app_item_t *app_item_ptr = BS_CONTAINER_OF(
+        menu_item_ptr, wlmaker_app_item_t, super_menu_item);
+    wlmaker_server_t *server_ptr = app_item_ptr->server_ptr;
+
+    int stdout_read_fd, stderr_read_fd;
+    pid_t pid = wlmaker_subprocess_spawn(
+        app_item_ptr->cmdline_ptr,
+        WLMAKER_SUBPROCESS_OUTPUT_LOG,
+        NULL,
+        &stdout_read_fd,
+        &stderr_read_fd);
+    if (0 > pid) {
+        bs_log(BS_ERROR, "Failed wlmaker_subprocess_spawn(\"%s\", ...)",
+               app_item_ptr->cmdline_ptr);
+    } else {
+        wlmaker_subprocess_handle_t *subprocess_handle_ptr =
+            wlmaker_subprocess_monitor_entrust_pid(
+                server_ptr->monitor_ptr,
+                pid,
+                stdout_read_fd,
+                stderr_read_fd,
+                NULL, NULL, NULL, NULL, NULL, NULL);
+        if (NULL == subprocess_handle_ptr) {
+            bs_log(BS_ERROR, "Failed to monitor PID %"PRIdMAX" of \"%s\"",
+                   (intmax_t)pid, app_item_ptr->cmdline_ptr);
+            wlmaker_subprocess_abandon(pid, stdout_read_fd, stderr_read_fd);
+        } else {
+            wlmaker_subprocess_monitor_cede(
+                server_ptr->monitor_ptr,
+                subprocess_handle_ptr);
+        }
+    }
+
+    // Note: Destroys this item, too.
+    if (NULL != server_ptr->root_menu_ptr) {
+        wlmaker_root_menu_destroy(server_ptr->root_menu_ptr);
+    }
+}
+
+/* == End of app_item.c ==================================================== */
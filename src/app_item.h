@@ -0,0 +1,70 @@
+/* ========================================================================= */
+/**
+ * @file app_item.h
+ *
+ * @copyright
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __WLMAKER_APP_ITEM_H__
+#define __WLMAKER_APP_ITEM_H__
+
+/** Forward declaration: A menu item that launches an application. */
+typedef struct _wlmaker_app_item_t wlmaker_app_item_t;
+
+#include "toolkit/toolkit.h"
+
+#include "server.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+/**
+ * Creates a menu item that launches an application. When clicked, the
+ * command line is started, and the root menu is closed.
+ *
+ * @param text_ptr
+ * @param style_ptr
+ * @param cmdline_ptr         Command line, as for
+ *                            @ref wlmaker_subprocess_spawn. Will be copied.
+ * @param server_ptr
+ * @param env_ptr
+ *
+ * @return Pointer to the menu item's handle or NULL on error.
+ */
+wlmaker_app_item_t *wlmaker_app_item_create(
+    const char *text_ptr,
+    const wlmtk_menu_item_style_t *style_ptr,
+    const char *cmdline_ptr,
+    wlmaker_server_t *server_ptr,
+    wlmtk_env_t *env_ptr);
+
+/**
+ * Destroys the application-launching menu item.
+ *
+ * @param app_item_ptr
+ */
+void wlmaker_app_item_destroy(wlmaker_app_item_t *app_item_ptr);
+
+/** @returns pointer to the superclass @ref wlmtk_menu_item_t. */
+wlmtk_menu_item_t *wlmaker_app_item_menu_item(
+    wlmaker_app_item_t *app_item_ptr);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif /* __WLMAKER_APP_ITEM_H__ */
+/* == End of app_item.h ==================================================== */
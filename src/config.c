@@ -156,6 +156,9 @@ static const wlmcfg_desc_t _wlmaker_config_window_titlebar_style_desc[] = {
     WLMCFG_DESC_DICT(
         "Font", true, wlmtk_titlebar_style_t, font,
         _wlmaker_config_font_style_desc),
+    WLMCFG_DESC_UINT64(
+        "InactiveReleaseDelay", false, wlmtk_titlebar_style_t,
+        inactive_release_delay, 5000),
     WLMCFG_DESC_SENTINEL()
  };
 
@@ -230,6 +233,8 @@ static const wlmcfg_desc_t _wlmaker_config_menu_style_desc[] = {
     WLMCFG_DESC_DICT(
         "Border", true, wlmtk_menu_style_t, border,
         _wlmaker_config_margin_style_desc),
+    WLMCFG_DESC_UINT64(
+        "ReleaseDelay", false, wlmtk_menu_style_t, release_delay, 5000),
     WLMCFG_DESC_SENTINEL()
 };
 
@@ -37,8 +37,15 @@ struct _wlmaker_dock_t {
     /** Back-link to server. */
     wlmaker_server_t          *server_ptr;
 
+    /** Launchers on this dock. Owned by their tiles on `wlmtk_dock_ptr`. */
+    wlmaker_launcher_t        **launchers_ptr;
+    /** Number of launchers in `launchers_ptr`. */
+    size_t                    launchers;
+
     /** Listener for @ref wlmtk_root_events_t::workspace_changed. */
     struct wl_listener        workspace_changed_listener;
+    /** Listener for @ref wlmaker_server_t::launcher_stats_event. */
+    struct wl_listener        launcher_stats_listener;
 };
 
 static bool _wlmaker_dock_decode_launchers(
@@ -48,6 +55,9 @@ static bool _wlmaker_dock_decode_launchers(
 static void _wlmaker_dock_handle_workspace_changed(
     struct wl_listener *listener_ptr,
     void *data_ptr);
+static void _wlmaker_dock_handle_launcher_stats(
+    struct wl_listener *listener_ptr,
+    void *data_ptr);
 
 /* == Data ================================================================= */
 
@@ -118,6 +128,13 @@ wlmaker_dock_t *wlmaker_dock_create(
         layer_ptr,
         wlmtk_dock_panel(dock_ptr->wlmtk_dock_ptr));
 
+    dock_ptr->launchers_ptr = logged_calloc(
+        BS_MAX(wlmcfg_array_size(args.launchers_array_ptr), 1),
+        sizeof(wlmaker_launcher_t*));
+    if (NULL == dock_ptr->launchers_ptr) {
+        wlmaker_dock_destroy(dock_ptr);
+        return NULL;
+    }
     for (size_t i = 0;
          i < wlmcfg_array_size(args.launchers_array_ptr);
          ++i) {
@@ -138,6 +155,7 @@ wlmaker_dock_t *wlmaker_dock_create(
         wlmtk_dock_add_tile(
             dock_ptr->wlmtk_dock_ptr,
             wlmaker_launcher_tile(launcher_ptr));
+        dock_ptr->launchers_ptr[dock_ptr->launchers++] = launcher_ptr;
     }
     // FIXME: This is leaky.
     if (NULL != args.launchers_array_ptr) {
@@ -149,6 +167,10 @@ wlmaker_dock_t *wlmaker_dock_create(
         &wlmtk_root_events(server_ptr->root_ptr)->workspace_changed,
         &dock_ptr->workspace_changed_listener,
         _wlmaker_dock_handle_workspace_changed);
+    wlmtk_util_connect_listener_signal(
+        &server_ptr->launcher_stats_event,
+        &dock_ptr->launcher_stats_listener,
+        _wlmaker_dock_handle_launcher_stats);
 
     bs_log(BS_INFO, "Created dock %p", dock_ptr);
     return dock_ptr;
@@ -157,6 +179,7 @@ wlmaker_dock_t *wlmaker_dock_create(
 /* ------------------------------------------------------------------------- */
 void wlmaker_dock_destroy(wlmaker_dock_t *dock_ptr)
 {
+    wlmtk_util_disconnect_listener(&dock_ptr->launcher_stats_listener);
     wlmtk_util_disconnect_listener(&dock_ptr->workspace_changed_listener);
 
     if (NULL != dock_ptr->wlmtk_dock_ptr) {
@@ -168,6 +191,12 @@ void wlmaker_dock_destroy(wlmaker_dock_t *dock_ptr)
         dock_ptr->wlmtk_dock_ptr = NULL;
     }
 
+    // The launchers were destroyed along with their tiles.
+    if (NULL != dock_ptr->launchers_ptr) {
+        free(dock_ptr->launchers_ptr);
+        dock_ptr->launchers_ptr = NULL;
+    }
+
     free(dock_ptr);
 }
 
@@ -212,6 +241,19 @@ void _wlmaker_dock_handle_workspace_changed(
     wlmtk_layer_add_panel(new_layer_ptr, panel_ptr);
 }
 
+/* ------------------------------------------------------------------------- */
+/** Logs the click-to-map latency statistics of each launcher on the dock. */
+void _wlmaker_dock_handle_launcher_stats(
+    struct wl_listener *listener_ptr,
+    __UNUSED__ void *data_ptr)
+{
+    wlmaker_dock_t *dock_ptr = BS_CONTAINER_OF(
+        listener_ptr, wlmaker_dock_t, launcher_stats_listener);
+    for (size_t i = 0; i < dock_ptr->launchers; ++i) {
+        wlmaker_launcher_log_stats(dock_ptr->launchers_ptr[i]);
+    }
+}
+
 /* == Unit tests =========================================================== */
 
 static void test_create_destroy(bs_test_t *test_ptr);
@@ -235,6 +277,7 @@ void test_create_destroy(bs_test_t *test_ptr)
     wlmtk_root_add_workspace(root_ptr, ws_ptr);
 
     wlmaker_server_t server = { .root_ptr = root_ptr };
+    wl_signal_init(&server.launcher_stats_event);
     wlmaker_config_style_t style = {};
 
     wlmcfg_dict_t *dict_ptr = wlmcfg_dict_from_object(
@@ -244,7 +287,9 @@ void test_create_destroy(bs_test_t *test_ptr)
     BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, dict_ptr);
 
     wlmaker_dock_t *dock_ptr = wlmaker_dock_create(&server, dict_ptr, &style);
-    BS_TEST_VERIFY_NEQ(test_ptr, NULL, dock_ptr);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, dock_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 3, dock_ptr->launchers);
+    wl_signal_emit(&server.launcher_stats_event, NULL);
 
     wlmaker_dock_destroy(dock_ptr);
     wlmcfg_dict_unref(dict_ptr);
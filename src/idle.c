@@ -18,8 +18,13 @@
  * limitations under the License.
  */
 
+/// clock_gettime(2) is a POSIX extension, needs this macro.
+#define _POSIX_C_SOURCE 199309L
+
 #include "idle.h"
 
+#include <time.h>
+
 #include "config.h"
 
 #define WLR_USE_UNSTABLE
@@ -45,6 +50,12 @@ struct _wlmaker_idle_monitor_t {
     struct wl_event_source    *timer_event_source_ptr;
     /** Whether the timer expired. Reset in @ref wlmaker_idle_monitor_reset. */
     bool                      timer_expired;
+    /** Whether the timer is armed. It is not re-armed on each activity. */
+    bool                      timer_armed;
+    /** Idle timeout, decoded from 'IdleSeconds' at creation. 0 to disable. */
+    int                       idle_msec;
+    /** Monotonic time of the most recent activity, in milliseconds. */
+    uint64_t                  last_activity_msec;
 
     /** Listener for `new_inhibitor` of wlr_idle_inhibit_manager_v1`. */
     struct wl_listener        new_inhibitor_listener;
@@ -83,6 +94,10 @@ struct _wlmaker_idle_inhibitor_t {
 static void _wlmaker_idle_monitor_consider_locking(
     wlmaker_idle_monitor_t *idle_monitor_ptr);
 static int _wlmaker_idle_monitor_timer(void *data_ptr);
+static void _wlmaker_idle_monitor_arm(
+    wlmaker_idle_monitor_t *idle_monitor_ptr,
+    int msec);
+static uint64_t _wlmaker_idle_now_msec(void);
 
 static int _wlmaker_idle_msec(wlmaker_idle_monitor_t *idle_monitor_ptr);
 static bool _wlmaker_idle_monitor_add_inhibitor(
@@ -118,6 +133,7 @@ wlmaker_idle_monitor_t *wlmaker_idle_monitor_create(
         wlmaker_idle_monitor_destroy(monitor_ptr);
         return NULL;
     }
+    monitor_ptr->idle_msec = _wlmaker_idle_msec(monitor_ptr);
 
     monitor_ptr->wlr_idle_inhibit_manager_v1_ptr =
         wlr_idle_inhibit_v1_create(server_ptr->wl_display_ptr);
@@ -147,12 +163,14 @@ wlmaker_idle_monitor_t *wlmaker_idle_monitor_create(
 
     if (0 != wl_event_source_timer_update(
             monitor_ptr->timer_event_source_ptr,
-            _wlmaker_idle_msec(monitor_ptr))) {
-        bs_log(BS_ERROR, "Failed wl_event_source_timer_update(%p, 1000)",
-               monitor_ptr->timer_event_source_ptr);
+            monitor_ptr->idle_msec)) {
+        bs_log(BS_ERROR, "Failed wl_event_source_timer_update(%p, %d)",
+               monitor_ptr->timer_event_source_ptr, monitor_ptr->idle_msec);
         wlmaker_idle_monitor_destroy(monitor_ptr);
         return NULL;
     }
+    monitor_ptr->timer_armed = 0 < monitor_ptr->idle_msec;
+    monitor_ptr->last_activity_msec = _wlmaker_idle_now_msec();
 
     return monitor_ptr;
 }
@@ -184,11 +202,14 @@ void wlmaker_idle_monitor_reset(wlmaker_idle_monitor_t *idle_monitor_ptr)
 {
     if (idle_monitor_ptr->locked) return;
 
-    int rv = wl_event_source_timer_update(
-        idle_monitor_ptr->timer_event_source_ptr,
-        _wlmaker_idle_msec(idle_monitor_ptr));
-    BS_ASSERT(0 == rv);
+    // Called for every input event: Just record the time. An armed timer
+    // will account for it when it fires, see _wlmaker_idle_monitor_timer.
+    idle_monitor_ptr->last_activity_msec = _wlmaker_idle_now_msec();
     idle_monitor_ptr->timer_expired = false;
+    if (!idle_monitor_ptr->timer_armed) {
+        _wlmaker_idle_monitor_arm(
+            idle_monitor_ptr, idle_monitor_ptr->idle_msec);
+    }
 }
 
 /* ------------------------------------------------------------------------- */
@@ -272,6 +293,9 @@ void _wlmaker_idle_monitor_consider_locking(
 /**
  * Timer function for the wayland event loop.
  *
+ * If there was activity since the timer was armed, re-arms it for the
+ * remainder of the idle timeout. Otherwise, the timer has expired.
+ *
  * @param data_ptr            Untyped pointer to @ref wlmaker_idle_monitor_t.
  *
  * @return Whether the event source is registered for re-check with
@@ -281,16 +305,55 @@ void _wlmaker_idle_monitor_consider_locking(
 int _wlmaker_idle_monitor_timer(void *data_ptr)
 {
     wlmaker_idle_monitor_t *idle_monitor_ptr = data_ptr;
+    idle_monitor_ptr->timer_armed = false;
+
+    uint64_t idle_msec = _wlmaker_idle_now_msec() -
+        idle_monitor_ptr->last_activity_msec;
+    if (idle_msec < (uint64_t)idle_monitor_ptr->idle_msec) {
+        _wlmaker_idle_monitor_arm(
+            idle_monitor_ptr, idle_monitor_ptr->idle_msec - idle_msec);
+        return 0;
+    }
 
     idle_monitor_ptr->timer_expired = true;
     _wlmaker_idle_monitor_consider_locking(idle_monitor_ptr);
     return 0;
 }
 
+/* ------------------------------------------------------------------------- */
+/**
+ * Arms the timer to fire in `msec`. Does nothing if `msec` is 0.
+ *
+ * @param idle_monitor_ptr
+ * @param msec
+ */
+void _wlmaker_idle_monitor_arm(
+    wlmaker_idle_monitor_t *idle_monitor_ptr,
+    int msec)
+{
+    if (0 >= msec) return;
+    int rv = wl_event_source_timer_update(
+        idle_monitor_ptr->timer_event_source_ptr, msec);
+    BS_ASSERT(0 == rv);
+    idle_monitor_ptr->timer_armed = true;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Returns the monotonic time, in milliseconds. */
+uint64_t _wlmaker_idle_now_msec(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000 + now.tv_nsec / 1000000;
+}
+
 /* ------------------------------------------------------------------------- */
 /**
  * Returns the idle timeout time in milliseconds.
  *
+ * Reads and parses the config dictionnary, so is called just once, from
+ * @ref wlmaker_idle_monitor_create.
+ *
  * @param idle_monitor_ptr
  *
  * @return The idle timeout, read from the config dictionnary. If no or a
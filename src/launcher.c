@@ -21,14 +21,34 @@
 #include "launcher.h"
 
 #include <limits.h>
+#include <string.h>
+#include <time.h>
 #include <libbase/libbase.h>
 #include "toolkit/toolkit.h"
 
 #include "conf/decode.h"
 #include "conf/plist.h"
+#include "subprocess_spawn.h"
 
 /* == Declarations ========================================================= */
 
+/** Number of most recent launches kept for the latency histogram. */
+#define WLMAKER_LAUNCHER_LATENCY_SAMPLES 32
+
+/** Timestamps of a launch, in microseconds of CLOCK_MONOTONIC. Or 0. */
+typedef struct {
+    /** Element of @ref wlmaker_launcher_t::launches. */
+    bs_dllist_node_t          dlnode;
+    /** The launched subprocess. */
+    wlmaker_subprocess_handle_t *subprocess_handle_ptr;
+    /** When the launcher was clicked. */
+    uint64_t                  click_usec;
+    /** When the subprocess was spawned. */
+    uint64_t                  spawn_usec;
+    /** When the first window was created. */
+    uint64_t                  created_usec;
+} wlmaker_launcher_launch_t;
+
 /** State of a launcher. */
 struct _wlmaker_launcher_t {
     /** The launcher is derived from a @ref wlmtk_tile_t. */
@@ -48,6 +68,12 @@ struct _wlmaker_launcher_t {
     char                      *cmdline_ptr;
     /** Path to the icon. */
     char                      *icon_path_ptr;
+    /** Where output of the launched application is routed to. */
+    wlmaker_subprocess_output_t output;
+    /** File to append output to, for @ref WLMAKER_SUBPROCESS_OUTPUT_FILE. */
+    char                      *output_file_ptr;
+    /** Whether windows of processes forked by the application map here. */
+    bool                      match_descendants;
 
     /** Windows that are running from subprocesses of this App (launcher). */
     bs_ptr_set_t              *created_windows_ptr;
@@ -55,6 +81,24 @@ struct _wlmaker_launcher_t {
     bs_ptr_set_t              *mapped_windows_ptr;
     /** Subprocesses that were created by this launcher. */
     bs_ptr_set_t              *subprocesses_ptr;
+
+    /** Whether to show the latency of the latest launch on the tile. */
+    bool                      debug_overlay;
+    /** Launches without mapped window. @ref wlmaker_launcher_launch_t. */
+    bs_dllist_t               launches;
+    /** Click-to-map latencies of the most recent launches, in msec. */
+    uint32_t                  latency_samples[WLMAKER_LAUNCHER_LATENCY_SAMPLES];
+    /** Launches that mapped a window. Indexes `latency_samples`. */
+    unsigned                  mapped_launches;
+};
+
+/** Enum descriptor for @ref wlmaker_subprocess_output_t. */
+static const wlmcfg_enum_desc_t _wlmaker_launcher_outputs[] = {
+    WLMCFG_ENUM("Log", WLMAKER_SUBPROCESS_OUTPUT_LOG),
+    WLMCFG_ENUM("Discard", WLMAKER_SUBPROCESS_OUTPUT_DISCARD),
+    WLMCFG_ENUM("File", WLMAKER_SUBPROCESS_OUTPUT_FILE),
+    WLMCFG_ENUM("Buffer", WLMAKER_SUBPROCESS_OUTPUT_BUFFER),
+    WLMCFG_ENUM_SENTINEL(),
 };
 
 /** Plist descroptor for a launcher. */
@@ -63,6 +107,16 @@ static const wlmcfg_desc_t _wlmaker_launcher_plist_desc[] = {
         "CommandLine", true, wlmaker_launcher_t, cmdline_ptr, ""),
     WLMCFG_DESC_STRING(
         "Icon", true, wlmaker_launcher_t, icon_path_ptr, ""),
+    WLMCFG_DESC_ENUM(
+        "Output", false, wlmaker_launcher_t, output,
+        WLMAKER_SUBPROCESS_OUTPUT_LOG, _wlmaker_launcher_outputs),
+    WLMCFG_DESC_STRING(
+        "OutputFile", false, wlmaker_launcher_t, output_file_ptr, ""),
+    WLMCFG_DESC_BOOL(
+        "MatchDescendants", false, wlmaker_launcher_t, match_descendants,
+        false),
+    WLMCFG_DESC_BOOL(
+        "DebugOverlay", false, wlmaker_launcher_t, debug_overlay, false),
     WLMCFG_DESC_SENTINEL(),
 };
 
@@ -90,6 +144,14 @@ static bool _wlmaker_launcher_pointer_button(
     const wlmtk_button_event_t *button_event_ptr);
 
 static void _wlmaker_launcher_start(wlmaker_launcher_t *launcher_ptr);
+static wlmaker_launcher_launch_t *_wlmaker_launcher_find_launch(
+    wlmaker_launcher_t *launcher_ptr,
+    wlmaker_subprocess_handle_t *subprocess_handle_ptr);
+static void _wlmaker_launcher_end_launch(
+    wlmaker_launcher_t *launcher_ptr,
+    wlmaker_launcher_launch_t *launch_ptr,
+    uint64_t mapped_usec);
+static uint64_t _wlmaker_launcher_now_usec(void);
 
 static void _wlmaker_launcher_handle_terminated(
     void *userdata_ptr,
@@ -177,12 +239,28 @@ wlmaker_launcher_t *wlmaker_launcher_create_from_plist(
         wlmaker_launcher_destroy(launcher_ptr);
         return NULL;
     }
+    if (WLMAKER_SUBPROCESS_OUTPUT_FILE == launcher_ptr->output &&
+        0 == strlen(launcher_ptr->output_file_ptr)) {
+        bs_log(BS_ERROR, "Launcher for '%s': Output is File, but OutputFile "
+               "is not set.", launcher_ptr->cmdline_ptr);
+        wlmaker_launcher_destroy(launcher_ptr);
+        return NULL;
+    }
 
-    // Resolves to a full path, and verifies the icon file exists.
+    // Resolves to a full path, and verifies the icon file exists. Falls back
+    // to looking up a freedesktop icon name in the icon theme.
     char full_path[PATH_MAX];
     char *path_ptr = bs_file_resolve_and_lookup_from_paths(
         BS_ASSERT_NOTNULL(launcher_ptr->icon_path_ptr),
         lookup_paths, 0, full_path);
+    if (NULL == path_ptr) {
+        path_ptr = wlmtk_icon_theme_lookup(
+            wlmtk_env_icon_theme(env_ptr),
+            launcher_ptr->icon_path_ptr,
+            launcher_ptr->super_tile.style.content_size,
+            1,
+            full_path);
+    }
     if (NULL == path_ptr) {
         bs_log(BS_ERROR | BS_ERRNO,
                "Failed bs_file_resolve_and_lookup_from_paths(\"%s\" ...)",
@@ -190,7 +268,7 @@ wlmaker_launcher_t *wlmaker_launcher_create_from_plist(
         wlmaker_launcher_destroy(launcher_ptr);
         return NULL;
     }
-    launcher_ptr->image_ptr = wlmtk_image_create_scaled(
+    launcher_ptr->image_ptr = wlmtk_image_create_async(
         path_ptr,
         launcher_ptr->super_tile.style.content_size,
         launcher_ptr->super_tile.style.content_size,
@@ -220,6 +298,15 @@ void wlmaker_launcher_destroy(wlmaker_launcher_t *launcher_ptr)
     wlmtk_tile_set_overlay(&launcher_ptr->super_tile, NULL);
     wlmtk_buffer_fini(&launcher_ptr->overlay_buffer);
 
+    if (0 < launcher_ptr->mapped_launches) {
+        wlmaker_launcher_log_stats(launcher_ptr);
+    }
+    bs_dllist_node_t *dlnode_ptr;
+    while (NULL != (dlnode_ptr = bs_dllist_pop_front(
+                        &launcher_ptr->launches))) {
+        free(BS_CONTAINER_OF(dlnode_ptr, wlmaker_launcher_launch_t, dlnode));
+    }
+
     if (NULL != launcher_ptr->subprocesses_ptr) {
         wlmaker_subprocess_handle_t *subprocess_handle_ptr;
         while (NULL != (subprocess_handle_ptr = bs_ptr_set_any(
@@ -253,10 +340,62 @@ void wlmaker_launcher_destroy(wlmaker_launcher_t *launcher_ptr)
         launcher_ptr->icon_path_ptr = NULL;
     }
 
+    if (NULL != launcher_ptr->output_file_ptr) {
+        free(launcher_ptr->output_file_ptr);
+        launcher_ptr->output_file_ptr = NULL;
+    }
+
     wlmtk_tile_fini(&launcher_ptr->super_tile);
     free(launcher_ptr);
 }
 
+/* ------------------------------------------------------------------------- */
+void wlmaker_launcher_get_stats(
+    wlmaker_launcher_t *launcher_ptr,
+    wlmaker_launcher_stats_t *stats_ptr)
+{
+    memset(stats_ptr, 0, sizeof(wlmaker_launcher_stats_t));
+    stats_ptr->launches = launcher_ptr->mapped_launches;
+    if (0 == launcher_ptr->mapped_launches) return;
+
+    stats_ptr->latest_msec = launcher_ptr->latency_samples[
+        (launcher_ptr->mapped_launches - 1) %
+        WLMAKER_LAUNCHER_LATENCY_SAMPLES];
+    unsigned samples = BS_MIN(launcher_ptr->mapped_launches,
+                              WLMAKER_LAUNCHER_LATENCY_SAMPLES);
+    for (unsigned i = 0; i < samples; ++i) {
+        uint32_t msec = launcher_ptr->latency_samples[i];
+        unsigned bucket = 0;
+        while (bucket < WLMAKER_LAUNCHER_LATENCY_BUCKETS - 1 &&
+               (UINT32_C(1) << bucket) <= msec) ++bucket;
+        stats_ptr->histogram[bucket]++;
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmaker_launcher_log_stats(wlmaker_launcher_t *launcher_ptr)
+{
+    wlmaker_launcher_stats_t stats;
+    wlmaker_launcher_get_stats(launcher_ptr, &stats);
+
+    char buf[256] = { 0 };
+    size_t pos = 0;
+    for (unsigned i = 0; i < WLMAKER_LAUNCHER_LATENCY_BUCKETS; ++i) {
+        if (0 == stats.histogram[i]) continue;
+        // The last bucket is open-ended: Label it by its lower bound.
+        bool last = i == WLMAKER_LAUNCHER_LATENCY_BUCKETS - 1;
+        int rv = snprintf(buf + pos, sizeof(buf) - pos, " %s%"PRIu32"ms: %u",
+                          last ? ">=" : "<",
+                          UINT32_C(1) << (last ? i - 1 : i),
+                          stats.histogram[i]);
+        if (0 > rv || (size_t)rv >= sizeof(buf) - pos) break;
+        pos += rv;
+    }
+    bs_log(BS_INFO, "App '%s' (%p): %u launches, latest %"PRIu32" ms.%s",
+           launcher_ptr->cmdline_ptr, launcher_ptr,
+           stats.launches, stats.latest_msec, buf);
+}
+
 /* ------------------------------------------------------------------------- */
 wlmtk_tile_t *wlmaker_launcher_tile(wlmaker_launcher_t *launcher_ptr)
 {
@@ -291,7 +430,9 @@ struct wlr_buffer *_wlmaker_launcher_create_overlay_buffer(
     } else if (!bs_ptr_set_empty(launcher_ptr->created_windows_ptr)) {
         status_ptr = "Started";
     }
-    if (NULL == status_ptr) return wlr_buffer_ptr;
+    bool show_latency = (launcher_ptr->debug_overlay &&
+                         0 < launcher_ptr->mapped_launches);
+    if (NULL == status_ptr && !show_latency) return wlr_buffer_ptr;
 
     cairo_t *cairo_ptr = cairo_create_from_wlr_buffer(wlr_buffer_ptr);
     if (NULL == cairo_ptr) {
@@ -299,6 +440,24 @@ struct wlr_buffer *_wlmaker_launcher_create_overlay_buffer(
         return NULL;
     }
 
+    cairo_select_font_face(cairo_ptr, "Helvetica",
+                           CAIRO_FONT_SLANT_NORMAL,
+                           CAIRO_FONT_WEIGHT_NORMAL);
+    cairo_set_font_size(cairo_ptr, 10.0 * s / 64.0);
+    if (show_latency) {
+        wlmaker_launcher_stats_t stats;
+        wlmaker_launcher_get_stats(launcher_ptr, &stats);
+        char latency[32];
+        snprintf(latency, sizeof(latency), "%"PRIu32" ms", stats.latest_msec);
+        cairo_set_source_argb8888(cairo_ptr, 0xffc0c0c0);
+        cairo_move_to(cairo_ptr, 4 * s / 64, 10 * s / 64);
+        cairo_show_text(cairo_ptr, latency);
+    }
+    if (NULL == status_ptr) {
+        cairo_destroy(cairo_ptr);
+        return wlr_buffer_ptr;
+    }
+
     float r, g, b, alpha;
     bs_gfxbuf_argb8888_to_floats(0xff12905a, &r, &g, &b, &alpha);
     cairo_pattern_t *cairo_pattern_ptr = cairo_pattern_create_rgba(
@@ -309,10 +468,6 @@ struct wlr_buffer *_wlmaker_launcher_create_overlay_buffer(
     cairo_fill(cairo_ptr);
     cairo_stroke(cairo_ptr);
 
-    cairo_select_font_face(cairo_ptr, "Helvetica",
-                           CAIRO_FONT_SLANT_NORMAL,
-                           CAIRO_FONT_WEIGHT_NORMAL);
-    cairo_set_font_size(cairo_ptr, 10.0 * s / 64.0);
     cairo_set_source_argb8888(cairo_ptr, 0xffffffff);
     cairo_move_to(cairo_ptr, 4 * s / 64, s - 2 * s / 64);
     cairo_show_text(cairo_ptr, status_ptr);
@@ -369,31 +524,58 @@ bool _wlmaker_launcher_pointer_button(
  */
 void _wlmaker_launcher_start(wlmaker_launcher_t *launcher_ptr)
 {
-    bs_subprocess_t *subprocess_ptr = bs_subprocess_create_cmdline(
-        launcher_ptr->cmdline_ptr);
-    if (NULL == subprocess_ptr) {
-        bs_log(BS_ERROR, "Failed bs_subprocess_create_cmdline(%s)",
-               launcher_ptr->cmdline_ptr);
-        return;
-    }
-
-    if (!bs_subprocess_start(subprocess_ptr)) {
-        bs_log(BS_ERROR, "Failed bs_subprocess_start for %s",
+    wlmaker_launcher_launch_t *launch_ptr = logged_calloc(
+        1, sizeof(wlmaker_launcher_launch_t));
+    if (NULL == launch_ptr) return;
+    launch_ptr->click_usec = _wlmaker_launcher_now_usec();
+
+    // Discarding or writing to a file is set up at spawn time. Only what the
+    // monitor needs to read will be connected to pipes.
+    int stdout_read_fd, stderr_read_fd;
+    pid_t pid = wlmaker_subprocess_spawn(
+        launcher_ptr->cmdline_ptr,
+        launcher_ptr->output,
+        launcher_ptr->output_file_ptr,
+        &stdout_read_fd,
+        &stderr_read_fd);
+    if (0 > pid) {
+        bs_log(BS_ERROR, "Failed wlmaker_subprocess_spawn(\"%s\", ...)",
                launcher_ptr->cmdline_ptr);
-        bs_subprocess_destroy(subprocess_ptr);
+        free(launch_ptr);
         return;
     }
+    launch_ptr->spawn_usec = _wlmaker_launcher_now_usec();
 
     wlmaker_subprocess_handle_t *subprocess_handle_ptr;
-    subprocess_handle_ptr = wlmaker_subprocess_monitor_entrust(
+    subprocess_handle_ptr = wlmaker_subprocess_monitor_entrust_pid(
         launcher_ptr->monitor_ptr,
-        subprocess_ptr,
+        pid,
+        stdout_read_fd,
+        stderr_read_fd,
         _wlmaker_launcher_handle_terminated,
         launcher_ptr,
         _wlmaker_launcher_handle_window_created,
         _wlmaker_launcher_handle_window_mapped,
         _wlmaker_launcher_handle_window_unmapped,
         _wlmaker_launcher_handle_window_destroyed);
+    if (NULL == subprocess_handle_ptr) {
+        bs_log(BS_ERROR, "Launcher %p: Failed to monitor PID %"PRIdMAX,
+               launcher_ptr, (intmax_t)pid);
+        wlmaker_subprocess_abandon(pid, stdout_read_fd, stderr_read_fd);
+        free(launch_ptr);
+        return;
+    }
+    launch_ptr->subprocess_handle_ptr = subprocess_handle_ptr;
+    bs_dllist_push_back(&launcher_ptr->launches, &launch_ptr->dlnode);
+    wlmaker_subprocess_set_match_descendants(
+        subprocess_handle_ptr, launcher_ptr->match_descendants);
+
+    if (WLMAKER_SUBPROCESS_OUTPUT_BUFFER == launcher_ptr->output &&
+        !wlmaker_subprocess_set_output(
+            subprocess_handle_ptr, WLMAKER_SUBPROCESS_OUTPUT_BUFFER, NULL)) {
+        bs_log(BS_WARNING, "Launcher %p: Failed to buffer output of '%s', "
+               "will log it instead.", launcher_ptr, launcher_ptr->cmdline_ptr);
+    }
 
     if (!bs_ptr_set_insert(launcher_ptr->subprocesses_ptr,
                            subprocess_handle_ptr)) {
@@ -407,6 +589,75 @@ void _wlmaker_launcher_start(wlmaker_launcher_t *launcher_ptr)
     }
 }
 
+/* ------------------------------------------------------------------------- */
+/**
+ * Finds the launch that is waiting for a window from the subprocess.
+ *
+ * @param launcher_ptr
+ * @param subprocess_handle_ptr
+ *
+ * @return Pointer to the @ref wlmaker_launcher_launch_t, or NULL.
+ */
+wlmaker_launcher_launch_t *_wlmaker_launcher_find_launch(
+    wlmaker_launcher_t *launcher_ptr,
+    wlmaker_subprocess_handle_t *subprocess_handle_ptr)
+{
+    for (bs_dllist_node_t *dlnode_ptr = launcher_ptr->launches.head_ptr;
+         NULL != dlnode_ptr;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        wlmaker_launcher_launch_t *launch_ptr = BS_CONTAINER_OF(
+            dlnode_ptr, wlmaker_launcher_launch_t, dlnode);
+        if (launch_ptr->subprocess_handle_ptr == subprocess_handle_ptr) {
+            return launch_ptr;
+        }
+    }
+    return NULL;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Ends tracking of the launch. Records the latency, if a window was mapped.
+ *
+ * @param launcher_ptr
+ * @param launch_ptr
+ * @param mapped_usec         When the first window was mapped, or 0 if the
+ *                            subprocess terminated before.
+ */
+void _wlmaker_launcher_end_launch(
+    wlmaker_launcher_t *launcher_ptr,
+    wlmaker_launcher_launch_t *launch_ptr,
+    uint64_t mapped_usec)
+{
+    bs_dllist_remove(&launcher_ptr->launches, &launch_ptr->dlnode);
+
+    if (0 < mapped_usec) {
+        uint32_t latency_msec = (mapped_usec - launch_ptr->click_usec) / 1000;
+        launcher_ptr->latency_samples[
+            launcher_ptr->mapped_launches %
+            WLMAKER_LAUNCHER_LATENCY_SAMPLES] = latency_msec;
+        launcher_ptr->mapped_launches++;
+
+        // Windows may get mapped without being reported as created first.
+        uint64_t created_usec = launch_ptr->created_usec;
+        if (0 == created_usec) created_usec = mapped_usec;
+        bs_log(BS_INFO, "App '%s' (%p) mapped after %"PRIu32" ms: spawned "
+               "after %"PRIu64" ms, window created after %"PRIu64" ms.",
+               launcher_ptr->cmdline_ptr, launcher_ptr, latency_msec,
+               (launch_ptr->spawn_usec - launch_ptr->click_usec) / 1000,
+               (created_usec - launch_ptr->click_usec) / 1000);
+    }
+    free(launch_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** @return Current time of CLOCK_MONOTONIC, in microseconds. */
+uint64_t _wlmaker_launcher_now_usec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
 /* ------------------------------------------------------------------------- */
 /**
  * Callback handler for when the registered subprocess terminates.
@@ -438,6 +689,18 @@ void _wlmaker_launcher_handle_terminated(
            launcher_ptr->cmdline_ptr,
            launcher_ptr,
            code);
+    if (WLMAKER_SUBPROCESS_OUTPUT_BUFFER == launcher_ptr->output &&
+        (0 != exit_status || 0 != signal_number)) {
+        char buf[1024];
+        wlmaker_subprocess_get_output(subprocess_handle_ptr, buf, sizeof(buf));
+        bs_log(BS_INFO, "App '%s' (%p) latest output:\n%s",
+               launcher_ptr->cmdline_ptr, launcher_ptr, buf);
+    }
+    wlmaker_launcher_launch_t *launch_ptr = _wlmaker_launcher_find_launch(
+        launcher_ptr, subprocess_handle_ptr);
+    if (NULL != launch_ptr) {
+        _wlmaker_launcher_end_launch(launcher_ptr, launch_ptr, 0);
+    }
     // TODO(kaeser@gubbe.ch): Keep exit status and latest output available
     // for visualization.
     wlmaker_subprocess_monitor_cede(
@@ -460,11 +723,17 @@ void _wlmaker_launcher_handle_terminated(
  */
 void _wlmaker_launcher_handle_window_created(
     void *userdata_ptr,
-    __UNUSED__ wlmaker_subprocess_handle_t *subprocess_handle_ptr,
+    wlmaker_subprocess_handle_t *subprocess_handle_ptr,
     wlmtk_window_t *window_ptr)
 {
     wlmaker_launcher_t *launcher_ptr = userdata_ptr;
 
+    wlmaker_launcher_launch_t *launch_ptr = _wlmaker_launcher_find_launch(
+        launcher_ptr, subprocess_handle_ptr);
+    if (NULL != launch_ptr && 0 == launch_ptr->created_usec) {
+        launch_ptr->created_usec = _wlmaker_launcher_now_usec();
+    }
+
     bool rv = bs_ptr_set_insert(launcher_ptr->created_windows_ptr, window_ptr);
     if (!rv) bs_log(BS_ERROR, "Failed bs_ptr_set_insert(%p)", window_ptr);
 
@@ -484,11 +753,18 @@ void _wlmaker_launcher_handle_window_created(
  */
 void _wlmaker_launcher_handle_window_mapped(
     void *userdata_ptr,
-    __UNUSED__ wlmaker_subprocess_handle_t *subprocess_handle_ptr,
+    wlmaker_subprocess_handle_t *subprocess_handle_ptr,
     wlmtk_window_t *window_ptr)
 {
     wlmaker_launcher_t *launcher_ptr = userdata_ptr;
 
+    wlmaker_launcher_launch_t *launch_ptr = _wlmaker_launcher_find_launch(
+        launcher_ptr, subprocess_handle_ptr);
+    if (NULL != launch_ptr) {
+        _wlmaker_launcher_end_launch(
+            launcher_ptr, launch_ptr, _wlmaker_launcher_now_usec());
+    }
+
     // TODO(kaeser@gubbe.ch): Appears we do encounter this scenario. File this
     // as a bug and fix it.
     // BS_ASSERT(bs_ptr_set_contains(launcher_ptr->created_windows_ptr, window_ptr));
@@ -548,9 +824,11 @@ void _wlmaker_launcher_handle_window_destroyed(
 /* == Unit tests =========================================================== */
 
 static void test_create_from_plist(bs_test_t *test_ptr);
+static void test_latency(bs_test_t *test_ptr);
 
 const bs_test_case_t wlmaker_launcher_test_cases[] = {
     { 1, "create_from_plist", test_create_from_plist },
+    { 1, "latency", test_latency },
     { 0, NULL, NULL }
 };
 
@@ -573,7 +851,92 @@ void test_create_from_plist(bs_test_t *test_ptr)
     BS_TEST_VERIFY_STREQ(test_ptr, "a", launcher_ptr->cmdline_ptr);
     BS_TEST_VERIFY_STREQ(
         test_ptr, "chrome-48x48.png", launcher_ptr->icon_path_ptr);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, WLMAKER_SUBPROCESS_OUTPUT_LOG, launcher_ptr->output);
+    BS_TEST_VERIFY_FALSE(test_ptr, launcher_ptr->match_descendants);
+
+    wlmaker_launcher_destroy(launcher_ptr);
+
+    // Output routing, and a file is required for routing to a file.
+    dict_ptr = wlmcfg_dict_from_object(
+        wlmcfg_create_object_from_plist_string(
+            "{CommandLine = \"a\"; Icon = \"chrome-48x48.png\"; "
+            "Output = Buffer; MatchDescendants = True;}"));
+    launcher_ptr = wlmaker_launcher_create_from_plist(
+        &style, dict_ptr, NULL, NULL);
+    wlmcfg_dict_unref(dict_ptr);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, launcher_ptr);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, WLMAKER_SUBPROCESS_OUTPUT_BUFFER, launcher_ptr->output);
+    BS_TEST_VERIFY_TRUE(test_ptr, launcher_ptr->match_descendants);
+    wlmaker_launcher_destroy(launcher_ptr);
 
+    dict_ptr = wlmcfg_dict_from_object(
+        wlmcfg_create_object_from_plist_string(
+            "{CommandLine = \"a\"; Icon = \"chrome-48x48.png\"; "
+            "Output = File;}"));
+    launcher_ptr = wlmaker_launcher_create_from_plist(
+        &style, dict_ptr, NULL, NULL);
+    wlmcfg_dict_unref(dict_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, launcher_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Tests tracking of click-to-map latency. */
+void test_latency(bs_test_t *test_ptr)
+{
+    static const wlmtk_tile_style_t style = { .size = 96 };
+    wlmcfg_dict_t *dict_ptr = wlmcfg_dict_from_object(
+        wlmcfg_create_object_from_plist_string(
+            "{CommandLine = \"a\"; Icon = \"chrome-48x48.png\"; "
+            "DebugOverlay = True;}"));
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, dict_ptr);
+    wlmaker_launcher_t *launcher_ptr = wlmaker_launcher_create_from_plist(
+        &style, dict_ptr, NULL, NULL);
+    wlmcfg_dict_unref(dict_ptr);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, launcher_ptr);
+    BS_TEST_VERIFY_TRUE(test_ptr, launcher_ptr->debug_overlay);
+
+    // Fake a launch of a subprocess, 5 milliseconds ago.
+    wlmaker_subprocess_handle_t *handle_ptr = (void*)launcher_ptr;
+    wlmtk_window_t *window_ptr = (void*)launcher_ptr;
+    wlmaker_launcher_launch_t *launch_ptr = logged_calloc(
+        1, sizeof(wlmaker_launcher_launch_t));
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, launch_ptr);
+    launch_ptr->subprocess_handle_ptr = handle_ptr;
+    launch_ptr->click_usec = _wlmaker_launcher_now_usec() - 5000;
+    launch_ptr->spawn_usec = launch_ptr->click_usec;
+    bs_dllist_push_back(&launcher_ptr->launches, &launch_ptr->dlnode);
+
+    _wlmaker_launcher_handle_window_created(
+        launcher_ptr, handle_ptr, window_ptr);
+    BS_TEST_VERIFY_NEQ(test_ptr, 0, launch_ptr->created_usec);
+    _wlmaker_launcher_handle_window_mapped(
+        launcher_ptr, handle_ptr, window_ptr);
+    BS_TEST_VERIFY_TRUE(test_ptr, bs_dllist_empty(&launcher_ptr->launches));
+
+    // 5ms and more go into the bucket for below 8ms, or later.
+    wlmaker_launcher_stats_t stats;
+    wlmaker_launcher_get_stats(launcher_ptr, &stats);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, stats.launches);
+    BS_TEST_VERIFY_TRUE(test_ptr, 5 <= stats.latest_msec);
+    unsigned total = 0;
+    for (unsigned i = 0; i < WLMAKER_LAUNCHER_LATENCY_BUCKETS; ++i) {
+        total += stats.histogram[i];
+        if (i < 3) BS_TEST_VERIFY_EQ(test_ptr, 0, stats.histogram[i]);
+    }
+    BS_TEST_VERIFY_EQ(test_ptr, 1, total);
+
+    // A second mapped window does not count as another launch.
+    _wlmaker_launcher_handle_window_mapped(
+        launcher_ptr, handle_ptr, window_ptr);
+    wlmaker_launcher_get_stats(launcher_ptr, &stats);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, stats.launches);
+
+    _wlmaker_launcher_handle_window_unmapped(
+        launcher_ptr, handle_ptr, window_ptr);
+    _wlmaker_launcher_handle_window_destroyed(
+        launcher_ptr, handle_ptr, window_ptr);
     wlmaker_launcher_destroy(launcher_ptr);
 }
 
@@ -30,6 +30,23 @@ extern "C" {
 /** Forward declaration: Launcher handle. */
 typedef struct _wlmaker_launcher_t wlmaker_launcher_t;
 
+/** Number of buckets in @ref wlmaker_launcher_stats_t::histogram. */
+#define WLMAKER_LAUNCHER_LATENCY_BUCKETS 16
+
+/** Click-to-map latency of launches from a launcher. */
+typedef struct {
+    /** Launches that mapped a window, since creating the launcher. */
+    unsigned                  launches;
+    /** Latency of the latest launch, in milliseconds. */
+    uint32_t                  latest_msec;
+    /**
+     * Latencies of the most recent launches. Bucket `i` counts launches
+     * below 2^i milliseconds, and not counted in a lower bucket. The last
+     * bucket is open-ended: It counts all from 2^(i-1) milliseconds.
+     */
+    unsigned                  histogram[WLMAKER_LAUNCHER_LATENCY_BUCKETS];
+} wlmaker_launcher_stats_t;
+
 /**
  * Creates an application launcher, configured from a plist dict.
  *
@@ -53,6 +70,23 @@ wlmaker_launcher_t *wlmaker_launcher_create_from_plist(
  */
 void wlmaker_launcher_destroy(wlmaker_launcher_t *launcher_ptr);
 
+/**
+ * Retrieves the click-to-map latency statistics of the launcher.
+ *
+ * @param launcher_ptr
+ * @param stats_ptr
+ */
+void wlmaker_launcher_get_stats(
+    wlmaker_launcher_t *launcher_ptr,
+    wlmaker_launcher_stats_t *stats_ptr);
+
+/**
+ * Logs the click-to-map latency statistics of the launcher.
+ *
+ * @param launcher_ptr
+ */
+void wlmaker_launcher_log_stats(wlmaker_launcher_t *launcher_ptr);
+
 /** @return A pointer to the @ref wlmtk_tile_t superclass of `launcher_ptr`. */
 wlmtk_tile_t *wlmaker_launcher_tile(wlmaker_launcher_t *launcher_ptr);
 
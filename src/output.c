@@ -41,11 +41,32 @@ static void handle_output_frame(struct wl_listener *listener_ptr,
 static void handle_request_state(struct wl_listener *listener_ptr,
                                  void *data_ptr);
 
+static int _wlmaker_output_handle_render_timer(void *data_ptr);
+static void _wlmaker_output_render(wlmaker_output_t *output_ptr);
+static uint64_t _wlmaker_output_usec(void);
+static uint64_t _wlmaker_output_refresh_usec(wlmaker_output_t *output_ptr);
+static void _wlmaker_output_record_render_usec(
+    wlmaker_output_t *output_ptr,
+    uint64_t usec);
+static uint64_t _wlmaker_output_predict_render_usec(
+    wlmaker_output_t *output_ptr);
+static unsigned _wlmaker_output_render_delay_msec(
+    wlmaker_output_t *output_ptr);
+
 /* == Data ================================================================= */
 
 /** Name of the plist dict describing the (default) output configuration. */
 static const char *_wlmaker_output_dict_name = "Output";
 
+/** Refresh period to assume, if the output does not report a refresh rate. */
+static const uint64_t _wlmaker_output_default_refresh_usec = 16667;
+
+/** Safety margin added to the predicted render time, in microseconds. */
+static const uint64_t _wlmaker_output_render_margin_usec = 1500;
+
+/** Percentile of recent render times used as the render time prediction. */
+static const unsigned _wlmaker_output_render_percentile = 95;
+
 /** Descriptor for output transformations. */
 static const wlmcfg_enum_desc_t _wlmaker_output_transformation_desc[] = {
     WLMCFG_ENUM("Normal", WL_OUTPUT_TRANSFORM_NORMAL),
@@ -65,6 +86,8 @@ static const wlmcfg_desc_t _wlmaker_output_config_desc[] = {
                      WL_OUTPUT_TRANSFORM_NORMAL,
                      _wlmaker_output_transformation_desc),
     WLMCFG_DESC_DOUBLE("Scale", true, wlmaker_output_t, scale, 1.0),
+    WLMCFG_DESC_UINT64("MaxRenderDelay", false, wlmaker_output_t,
+                       max_render_delay_msec, 0),
     WLMCFG_DESC_SENTINEL()
 };
 
@@ -121,6 +144,21 @@ wlmaker_output_t *wlmaker_output_create(
         &output_ptr->output_request_state_listener,
         handle_request_state);
 
+    if (0 < output_ptr->max_render_delay_msec) {
+        output_ptr->render_timer_event_source_ptr = wl_event_loop_add_timer(
+            wl_display_get_event_loop(server_ptr->wl_display_ptr),
+            _wlmaker_output_handle_render_timer,
+            output_ptr);
+        if (NULL == output_ptr->render_timer_event_source_ptr) {
+            bs_log(BS_ERROR, "Failed wl_event_loop_add_timer(%p, %p, %p)",
+                   wl_display_get_event_loop(server_ptr->wl_display_ptr),
+                   _wlmaker_output_handle_render_timer,
+                   output_ptr);
+            wlmaker_output_destroy(output_ptr);
+            return NULL;
+        }
+    }
+
     // From tinwywl: Configures the output created by the backend to use our
     // allocator and our renderer. Must be done once, before commiting the
     // output.
@@ -159,8 +197,10 @@ wlmaker_output_t *wlmaker_output_create(
         _wlmaker_output_transformation_desc,
         output_ptr->transformation,
         &transformation_name_ptr);
-    bs_log(BS_INFO, "Configured transformation '%s' and scale %.2f on %s",
+    bs_log(BS_INFO, "Configured transformation '%s', scale %.2f and max "
+           "render delay %"PRIu64" ms on %s",
            transformation_name_ptr, output_ptr->scale,
+           output_ptr->max_render_delay_msec,
            output_ptr->wlr_output_ptr->name);
 
     // Set modes for backends that have them.
@@ -207,7 +247,21 @@ wlmaker_output_t *wlmaker_output_create(
 void wlmaker_output_destroy(wlmaker_output_t *output_ptr)
 {
     if (NULL != output_ptr->wlr_output_ptr) {
-        bs_log(BS_INFO, "Destroy output %s", output_ptr->wlr_output_ptr->name);
+        bs_log(BS_INFO, "Destroy output %s: %"PRIu64" frames committed, "
+               "%"PRIu64" skipped, %"PRIu64" failed, %"PRIu64" late. "
+               "Average frame latency %"PRIu64" us.",
+               output_ptr->wlr_output_ptr->name,
+               output_ptr->committed_frames,
+               output_ptr->skipped_frames,
+               output_ptr->failed_frames,
+               output_ptr->late_frames,
+               output_ptr->frame_latency_usec / BS_MAX(
+                   output_ptr->committed_frames, (uint64_t)1));
+    }
+
+    if (NULL != output_ptr->render_timer_event_source_ptr) {
+        wl_event_source_remove(output_ptr->render_timer_event_source_ptr);
+        output_ptr->render_timer_event_source_ptr = NULL;
     }
 
     wl_list_remove(&output_ptr->output_request_state_listener.link);
@@ -239,6 +293,10 @@ void handle_output_destroy(struct wl_listener *listener_ptr,
 /**
  * Event handler for the `frame` signal raised by `wlr_output`.
  *
+ * Renders right away, unless a render delay is configured: Then, arms the
+ * render timer such that the render starts as late as the predicted render
+ * time permits. Clients committing in the meantime still make this frame.
+ *
  * @param listener_ptr
  * @param data_ptr
  */
@@ -248,14 +306,27 @@ void handle_output_frame(struct wl_listener *listener_ptr,
     wlmaker_output_t *output_ptr = BS_CONTAINER_OF(
         listener_ptr, wlmaker_output_t, output_frame_listener);
 
-    struct wlr_scene_output *wlr_scene_output_ptr = wlr_scene_get_scene_output(
-        output_ptr->wlr_scene_ptr,
-        output_ptr->wlr_output_ptr);
-    wlr_scene_output_commit(wlr_scene_output_ptr, NULL);
+    // An armed timer will render this frame.
+    if (output_ptr->render_pending) return;
 
-    struct timespec now;
-    clock_gettime(CLOCK_MONOTONIC, &now);
-    wlr_scene_output_send_frame_done(wlr_scene_output_ptr, &now);
+    output_ptr->frame_usec = _wlmaker_output_usec();
+    output_ptr->render_delay_msec = _wlmaker_output_render_delay_msec(
+        output_ptr);
+    if (0 == output_ptr->render_delay_msec) {
+        _wlmaker_output_render(output_ptr);
+        return;
+    }
+
+    if (0 != wl_event_source_timer_update(
+            output_ptr->render_timer_event_source_ptr,
+            output_ptr->render_delay_msec)) {
+        bs_log(BS_WARNING, "Failed wl_event_source_timer_update(%p, %u)",
+               output_ptr->render_timer_event_source_ptr,
+               output_ptr->render_delay_msec);
+        _wlmaker_output_render(output_ptr);
+        return;
+    }
+    output_ptr->render_pending = true;
 }
 
 /* ------------------------------------------------------------------------- */
@@ -275,4 +346,237 @@ void handle_request_state(struct wl_listener *listener_ptr,
     wlr_output_commit_state(output_ptr->wlr_output_ptr, event_ptr->state);
 }
 
+/* ------------------------------------------------------------------------- */
+/** Handles the render timer: Renders the delayed frame. */
+int _wlmaker_output_handle_render_timer(void *data_ptr)
+{
+    wlmaker_output_t *output_ptr = data_ptr;
+    output_ptr->render_pending = false;
+    _wlmaker_output_render(output_ptr);
+    return 0;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Renders a frame for the output.
+ *
+ * Emits @ref wlmtk_root_events_t::pre_frame, for deferred scene updates to
+ * go in. Then commits the scene output only if the scene has damage (or
+ * otherwise needs a frame), and counts committed and skipped frames.
+ * Frame-done events are sent in either case, so clients waiting on a frame
+ * callback will proceed.
+ * Further damage will schedule a new `frame` signal through wlroots.
+ *
+ * The time taken for the commit is recorded for predicting the render delay.
+ *
+ * @param output_ptr
+ */
+void _wlmaker_output_render(wlmaker_output_t *output_ptr)
+{
+    struct wlr_scene_output *wlr_scene_output_ptr = wlr_scene_get_scene_output(
+        output_ptr->wlr_scene_ptr,
+        output_ptr->wlr_output_ptr);
+    if (NULL == wlr_scene_output_ptr) return;
+
+    // Deferred updates to the scene go in before checking for damage.
+    if (NULL != output_ptr->server_ptr->root_ptr) {
+        wlmtk_root_pre_frame(output_ptr->server_ptr->root_ptr,
+                             output_ptr->wlr_output_ptr);
+    }
+
+    if (!wlr_scene_output_needs_frame(wlr_scene_output_ptr)) {
+        ++output_ptr->skipped_frames;
+    } else {
+        uint64_t start_usec = _wlmaker_output_usec();
+        if (wlr_scene_output_commit(wlr_scene_output_ptr, NULL)) {
+            uint64_t end_usec = _wlmaker_output_usec();
+            _wlmaker_output_record_render_usec(
+                output_ptr, end_usec - start_usec);
+            ++output_ptr->committed_frames;
+            output_ptr->frame_latency_usec += end_usec - output_ptr->frame_usec;
+            if (end_usec - output_ptr->frame_usec >
+                _wlmaker_output_refresh_usec(output_ptr)) {
+                ++output_ptr->late_frames;
+            }
+        } else {
+            ++output_ptr->failed_frames;
+            bs_log(BS_DEBUG, "Failed wlr_scene_output_commit() on %s",
+                   output_ptr->wlr_output_ptr->name);
+        }
+    }
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    wlr_scene_output_send_frame_done(wlr_scene_output_ptr, &now);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Returns the monotonic time, in microseconds. */
+uint64_t _wlmaker_output_usec(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Returns the output's refresh period, in microseconds. */
+uint64_t _wlmaker_output_refresh_usec(wlmaker_output_t *output_ptr)
+{
+    // wlr_output::refresh is in mHz, and 0 if unknown.
+    if (NULL == output_ptr->wlr_output_ptr ||
+        0 >= output_ptr->wlr_output_ptr->refresh) {
+        return _wlmaker_output_default_refresh_usec;
+    }
+    return 1000000000 / (uint64_t)output_ptr->wlr_output_ptr->refresh;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Records a render time. Once @ref WLMAKER_OUTPUT_RENDER_SAMPLES are
+ * recorded, the oldest sample is dropped from the histogram.
+ *
+ * @param output_ptr
+ * @param usec
+ */
+void _wlmaker_output_record_render_usec(
+    wlmaker_output_t *output_ptr,
+    uint64_t usec)
+{
+    size_t idx = output_ptr->render_sample_idx;
+    if (WLMAKER_OUTPUT_RENDER_SAMPLES <= output_ptr->render_samples) {
+        uint64_t bucket = BS_MIN(
+            output_ptr->render_usec[idx] / WLMAKER_OUTPUT_RENDER_BUCKET_USEC,
+            (uint64_t)WLMAKER_OUTPUT_RENDER_BUCKETS - 1);
+        --output_ptr->render_buckets[bucket];
+    } else {
+        ++output_ptr->render_samples;
+    }
+
+    output_ptr->render_usec[idx] = usec;
+    uint64_t bucket = BS_MIN(usec / WLMAKER_OUTPUT_RENDER_BUCKET_USEC,
+                             (uint64_t)WLMAKER_OUTPUT_RENDER_BUCKETS - 1);
+    ++output_ptr->render_buckets[bucket];
+    output_ptr->render_sample_idx = (idx + 1) % WLMAKER_OUTPUT_RENDER_SAMPLES;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Predicts the render time from the histogram of recent render times.
+ *
+ * @param output_ptr
+ *
+ * @return Upper bound of the bucket holding the configured percentile of
+ *     recent render times. UINT64_MAX, if there are too few samples yet, or
+ *     if the percentile is in the overflow bucket.
+ */
+uint64_t _wlmaker_output_predict_render_usec(wlmaker_output_t *output_ptr)
+{
+    if (output_ptr->render_samples < WLMAKER_OUTPUT_RENDER_SAMPLES / 4) {
+        return UINT64_MAX;
+    }
+
+    unsigned threshold = (output_ptr->render_samples *
+                          _wlmaker_output_render_percentile + 99) / 100;
+    unsigned count = 0;
+    for (size_t i = 0; i < WLMAKER_OUTPUT_RENDER_BUCKETS - 1; ++i) {
+        count += output_ptr->render_buckets[i];
+        if (count >= threshold) {
+            return (i + 1) * WLMAKER_OUTPUT_RENDER_BUCKET_USEC;
+        }
+    }
+    return UINT64_MAX;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Computes the render delay for the upcoming frame: The refresh period,
+ * minus predicted render time and safety margin, capped by
+ * @ref wlmaker_output_t::max_render_delay_msec.
+ *
+ * @param output_ptr
+ *
+ * @return The delay, in milliseconds. 0 to render right away.
+ */
+unsigned _wlmaker_output_render_delay_msec(wlmaker_output_t *output_ptr)
+{
+    if (0 == output_ptr->max_render_delay_msec) return 0;
+
+    uint64_t predicted_usec = _wlmaker_output_predict_render_usec(output_ptr);
+    uint64_t refresh_usec = _wlmaker_output_refresh_usec(output_ptr);
+    if (predicted_usec >= refresh_usec) return 0;
+    uint64_t budget_usec = predicted_usec + _wlmaker_output_render_margin_usec;
+    if (budget_usec >= refresh_usec) return 0;
+
+    return BS_MIN((refresh_usec - budget_usec) / 1000,
+                  output_ptr->max_render_delay_msec);
+}
+
+/* == Unit tests =========================================================== */
+
+static void test_render_delay(bs_test_t *test_ptr);
+
+const bs_test_case_t wlmaker_output_test_cases[] = {
+    { 1, "render_delay", test_render_delay },
+    { 0, NULL, NULL }
+};
+
+/* ------------------------------------------------------------------------- */
+/** Exercises the render time histogram and the render delay prediction. */
+void test_render_delay(bs_test_t *test_ptr)
+{
+    struct wlr_output wlr_output = { .refresh = 60000 };
+    wlmaker_output_t output = {
+        .wlr_output_ptr = &wlr_output,
+        .max_render_delay_msec = 20
+    };
+
+    // Not enough samples yet: Render right away.
+    for (int i = 0; i < WLMAKER_OUTPUT_RENDER_SAMPLES / 4 - 1; ++i) {
+        _wlmaker_output_record_render_usec(&output, 2000);
+    }
+    BS_TEST_VERIFY_EQ(test_ptr, 0, _wlmaker_output_render_delay_msec(&output));
+
+    // 16666us period, 2250us predicted, 1500us margin.
+    for (int i = 0; i < WLMAKER_OUTPUT_RENDER_SAMPLES; ++i) {
+        _wlmaker_output_record_render_usec(&output, 2000);
+    }
+    BS_TEST_VERIFY_EQ(test_ptr, 2250,
+                      _wlmaker_output_predict_render_usec(&output));
+    BS_TEST_VERIFY_EQ(test_ptr, 12, _wlmaker_output_render_delay_msec(&output));
+    output.max_render_delay_msec = 5;
+    BS_TEST_VERIFY_EQ(test_ptr, 5, _wlmaker_output_render_delay_msec(&output));
+    output.max_render_delay_msec = 20;
+
+    // A few outliers do not move the 95th percentile...
+    for (int i = 0; i < 3; ++i) {
+        _wlmaker_output_record_render_usec(&output, 9000);
+    }
+    BS_TEST_VERIFY_EQ(test_ptr, 2250,
+                      _wlmaker_output_predict_render_usec(&output));
+    // ... but more do.
+    for (int i = 0; i < 3; ++i) {
+        _wlmaker_output_record_render_usec(&output, 9000);
+    }
+    BS_TEST_VERIFY_EQ(test_ptr, 9250,
+                      _wlmaker_output_predict_render_usec(&output));
+    BS_TEST_VERIFY_EQ(test_ptr, 5, _wlmaker_output_render_delay_msec(&output));
+
+    // Render times beyond the histogram range: Render right away.
+    for (int i = 0; i < WLMAKER_OUTPUT_RENDER_SAMPLES; ++i) {
+        _wlmaker_output_record_render_usec(&output, 30000);
+    }
+    BS_TEST_VERIFY_EQ(test_ptr, UINT64_MAX,
+                      _wlmaker_output_predict_render_usec(&output));
+    BS_TEST_VERIFY_EQ(test_ptr, 0, _wlmaker_output_render_delay_msec(&output));
+
+    // Old samples are dropped entirely.
+    for (int i = 0; i < WLMAKER_OUTPUT_RENDER_SAMPLES; ++i) {
+        _wlmaker_output_record_render_usec(&output, 500);
+    }
+    BS_TEST_VERIFY_EQ(test_ptr, 750,
+                      _wlmaker_output_predict_render_usec(&output));
+    BS_TEST_VERIFY_EQ(test_ptr, 14, _wlmaker_output_render_delay_msec(&output));
+}
+
 /* == End of output.c ====================================================== */
@@ -37,6 +37,13 @@ typedef struct _wlmaker_output_t wlmaker_output_t;
 extern "C" {
 #endif  // __cplusplus
 
+/** Number of recent render times used for predicting the render time. */
+#define WLMAKER_OUTPUT_RENDER_SAMPLES 64
+/** Width of one bucket of the render time histogram, in microseconds. */
+#define WLMAKER_OUTPUT_RENDER_BUCKET_USEC 250
+/** Number of histogram buckets. The last bucket holds all longer times. */
+#define WLMAKER_OUTPUT_RENDER_BUCKETS 80
+
 /** Handle for a compositor output device. */
 struct _wlmaker_output_t {
     /** List node for insertion to server's list of outputs. */
@@ -64,6 +71,42 @@ struct _wlmaker_output_t {
     enum wl_output_transform  transformation;
     /** Default scaling factor to use for the output(s). */
     double                    scale;
+
+    /** Number of `frame` signals that led to a commit of the scene output. */
+    uint64_t                  committed_frames;
+    /** Number of `frame` signals skipped, since the scene had no damage. */
+    uint64_t                  skipped_frames;
+    /** Number of commits of the scene output that failed. */
+    uint64_t                  failed_frames;
+
+    /**
+     * Upper limit for delaying the render after the `frame` signal, in
+     * milliseconds. 0 disables the render delay. Configured as
+     * `MaxRenderDelay`.
+     */
+    uint64_t                  max_render_delay_msec;
+    /** Timer for the delayed render. NULL if there is no render delay. */
+    struct wl_event_source    *render_timer_event_source_ptr;
+    /** Whether the render timer is armed. */
+    bool                      render_pending;
+    /** Time of the last `frame` signal, in microseconds. */
+    uint64_t                  frame_usec;
+    /** The render delay applied at the last `frame` signal, in msec. */
+    unsigned                  render_delay_msec;
+
+    /** Ring buffer of the most recent render times, in microseconds. */
+    uint64_t                  render_usec[WLMAKER_OUTPUT_RENDER_SAMPLES];
+    /** Index of the next entry to write into @ref render_usec. */
+    size_t                    render_sample_idx;
+    /** Number of valid entries in @ref render_usec. */
+    size_t                    render_samples;
+    /** Histogram of the render times in @ref render_usec. */
+    unsigned                  render_buckets[WLMAKER_OUTPUT_RENDER_BUCKETS];
+
+    /** Accumulated time from `frame` signal to completed commit, in usec. */
+    uint64_t                  frame_latency_usec;
+    /** Number of commits that completed later than one refresh period. */
+    uint64_t                  late_frames;
 };
 
 /**
@@ -95,6 +138,9 @@ wlmaker_output_t *wlmaker_output_create(
  */
 void wlmaker_output_destroy(wlmaker_output_t *output_ptr);
 
+/** Unit test cases. */
+extern const bs_test_case_t wlmaker_output_test_cases[];
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -20,12 +20,29 @@
 
 #include "root_menu.h"
 
+#include <string.h>
+
 #include <libbase/libbase.h>
 
 #include "action_item.h"
+#include "app_index.h"
+#include "app_item.h"
+#include "submenu_item.h"
 
 /* == Declarations ========================================================= */
 
+/** A category submenu of the 'Applications' submenu. */
+typedef struct {
+    /** Back-link to the root menu. */
+    wlmaker_root_menu_t       *root_menu_ptr;
+    /** Title of the category, as returned by @ref wlmaker_app_category. */
+    const char                *title_ptr;
+    /** Whether an application of this category was found. */
+    bool                      found;
+    /** The category's submenu, once populated. */
+    wlmtk_popup_menu_t        *popup_menu_ptr;
+} wlmaker_root_menu_category_t;
+
 /** State of the root menu. */
 struct _wlmaker_root_menu_t {
     /** Window. */
@@ -38,10 +55,29 @@ struct _wlmaker_root_menu_t {
 
     /** Back-link to the server. */
     wlmaker_server_t          *server_ptr;
+    /** Style of the menu, for the submenus. */
+    const wlmtk_menu_style_t  *menu_style_ptr;
+    /** Environment, for the submenus. */
+    wlmtk_env_t               *env_ptr;
+
+    /** Categories of the 'Applications' submenu, once populated. */
+    wlmaker_root_menu_category_t *categories_ptr;
 };
 
 static void _wlmaker_root_menu_content_request_close(
     wlmtk_content_t *content_ptr);
+static bool _wlmaker_root_menu_populate_applications(
+    wlmtk_popup_menu_t *popup_menu_ptr,
+    void *ud_ptr);
+static bool _wlmaker_root_menu_populate_category(
+    wlmtk_popup_menu_t *popup_menu_ptr,
+    void *ud_ptr);
+static void _wlmaker_root_menu_find_category(
+    const wlmaker_app_t *app_ptr,
+    void *ud_ptr);
+static void _wlmaker_root_menu_add_app_item(
+    const wlmaker_app_t *app_ptr,
+    void *ud_ptr);
 
 /** Temporary: Struct for defining a menu item for the root menu. */
 typedef struct {
@@ -83,6 +119,8 @@ wlmaker_root_menu_t *wlmaker_root_menu_create(
     if (NULL == root_menu_ptr) return NULL;
     root_menu_ptr->server_ptr = server_ptr;
     root_menu_ptr->server_ptr->root_menu_ptr = root_menu_ptr;
+    root_menu_ptr->menu_style_ptr = menu_style_ptr;
+    root_menu_ptr->env_ptr = env_ptr;
 
     if (!wlmtk_menu_init(&root_menu_ptr->menu,
                          menu_style_ptr,
@@ -96,6 +134,24 @@ wlmaker_root_menu_t *wlmaker_root_menu_create(
             WLMTK_MENU_MODE_RIGHTCLICK);
     }
 
+    // The content's popup container gets initialized further below. It is
+    // used only once the item is clicked.
+    wlmaker_submenu_item_t *submenu_item_ptr = wlmaker_submenu_item_create(
+        "Applications",
+        menu_style_ptr,
+        &root_menu_ptr->menu,
+        &root_menu_ptr->content.popup_container,
+        _wlmaker_root_menu_populate_applications,
+        root_menu_ptr,
+        env_ptr);
+    if (NULL == submenu_item_ptr) {
+        wlmaker_root_menu_destroy(root_menu_ptr);
+        return NULL;
+    }
+    wlmtk_menu_add_item(
+        &root_menu_ptr->menu,
+        wlmaker_submenu_item_menu_item(submenu_item_ptr));
+
     for (const wlmaker_root_menu_item_t *i_ptr = &_wlmaker_root_menu_items[0];
          i_ptr->text_ptr != NULL;
          ++i_ptr) {
@@ -188,6 +244,10 @@ void wlmaker_root_menu_destroy(wlmaker_root_menu_t *root_menu_ptr)
 
     wlmtk_content_fini(&root_menu_ptr->content);
     wlmtk_menu_fini(&root_menu_ptr->menu);
+    if (NULL != root_menu_ptr->categories_ptr) {
+        free(root_menu_ptr->categories_ptr);
+        root_menu_ptr->categories_ptr = NULL;
+    }
     free(root_menu_ptr);
 }
 
@@ -215,4 +275,143 @@ void _wlmaker_root_menu_content_request_close(
     wlmaker_root_menu_destroy(root_menu_ptr);
 }
 
+/* ------------------------------------------------------------------------- */
+/**
+ * Implements @ref wlmaker_submenu_item_populate_t for 'Applications'. Adds
+ * a submenu for each category that holds applications.
+ *
+ * The application index is created on first use, and kept with the server.
+ * It then follows changes to the installed applications.
+ *
+ * @param popup_menu_ptr
+ * @param ud_ptr              Points to @ref wlmaker_root_menu_t.
+ *
+ * @return true on success.
+ */
+bool _wlmaker_root_menu_populate_applications(
+    wlmtk_popup_menu_t *popup_menu_ptr,
+    void *ud_ptr)
+{
+    wlmaker_root_menu_t *root_menu_ptr = ud_ptr;
+    wlmaker_server_t *server_ptr = root_menu_ptr->server_ptr;
+
+    if (NULL == server_ptr->app_index_ptr) {
+        server_ptr->app_index_ptr = wlmaker_app_index_create(
+            NULL, NULL, wl_display_get_event_loop(server_ptr->wl_display_ptr));
+        if (NULL == server_ptr->app_index_ptr) return false;
+    }
+
+    size_t categories = 0;
+    while (NULL != wlmaker_app_categories[categories]) ++categories;
+    // Kept until the root menu is destroyed: Items of an earlier populate may
+    // still point into it.
+    if (NULL == root_menu_ptr->categories_ptr) {
+        root_menu_ptr->categories_ptr = logged_calloc(
+            categories, sizeof(wlmaker_root_menu_category_t));
+        if (NULL == root_menu_ptr->categories_ptr) return false;
+    }
+    for (size_t i = 0; i < categories; ++i) {
+        root_menu_ptr->categories_ptr[i].root_menu_ptr = root_menu_ptr;
+        root_menu_ptr->categories_ptr[i].title_ptr =
+            wlmaker_app_categories[i];
+        root_menu_ptr->categories_ptr[i].found = false;
+    }
+    wlmaker_app_index_for_each(
+        server_ptr->app_index_ptr,
+        _wlmaker_root_menu_find_category,
+        root_menu_ptr->categories_ptr);
+
+    for (size_t i = 0; i < categories; ++i) {
+        if (!root_menu_ptr->categories_ptr[i].found) continue;
+        wlmaker_submenu_item_t *submenu_item_ptr = wlmaker_submenu_item_create(
+            root_menu_ptr->categories_ptr[i].title_ptr,
+            root_menu_ptr->menu_style_ptr,
+            wlmtk_popup_menu_menu(popup_menu_ptr),
+            &wlmtk_popup_menu_popup(popup_menu_ptr)->popup_container,
+            _wlmaker_root_menu_populate_category,
+            &root_menu_ptr->categories_ptr[i],
+            root_menu_ptr->env_ptr);
+        if (NULL == submenu_item_ptr) return false;
+        wlmtk_menu_add_item(
+            wlmtk_popup_menu_menu(popup_menu_ptr),
+            wlmaker_submenu_item_menu_item(submenu_item_ptr));
+    }
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Implements @ref wlmaker_submenu_item_populate_t for a category. Adds an
+ * item for each application of the category.
+ *
+ * @param popup_menu_ptr
+ * @param ud_ptr              Points to @ref wlmaker_root_menu_category_t.
+ *
+ * @return true.
+ */
+bool _wlmaker_root_menu_populate_category(
+    wlmtk_popup_menu_t *popup_menu_ptr,
+    void *ud_ptr)
+{
+    wlmaker_root_menu_category_t *category_ptr = ud_ptr;
+    category_ptr->popup_menu_ptr = popup_menu_ptr;
+    wlmaker_app_index_for_each(
+        category_ptr->root_menu_ptr->server_ptr->app_index_ptr,
+        _wlmaker_root_menu_add_app_item,
+        category_ptr);
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Callback for @ref wlmaker_app_index_for_each: Marks the application's
+ * category as found.
+ *
+ * @param app_ptr
+ * @param ud_ptr              Points to the array of
+ *                            @ref wlmaker_root_menu_category_t.
+ */
+void _wlmaker_root_menu_find_category(
+    const wlmaker_app_t *app_ptr,
+    void *ud_ptr)
+{
+    wlmaker_root_menu_category_t *categories_ptr = ud_ptr;
+    const char *title_ptr = wlmaker_app_category(app_ptr);
+    for (size_t i = 0; NULL != wlmaker_app_categories[i]; ++i) {
+        if (0 == strcmp(categories_ptr[i].title_ptr, title_ptr)) {
+            categories_ptr[i].found = true;
+            return;
+        }
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Callback for @ref wlmaker_app_index_for_each: Adds an item for the
+ * application, if it is of the category.
+ *
+ * @param app_ptr
+ * @param ud_ptr              Points to @ref wlmaker_root_menu_category_t.
+ */
+void _wlmaker_root_menu_add_app_item(
+    const wlmaker_app_t *app_ptr,
+    void *ud_ptr)
+{
+    wlmaker_root_menu_category_t *category_ptr = ud_ptr;
+    wlmaker_root_menu_t *root_menu_ptr = category_ptr->root_menu_ptr;
+    if (0 != strcmp(category_ptr->title_ptr,
+                    wlmaker_app_category(app_ptr))) return;
+
+    wlmaker_app_item_t *app_item_ptr = wlmaker_app_item_create(
+        app_ptr->name_ptr,
+        &root_menu_ptr->menu_style_ptr->item,
+        app_ptr->exec_ptr,
+        root_menu_ptr->server_ptr,
+        root_menu_ptr->env_ptr);
+    if (NULL == app_item_ptr) return;
+    wlmtk_menu_add_item(
+        wlmtk_popup_menu_menu(category_ptr->popup_menu_ptr),
+        wlmaker_app_item_menu_item(app_item_ptr));
+}
+
 /* == End of root_menu.c =================================================== */
@@ -54,12 +54,18 @@ typedef struct {
 struct _wlmaker_key_binding_t {
     /** Node within @ref wlmaker_server_t::bindings. */
     bs_dllist_node_t          dlnode;
+    /** Node within the bucket of @ref wlmaker_server_t::binding_buckets. */
+    bs_dllist_node_t          bucket_dlnode;
     /** The key binding: Modifier and keysym to bind to. */
     const wlmaker_key_combo_t *key_combo_ptr;
     /** Callback for when this modifier + key is encountered. */
     wlmaker_keybinding_callback_t callback;
 };
 
+static bs_dllist_t *_wlmaker_server_binding_bucket(
+    wlmaker_server_t *server_ptr,
+    xkb_keysym_t keysym);
+
 static bool register_input_device(
     wlmaker_server_t *server_ptr,
     struct wlr_input_device *wlr_input_device_ptr,
@@ -82,8 +88,44 @@ static void _wlmaker_server_unclaimed_button_event_handler(
     struct wl_listener *listener_ptr,
     void *data_ptr);
 
+/** Configuration of the on-disk cache of scaled icons. */
+typedef struct {
+    /** Whether to cache scaled icons on disk. */
+    bool                      enabled;
+    /** Directory of the cache. Empty for the default. */
+    char                      *directory_ptr;
+} wlmaker_server_icon_cache_config_t;
+
+static void _wlmaker_server_init_icon_cache(wlmaker_server_t *server_ptr);
+
+/** Configuration of the icon theme. */
+typedef struct {
+    /** Name of the freedesktop icon theme. */
+    char                      *name_ptr;
+} wlmaker_server_icon_theme_config_t;
+
+static void _wlmaker_server_init_icon_theme(wlmaker_server_t *server_ptr);
+
 /* == Data ================================================================= */
 
+/** Plist descriptor of the 'IconCache' dict. */
+static const wlmcfg_desc_t _wlmaker_server_icon_cache_desc[] = {
+    WLMCFG_DESC_BOOL(
+        "Enabled", false, wlmaker_server_icon_cache_config_t, enabled, false),
+    WLMCFG_DESC_STRING(
+        "Directory", false, wlmaker_server_icon_cache_config_t,
+        directory_ptr, ""),
+    WLMCFG_DESC_SENTINEL()
+};
+
+/** Plist descriptor of the 'IconTheme' dict. */
+static const wlmcfg_desc_t _wlmaker_server_icon_theme_desc[] = {
+    WLMCFG_DESC_STRING(
+        "Name", false, wlmaker_server_icon_theme_config_t,
+        name_ptr, "hicolor"),
+    WLMCFG_DESC_SENTINEL()
+};
+
 const uint32_t wlmaker_modifier_default_mask = (
     WLR_MODIFIER_SHIFT |
     // Excluding: WLR_MODIFIER_CAPS.
@@ -117,6 +159,7 @@ wlmaker_server_t *wlmaker_server_create(
     wl_signal_init(&server_ptr->window_created_event);
     wl_signal_init(&server_ptr->window_destroyed_event);
     wl_signal_init(&server_ptr->output_layout_changed_event);
+    wl_signal_init(&server_ptr->launcher_stats_event);
 
     // Prepare display and socket.
     server_ptr->wl_display_ptr = wl_display_create();
@@ -232,11 +275,14 @@ wlmaker_server_t *wlmaker_server_create(
     server_ptr->env_ptr = wlmtk_env_create(
         server_ptr->cursor_ptr->wlr_cursor_ptr,
         server_ptr->cursor_ptr->wlr_xcursor_manager_ptr,
-        server_ptr->wlr_seat_ptr);
+        server_ptr->wlr_seat_ptr,
+        wl_display_get_event_loop(server_ptr->wl_display_ptr));
     if (NULL == server_ptr->env_ptr) {
         wlmaker_server_destroy(server_ptr);
         return NULL;
     }
+    _wlmaker_server_init_icon_cache(server_ptr);
+    _wlmaker_server_init_icon_theme(server_ptr);
 
     // Root element.
     server_ptr->root_ptr = wlmtk_root_create(
@@ -384,6 +430,11 @@ void wlmaker_server_destroy(wlmaker_server_t *server_ptr)
         server_ptr->corner_ptr = NULL;
     }
 
+    if (NULL != server_ptr->app_index_ptr) {
+        wlmaker_app_index_destroy(server_ptr->app_index_ptr);
+        server_ptr->app_index_ptr = NULL;
+    }
+
     if (NULL != server_ptr->monitor_ptr) {
         wlmaker_subprocess_monitor_destroy(server_ptr->monitor_ptr);
         server_ptr->monitor_ptr =NULL;
@@ -441,6 +492,12 @@ void wlmaker_server_destroy(wlmaker_server_t *server_ptr)
         wlmtk_env_destroy(server_ptr->env_ptr);
         server_ptr->env_ptr = NULL;
     }
+    if (NULL != server_ptr->icon_theme_ptr) {
+        wlmtk_icon_theme_destroy(server_ptr->icon_theme_ptr);
+        server_ptr->icon_theme_ptr = NULL;
+    }
+    wlmtk_raster_cache_fini();
+    wlmtk_text_cache_fini();
 
     if (NULL != server_ptr->cursor_ptr) {
         wlmaker_cursor_destroy(server_ptr->cursor_ptr);
@@ -552,6 +609,9 @@ wlmaker_key_binding_t *wlmaker_server_bind_key(
     key_binding_ptr->key_combo_ptr = key_combo_ptr;
     key_binding_ptr->callback = callback;
     bs_dllist_push_back(&server_ptr->bindings, &key_binding_ptr->dlnode);
+    bs_dllist_push_back(
+        _wlmaker_server_binding_bucket(server_ptr, key_combo_ptr->keysym),
+        &key_binding_ptr->bucket_dlnode);
     return key_binding_ptr;
 }
 
@@ -560,6 +620,10 @@ void wlmaker_server_unbind_key(
     wlmaker_server_t *server_ptr,
     wlmaker_key_binding_t *key_binding_ptr)
 {
+    bs_dllist_remove(
+        _wlmaker_server_binding_bucket(
+            server_ptr, key_binding_ptr->key_combo_ptr->keysym),
+        &key_binding_ptr->bucket_dlnode);
     bs_dllist_remove(&server_ptr->bindings, &key_binding_ptr->dlnode);
     free(key_binding_ptr);
 }
@@ -577,11 +641,13 @@ bool wlmaker_keyboard_process_bindings(
                keysym_name, keysym, modifiers);
     }
 
-    for (bs_dllist_node_t *dlnode_ptr = server_ptr->bindings.head_ptr;
+    // Only bindings from the keysym's bucket can match.
+    for (bs_dllist_node_t *dlnode_ptr = _wlmaker_server_binding_bucket(
+             server_ptr, keysym)->head_ptr;
          NULL != dlnode_ptr;
          dlnode_ptr = dlnode_ptr->next_ptr) {
         wlmaker_key_binding_t *key_binding_ptr = BS_CONTAINER_OF(
-            dlnode_ptr, wlmaker_key_binding_t, dlnode);
+            dlnode_ptr, wlmaker_key_binding_t, bucket_dlnode);
         const wlmaker_key_combo_t *key_combo_ptr =
             key_binding_ptr->key_combo_ptr;
 
@@ -603,6 +669,26 @@ bool wlmaker_keyboard_process_bindings(
 
 /* == Local (static) methods =============================================== */
 
+/* ------------------------------------------------------------------------- */
+/**
+ * Returns the bucket for `keysym` in @ref wlmaker_server_t::binding_buckets.
+ *
+ * Hashes by the lower-case keysym, so that both cases of a keysym land in
+ * the same bucket. This permits matching bindings with `ignore_case`.
+ *
+ * @param server_ptr
+ * @param keysym
+ *
+ * @return Pointer to the bucket's list.
+ */
+bs_dllist_t *_wlmaker_server_binding_bucket(
+    wlmaker_server_t *server_ptr,
+    xkb_keysym_t keysym)
+{
+    return &server_ptr->binding_buckets[
+        xkb_keysym_to_lower(keysym) % WLMAKER_SERVER_KEY_BINDING_BUCKETS];
+}
+
 /* ------------------------------------------------------------------------- */
 /**
  * Registers the input device at |handle_ptr| with |server_ptr|.
@@ -662,6 +748,11 @@ void handle_new_output(struct wl_listener *listener_ptr, void *data_ptr)
 
     wlmaker_server_output_add(server_ptr, output_ptr);
     bs_log(BS_INFO, "Server %p: Added output %p", server_ptr, output_ptr);
+
+    // Images are rendered for the output with the highest scale.
+    if (wlr_output_ptr->scale > wlmtk_env_scale(server_ptr->env_ptr)) {
+        wlmtk_env_set_scale(server_ptr->env_ptr, wlr_output_ptr->scale);
+    }
 }
 
 /* ------------------------------------------------------------------------- */
@@ -812,6 +903,59 @@ void _wlmaker_server_unclaimed_button_event_handler(
     }
 }
 
+/* ------------------------------------------------------------------------- */
+/**
+ * Enables the on-disk cache of scaled icons, if configured so in the
+ * 'IconCache' dict. Not fatal on failure: Icons are then decoded each time.
+ *
+ * @param server_ptr
+ */
+void _wlmaker_server_init_icon_cache(wlmaker_server_t *server_ptr)
+{
+    wlmcfg_dict_t *dict_ptr = wlmcfg_dict_get_dict(
+        server_ptr->config_dict_ptr, "IconCache");
+    if (NULL == dict_ptr) return;
+
+    wlmaker_server_icon_cache_config_t config = { 0 };
+    if (!wlmcfg_decode_dict(dict_ptr, _wlmaker_server_icon_cache_desc,
+                            &config)) {
+        bs_log(BS_WARNING, "Failed to decode 'IconCache' dict.");
+    } else if (config.enabled &&
+               !wlmtk_raster_cache_init(
+                   0 < strlen(config.directory_ptr) ?
+                   config.directory_ptr : NULL)) {
+        bs_log(BS_WARNING, "Failed to enable icon cache.");
+    }
+    wlmcfg_decoded_destroy(_wlmaker_server_icon_cache_desc, &config);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Creates the icon theme configured in the 'IconTheme' dict, or `hicolor`.
+ * Not fatal on failure: Icons are then only found by path.
+ *
+ * @param server_ptr
+ */
+void _wlmaker_server_init_icon_theme(wlmaker_server_t *server_ptr)
+{
+    wlmaker_server_icon_theme_config_t config = { 0 };
+    wlmcfg_dict_t *dict_ptr = wlmcfg_dict_get_dict(
+        server_ptr->config_dict_ptr, "IconTheme");
+    if (NULL != dict_ptr &&
+        !wlmcfg_decode_dict(dict_ptr, _wlmaker_server_icon_theme_desc,
+                            &config)) {
+        bs_log(BS_WARNING, "Failed to decode 'IconTheme' dict.");
+    }
+
+    server_ptr->icon_theme_ptr = wlmtk_icon_theme_create(
+        NULL != config.name_ptr ? config.name_ptr : "hicolor", NULL, NULL);
+    if (NULL == server_ptr->icon_theme_ptr) {
+        bs_log(BS_WARNING, "Failed to create icon theme.");
+    }
+    wlmtk_env_set_icon_theme(server_ptr->env_ptr, server_ptr->icon_theme_ptr);
+    wlmcfg_decoded_destroy(_wlmaker_server_icon_theme_desc, &config);
+}
+
 /* == Unit tests =========================================================== */
 
 static void test_bind(bs_test_t *test_ptr);
@@ -842,6 +986,10 @@ void test_bind(bs_test_t *test_ptr)
     wlmaker_key_combo_t      binding_b = {
         .keysym = XKB_KEY_b
     };
+    wlmaker_key_combo_t      binding_c = {
+        .keysym = XKB_KEY_q,
+        .ignore_case = true
+    };
 
     wlmaker_key_binding_t *kb1_ptr = wlmaker_server_bind_key(
         &srv, &binding_a, test_binding_callback);
@@ -849,6 +997,9 @@ void test_bind(bs_test_t *test_ptr)
     wlmaker_key_binding_t *kb2_ptr = wlmaker_server_bind_key(
         &srv, &binding_b, test_binding_callback);
         BS_TEST_VERIFY_NEQ(test_ptr, NULL, kb2_ptr);
+    wlmaker_key_binding_t *kb3_ptr = wlmaker_server_bind_key(
+        &srv, &binding_c, test_binding_callback);
+    BS_TEST_VERIFY_NEQ(test_ptr, NULL, kb3_ptr);
 
     // First binding. Ctrl-A, permitting other modifiers except Ctrl.
     BS_TEST_VERIFY_TRUE(
@@ -877,7 +1028,24 @@ void test_bind(bs_test_t *test_ptr)
     BS_TEST_VERIFY_FALSE(
         test_ptr,
         wlmaker_keyboard_process_bindings(&srv, XKB_KEY_B, 0));
+    // Same bucket as 'b', but must not match.
+    BS_TEST_VERIFY_FALSE(
+        test_ptr,
+        wlmaker_keyboard_process_bindings(
+            &srv, XKB_KEY_b + WLMAKER_SERVER_KEY_BINDING_BUCKETS, 0));
 
+    // Third binding: Bound as lower-case, ignoring case.
+    BS_TEST_VERIFY_TRUE(
+        test_ptr,
+        wlmaker_keyboard_process_bindings(&srv, XKB_KEY_Q, 0));
+    BS_TEST_VERIFY_TRUE(
+        test_ptr,
+        wlmaker_keyboard_process_bindings(&srv, XKB_KEY_q, 0));
+
+    wlmaker_server_unbind_key(&srv, kb3_ptr);
+    BS_TEST_VERIFY_FALSE(
+        test_ptr,
+        wlmaker_keyboard_process_bindings(&srv, XKB_KEY_q, 0));
     wlmaker_server_unbind_key(&srv, kb2_ptr);
     wlmaker_server_unbind_key(&srv, kb1_ptr);
 }
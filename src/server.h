@@ -54,6 +54,7 @@ typedef struct _wlmaker_key_binding_t wlmaker_key_binding_t;
  */
 typedef bool (*wlmaker_keybinding_callback_t)(const wlmaker_key_combo_t *kc);
 
+#include "app_index.h"
 #include "config.h"
 #include "corner.h"
 #include "cursor.h"
@@ -76,6 +77,9 @@ typedef bool (*wlmaker_keybinding_callback_t)(const wlmaker_key_combo_t *kc);
 extern "C" {
 #endif  // __cplusplus
 
+/** Number of buckets for hashing key bindings by their keysym. */
+#define WLMAKER_SERVER_KEY_BINDING_BUCKETS 64
+
 /** Options for the Wayland server. */
 typedef struct {
     /** Whether to start XWayland. */
@@ -163,6 +167,8 @@ struct _wlmaker_server_t {
 
     /** Toolkit environment. */
     wlmtk_env_t               *env_ptr;
+    /** Icon theme, to look up icons by name. */
+    wlmtk_icon_theme_t        *icon_theme_ptr;
 
     /** The root element. */
     wlmtk_root_t              *root_ptr;
@@ -175,6 +181,13 @@ struct _wlmaker_server_t {
 
     /** List of all bound keys, see @ref wlmaker_key_binding_t::dlnode. */
     bs_dllist_t               bindings;
+    /**
+     * Bound keys, hashed by the lower-case keysym. Each bucket holds the
+     * bindings in order of registration.
+     * See @ref wlmaker_key_binding_t::bucket_dlnode.
+     */
+    bs_dllist_t               binding_buckets[
+        WLMAKER_SERVER_KEY_BINDING_BUCKETS];
 
     /** Clients for this server. */
     bs_dllist_t               clients;
@@ -194,10 +207,14 @@ struct _wlmaker_server_t {
 
     /** Signal: Output dimensions changed. Parameter: struct wlr_box*. */
     struct wl_signal          output_layout_changed_event;
+    /** Signal: Launchers shall log their statistics. Parameter: NULL. */
+    struct wl_signal          launcher_stats_event;
 
     /** Temporary: Points to the @ref wlmtk_dock_t of the clip. */
     wlmtk_dock_t              *clip_dock_ptr;
 
+    /** Index of installed applications. Created when first needed. */
+    wlmaker_app_index_t       *app_index_ptr;
     /** Root menu, when active. NULL when not invoked. */
     wlmaker_root_menu_t       *root_menu_ptr;
     /** Listener for `unclaimed_button_event` signal raised by `wlmtk_root`. */
@@ -0,0 +1,225 @@
+/* ========================================================================= */
+/**
+ * @file submenu_item.c
+ *
+ * @copyright
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "submenu_item.h"
+
+/* == Declarations ========================================================= */
+
+/** State of a menu item that opens a submenu. */
+struct _wlmaker_submenu_item_t {
+    /** Superclass: a menu item. */
+    wlmtk_menu_item_t         super_menu_item;
+
+    /** Style of the submenu. */
+    const wlmtk_menu_style_t  *style_ptr;
+    /** The menu this item is added to. For positioning the submenu. */
+    wlmtk_menu_t              *menu_ptr;
+    /** Container to hold the submenu's popup. */
+    wlmtk_container_t         *popup_container_ptr;
+    /** Populates the submenu. */
+    wlmaker_submenu_item_populate_t populate;
+    /** Argument to @ref wlmaker_submenu_item_t::populate. */
+    void                      *ud_ptr;
+    /** Environment, for creating the submenu. */
+    wlmtk_env_t               *env_ptr;
+
+    /** The submenu, once created. Owned by `popup_container_ptr`. */
+    wlmtk_popup_menu_t        *popup_menu_ptr;
+};
+
+static void _wlmaker_submenu_item_element_destroy(
+    wlmtk_element_t *element_ptr);
+static void _wlmaker_submenu_item_clicked(
+    wlmtk_menu_item_t *menu_item_ptr);
+static bool _wlmaker_submenu_item_create_popup_menu(
+    wlmaker_submenu_item_t *submenu_item_ptr);
+static void _wlmaker_submenu_item_hide_popup(
+    bs_dllist_node_t *dlnode_ptr,
+    void *ud_ptr);
+
+/* == Data ================================================================= */
+
+/** Virtual method table for the submenu item. */
+static const wlmtk_menu_item_vmt_t _wlmaker_submenu_item_vmt = {
+    .clicked = _wlmaker_submenu_item_clicked
+};
+/** Virtual method table for the menu item's element superclass. */
+static const wlmtk_element_vmt_t _wlmaker_submenu_item_element_vmt = {
+    .destroy = _wlmaker_submenu_item_element_destroy
+};
+
+/* == Exported methods ===================================================== */
+
+/* ------------------------------------------------------------------------- */
+wlmaker_submenu_item_t *wlmaker_submenu_item_create(
+    const char *text_ptr,
+    const wlmtk_menu_style_t *style_ptr,
+    wlmtk_menu_t *menu_ptr,
+    wlmtk_container_t *popup_container_ptr,
+    wlmaker_submenu_item_populate_t populate,
+    void *ud_ptr,
+    wlmtk_env_t *env_ptr)
+{
+    wlmaker_submenu_item_t *submenu_item_ptr = logged_calloc(
+        1, sizeof(wlmaker_submenu_item_t));
+    if (NULL == submenu_item_ptr) return NULL;
+    submenu_item_ptr->style_ptr = style_ptr;
+    submenu_item_ptr->menu_ptr = menu_ptr;
+    submenu_item_ptr->popup_container_ptr = popup_container_ptr;
+    submenu_item_ptr->populate = populate;
+    submenu_item_ptr->ud_ptr = ud_ptr;
+    submenu_item_ptr->env_ptr = env_ptr;
+
+    if (!wlmtk_menu_item_init(
+            &submenu_item_ptr->super_menu_item,
+            &style_ptr->item,
+            env_ptr)) {
+        wlmaker_submenu_item_destroy(submenu_item_ptr);
+        return NULL;
+    }
+    wlmtk_menu_item_extend(
+        &submenu_item_ptr->super_menu_item,
+        &_wlmaker_submenu_item_vmt);
+    wlmtk_element_extend(
+        wlmtk_menu_item_element(&submenu_item_ptr->super_menu_item),
+        &_wlmaker_submenu_item_element_vmt);
+
+    if (!wlmtk_menu_item_set_text(
+            &submenu_item_ptr->super_menu_item,
+            text_ptr)) {
+        wlmaker_submenu_item_destroy(submenu_item_ptr);
+        return NULL;
+    }
+
+    return submenu_item_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmaker_submenu_item_destroy(wlmaker_submenu_item_t *submenu_item_ptr)
+{
+    // The popup menu is owned by the popup container, which is finalized
+    // before the menu holding this item.
+    submenu_item_ptr->popup_menu_ptr = NULL;
+
+    wlmtk_menu_item_fini(&submenu_item_ptr->super_menu_item);
+    free(submenu_item_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+wlmtk_menu_item_t *wlmaker_submenu_item_menu_item(
+    wlmaker_submenu_item_t *submenu_item_ptr)
+{
+    return &submenu_item_ptr->super_menu_item;
+}
+
+/* == Local (static) methods =============================================== */
+
+/* ------------------------------------------------------------------------- */
+/** Implements @ref wlmtk_element_vmt_t::destroy. Routes to instance's dtor. */
+void _wlmaker_submenu_item_element_destroy(
+    wlmtk_element_t *element_ptr)
+{
+    wlmaker_submenu_item_t *submenu_item_ptr = BS_CONTAINER_OF(
+        element_ptr, wlmaker_submenu_item_t,
+        super_menu_item.super_buffer.super_element);
+    wlmaker_submenu_item_destroy(submenu_item_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Implements @ref wlmtk_menu_item_vmt_t::clicked. Creates the submenu, if
+ * not done yet, and toggles its visibility. Other submenus in the same
+ * popup container get hidden.
+ */
+void _wlmaker_submenu_item_clicked(wlmtk_menu_item_t *menu_item_ptr)
+{
+    wlmaker_submenu_item_t *submenu_item_ptr = BS_CONTAINER_OF(
+        menu_item_ptr, wlmaker_submenu_item_t, super_menu_item);
+
+    if (NULL == submenu_item_ptr->popup_menu_ptr &&
+        !_wlmaker_submenu_item_create_popup_menu(submenu_item_ptr)) return;
+    wlmtk_element_t *element_ptr = wlmtk_popup_element(
+        wlmtk_popup_menu_popup(submenu_item_ptr->popup_menu_ptr));
+    bool visible = !element_ptr->visible;
+
+    bs_dllist_for_each(
+        &submenu_item_ptr->popup_container_ptr->elements,
+        _wlmaker_submenu_item_hide_popup,
+        NULL);
+    if (!visible) return;
+
+    // Places the submenu right of the menu, aligned with this item.
+    struct wlr_box box = wlmtk_element_get_dimensions_box(
+        wlmtk_menu_element(submenu_item_ptr->menu_ptr));
+    int y;
+    wlmtk_element_get_position(
+        wlmtk_menu_item_element(menu_item_ptr), NULL, &y);
+    wlmtk_element_set_position(element_ptr, box.x + box.width, y);
+
+    wlmtk_menu_set_mode(
+        wlmtk_popup_menu_menu(submenu_item_ptr->popup_menu_ptr),
+        submenu_item_ptr->menu_ptr->mode);
+    wlmtk_container_raise_element_to_top(
+        submenu_item_ptr->popup_container_ptr, element_ptr);
+    wlmtk_element_set_visible(element_ptr, true);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Creates the submenu, populates it and adds it to the popup container.
+ *
+ * @param submenu_item_ptr
+ *
+ * @return true on success.
+ */
+bool _wlmaker_submenu_item_create_popup_menu(
+    wlmaker_submenu_item_t *submenu_item_ptr)
+{
+    wlmtk_popup_menu_t *popup_menu_ptr = wlmtk_popup_menu_create(
+        submenu_item_ptr->style_ptr,
+        submenu_item_ptr->env_ptr);
+    if (NULL == popup_menu_ptr) return false;
+
+    if (!submenu_item_ptr->populate(
+            popup_menu_ptr,
+            submenu_item_ptr->ud_ptr)) {
+        wlmtk_popup_menu_destroy(popup_menu_ptr);
+        return false;
+    }
+
+    wlmtk_element_set_visible(
+        wlmtk_popup_element(wlmtk_popup_menu_popup(popup_menu_ptr)), false);
+    wlmtk_container_add_element(
+        submenu_item_ptr->popup_container_ptr,
+        wlmtk_popup_element(wlmtk_popup_menu_popup(popup_menu_ptr)));
+    submenu_item_ptr->popup_menu_ptr = popup_menu_ptr;
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Callback for bs_dllist_for_each: Hides the element at `dlnode_ptr`. */
+void _wlmaker_submenu_item_hide_popup(
+    bs_dllist_node_t *dlnode_ptr,
+    __UNUSED__ void *ud_ptr)
+{
+    wlmtk_element_set_visible(wlmtk_element_from_dlnode(dlnode_ptr), false);
+}
+
+/* == End of submenu_item.c ================================================ */
@@ -0,0 +1,92 @@
+/* ========================================================================= */
+/**
+ * @file submenu_item.h
+ *
+ * @copyright
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __WLMAKER_SUBMENU_ITEM_H__
+#define __WLMAKER_SUBMENU_ITEM_H__
+
+/** Forward declaration: A menu item that opens a submenu. */
+typedef struct _wlmaker_submenu_item_t wlmaker_submenu_item_t;
+
+#include "toolkit/toolkit.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+/**
+ * Populates the submenu. Called once, when the submenu is first opened.
+ *
+ * @param popup_menu_ptr      The submenu, initially empty. Its popup
+ *                            container may hold further submenus.
+ * @param ud_ptr
+ *
+ * @return true on success.
+ */
+typedef bool (*wlmaker_submenu_item_populate_t)(
+    wlmtk_popup_menu_t *popup_menu_ptr,
+    void *ud_ptr);
+
+/**
+ * Creates a menu item that opens a submenu, right of the menu it is in.
+ *
+ * The submenu is created and populated only when the item is first clicked,
+ * and is added as a popup to `popup_container_ptr`. It is then owned by that
+ * container, and destroyed with it. Clicking the item again toggles the
+ * submenu's visibility.
+ *
+ * @param text_ptr
+ * @param style_ptr           Style of the submenu. Its item style is used
+ *                            for this item, too.
+ * @param menu_ptr            The menu this item is added to.
+ * @param popup_container_ptr Container to hold the submenu's popup. Must be
+ *                            positioned at the origin of `menu_ptr`. It
+ *                            may be uninitialized until the item is clicked.
+ * @param populate
+ * @param ud_ptr              Argument to `populate`.
+ * @param env_ptr
+ *
+ * @return Pointer to the menu item's handle or NULL on error.
+ */
+wlmaker_submenu_item_t *wlmaker_submenu_item_create(
+    const char *text_ptr,
+    const wlmtk_menu_style_t *style_ptr,
+    wlmtk_menu_t *menu_ptr,
+    wlmtk_container_t *popup_container_ptr,
+    wlmaker_submenu_item_populate_t populate,
+    void *ud_ptr,
+    wlmtk_env_t *env_ptr);
+
+/**
+ * Destroys the submenu item. Does not destroy the submenu, which is owned by
+ * the popup container.
+ *
+ * @param submenu_item_ptr
+ */
+void wlmaker_submenu_item_destroy(wlmaker_submenu_item_t *submenu_item_ptr);
+
+/** @returns pointer to the superclass @ref wlmtk_menu_item_t. */
+wlmtk_menu_item_t *wlmaker_submenu_item_menu_item(
+    wlmaker_submenu_item_t *submenu_item_ptr);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif /* __WLMAKER_SUBMENU_ITEM_H__ */
+/* == End of submenu_item.h ================================================ */
@@ -22,16 +22,40 @@
 
 #include "toolkit/toolkit.h"
 
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <poll.h>
 #include <signal.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <time.h>
 #include <unistd.h>
 
 /* == Declarations ========================================================= */
 
+/** How many parent processes to follow when resolving a window's client. */
+#define WLMAKER_SUBPROCESS_MAX_ANCESTORS 8
+
+/** Size of the ring buffer for @ref WLMAKER_SUBPROCESS_OUTPUT_BUFFER. */
+#define WLMAKER_SUBPROCESS_OUTPUT_BUFFER_SIZE 16384
+/** Bytes per second kept in the ring buffer. Any excess gets dropped. */
+#define WLMAKER_SUBPROCESS_OUTPUT_RATE_LIMIT 4096
+/** Bytes to read per wakeup, for output that is not logged. */
+#define WLMAKER_SUBPROCESS_OUTPUT_READ_SIZE 16384
+/** Maximum number of reads when draining output of a terminated process. */
+#define WLMAKER_SUBPROCESS_DRAIN_MAX_READS 16
+
 /** State of the subprocess monitor. */
 struct _wlmaker_subprocess_monitor_t {
     /** Reference to the event loop. */
     struct wl_event_loop      *wl_event_loop_ptr;
-    /** Event source used for monitoring SIGCHLD. */
+    /**
+     * Event source used for monitoring SIGCHLD. Only relevant for
+     * subprocesses that could not be tracked through a pidfd.
+     */
     struct wl_event_source    *sigchld_event_source_ptr;
 
     /** Listener: Receives a signal whenever a window is created. */
@@ -45,6 +69,10 @@ struct _wlmaker_subprocess_monitor_t {
 
     /** Monitored subprocesses. */
     bs_dllist_t               subprocesses;
+    /** Subprocesses not yet ceded, by PID. */
+    bs_avltree_t              *pid_tree_ptr;
+    /** Subprocesses in the PID tree that also match their descendants. */
+    unsigned                  match_descendants_count;
     /** Windows for monitored subprocesses. */
     bs_avltree_t              *window_tree_ptr;
 };
@@ -53,8 +81,33 @@ struct _wlmaker_subprocess_monitor_t {
 struct _wlmaker_subprocess_handle_t {
     /** Element of @ref wlmaker_subprocess_monitor_t `subprocesses`. */
     bs_dllist_node_t          dlnode;
-    /** Points to the subprocess. */
+    /** Points to the subprocess. NULL, if entrusted by PID. */
     bs_subprocess_t           *subprocess_ptr;
+    /** Element of @ref wlmaker_subprocess_monitor_t::pid_tree_ptr. */
+    bs_avltree_node_t         avlnode;
+    /** PID of the subprocess. Also the key for the PID tree. */
+    pid_t                     pid;
+    /** Whether the handle is in the PID tree. */
+    bool                      in_pid_tree;
+    /** Whether windows of the subprocess' descendants map to it, too. */
+    bool                      match_descendants;
+    /** Back-link to the monitor. */
+    wlmaker_subprocess_monitor_t *monitor_ptr;
+    /**
+     * Whether the subprocess was reaped, when entrusted by PID. Or found to
+     * have exited without being reapable by us, in which case the exit
+     * status is @ref WLMAKER_SUBPROCESS_EXIT_STATUS_UNKNOWN.
+     */
+    bool                      terminated;
+    /** Exit status, once @ref wlmaker_subprocess_handle_t::terminated. */
+    int                       exit_status;
+    /** Signal number, once @ref wlmaker_subprocess_handle_t::terminated. */
+    int                       signal_number;
+
+    /** Process file descriptor, readable once the subprocess exits. Or -1. */
+    int                       pidfd;
+    /** Event source for @ref wlmaker_subprocess_handle_t::pidfd. */
+    struct wl_event_source    *pidfd_wl_event_source_ptr;
 
     /** File descriptor of the subprocess' stdout. */
     int                       stdout_read_fd;
@@ -65,6 +118,23 @@ struct _wlmaker_subprocess_handle_t {
     /** Event source corresponding to events related to reading stderr. */
     struct wl_event_source    *stderr_wl_event_source_ptr;
 
+    /** Where stdout and stderr get routed to. */
+    wlmaker_subprocess_output_t output;
+    /** File to append to, for @ref WLMAKER_SUBPROCESS_OUTPUT_FILE. Or -1. */
+    int                       output_fd;
+    /** Ring buffer for @ref WLMAKER_SUBPROCESS_OUTPUT_BUFFER. Or NULL. */
+    char                      *ring_ptr;
+    /** Position in @ref wlmaker_subprocess_handle_t::ring_ptr to write to. */
+    size_t                    ring_pos;
+    /** Number of bytes held in @ref wlmaker_subprocess_handle_t::ring_ptr. */
+    size_t                    ring_fill;
+    /** Second of the current rate limiting period. */
+    time_t                    rate_period;
+    /** Bytes kept in the current rate limiting period. */
+    size_t                    rate_bytes;
+    /** Bytes dropped due to the rate limit. */
+    size_t                    dropped_bytes;
+
     /** Callback:  The subprocess was terminated. */
     wlmaker_subprocess_terminated_callback_t terminated_callback;
     /** Argument to all the callbacks. */
@@ -98,11 +168,29 @@ typedef struct {
     bool                      mapped;
 } wlmaker_subprocess_window_t;
 
+static wlmaker_subprocess_handle_t *_wlmaker_subprocess_monitor_entrust(
+    wlmaker_subprocess_monitor_t *monitor_ptr,
+    wlmaker_subprocess_handle_t *subprocess_handle_ptr,
+    wlmaker_subprocess_terminated_callback_t terminated_callback,
+    void *userdata_ptr,
+    wlmaker_subprocess_window_callback_t window_created_callback,
+    wlmaker_subprocess_window_callback_t window_mapped_callback,
+    wlmaker_subprocess_window_callback_t window_unmapped_callback,
+    wlmaker_subprocess_window_callback_t window_destroyed_callback);
 static wlmaker_subprocess_handle_t *wlmaker_subprocess_handle_create(
     bs_subprocess_t *subprocess_ptr,
+    pid_t pid,
+    int stdout_read_fd,
+    int stderr_read_fd,
     struct wl_event_loop *wl_event_loop_ptr);
 static void wlmaker_subprocess_handle_destroy(
     wlmaker_subprocess_handle_t *sp_handle_ptr);
+static bool _wlmaker_subprocess_handle_terminated(
+    wlmaker_subprocess_handle_t *subprocess_handle_ptr,
+    int *exit_status_ptr,
+    int *signal_number_ptr);
+static void _wlmaker_subprocess_handle_set_exited(
+    wlmaker_subprocess_handle_t *subprocess_handle_ptr);
 static int _wlmaker_subprocess_monitor_handle_read_stdout(
     int fd, uint32_t mask, void *data_ptr);
 static int _wlmaker_subprocess_monitor_handle_read_stderr(
@@ -114,8 +202,31 @@ static int _wlmaker_subprocess_monitor_process_fd(
     int fd,
     uint32_t mask,
     const char *fd_name_ptr);
+static void _wlmaker_subprocess_handle_drain_fd(
+    wlmaker_subprocess_handle_t *subprocess_handle_ptr,
+    struct wl_event_source **wl_event_source_ptr_ptr,
+    int fd,
+    const char *fd_name_ptr);
+static void _wlmaker_subprocess_handle_route_output(
+    wlmaker_subprocess_handle_t *subprocess_handle_ptr,
+    const char *data_ptr,
+    size_t size);
+static void _wlmaker_subprocess_handle_ring_append(
+    wlmaker_subprocess_handle_t *subprocess_handle_ptr,
+    const char *data_ptr,
+    size_t size);
 
 static int _wlmaker_subprocess_monitor_handle_sigchld(int signum, void *data_ptr);
+static void _wlmaker_subprocess_monitor_watch_pidfd(
+    wlmaker_subprocess_monitor_t *monitor_ptr,
+    wlmaker_subprocess_handle_t *subprocess_handle_ptr);
+static void _wlmaker_subprocess_handle_unwatch_pidfd(
+    wlmaker_subprocess_handle_t *subprocess_handle_ptr);
+static int _wlmaker_subprocess_monitor_handle_pidfd(
+    int fd, uint32_t mask, void *data_ptr);
+static bool _wlmaker_subprocess_monitor_reap(
+    wlmaker_subprocess_monitor_t *monitor_ptr,
+    wlmaker_subprocess_handle_t *subprocess_handle_ptr);
 
 static void _wlmaker_subprocess_monitor_handle_window_created(
     struct wl_listener *listener_ptr,
@@ -133,6 +244,16 @@ static void _wlmaker_subprocess_monitor_handle_window_destroyed(
 static wlmaker_subprocess_handle_t *subprocess_handle_from_window(
     wlmaker_subprocess_monitor_t *monitor_ptr,
     wlmtk_window_t *window_ptr);
+static wlmaker_subprocess_handle_t *_wlmaker_subprocess_monitor_lookup_pid(
+    wlmaker_subprocess_monitor_t *monitor_ptr,
+    pid_t pid);
+static void _wlmaker_subprocess_monitor_unindex(
+    wlmaker_subprocess_monitor_t *monitor_ptr,
+    wlmaker_subprocess_handle_t *subprocess_handle_ptr);
+static pid_t _wlmaker_subprocess_parent_pid(pid_t pid);
+static int _wlmaker_subprocess_handle_node_cmp(
+    const bs_avltree_node_t *node_ptr,
+    const void *key_ptr);
 
 static wlmaker_subprocess_window_t *wlmaker_subprocess_window_create(
     wlmtk_window_t *window_ptr,
@@ -156,6 +277,16 @@ wlmaker_subprocess_monitor_t* wlmaker_subprocess_monitor_create(
         1, sizeof(wlmaker_subprocess_monitor_t));
     if (NULL == monitor_ptr) return NULL;
 
+    // Handles are owned by `subprocesses`, the PID tree just indexes them.
+    monitor_ptr->pid_tree_ptr = bs_avltree_create(
+        _wlmaker_subprocess_handle_node_cmp, NULL);
+    if (NULL == monitor_ptr->pid_tree_ptr) {
+        bs_log(BS_ERROR, "Failed bs_avltree_create(%p, NULL)",
+               _wlmaker_subprocess_handle_node_cmp);
+        wlmaker_subprocess_monitor_destroy(monitor_ptr);
+        return NULL;
+    }
+
     monitor_ptr->window_tree_ptr = bs_avltree_create(
         wlmaker_subprocess_window_node_cmp,
         wlmaker_subprocess_window_node_destroy);
@@ -219,6 +350,10 @@ void wlmaker_subprocess_monitor_destroy(
         bs_avltree_destroy(monitor_ptr->window_tree_ptr);
         monitor_ptr->window_tree_ptr = NULL;
     }
+    if (NULL != monitor_ptr->pid_tree_ptr) {
+        bs_avltree_destroy(monitor_ptr->pid_tree_ptr);
+        monitor_ptr->pid_tree_ptr = NULL;
+    }
 
     monitor_ptr->wl_event_loop_ptr = NULL;
     free(monitor_ptr);
@@ -235,29 +370,66 @@ wlmaker_subprocess_handle_t *wlmaker_subprocess_monitor_entrust(
     wlmaker_subprocess_window_callback_t window_unmapped_callback,
     wlmaker_subprocess_window_callback_t window_destroyed_callback)
 {
-    wlmaker_subprocess_handle_t *subprocess_handle_ptr =
-        wlmaker_subprocess_handle_create(
-            subprocess_ptr, monitor_ptr->wl_event_loop_ptr);
-    if (NULL == subprocess_handle_ptr) return NULL;
-    bs_dllist_push_back(&monitor_ptr->subprocesses,
-                        &subprocess_handle_ptr->dlnode);
+    int stdout_read_fd, stderr_read_fd;
+    bs_subprocess_get_fds(
+        subprocess_ptr,
+        NULL,  // no interest in stdin.
+        &stdout_read_fd,
+        &stderr_read_fd);
 
-    subprocess_handle_ptr->terminated_callback = terminated_callback;
-    subprocess_handle_ptr->userdata_ptr = userdata_ptr;
-    subprocess_handle_ptr->window_created_callback = window_created_callback;
-    subprocess_handle_ptr->window_mapped_callback = window_mapped_callback;
-    subprocess_handle_ptr->window_unmapped_callback = window_unmapped_callback;
-    subprocess_handle_ptr->window_destroyed_callback =
-        window_destroyed_callback;
+    return _wlmaker_subprocess_monitor_entrust(
+        monitor_ptr,
+        wlmaker_subprocess_handle_create(
+            subprocess_ptr,
+            bs_subprocess_pid(subprocess_ptr),
+            stdout_read_fd,
+            stderr_read_fd,
+            monitor_ptr->wl_event_loop_ptr),
+        terminated_callback,
+        userdata_ptr,
+        window_created_callback,
+        window_mapped_callback,
+        window_unmapped_callback,
+        window_destroyed_callback);
+}
 
-    return subprocess_handle_ptr;
+/* ------------------------------------------------------------------------- */
+wlmaker_subprocess_handle_t *wlmaker_subprocess_monitor_entrust_pid(
+    wlmaker_subprocess_monitor_t *monitor_ptr,
+    pid_t pid,
+    int stdout_read_fd,
+    int stderr_read_fd,
+    wlmaker_subprocess_terminated_callback_t terminated_callback,
+    void *userdata_ptr,
+    wlmaker_subprocess_window_callback_t window_created_callback,
+    wlmaker_subprocess_window_callback_t window_mapped_callback,
+    wlmaker_subprocess_window_callback_t window_unmapped_callback,
+    wlmaker_subprocess_window_callback_t window_destroyed_callback)
+{
+    return _wlmaker_subprocess_monitor_entrust(
+        monitor_ptr,
+        wlmaker_subprocess_handle_create(
+            NULL,
+            pid,
+            stdout_read_fd,
+            stderr_read_fd,
+            monitor_ptr->wl_event_loop_ptr),
+        terminated_callback,
+        userdata_ptr,
+        window_created_callback,
+        window_mapped_callback,
+        window_unmapped_callback,
+        window_destroyed_callback);
 }
 
 /* ------------------------------------------------------------------------- */
 void wlmaker_subprocess_monitor_cede(
-    __UNUSED__ wlmaker_subprocess_monitor_t *monitor_ptr,
+    wlmaker_subprocess_monitor_t *monitor_ptr,
     wlmaker_subprocess_handle_t *subprocess_handle_ptr)
 {
+    // Ceded subprocesses will not be matched to windows anymore.
+    _wlmaker_subprocess_monitor_unindex(monitor_ptr, subprocess_handle_ptr);
+
     bs_dllist_node_t *dlnode_ptr;
     while (NULL != (dlnode_ptr = bs_dllist_pop_front(
                         &subprocess_handle_ptr->windows))) {
@@ -293,19 +465,159 @@ bs_subprocess_t *wlmaker_subprocess_from_subprocess_handle(
     return subprocess_handle_ptr->subprocess_ptr;
 }
 
+/* ------------------------------------------------------------------------- */
+void wlmaker_subprocess_set_match_descendants(
+    wlmaker_subprocess_handle_t *subprocess_handle_ptr,
+    bool match_descendants)
+{
+    if (subprocess_handle_ptr->match_descendants == match_descendants) return;
+    subprocess_handle_ptr->match_descendants = match_descendants;
+    if (!subprocess_handle_ptr->in_pid_tree) return;
+
+    if (match_descendants) {
+        ++subprocess_handle_ptr->monitor_ptr->match_descendants_count;
+    } else {
+        BS_ASSERT(0 < subprocess_handle_ptr->monitor_ptr->
+                  match_descendants_count);
+        --subprocess_handle_ptr->monitor_ptr->match_descendants_count;
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+bool wlmaker_subprocess_set_output(
+    wlmaker_subprocess_handle_t *subprocess_handle_ptr,
+    wlmaker_subprocess_output_t output,
+    const char *path_ptr)
+{
+    int fd = -1;
+    char *ring_ptr = NULL;
+
+    switch (output) {
+    case WLMAKER_SUBPROCESS_OUTPUT_FILE:
+        fd = open(path_ptr, O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, 0600);
+        if (0 > fd) {
+            bs_log(BS_WARNING | BS_ERRNO,
+                   "Failed open(\"%s\", O_WRONLY | O_APPEND | O_CREAT | "
+                   "O_CLOEXEC, 0600)", path_ptr);
+            return false;
+        }
+        break;
+    case WLMAKER_SUBPROCESS_OUTPUT_BUFFER:
+        ring_ptr = logged_calloc(1, WLMAKER_SUBPROCESS_OUTPUT_BUFFER_SIZE);
+        if (NULL == ring_ptr) return false;
+        break;
+    default:
+        break;
+    }
+
+    if (0 <= subprocess_handle_ptr->output_fd) {
+        close(subprocess_handle_ptr->output_fd);
+    }
+    subprocess_handle_ptr->output_fd = fd;
+    if (NULL != subprocess_handle_ptr->ring_ptr) {
+        free(subprocess_handle_ptr->ring_ptr);
+    }
+    subprocess_handle_ptr->ring_ptr = ring_ptr;
+    subprocess_handle_ptr->ring_pos = 0;
+    subprocess_handle_ptr->ring_fill = 0;
+    subprocess_handle_ptr->output = output;
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+size_t wlmaker_subprocess_get_output(
+    wlmaker_subprocess_handle_t *subprocess_handle_ptr,
+    char *buf_ptr,
+    size_t buf_size)
+{
+    BS_ASSERT(0 < buf_size);
+    size_t size = BS_MIN(subprocess_handle_ptr->ring_fill, buf_size - 1);
+
+    // Start of the most recent `size` bytes, then copy in up to two parts.
+    size_t start = (subprocess_handle_ptr->ring_pos +
+                    WLMAKER_SUBPROCESS_OUTPUT_BUFFER_SIZE - size) %
+        WLMAKER_SUBPROCESS_OUTPUT_BUFFER_SIZE;
+    size_t first = BS_MIN(size, WLMAKER_SUBPROCESS_OUTPUT_BUFFER_SIZE - start);
+    if (0 < size) {
+        memcpy(buf_ptr, subprocess_handle_ptr->ring_ptr + start, first);
+        memcpy(buf_ptr + first, subprocess_handle_ptr->ring_ptr, size - first);
+    }
+    buf_ptr[size] = '\0';
+    return size;
+}
+
 /* == Local (static) methods =============================================== */
 
 /* ------------------------------------------------------------------------- */
 /**
- * Creates a @ref wlmaker_subprocess_handle_t and connects to subprocess_ptr.
+ * Registers the created handle with the monitor, and sets the callbacks.
+ *
+ * @param monitor_ptr
+ * @param subprocess_handle_ptr May be NULL, if creating the handle failed.
+ * @param terminated_callback
+ * @param userdata_ptr
+ * @param window_created_callback
+ * @param window_mapped_callback
+ * @param window_unmapped_callback
+ * @param window_destroyed_callback
  *
- * @param subprocess_ptr
+ * @return `subprocess_handle_ptr`.
+ */
+wlmaker_subprocess_handle_t *_wlmaker_subprocess_monitor_entrust(
+    wlmaker_subprocess_monitor_t *monitor_ptr,
+    wlmaker_subprocess_handle_t *subprocess_handle_ptr,
+    wlmaker_subprocess_terminated_callback_t terminated_callback,
+    void *userdata_ptr,
+    wlmaker_subprocess_window_callback_t window_created_callback,
+    wlmaker_subprocess_window_callback_t window_mapped_callback,
+    wlmaker_subprocess_window_callback_t window_unmapped_callback,
+    wlmaker_subprocess_window_callback_t window_destroyed_callback)
+{
+    if (NULL == subprocess_handle_ptr) return NULL;
+    bs_dllist_push_back(&monitor_ptr->subprocesses,
+                        &subprocess_handle_ptr->dlnode);
+    subprocess_handle_ptr->in_pid_tree = bs_avltree_insert(
+        monitor_ptr->pid_tree_ptr,
+        &subprocess_handle_ptr->pid,
+        &subprocess_handle_ptr->avlnode,
+        false);
+    if (!subprocess_handle_ptr->in_pid_tree) {
+        bs_log(BS_WARNING, "Subprocess %p: PID %"PRIdMAX" already monitored.",
+               subprocess_handle_ptr->subprocess_ptr,
+               (intmax_t)subprocess_handle_ptr->pid);
+    }
+    _wlmaker_subprocess_monitor_watch_pidfd(
+        monitor_ptr, subprocess_handle_ptr);
+
+    subprocess_handle_ptr->terminated_callback = terminated_callback;
+    subprocess_handle_ptr->userdata_ptr = userdata_ptr;
+    subprocess_handle_ptr->window_created_callback = window_created_callback;
+    subprocess_handle_ptr->window_mapped_callback = window_mapped_callback;
+    subprocess_handle_ptr->window_unmapped_callback = window_unmapped_callback;
+    subprocess_handle_ptr->window_destroyed_callback =
+        window_destroyed_callback;
+
+    return subprocess_handle_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Creates a @ref wlmaker_subprocess_handle_t and connects to the subprocess'
+ * stdout and stderr.
+ *
+ * @param subprocess_ptr      The subprocess, or NULL if entrusted by PID.
+ * @param pid
+ * @param stdout_read_fd      Read end of the stdout pipe, or -1.
+ * @param stderr_read_fd      Read end of the stderr pipe, or -1.
  * @param wl_event_loop_ptr
  *
  * @return The subprocess handle or NULL on error.
  */
 wlmaker_subprocess_handle_t *wlmaker_subprocess_handle_create(
     bs_subprocess_t *subprocess_ptr,
+    pid_t pid,
+    int stdout_read_fd,
+    int stderr_read_fd,
     struct wl_event_loop *wl_event_loop_ptr)
 {
     wlmaker_subprocess_handle_t *subprocess_handle_ptr = logged_calloc(
@@ -313,25 +625,30 @@ wlmaker_subprocess_handle_t *wlmaker_subprocess_handle_create(
     if (NULL == subprocess_handle_ptr) return NULL;
 
     subprocess_handle_ptr->subprocess_ptr = subprocess_ptr;
-
-    bs_subprocess_get_fds(
-        subprocess_ptr,
-        NULL,  // no interest in stdin.
-        &subprocess_handle_ptr->stdout_read_fd,
-        &subprocess_handle_ptr->stderr_read_fd);
-
-    subprocess_handle_ptr->stdout_wl_event_source_ptr = wl_event_loop_add_fd(
-        wl_event_loop_ptr,
-        subprocess_handle_ptr->stdout_read_fd,
-        WL_EVENT_READABLE,
-        _wlmaker_subprocess_monitor_handle_read_stdout,
-        subprocess_handle_ptr);
-    subprocess_handle_ptr->stderr_wl_event_source_ptr = wl_event_loop_add_fd(
-        wl_event_loop_ptr,
-        subprocess_handle_ptr->stderr_read_fd,
-        WL_EVENT_READABLE,
-        _wlmaker_subprocess_monitor_handle_read_stderr,
-        subprocess_handle_ptr);
+    subprocess_handle_ptr->pid = pid;
+    subprocess_handle_ptr->pidfd = -1;
+    subprocess_handle_ptr->output_fd = -1;
+    subprocess_handle_ptr->stdout_read_fd = stdout_read_fd;
+    subprocess_handle_ptr->stderr_read_fd = stderr_read_fd;
+
+    if (0 <= stdout_read_fd) {
+        subprocess_handle_ptr->stdout_wl_event_source_ptr =
+            wl_event_loop_add_fd(
+                wl_event_loop_ptr,
+                stdout_read_fd,
+                WL_EVENT_READABLE,
+                _wlmaker_subprocess_monitor_handle_read_stdout,
+                subprocess_handle_ptr);
+    }
+    if (0 <= stderr_read_fd) {
+        subprocess_handle_ptr->stderr_wl_event_source_ptr =
+            wl_event_loop_add_fd(
+                wl_event_loop_ptr,
+                stderr_read_fd,
+                WL_EVENT_READABLE,
+                _wlmaker_subprocess_monitor_handle_read_stderr,
+                subprocess_handle_ptr);
+    }
 
     return subprocess_handle_ptr;
 }
@@ -347,12 +664,12 @@ void wlmaker_subprocess_handle_destroy(
 {
     BS_ASSERT(NULL == sp_handle_ptr->dlnode.prev_ptr);
     int exit_status, signal_number;
-    if (!bs_subprocess_terminated(
-            sp_handle_ptr->subprocess_ptr, &exit_status, &signal_number)) {
+    if (!_wlmaker_subprocess_handle_terminated(
+            sp_handle_ptr, &exit_status, &signal_number)) {
         bs_log(BS_FATAL, "Destroying subprocess handle, but still running: "
                "subprocess %p (pid: %"PRIdMAX")",
                sp_handle_ptr->subprocess_ptr,
-               (intmax_t)bs_subprocess_pid(sp_handle_ptr->subprocess_ptr));
+               (intmax_t)sp_handle_ptr->pid);
     }
     bs_log(BS_DEBUG, "Terminated subprocess %p. Status %d, signal %d.",
            sp_handle_ptr->subprocess_ptr, exit_status, signal_number);
@@ -366,10 +683,22 @@ void wlmaker_subprocess_handle_destroy(
         sp_handle_ptr->terminated_callback = NULL;
     }
 
+    _wlmaker_subprocess_handle_unwatch_pidfd(sp_handle_ptr);
+
     if (NULL != sp_handle_ptr->subprocess_ptr) {
         bs_subprocess_destroy(sp_handle_ptr->subprocess_ptr);
         sp_handle_ptr->subprocess_ptr = NULL;
+    } else {
+        // Entrusted by PID: The pipes are ours to close.
+        if (0 <= sp_handle_ptr->stdout_read_fd) {
+            close(sp_handle_ptr->stdout_read_fd);
+        }
+        if (0 <= sp_handle_ptr->stderr_read_fd) {
+            close(sp_handle_ptr->stderr_read_fd);
+        }
     }
+    sp_handle_ptr->stdout_read_fd = -1;
+    sp_handle_ptr->stderr_read_fd = -1;
 
     if (NULL != sp_handle_ptr->stdout_wl_event_source_ptr) {
         wl_event_source_remove(sp_handle_ptr->stdout_wl_event_source_ptr);
@@ -379,9 +708,88 @@ void wlmaker_subprocess_handle_destroy(
         wl_event_source_remove(sp_handle_ptr->stderr_wl_event_source_ptr);
         sp_handle_ptr->stderr_wl_event_source_ptr = NULL;
     }
+
+    if (0 < sp_handle_ptr->dropped_bytes) {
+        bs_log(BS_DEBUG, "Subprocess %"PRIdMAX": Dropped %zu bytes of output.",
+               (intmax_t)sp_handle_ptr->pid, sp_handle_ptr->dropped_bytes);
+    }
+    if (0 <= sp_handle_ptr->output_fd) {
+        close(sp_handle_ptr->output_fd);
+        sp_handle_ptr->output_fd = -1;
+    }
+    if (NULL != sp_handle_ptr->ring_ptr) {
+        free(sp_handle_ptr->ring_ptr);
+        sp_handle_ptr->ring_ptr = NULL;
+    }
     free(sp_handle_ptr);
 }
 
+/* ------------------------------------------------------------------------- */
+/**
+ * Checks whether the subprocess has terminated, and reaps it if so.
+ *
+ * A subprocess entrusted by PID, that is no child of ours anymore (ECHILD),
+ * was reaped by someone else. It is reported as terminated, with unknown
+ * exit status.
+ *
+ * @param subprocess_handle_ptr
+ * @param exit_status_ptr
+ * @param signal_number_ptr
+ *
+ * @return true if the subprocess has terminated.
+ */
+bool _wlmaker_subprocess_handle_terminated(
+    wlmaker_subprocess_handle_t *subprocess_handle_ptr,
+    int *exit_status_ptr,
+    int *signal_number_ptr)
+{
+    if (!subprocess_handle_ptr->terminated &&
+        NULL != subprocess_handle_ptr->subprocess_ptr) {
+        return bs_subprocess_terminated(
+            subprocess_handle_ptr->subprocess_ptr,
+            exit_status_ptr,
+            signal_number_ptr);
+    }
+
+    if (!subprocess_handle_ptr->terminated) {
+        int status;
+        pid_t pid = waitpid(subprocess_handle_ptr->pid, &status, WNOHANG);
+        if (0 > pid && ECHILD == errno) {
+            _wlmaker_subprocess_handle_set_exited(subprocess_handle_ptr);
+        } else if (subprocess_handle_ptr->pid != pid) {
+            return false;
+        } else {
+            subprocess_handle_ptr->terminated = true;
+            if (WIFEXITED(status)) {
+                subprocess_handle_ptr->exit_status = WEXITSTATUS(status);
+            } else if (WIFSIGNALED(status)) {
+                subprocess_handle_ptr->signal_number = WTERMSIG(status);
+            }
+        }
+    }
+    *exit_status_ptr = subprocess_handle_ptr->exit_status;
+    *signal_number_ptr = subprocess_handle_ptr->signal_number;
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Marks the subprocess as terminated, for one that exited but cannot be
+ * reaped by us. The exit status is then unknown.
+ *
+ * @param subprocess_handle_ptr
+ */
+void _wlmaker_subprocess_handle_set_exited(
+    wlmaker_subprocess_handle_t *subprocess_handle_ptr)
+{
+    bs_log(BS_WARNING, "Subprocess %"PRIdMAX" exited but not reaped.",
+           (intmax_t)subprocess_handle_ptr->pid);
+    subprocess_handle_ptr->terminated = true;
+    subprocess_handle_ptr->exit_status =
+        WLMAKER_SUBPROCESS_EXIT_STATUS_UNKNOWN;
+    subprocess_handle_ptr->signal_number = 0;
+}
+
 /* ------------------------------------------------------------------------- */
 /**
  * Handler for activity on stdout file descriptor, as prescribed by
@@ -452,19 +860,30 @@ int _wlmaker_subprocess_monitor_process_fd(
     const char *fd_name_ptr)
 {
     // Convenience copy.
-    intmax_t pid = bs_subprocess_pid(subprocess_handle_ptr->subprocess_ptr);
+    intmax_t pid = subprocess_handle_ptr->pid;
 
     if (mask & WL_EVENT_READABLE) {
         ssize_t read_bytes;
-        char buf[1024];
-        read_bytes = read(fd, buf, sizeof(buf));
-        buf[BS_MIN(read_bytes, 1023)] = '\0';
-        if (0 < read_bytes) {
-            // TODO(kaeser@gubbe.ch): Find a way to log this appropriately.
-            // We'd want to have STDERR logged as WARN, and STDOUT in INFO.
-            bs_log(BS_DEBUG, "subprocess %"PRIdMAX" %s: %s",
-                   pid, fd_name_ptr, buf);
-        } else if (0 > read_bytes) {
+        if (WLMAKER_SUBPROCESS_OUTPUT_LOG != subprocess_handle_ptr->output) {
+            // Read larger chunks: Fewer wakeups for chatty subprocesses.
+            char buf[WLMAKER_SUBPROCESS_OUTPUT_READ_SIZE];
+            read_bytes = read(fd, buf, sizeof(buf));
+            if (0 < read_bytes) {
+                _wlmaker_subprocess_handle_route_output(
+                    subprocess_handle_ptr, buf, read_bytes);
+            }
+        } else {
+            char buf[1024];
+            read_bytes = read(fd, buf, sizeof(buf));
+            buf[BS_MIN(read_bytes, 1023)] = '\0';
+            if (0 < read_bytes) {
+                // TODO(kaeser@gubbe.ch): Find a way to log this appropriately.
+                // We'd want to have STDERR logged as WARN, and STDOUT in INFO.
+                bs_log(BS_DEBUG, "subprocess %"PRIdMAX" %s: %s",
+                       pid, fd_name_ptr, buf);
+            }
+        }
+        if (0 > read_bytes) {
             bs_log(BS_WARNING | BS_ERRNO,
                    "subprocess %"PRIdMAX" %s: Failed raad(%d, ...)",
                    pid, fd_name_ptr, fd);
@@ -486,10 +905,132 @@ int _wlmaker_subprocess_monitor_process_fd(
     return 0;
 }
 
+/* ------------------------------------------------------------------------- */
+/**
+ * Reads output that is still pending on `fd`, without blocking.
+ *
+ * Stops once nothing is readable, or after a bounded number of reads: A
+ * descendant may still hold the write end and keep writing.
+ *
+ * @param subprocess_handle_ptr
+ * @param wl_event_source_ptr_ptr
+ * @param fd
+ * @param fd_name_ptr
+ */
+void _wlmaker_subprocess_handle_drain_fd(
+    wlmaker_subprocess_handle_t *subprocess_handle_ptr,
+    struct wl_event_source **wl_event_source_ptr_ptr,
+    int fd,
+    const char *fd_name_ptr)
+{
+    // Without event source, the hangup was seen: Nothing left to read.
+    if (0 > fd || NULL == *wl_event_source_ptr_ptr) return;
+
+    struct pollfd pollfd = { .fd = fd, .events = POLLIN };
+    for (int i = 0; i < WLMAKER_SUBPROCESS_DRAIN_MAX_READS; ++i) {
+        if (1 != poll(&pollfd, 1, 0) || !(pollfd.revents & POLLIN)) return;
+        _wlmaker_subprocess_monitor_process_fd(
+            subprocess_handle_ptr,
+            wl_event_source_ptr_ptr,
+            fd,
+            WL_EVENT_READABLE,
+            fd_name_ptr);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Routes output read from the subprocess, for all but
+ * @ref WLMAKER_SUBPROCESS_OUTPUT_LOG.
+ *
+ * @param subprocess_handle_ptr
+ * @param data_ptr
+ * @param size
+ */
+void _wlmaker_subprocess_handle_route_output(
+    wlmaker_subprocess_handle_t *subprocess_handle_ptr,
+    const char *data_ptr,
+    size_t size)
+{
+    ssize_t written_bytes;
+
+    switch (subprocess_handle_ptr->output) {
+    case WLMAKER_SUBPROCESS_OUTPUT_FILE:
+        written_bytes = write(subprocess_handle_ptr->output_fd, data_ptr, size);
+        if (0 > written_bytes) {
+            bs_log(BS_WARNING | BS_ERRNO,
+                   "Subprocess %"PRIdMAX": Failed write(%d, %p, %zu)",
+                   (intmax_t)subprocess_handle_ptr->pid,
+                   subprocess_handle_ptr->output_fd, data_ptr, size);
+        } else if ((size_t)written_bytes < size) {
+            subprocess_handle_ptr->dropped_bytes += size - written_bytes;
+        }
+        break;
+
+    case WLMAKER_SUBPROCESS_OUTPUT_BUFFER:
+        _wlmaker_subprocess_handle_ring_append(
+            subprocess_handle_ptr, data_ptr, size);
+        break;
+
+    case WLMAKER_SUBPROCESS_OUTPUT_DISCARD:
+    default:
+        break;
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Appends to the ring buffer, up to the rate limit. The remainder is dropped.
+ *
+ * @param subprocess_handle_ptr
+ * @param data_ptr
+ * @param size
+ */
+void _wlmaker_subprocess_handle_ring_append(
+    wlmaker_subprocess_handle_t *subprocess_handle_ptr,
+    const char *data_ptr,
+    size_t size)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    if (ts.tv_sec != subprocess_handle_ptr->rate_period) {
+        subprocess_handle_ptr->rate_period = ts.tv_sec;
+        subprocess_handle_ptr->rate_bytes = 0;
+    }
+
+    size_t keep = BS_MIN(
+        size,
+        WLMAKER_SUBPROCESS_OUTPUT_RATE_LIMIT -
+        subprocess_handle_ptr->rate_bytes);
+    subprocess_handle_ptr->rate_bytes += keep;
+    subprocess_handle_ptr->dropped_bytes += size - keep;
+
+    while (0 < keep) {
+        size_t chunk = BS_MIN(
+            keep,
+            WLMAKER_SUBPROCESS_OUTPUT_BUFFER_SIZE -
+            subprocess_handle_ptr->ring_pos);
+        memcpy(subprocess_handle_ptr->ring_ptr +
+               subprocess_handle_ptr->ring_pos, data_ptr, chunk);
+        subprocess_handle_ptr->ring_pos =
+            (subprocess_handle_ptr->ring_pos + chunk) %
+            WLMAKER_SUBPROCESS_OUTPUT_BUFFER_SIZE;
+        subprocess_handle_ptr->ring_fill = BS_MIN(
+            subprocess_handle_ptr->ring_fill + chunk,
+            WLMAKER_SUBPROCESS_OUTPUT_BUFFER_SIZE);
+        data_ptr += chunk;
+        keep -= chunk;
+    }
+}
+
 /* ------------------------------------------------------------------------- */
 /**
  * Handles SIGCHLD. Callback for Wayland event loop.
  *
+ * Subprocesses tracked through a pidfd are reaped when their pidfd turns
+ * readable, see @ref _wlmaker_subprocess_monitor_handle_pidfd. So this only
+ * needs to check the subprocesses without.
+ *
  * @param signum
  *
  * @param data_ptr            Points to @ref wlmaker_subprocess_monitor_t.
@@ -505,19 +1046,150 @@ int _wlmaker_subprocess_monitor_handle_sigchld(
             dlnode_ptr, wlmaker_subprocess_handle_t, dlnode);
         dlnode_ptr = dlnode_ptr->next_ptr;
 
-        int exit_status, signal_number;
-        if (bs_subprocess_terminated(subprocess_handle_ptr->subprocess_ptr,
-                                     &exit_status, &signal_number)) {
-            bs_dllist_remove(
-                &monitor_ptr->subprocesses,
-                &subprocess_handle_ptr->dlnode);
-            wlmaker_subprocess_handle_destroy(subprocess_handle_ptr);
-        }
+        if (0 <= subprocess_handle_ptr->pidfd) continue;
+        _wlmaker_subprocess_monitor_reap(monitor_ptr, subprocess_handle_ptr);
     }
 
     return 0;
 }
 
+/* ------------------------------------------------------------------------- */
+/**
+ * Opens a pidfd for the subprocess and registers it with the event loop.
+ *
+ * The subprocess then gets reaped as soon as it exits, independent of
+ * SIGCHLD, which may coalesce or get consumed by other handlers. If the
+ * kernel does not support pidfds, the subprocess is left to SIGCHLD.
+ *
+ * @param monitor_ptr
+ * @param subprocess_handle_ptr
+ */
+void _wlmaker_subprocess_monitor_watch_pidfd(
+    wlmaker_subprocess_monitor_t *monitor_ptr,
+    wlmaker_subprocess_handle_t *subprocess_handle_ptr)
+{
+    subprocess_handle_ptr->monitor_ptr = monitor_ptr;
+
+#if defined(SYS_pidfd_open)
+    // pidfd_open(2) sets FD_CLOEXEC, so it won't leak into children.
+    subprocess_handle_ptr->pidfd = syscall(
+        SYS_pidfd_open, subprocess_handle_ptr->pid, 0);
+#else
+    errno = ENOSYS;
+#endif  // defined(SYS_pidfd_open)
+    if (0 > subprocess_handle_ptr->pidfd) {
+        bs_log(BS_DEBUG | BS_ERRNO, "Failed pidfd_open(%"PRIdMAX", 0)",
+               (intmax_t)subprocess_handle_ptr->pid);
+        subprocess_handle_ptr->pidfd = -1;
+        return;
+    }
+
+    subprocess_handle_ptr->pidfd_wl_event_source_ptr = wl_event_loop_add_fd(
+        monitor_ptr->wl_event_loop_ptr,
+        subprocess_handle_ptr->pidfd,
+        WL_EVENT_READABLE,
+        _wlmaker_subprocess_monitor_handle_pidfd,
+        subprocess_handle_ptr);
+    if (NULL == subprocess_handle_ptr->pidfd_wl_event_source_ptr) {
+        bs_log(BS_WARNING, "Failed wl_event_loop_add_fd(%p, %d, ...)",
+               monitor_ptr->wl_event_loop_ptr, subprocess_handle_ptr->pidfd);
+        _wlmaker_subprocess_handle_unwatch_pidfd(subprocess_handle_ptr);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Removes the pidfd's event source and closes the pidfd. The subprocess
+ * will then be reaped through SIGCHLD.
+ *
+ * @param subprocess_handle_ptr
+ */
+void _wlmaker_subprocess_handle_unwatch_pidfd(
+    wlmaker_subprocess_handle_t *subprocess_handle_ptr)
+{
+    if (NULL != subprocess_handle_ptr->pidfd_wl_event_source_ptr) {
+        wl_event_source_remove(
+            subprocess_handle_ptr->pidfd_wl_event_source_ptr);
+        subprocess_handle_ptr->pidfd_wl_event_source_ptr = NULL;
+    }
+    if (0 <= subprocess_handle_ptr->pidfd) {
+        close(subprocess_handle_ptr->pidfd);
+        subprocess_handle_ptr->pidfd = -1;
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Handles the pidfd turning readable: The subprocess has exited.
+ *
+ * @param fd
+ * @param mask
+ * @param data_ptr            Points to a @ref wlmaker_subprocess_handle_t.
+ *
+ * @return 0.
+ */
+int _wlmaker_subprocess_monitor_handle_pidfd(
+    int fd,
+    __UNUSED__ uint32_t mask,
+    void *data_ptr)
+{
+    wlmaker_subprocess_handle_t *subprocess_handle_ptr = data_ptr;
+    BS_ASSERT(fd == subprocess_handle_ptr->pidfd);
+
+    if (_wlmaker_subprocess_monitor_reap(
+            subprocess_handle_ptr->monitor_ptr, subprocess_handle_ptr)) {
+        return 0;
+    }
+
+    // Exited, but not reapable by us: Someone else waited for it. Report it
+    // as terminated all the same, the pidfd would otherwise remain readable
+    // forever, and the handle never be released.
+    _wlmaker_subprocess_handle_set_exited(subprocess_handle_ptr);
+    _wlmaker_subprocess_monitor_reap(
+        subprocess_handle_ptr->monitor_ptr, subprocess_handle_ptr);
+    return 0;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Reaps the subprocess, if it has terminated: Removes it from the monitor
+ * and destroys the handle, which calls the `terminated_callback`.
+ *
+ * @param monitor_ptr
+ * @param subprocess_handle_ptr
+ *
+ * @return true if the subprocess had terminated, and the handle was
+ *     destroyed.
+ */
+bool _wlmaker_subprocess_monitor_reap(
+    wlmaker_subprocess_monitor_t *monitor_ptr,
+    wlmaker_subprocess_handle_t *subprocess_handle_ptr)
+{
+    int exit_status, signal_number;
+    if (!_wlmaker_subprocess_handle_terminated(
+            subprocess_handle_ptr, &exit_status, &signal_number)) return false;
+
+    // The pidfd or SIGCHLD may be reported before the pipes: Pick up what
+    // the subprocess wrote, before reporting termination.
+    _wlmaker_subprocess_handle_drain_fd(
+        subprocess_handle_ptr,
+        &subprocess_handle_ptr->stdout_wl_event_source_ptr,
+        subprocess_handle_ptr->stdout_read_fd,
+        "stdout");
+    _wlmaker_subprocess_handle_drain_fd(
+        subprocess_handle_ptr,
+        &subprocess_handle_ptr->stderr_wl_event_source_ptr,
+        subprocess_handle_ptr->stderr_read_fd,
+        "stderr");
+
+    _wlmaker_subprocess_monitor_unindex(monitor_ptr, subprocess_handle_ptr);
+    bs_dllist_remove(
+        &monitor_ptr->subprocesses,
+        &subprocess_handle_ptr->dlnode);
+    wlmaker_subprocess_handle_destroy(subprocess_handle_ptr);
+    return true;
+}
+
 /* ------------------------------------------------------------------------- */
 /**
  * Handles window creation: Will see if there's a subprocess mapping to the
@@ -651,9 +1323,6 @@ void _wlmaker_subprocess_monitor_handle_window_destroyed(
 /**
  * Returns the subprocess matching the window's client, if any.
  *
- * Practically, there should only ever be one subprocess matching, since the
- * PID of a subprocess is supposed to be unique.
- *
  * @param monitor_ptr
  * @param window_ptr
  *
@@ -666,21 +1335,115 @@ wlmaker_subprocess_handle_t *subprocess_handle_from_window(
 {
     const wlmtk_util_client_t *client_ptr = wlmtk_window_get_client_ptr(
         window_ptr);
-    // TODO(kaeser@gubbe.ch): Should be a O(1) or O(log(n)) structure.
-    for (bs_dllist_node_t *dlnode_ptr = monitor_ptr->subprocesses.head_ptr;
-         NULL != dlnode_ptr;
-         dlnode_ptr = dlnode_ptr->next_ptr) {
-        wlmaker_subprocess_handle_t *subprocess_handle_ptr = BS_CONTAINER_OF(
-            dlnode_ptr, wlmaker_subprocess_handle_t, dlnode);
-        if (client_ptr->pid ==
-            bs_subprocess_pid(subprocess_handle_ptr->subprocess_ptr)) {
-            return subprocess_handle_ptr;
-        }
+    if (NULL == client_ptr) return NULL;
+    return _wlmaker_subprocess_monitor_lookup_pid(
+        monitor_ptr, client_ptr->pid);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Returns the subprocess that `pid` belongs to, if any.
+ *
+ * Practically, there should only ever be one subprocess matching, since the
+ * PID of a subprocess is supposed to be unique. If `pid` is not monitored,
+ * its parent processes are looked up, but only if any subprocess asked for
+ * matching its descendants: Launchers that fork (or wrapper scripts) will
+ * then still match the subprocess they were started as. Other subprocesses
+ * are not matched by their descendants, so that eg. an application started
+ * from a terminal does not map to the terminal's launcher.
+ *
+ * @param monitor_ptr
+ * @param pid
+ *
+ * @return A pointer to the subprocess handle, or NULL if not found.
+ */
+wlmaker_subprocess_handle_t *_wlmaker_subprocess_monitor_lookup_pid(
+    wlmaker_subprocess_monitor_t *monitor_ptr,
+    pid_t pid)
+{
+    bs_avltree_node_t *avlnode_ptr = bs_avltree_lookup(
+        monitor_ptr->pid_tree_ptr, &pid);
+    if (NULL != avlnode_ptr) {
+        return BS_CONTAINER_OF(
+            avlnode_ptr, wlmaker_subprocess_handle_t, avlnode);
     }
+    if (0 == monitor_ptr->match_descendants_count) return NULL;
+
+    for (int i = 0; i < WLMAKER_SUBPROCESS_MAX_ANCESTORS; ++i) {
+        pid = _wlmaker_subprocess_parent_pid(pid);
+        if (1 >= pid) return NULL;
+        avlnode_ptr = bs_avltree_lookup(monitor_ptr->pid_tree_ptr, &pid);
+        if (NULL == avlnode_ptr) continue;
 
+        wlmaker_subprocess_handle_t *subprocess_handle_ptr = BS_CONTAINER_OF(
+            avlnode_ptr, wlmaker_subprocess_handle_t, avlnode);
+        return subprocess_handle_ptr->match_descendants ?
+            subprocess_handle_ptr : NULL;
+    }
     return NULL;
 }
 
+/* ------------------------------------------------------------------------- */
+/**
+ * Removes the subprocess from @ref wlmaker_subprocess_monitor_t::pid_tree_ptr,
+ * if it is in there.
+ *
+ * @param monitor_ptr
+ * @param subprocess_handle_ptr
+ */
+void _wlmaker_subprocess_monitor_unindex(
+    wlmaker_subprocess_monitor_t *monitor_ptr,
+    wlmaker_subprocess_handle_t *subprocess_handle_ptr)
+{
+    if (!subprocess_handle_ptr->in_pid_tree) return;
+    bs_avltree_delete(monitor_ptr->pid_tree_ptr, &subprocess_handle_ptr->pid);
+    subprocess_handle_ptr->in_pid_tree = false;
+    if (subprocess_handle_ptr->match_descendants) {
+        BS_ASSERT(0 < monitor_ptr->match_descendants_count);
+        --monitor_ptr->match_descendants_count;
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Returns the parent PID of `pid`, as found in `/proc/<pid>/stat`.
+ *
+ * @param pid
+ *
+ * @return The parent's PID, or 0 if it could not be determined.
+ */
+pid_t _wlmaker_subprocess_parent_pid(pid_t pid)
+{
+    char fname[PATH_MAX], stat_buf[1024];
+    snprintf(fname, sizeof(fname), "/proc/%"PRIdMAX"/stat", (intmax_t)pid);
+    ssize_t read_bytes = bs_file_read_buffer(
+        fname, stat_buf, sizeof(stat_buf));
+    if (0 >= read_bytes) return 0;
+    stat_buf[BS_MIN((size_t)read_bytes, sizeof(stat_buf) - 1)] = '\0';
+
+    // Format is "pid (comm) state ppid ...". `comm` may contain spaces and
+    // parentheses, so parse from the last closing parenthesis.
+    const char *pos_ptr = strrchr(stat_buf, ')');
+    intmax_t ppid;
+    if (NULL == pos_ptr ||
+        1 != sscanf(pos_ptr + 1, " %*c %"SCNdMAX, &ppid)) return 0;
+    return ppid;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Comparator for the PID tree nodes. */
+int _wlmaker_subprocess_handle_node_cmp(
+    const bs_avltree_node_t *node_ptr,
+    const void *key_ptr)
+{
+    wlmaker_subprocess_handle_t *subprocess_handle_ptr = BS_CONTAINER_OF(
+        node_ptr, wlmaker_subprocess_handle_t, avlnode);
+    pid_t pid = *(const pid_t*)key_ptr;
+    if (subprocess_handle_ptr->pid < pid) return -1;
+    if (subprocess_handle_ptr->pid > pid) return 1;
+    return 0;
+}
+
 /* ------------------------------------------------------------------------- */
 /**
  * Creates a structure to track windows for subprocesses.
@@ -776,4 +1539,234 @@ void wlmaker_subprocess_window_node_destroy(bs_avltree_node_t *node_ptr)
     wlmaker_subprocess_window_destroy(ws_window_ptr);
 }
 
+/* == Unit tests =========================================================== */
+
+static void test_parent_pid(bs_test_t *test_ptr);
+static void test_output_buffer(bs_test_t *test_ptr);
+static void test_reaped_elsewhere(bs_test_t *test_ptr);
+static void test_drain_on_reap(bs_test_t *test_ptr);
+static void test_lookup_pid(bs_test_t *test_ptr);
+
+const bs_test_case_t wlmaker_subprocess_monitor_test_cases[] = {
+    { 1, "parent_pid", test_parent_pid },
+    { 1, "output_buffer", test_output_buffer },
+    { 1, "reaped_elsewhere", test_reaped_elsewhere },
+    { 1, "drain_on_reap", test_drain_on_reap },
+    { 1, "lookup_pid", test_lookup_pid },
+    { 0, NULL, NULL }
+};
+
+/* ------------------------------------------------------------------------- */
+/** Tests resolving the parent PID. */
+void test_parent_pid(bs_test_t *test_ptr)
+{
+    BS_TEST_VERIFY_EQ(
+        test_ptr, getppid(), _wlmaker_subprocess_parent_pid(getpid()));
+    BS_TEST_VERIFY_EQ(test_ptr, 0, _wlmaker_subprocess_parent_pid(-1));
+}
+
+/* ------------------------------------------------------------------------- */
+/** Tests keeping output in the ring buffer. */
+void test_output_buffer(bs_test_t *test_ptr)
+{
+    wlmaker_subprocess_handle_t handle = { .output_fd = -1 };
+    char buf[8];
+
+    BS_TEST_VERIFY_TRUE_OR_RETURN(
+        test_ptr,
+        wlmaker_subprocess_set_output(
+            &handle, WLMAKER_SUBPROCESS_OUTPUT_BUFFER, NULL));
+    BS_TEST_VERIFY_EQ(
+        test_ptr, 0, wlmaker_subprocess_get_output(&handle, buf, sizeof(buf)));
+    BS_TEST_VERIFY_STREQ(test_ptr, "", buf);
+
+    // Keeps the most recent output, if the destination is too small.
+    _wlmaker_subprocess_handle_route_output(&handle, "0123456789", 10);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, 7, wlmaker_subprocess_get_output(&handle, buf, sizeof(buf)));
+    BS_TEST_VERIFY_STREQ(test_ptr, "3456789", buf);
+
+    // Wraps around at the end of the ring.
+    handle.ring_pos = WLMAKER_SUBPROCESS_OUTPUT_BUFFER_SIZE - 3;
+    handle.ring_fill = 0;
+    _wlmaker_subprocess_handle_route_output(&handle, "abcdef", 6);
+    BS_TEST_VERIFY_EQ(test_ptr, 3, handle.ring_pos);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, 6, wlmaker_subprocess_get_output(&handle, buf, sizeof(buf)));
+    BS_TEST_VERIFY_STREQ(test_ptr, "abcdef", buf);
+
+    BS_TEST_VERIFY_TRUE(
+        test_ptr,
+        wlmaker_subprocess_set_output(
+            &handle, WLMAKER_SUBPROCESS_OUTPUT_DISCARD, NULL));
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, handle.ring_ptr);
+    _wlmaker_subprocess_handle_route_output(&handle, "0123456789", 10);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, 0, wlmaker_subprocess_get_output(&handle, buf, sizeof(buf)));
+}
+
+/* ------------------------------------------------------------------------- */
+/** Test helper: Stores the exit status at `userdata_ptr`. */
+static void _wlmaker_subprocess_monitor_test_terminated(
+    void *userdata_ptr,
+    __UNUSED__ wlmaker_subprocess_handle_t *subprocess_handle_ptr,
+    int exit_status,
+    __UNUSED__ int signal_number)
+{
+    *(int*)userdata_ptr = exit_status;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Tests that a subprocess reaped by someone else is reported terminated. */
+void test_reaped_elsewhere(bs_test_t *test_ptr)
+{
+    struct wl_event_loop *wl_event_loop_ptr = wl_event_loop_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, wl_event_loop_ptr);
+    wlmaker_subprocess_monitor_t monitor = {
+        .wl_event_loop_ptr = wl_event_loop_ptr,
+        .pid_tree_ptr = bs_avltree_create(
+            _wlmaker_subprocess_handle_node_cmp, NULL)
+    };
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, monitor.pid_tree_ptr);
+
+    pid_t pid = fork();
+    if (0 == pid) _exit(0);
+    BS_TEST_VERIFY_TRUE_OR_RETURN(test_ptr, 0 < pid);
+
+    int exit_status = 0;
+    wlmaker_subprocess_handle_t *subprocess_handle_ptr =
+        _wlmaker_subprocess_monitor_entrust(
+            &monitor,
+            wlmaker_subprocess_handle_create(
+                NULL, pid, -1, -1, wl_event_loop_ptr),
+            _wlmaker_subprocess_monitor_test_terminated,
+            &exit_status,
+            NULL, NULL, NULL, NULL);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, subprocess_handle_ptr);
+
+    // Someone else waits for the subprocess. It must be released anyway.
+    int status;
+    BS_TEST_VERIFY_EQ(test_ptr, pid, waitpid(pid, &status, 0));
+    if (0 <= subprocess_handle_ptr->pidfd) {
+        wl_event_loop_dispatch(wl_event_loop_ptr, 1000);
+    } else {
+        _wlmaker_subprocess_monitor_handle_sigchld(SIGCHLD, &monitor);
+    }
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, monitor.subprocesses.head_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, bs_avltree_lookup(
+                          monitor.pid_tree_ptr, &pid));
+    BS_TEST_VERIFY_EQ(
+        test_ptr, WLMAKER_SUBPROCESS_EXIT_STATUS_UNKNOWN, exit_status);
+
+    bs_avltree_destroy(monitor.pid_tree_ptr);
+    wl_event_loop_destroy(wl_event_loop_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Captures the kept output, matches wlmaker_subprocess_terminated_callback_t. */
+static void _wlmaker_subprocess_monitor_test_output(
+    void *userdata_ptr,
+    wlmaker_subprocess_handle_t *subprocess_handle_ptr,
+    __UNUSED__ int exit_status,
+    __UNUSED__ int signal_number)
+{
+    wlmaker_subprocess_get_output(subprocess_handle_ptr, userdata_ptr, 16);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Tests that output still in the pipe is kept when reaping first. */
+void test_drain_on_reap(bs_test_t *test_ptr)
+{
+    struct wl_event_loop *wl_event_loop_ptr = wl_event_loop_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, wl_event_loop_ptr);
+    wlmaker_subprocess_monitor_t monitor = {
+        .wl_event_loop_ptr = wl_event_loop_ptr,
+        .pid_tree_ptr = bs_avltree_create(
+            _wlmaker_subprocess_handle_node_cmp, NULL)
+    };
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, monitor.pid_tree_ptr);
+
+    int fds[2];
+    BS_TEST_VERIFY_EQ_OR_RETURN(test_ptr, 0, pipe2(fds, O_CLOEXEC));
+    pid_t pid = fork();
+    if (0 == pid) {
+        ssize_t written = write(fds[1], "output", 6);
+        _exit(6 == written ? 0 : 1);
+    }
+    close(fds[1]);
+    BS_TEST_VERIFY_TRUE_OR_RETURN(test_ptr, 0 < pid);
+
+    char output[16] = {};
+    wlmaker_subprocess_handle_t *subprocess_handle_ptr =
+        _wlmaker_subprocess_monitor_entrust(
+            &monitor,
+            wlmaker_subprocess_handle_create(
+                NULL, pid, fds[0], -1, wl_event_loop_ptr),
+            _wlmaker_subprocess_monitor_test_output,
+            output,
+            NULL, NULL, NULL, NULL);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, subprocess_handle_ptr);
+    BS_TEST_VERIFY_TRUE(
+        test_ptr,
+        wlmaker_subprocess_set_output(
+            subprocess_handle_ptr, WLMAKER_SUBPROCESS_OUTPUT_BUFFER, NULL));
+
+    // Wait for the exit, but leave reaping to the monitor. No dispatch: The
+    // output is still in the pipe.
+    siginfo_t siginfo;
+    BS_TEST_VERIFY_EQ(
+        test_ptr, 0, waitid(P_PID, pid, &siginfo, WEXITED | WNOWAIT));
+    BS_TEST_VERIFY_TRUE(
+        test_ptr,
+        _wlmaker_subprocess_monitor_reap(&monitor, subprocess_handle_ptr));
+    BS_TEST_VERIFY_STREQ(test_ptr, "output", output);
+
+    bs_avltree_destroy(monitor.pid_tree_ptr);
+    wl_event_loop_destroy(wl_event_loop_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Tests looking up subprocesses by PID, and by the PIDs of descendants. */
+void test_lookup_pid(bs_test_t *test_ptr)
+{
+    wlmaker_subprocess_monitor_t monitor = {
+        .pid_tree_ptr = bs_avltree_create(
+            _wlmaker_subprocess_handle_node_cmp, NULL)
+    };
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, monitor.pid_tree_ptr);
+
+    // Our parent process is the monitored one. We're its descendant.
+    wlmaker_subprocess_handle_t handle = {
+        .pid = getppid(), .monitor_ptr = &monitor };
+    handle.in_pid_tree = bs_avltree_insert(
+        monitor.pid_tree_ptr, &handle.pid, &handle.avlnode, false);
+    BS_TEST_VERIFY_TRUE(test_ptr, handle.in_pid_tree);
+
+    BS_TEST_VERIFY_EQ(
+        test_ptr, &handle,
+        _wlmaker_subprocess_monitor_lookup_pid(&monitor, getppid()));
+    BS_TEST_VERIFY_EQ(
+        test_ptr, NULL,
+        _wlmaker_subprocess_monitor_lookup_pid(&monitor, getpid()));
+
+    // Descendants match only once requested.
+    wlmaker_subprocess_set_match_descendants(&handle, true);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, monitor.match_descendants_count);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, &handle,
+        _wlmaker_subprocess_monitor_lookup_pid(&monitor, getpid()));
+    BS_TEST_VERIFY_EQ(
+        test_ptr, NULL,
+        _wlmaker_subprocess_monitor_lookup_pid(&monitor, 1));
+
+    // Unindexing stops matching, and releases the count.
+    _wlmaker_subprocess_monitor_unindex(&monitor, &handle);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, monitor.match_descendants_count);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, NULL,
+        _wlmaker_subprocess_monitor_lookup_pid(&monitor, getpid()));
+
+    bs_avltree_destroy(monitor.pid_tree_ptr);
+}
+
 /* == End of subprocess_monitor.c ========================================== */
@@ -35,12 +35,31 @@ typedef struct _wlmaker_subprocess_handle_t wlmaker_subprocess_handle_t;
 extern "C" {
 #endif  // __cplusplus
 
+/** Where the output (stdout and stderr) of a subprocess is routed to. */
+typedef enum {
+    /** Logs each chunk of output at debug level. The default. */
+    WLMAKER_SUBPROCESS_OUTPUT_LOG,
+    /** Drains and drops the output. */
+    WLMAKER_SUBPROCESS_OUTPUT_DISCARD,
+    /** Appends the output to a file. */
+    WLMAKER_SUBPROCESS_OUTPUT_FILE,
+    /** Keeps the latest output in a bounded ring buffer. */
+    WLMAKER_SUBPROCESS_OUTPUT_BUFFER
+} wlmaker_subprocess_output_t;
+
+/**
+ * Exit status reported for a subprocess that exited, but was reaped by
+ * someone else: Its actual exit status is lost.
+ */
+#define WLMAKER_SUBPROCESS_EXIT_STATUS_UNKNOWN -1
+
 /**
  * Callback for then the subprocess is terminated.
  *
  * @param userdata_ptr
  * @param subprocess_handle_ptr
- * @param state
+ * @param state               Exit status, or
+ *                            @ref WLMAKER_SUBPROCESS_EXIT_STATUS_UNKNOWN.
  * @param code
  */
 typedef void (*wlmaker_subprocess_terminated_callback_t)(
@@ -107,6 +126,40 @@ wlmaker_subprocess_handle_t *wlmaker_subprocess_monitor_entrust(
     wlmaker_subprocess_window_callback_t window_unmapped_callback,
     wlmaker_subprocess_window_callback_t window_destroyed_callback);
 
+/**
+ * Passes ownership of a started process to `monitor_ptr`, identified by PID.
+ *
+ * Same as @ref wlmaker_subprocess_monitor_entrust, for processes that were
+ * not started through `bs_subprocess_t`, eg. by @ref wlmaker_subprocess_spawn.
+ * The monitor reaps the process, and closes the file descriptors.
+ *
+ * @param monitor_ptr
+ * @param pid
+ * @param stdout_read_fd      Read end of the process' stdout, or -1.
+ * @param stderr_read_fd      Read end of the process' stderr, or -1.
+ * @param terminated_callback
+ * @param userdata_ptr
+ * @param window_created_callback
+ * @param window_mapped_callback
+ * @param window_unmapped_callback
+ * @param window_destroyed_callback
+ *
+ * @return A pointer to the created subprocess handle or NULL on error. On
+ *     error, ownership of the process and file descriptors remains with the
+ *     caller.
+ */
+wlmaker_subprocess_handle_t *wlmaker_subprocess_monitor_entrust_pid(
+    wlmaker_subprocess_monitor_t *monitor_ptr,
+    pid_t pid,
+    int stdout_read_fd,
+    int stderr_read_fd,
+    wlmaker_subprocess_terminated_callback_t terminated_callback,
+    void *userdata_ptr,
+    wlmaker_subprocess_window_callback_t window_created_callback,
+    wlmaker_subprocess_window_callback_t window_mapped_callback,
+    wlmaker_subprocess_window_callback_t window_unmapped_callback,
+    wlmaker_subprocess_window_callback_t window_destroyed_callback);
+
 /**
  * Releases the reference held on `subprocess_handle_ptr`. Once the subprocess
  * terminates, all corresponding resources will be freed.
@@ -118,10 +171,62 @@ void wlmaker_subprocess_monitor_cede(
     wlmaker_subprocess_monitor_t *monitor_ptr,
     wlmaker_subprocess_handle_t *subprocess_handle_ptr);
 
-/** Returns the `bs_subprocess_t` from the @ref wlmaker_subprocess_handle_t. */
+/**
+ * Returns the `bs_subprocess_t` from the @ref wlmaker_subprocess_handle_t.
+ * NULL, if entrusted through @ref wlmaker_subprocess_monitor_entrust_pid.
+ */
 bs_subprocess_t *wlmaker_subprocess_from_subprocess_handle(
     wlmaker_subprocess_handle_t *subprocess_handle_ptr);
 
+/**
+ * Sets whether windows of the subprocess' descendants map to it, too.
+ *
+ * By default, a window maps to the subprocess only if the window's client is
+ * the subprocess itself. When set, windows of clients that were forked from
+ * the subprocess (eg. by a launcher script) are mapped to it as well. This
+ * looks up the parent processes of unmatched clients through `/proc`.
+ *
+ * @param subprocess_handle_ptr
+ * @param match_descendants
+ */
+void wlmaker_subprocess_set_match_descendants(
+    wlmaker_subprocess_handle_t *subprocess_handle_ptr,
+    bool match_descendants);
+
+/**
+ * Sets where the output of the subprocess is routed to.
+ *
+ * @param subprocess_handle_ptr
+ * @param output
+ * @param path_ptr            Path of the file to append to. Only used for
+ *                            @ref WLMAKER_SUBPROCESS_OUTPUT_FILE.
+ *
+ * @return true on success. On failure, the output routing is left unchanged.
+ */
+bool wlmaker_subprocess_set_output(
+    wlmaker_subprocess_handle_t *subprocess_handle_ptr,
+    wlmaker_subprocess_output_t output,
+    const char *path_ptr);
+
+/**
+ * Retrieves the output kept for the subprocess, when routed to
+ * @ref WLMAKER_SUBPROCESS_OUTPUT_BUFFER.
+ *
+ * @param subprocess_handle_ptr
+ * @param buf_ptr             Destination. Will be NUL-terminated.
+ * @param buf_size            Size of `buf_ptr`. Must be at least 1.
+ *
+ * @return The number of bytes stored in `buf_ptr`, excluding the NUL. If
+ *     the buffer is too small, the most recent output is kept.
+ */
+size_t wlmaker_subprocess_get_output(
+    wlmaker_subprocess_handle_t *subprocess_handle_ptr,
+    char *buf_ptr,
+    size_t buf_size);
+
+/** Unit test cases. */
+extern const bs_test_case_t wlmaker_subprocess_monitor_test_cases[];
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -0,0 +1,485 @@
+/* ========================================================================= */
+/**
+ * @file subprocess_spawn.c
+ *
+ * @copyright
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/// pipe2(2) and `environ` are GNU extensions, need this macro.
+#define _GNU_SOURCE
+
+#include "subprocess_spawn.h"
+
+#include <ctype.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <signal.h>
+#include <spawn.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+/* == Declarations ========================================================= */
+
+/** Number of spawns to average over, in the benchmark. */
+#define WLMAKER_SUBPROCESS_SPAWN_BENCHMARK_ROUNDS 20
+
+static char **_wlmaker_subprocess_spawn_split(const char *cmdline_ptr);
+static bool _wlmaker_subprocess_spawn_is_assignment(const char *word_ptr);
+static char **_wlmaker_subprocess_spawn_environment(
+    char **assignments_ptr,
+    size_t assignments);
+static bool _wlmaker_subprocess_spawn_setup_output(
+    posix_spawn_file_actions_t *file_actions_ptr,
+    wlmaker_subprocess_output_t output,
+    const char *path_ptr,
+    int stdout_pipe[2],
+    int stderr_pipe[2]);
+static bool _wlmaker_subprocess_spawn_setup_attr(posix_spawnattr_t *attr_ptr);
+
+/* == Exported methods ===================================================== */
+
+/* ------------------------------------------------------------------------- */
+pid_t wlmaker_subprocess_spawn(
+    const char *cmdline_ptr,
+    wlmaker_subprocess_output_t output,
+    const char *path_ptr,
+    int *stdout_read_fd_ptr,
+    int *stderr_read_fd_ptr)
+{
+    *stdout_read_fd_ptr = -1;
+    *stderr_read_fd_ptr = -1;
+
+    char **words_ptr = _wlmaker_subprocess_spawn_split(cmdline_ptr);
+    if (NULL == words_ptr) return -1;
+    char **argv_ptr = words_ptr;
+    while (NULL != *argv_ptr &&
+           _wlmaker_subprocess_spawn_is_assignment(*argv_ptr)) ++argv_ptr;
+    if (NULL == *argv_ptr) {
+        bs_log(BS_WARNING, "No command in \"%s\"", cmdline_ptr);
+        free(words_ptr);
+        return -1;
+    }
+    char **envp_ptr = _wlmaker_subprocess_spawn_environment(
+        words_ptr, argv_ptr - words_ptr);
+
+    pid_t pid = -1;
+    int stdout_pipe[2] = { -1, -1 };
+    int stderr_pipe[2] = { -1, -1 };
+    posix_spawn_file_actions_t file_actions;
+    posix_spawnattr_t attr;
+    posix_spawn_file_actions_init(&file_actions);
+    posix_spawnattr_init(&attr);
+    if (NULL != envp_ptr &&
+        _wlmaker_subprocess_spawn_setup_attr(&attr) &&
+        _wlmaker_subprocess_spawn_setup_output(
+            &file_actions, output, path_ptr, stdout_pipe, stderr_pipe)) {
+        int rv = posix_spawnp(
+            &pid, argv_ptr[0], &file_actions, &attr, argv_ptr, envp_ptr);
+        if (0 != rv) {
+            errno = rv;
+            bs_log(BS_WARNING | BS_ERRNO,
+                   "Failed posix_spawnp(%p, \"%s\", ...) for \"%s\"",
+                   &pid, argv_ptr[0], cmdline_ptr);
+            pid = -1;
+        }
+    }
+    posix_spawnattr_destroy(&attr);
+    posix_spawn_file_actions_destroy(&file_actions);
+    if (NULL != envp_ptr) free(envp_ptr);
+    free(words_ptr);
+
+    // The write ends were passed on to the child.
+    if (0 <= stdout_pipe[1]) close(stdout_pipe[1]);
+    if (0 <= stderr_pipe[1]) close(stderr_pipe[1]);
+    if (0 > pid) {
+        if (0 <= stdout_pipe[0]) close(stdout_pipe[0]);
+        if (0 <= stderr_pipe[0]) close(stderr_pipe[0]);
+        return -1;
+    }
+    *stdout_read_fd_ptr = stdout_pipe[0];
+    *stderr_read_fd_ptr = stderr_pipe[0];
+    return pid;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmaker_subprocess_abandon(
+    pid_t pid,
+    int stdout_read_fd,
+    int stderr_read_fd)
+{
+    if (0 <= stdout_read_fd) close(stdout_read_fd);
+    if (0 <= stderr_read_fd) close(stderr_read_fd);
+
+    if (0 != kill(pid, SIGKILL)) {
+        bs_log(BS_WARNING | BS_ERRNO, "Failed kill(%"PRIdMAX", SIGKILL)",
+               (intmax_t)pid);
+    }
+    while (0 > waitpid(pid, NULL, 0) && EINTR == errno) continue;
+}
+
+/* == Local (static) methods =============================================== */
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Splits the command line into words.
+ *
+ * @param cmdline_ptr
+ *
+ * @return A NULL-terminated array of words, or NULL on error. The words are
+ *     stored in the same allocation, and must be released by a single call
+ *     to free(3).
+ */
+char **_wlmaker_subprocess_spawn_split(const char *cmdline_ptr)
+{
+    // Each word takes at least a character and a separator.
+    size_t len = strlen(cmdline_ptr);
+    size_t max_words = len / 2 + 2;
+    char **words_ptr = logged_calloc(
+        1, max_words * sizeof(char*) + len + 1);
+    if (NULL == words_ptr) return NULL;
+
+    char *dest_ptr = (char*)(words_ptr + max_words);
+    const char *src_ptr = cmdline_ptr;
+    size_t words = 0;
+    while (true) {
+        while (isspace((unsigned char)*src_ptr)) ++src_ptr;
+        if ('\0' == *src_ptr) break;
+
+        words_ptr[words++] = dest_ptr;
+        bool quoted = false;
+        for (; '\0' != *src_ptr; ++src_ptr) {
+            if (!quoted && isspace((unsigned char)*src_ptr)) break;
+            if ('"' == *src_ptr) {
+                quoted = !quoted;
+            } else {
+                *dest_ptr++ = *src_ptr;
+            }
+        }
+        *dest_ptr++ = '\0';
+    }
+    words_ptr[words] = NULL;
+    return words_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/** @return Whether `word_ptr` is an environment assignment, `NAME=value`. */
+bool _wlmaker_subprocess_spawn_is_assignment(const char *word_ptr)
+{
+    if ('_' != *word_ptr && !isalpha((unsigned char)*word_ptr)) return false;
+    for (++word_ptr; '=' != *word_ptr; ++word_ptr) {
+        if ('_' != *word_ptr && !isalnum((unsigned char)*word_ptr)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Creates the environment for the child: The compositor's environment, with
+ * the assignments from the command line added or replaced.
+ *
+ * @param assignments_ptr
+ * @param assignments
+ *
+ * @return A NULL-terminated array, to be released by free(3). Or NULL on
+ *     error.
+ */
+char **_wlmaker_subprocess_spawn_environment(
+    char **assignments_ptr,
+    size_t assignments)
+{
+    size_t variables = 0;
+    for (char **env_ptr = environ; NULL != *env_ptr; ++env_ptr) ++variables;
+    char **envp_ptr = logged_calloc(
+        assignments + variables + 1, sizeof(char*));
+    if (NULL == envp_ptr) return NULL;
+
+    size_t pos = 0;
+    for (size_t i = 0; i < assignments; ++i) {
+        envp_ptr[pos++] = assignments_ptr[i];
+    }
+    for (char **env_ptr = environ; NULL != *env_ptr; ++env_ptr) {
+        bool replaced = false;
+        for (size_t i = 0; i < assignments && !replaced; ++i) {
+            size_t name_len = strchr(assignments_ptr[i], '=') -
+                assignments_ptr[i] + 1;
+            replaced = 0 == strncmp(*env_ptr, assignments_ptr[i], name_len);
+        }
+        if (!replaced) envp_ptr[pos++] = *env_ptr;
+    }
+    envp_ptr[pos] = NULL;
+    return envp_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Sets up the file actions for stdin, stdout and stderr of the child.
+ *
+ * @param file_actions_ptr
+ * @param output
+ * @param path_ptr
+ * @param stdout_pipe         Set to the stdout pipe, if a pipe is used.
+ * @param stderr_pipe         Set to the stderr pipe, if a pipe is used.
+ *
+ * @return true on success.
+ */
+bool _wlmaker_subprocess_spawn_setup_output(
+    posix_spawn_file_actions_t *file_actions_ptr,
+    wlmaker_subprocess_output_t output,
+    const char *path_ptr,
+    int stdout_pipe[2],
+    int stderr_pipe[2])
+{
+    int rv = posix_spawn_file_actions_addopen(
+        file_actions_ptr, STDIN_FILENO, "/dev/null", O_RDONLY, 0);
+
+    switch (output) {
+    case WLMAKER_SUBPROCESS_OUTPUT_DISCARD:
+        path_ptr = "/dev/null";
+        // fall through.
+    case WLMAKER_SUBPROCESS_OUTPUT_FILE:
+        if (0 == rv) {
+            rv = posix_spawn_file_actions_addopen(
+                file_actions_ptr, STDOUT_FILENO, path_ptr,
+                O_WRONLY | O_APPEND | O_CREAT, 0600);
+        }
+        if (0 == rv) {
+            rv = posix_spawn_file_actions_adddup2(
+                file_actions_ptr, STDOUT_FILENO, STDERR_FILENO);
+        }
+        break;
+
+    default:
+        // The read ends stay with the compositor, and must not leak.
+        if (0 != pipe2(stdout_pipe, O_CLOEXEC) ||
+            0 != pipe2(stderr_pipe, O_CLOEXEC)) {
+            bs_log(BS_WARNING | BS_ERRNO, "Failed pipe2(..., O_CLOEXEC)");
+            return false;
+        }
+        if (0 == rv) {
+            rv = posix_spawn_file_actions_adddup2(
+                file_actions_ptr, stdout_pipe[1], STDOUT_FILENO);
+        }
+        if (0 == rv) {
+            rv = posix_spawn_file_actions_adddup2(
+                file_actions_ptr, stderr_pipe[1], STDERR_FILENO);
+        }
+        break;
+    }
+
+    if (0 != rv) {
+        errno = rv;
+        bs_log(BS_WARNING | BS_ERRNO, "Failed posix_spawn_file_actions_*");
+        return false;
+    }
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Sets up attributes for the child: Signals are unblocked, and reset to the
+ * default disposition. The event loop blocks the signals it handles.
+ *
+ * @param attr_ptr
+ *
+ * @return true on success.
+ */
+bool _wlmaker_subprocess_spawn_setup_attr(posix_spawnattr_t *attr_ptr)
+{
+    sigset_t sigset;
+    sigemptyset(&sigset);
+    int rv = posix_spawnattr_setsigmask(attr_ptr, &sigset);
+    if (0 == rv) {
+        sigfillset(&sigset);
+        rv = posix_spawnattr_setsigdefault(attr_ptr, &sigset);
+    }
+    if (0 == rv) {
+        rv = posix_spawnattr_setflags(
+            attr_ptr, POSIX_SPAWN_SETSIGMASK | POSIX_SPAWN_SETSIGDEF);
+    }
+    if (0 != rv) {
+        errno = rv;
+        bs_log(BS_WARNING | BS_ERRNO, "Failed posix_spawnattr_*(%p, ...)",
+               attr_ptr);
+        return false;
+    }
+    return true;
+}
+
+/* == Unit tests =========================================================== */
+
+static void test_split(bs_test_t *test_ptr);
+static void test_spawn(bs_test_t *test_ptr);
+static void test_abandon(bs_test_t *test_ptr);
+static void test_benchmark(bs_test_t *test_ptr);
+
+const bs_test_case_t wlmaker_subprocess_spawn_test_cases[] = {
+    { 1, "split", test_split },
+    { 1, "spawn", test_spawn },
+    { 1, "abandon", test_abandon },
+    // Takes a while, and needs 1 GiB of memory. Enable for measuring.
+    { 0, "benchmark", test_benchmark },
+    { 0, NULL, NULL }
+};
+
+/* ------------------------------------------------------------------------- */
+/** Tests splitting the command line into words. */
+void test_split(bs_test_t *test_ptr)
+{
+    char **words_ptr = _wlmaker_subprocess_spawn_split(
+        " A=1  /bin/sh -c \"echo a  b\" x\"y\"z ");
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, words_ptr);
+    BS_TEST_VERIFY_STREQ(test_ptr, "A=1", words_ptr[0]);
+    BS_TEST_VERIFY_STREQ(test_ptr, "/bin/sh", words_ptr[1]);
+    BS_TEST_VERIFY_STREQ(test_ptr, "-c", words_ptr[2]);
+    BS_TEST_VERIFY_STREQ(test_ptr, "echo a  b", words_ptr[3]);
+    BS_TEST_VERIFY_STREQ(test_ptr, "xyz", words_ptr[4]);
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, words_ptr[5]);
+    free(words_ptr);
+
+    words_ptr = _wlmaker_subprocess_spawn_split("");
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, words_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, words_ptr[0]);
+    free(words_ptr);
+
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, _wlmaker_subprocess_spawn_is_assignment("A_1=x"));
+    BS_TEST_VERIFY_FALSE(
+        test_ptr, _wlmaker_subprocess_spawn_is_assignment("1A=x"));
+    BS_TEST_VERIFY_FALSE(
+        test_ptr, _wlmaker_subprocess_spawn_is_assignment("/bin/a=x"));
+    BS_TEST_VERIFY_FALSE(
+        test_ptr, _wlmaker_subprocess_spawn_is_assignment("A"));
+}
+
+/* ------------------------------------------------------------------------- */
+/** Tests spawning, with output to the pipe and discarded. */
+void test_spawn(bs_test_t *test_ptr)
+{
+    int stdout_fd, stderr_fd, status;
+    pid_t pid = wlmaker_subprocess_spawn(
+        "WLMAKER_TEST=value /bin/sh -c \"echo $WLMAKER_TEST\"",
+        WLMAKER_SUBPROCESS_OUTPUT_LOG, NULL, &stdout_fd, &stderr_fd);
+    BS_TEST_VERIFY_TRUE_OR_RETURN(test_ptr, 0 < pid);
+    BS_TEST_VERIFY_TRUE(test_ptr, 0 <= stdout_fd);
+    BS_TEST_VERIFY_TRUE(test_ptr, 0 <= stderr_fd);
+
+    char buf[16] = { 0 };
+    BS_TEST_VERIFY_EQ(test_ptr, 6, read(stdout_fd, buf, sizeof(buf) - 1));
+    BS_TEST_VERIFY_STREQ(test_ptr, "value\n", buf);
+    BS_TEST_VERIFY_EQ(test_ptr, pid, waitpid(pid, &status, 0));
+    BS_TEST_VERIFY_TRUE(test_ptr, WIFEXITED(status));
+    BS_TEST_VERIFY_EQ(test_ptr, 0, WEXITSTATUS(status));
+    close(stdout_fd);
+    close(stderr_fd);
+
+    pid = wlmaker_subprocess_spawn(
+        "/bin/sh -c \"echo discarded\"",
+        WLMAKER_SUBPROCESS_OUTPUT_DISCARD, NULL, &stdout_fd, &stderr_fd);
+    BS_TEST_VERIFY_TRUE_OR_RETURN(test_ptr, 0 < pid);
+    BS_TEST_VERIFY_EQ(test_ptr, -1, stdout_fd);
+    BS_TEST_VERIFY_EQ(test_ptr, -1, stderr_fd);
+    BS_TEST_VERIFY_EQ(test_ptr, pid, waitpid(pid, &status, 0));
+    BS_TEST_VERIFY_TRUE(test_ptr, WIFEXITED(status));
+    BS_TEST_VERIFY_EQ(test_ptr, 0, WEXITSTATUS(status));
+
+    BS_TEST_VERIFY_EQ(
+        test_ptr, -1,
+        wlmaker_subprocess_spawn(
+            "/nonexistent/binary", WLMAKER_SUBPROCESS_OUTPUT_LOG, NULL,
+            &stdout_fd, &stderr_fd));
+    BS_TEST_VERIFY_EQ(test_ptr, -1, stdout_fd);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Tests that an abandoned process is killed and reaped, pipes closed. */
+void test_abandon(bs_test_t *test_ptr)
+{
+    int stdout_fd, stderr_fd;
+    pid_t pid = wlmaker_subprocess_spawn(
+        "/bin/sh -c \"trap '' TERM; sleep 60\"",
+        WLMAKER_SUBPROCESS_OUTPUT_LOG, NULL, &stdout_fd, &stderr_fd);
+    BS_TEST_VERIFY_TRUE_OR_RETURN(test_ptr, 0 < pid);
+
+    wlmaker_subprocess_abandon(pid, stdout_fd, stderr_fd);
+    BS_TEST_VERIFY_EQ(test_ptr, -1, waitpid(pid, NULL, WNOHANG));
+    BS_TEST_VERIFY_EQ(test_ptr, ECHILD, errno);
+    BS_TEST_VERIFY_EQ(test_ptr, -1, fcntl(stdout_fd, F_GETFD));
+    BS_TEST_VERIFY_EQ(test_ptr, -1, fcntl(stderr_fd, F_GETFD));
+}
+
+/* ------------------------------------------------------------------------- */
+/** @return Monotonic time, in microseconds. */
+static uint64_t _wlmaker_subprocess_spawn_test_usec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Compares latency of starting a process through bs_subprocess (fork) and
+ * @ref wlmaker_subprocess_spawn, from a parent with 1 GiB resident.
+ */
+void test_benchmark(bs_test_t *test_ptr)
+{
+    // Touch all pages: fork(2) has to copy the page tables of these.
+    size_t rss_size = (size_t)1 << 30;
+    char *rss_ptr = malloc(rss_size);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, rss_ptr);
+    memset(rss_ptr, 0x5a, rss_size);
+
+    uint64_t fork_usec = 0, spawn_usec = 0;
+    for (int i = 0; i < WLMAKER_SUBPROCESS_SPAWN_BENCHMARK_ROUNDS; ++i) {
+        bs_subprocess_t *sp_ptr = bs_subprocess_create_cmdline("/bin/true");
+        BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, sp_ptr);
+        uint64_t start_usec = _wlmaker_subprocess_spawn_test_usec();
+        bool started = bs_subprocess_start(sp_ptr);
+        fork_usec += _wlmaker_subprocess_spawn_test_usec() - start_usec;
+        BS_TEST_VERIFY_TRUE(test_ptr, started);
+        int exit_status, signal_number;
+        while (started && !bs_subprocess_terminated(
+                   sp_ptr, &exit_status, &signal_number)) usleep(1000);
+        bs_subprocess_destroy(sp_ptr);
+
+        int stdout_fd, stderr_fd;
+        start_usec = _wlmaker_subprocess_spawn_test_usec();
+        pid_t pid = wlmaker_subprocess_spawn(
+            "/bin/true", WLMAKER_SUBPROCESS_OUTPUT_LOG, NULL,
+            &stdout_fd, &stderr_fd);
+        spawn_usec += _wlmaker_subprocess_spawn_test_usec() - start_usec;
+        BS_TEST_VERIFY_TRUE(test_ptr, 0 < pid);
+        if (0 < pid) {
+            waitpid(pid, NULL, 0);
+            close(stdout_fd);
+            close(stderr_fd);
+        }
+    }
+    free(rss_ptr);
+
+    bs_log(BS_INFO, "Start latency with 1 GiB resident, average of %d: "
+           "bs_subprocess %"PRIu64" us, wlmaker_subprocess_spawn %"PRIu64" us.",
+           WLMAKER_SUBPROCESS_SPAWN_BENCHMARK_ROUNDS,
+           fork_usec / WLMAKER_SUBPROCESS_SPAWN_BENCHMARK_ROUNDS,
+           spawn_usec / WLMAKER_SUBPROCESS_SPAWN_BENCHMARK_ROUNDS);
+}
+
+/* == End of subprocess_spawn.c ============================================ */
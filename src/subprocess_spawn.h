@@ -0,0 +1,91 @@
+/* ========================================================================= */
+/**
+ * @file subprocess_spawn.h
+ *
+ * @copyright
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __SUBPROCESS_SPAWN_H__
+#define __SUBPROCESS_SPAWN_H__
+
+#include <sys/types.h>
+#include <libbase/libbase.h>
+
+#include "subprocess_monitor.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+/**
+ * Starts the command line through posix_spawn(3).
+ *
+ * Other than fork(2), this does not copy the compositor's page tables, so
+ * the cost of starting does not grow with the compositor's memory use.
+ *
+ * The command line is split at whitespace, double quotes group words.
+ * Leading `NAME=value` words are added to the environment.
+ *
+ * The executable is searched for in the compositor's `PATH`. A `PATH=value`
+ * word given on the command line applies to the started process only, and
+ * is not used to locate its executable.
+ *
+ * stdin is connected to /dev/null. stdout and stderr are routed as given by
+ * `output`: @ref WLMAKER_SUBPROCESS_OUTPUT_DISCARD connects them to
+ * /dev/null, and @ref WLMAKER_SUBPROCESS_OUTPUT_FILE appends them to
+ * `path_ptr`. Otherwise, they are connected to pipes, for reading through
+ * the @ref wlmaker_subprocess_monitor_t.
+ *
+ * @param cmdline_ptr
+ * @param output
+ * @param path_ptr
+ * @param stdout_read_fd_ptr  Set to the read end of the stdout pipe, or -1.
+ * @param stderr_read_fd_ptr  Set to the read end of the stderr pipe, or -1.
+ *
+ * @return PID of the started process, or -1 on error.
+ */
+pid_t wlmaker_subprocess_spawn(
+    const char *cmdline_ptr,
+    wlmaker_subprocess_output_t output,
+    const char *path_ptr,
+    int *stdout_read_fd_ptr,
+    int *stderr_read_fd_ptr);
+
+/**
+ * Cleans up after a process from @ref wlmaker_subprocess_spawn that could not
+ * be handed over to the @ref wlmaker_subprocess_monitor_t.
+ *
+ * Closes the read ends of the pipes, then kills and reaps the process, since
+ * nobody else would. Uses SIGKILL, as a process ignoring SIGTERM would block
+ * the compositor in waitpid(2).
+ *
+ * @param pid
+ * @param stdout_read_fd      Read end of the stdout pipe, or -1.
+ * @param stderr_read_fd      Read end of the stderr pipe, or -1.
+ */
+void wlmaker_subprocess_abandon(
+    pid_t pid,
+    int stdout_read_fd,
+    int stderr_read_fd);
+
+/** Unit test cases. */
+extern const bs_test_case_t wlmaker_subprocess_spawn_test_cases[];
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif /* __SUBPROCESS_SPAWN_H__ */
+/* == End of subprocess_spawn.h ============================================ */
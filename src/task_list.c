@@ -324,16 +324,16 @@ void _wlmaker_task_list_draw_window_into_cairo(
     bool active,
     int pos_y)
 {
-    cairo_set_source_argb8888(cairo_ptr, color);
-    cairo_set_font_size(cairo_ptr, font_style_ptr->size);
-    cairo_select_font_face(
+    wlmtk_style_font_t font_style = *font_style_ptr;
+    font_style.weight = active ?
+        WLMTK_FONT_WEIGHT_BOLD : WLMTK_FONT_WEIGHT_NORMAL;
+    wlmaker_primitives_draw_text(
         cairo_ptr,
-        font_style_ptr->face,
-        CAIRO_FONT_SLANT_NORMAL,
-        active ? CAIRO_FONT_WEIGHT_BOLD : CAIRO_FONT_WEIGHT_NORMAL);
-    cairo_move_to(cairo_ptr, 10, pos_y);
-    cairo_show_text(cairo_ptr, _wlmaker_task_list_window_name(window_ptr));
- }
+        10, pos_y,
+        &font_style,
+        color,
+        _wlmaker_task_list_window_name(window_ptr));
+}
 
 /* ------------------------------------------------------------------------- */
 /**
@@ -26,8 +26,10 @@
 
 /** State of a toplevel's window menu. */
 struct _wlmaker_tl_menu_t {
-    /** Pointer to the window's @ref wlmtk_menu_t. */
-    wlmtk_menu_t              *menu_ptr;
+    /** Back-link to server, for creating the action items. */
+    wlmaker_server_t          *server_ptr;
+    /** Listener for @ref wlmtk_window_events_t::menu_created. */
+    struct wl_listener        menu_created_listener;
 };
 
 /** Temporary: Struct for defining an item for the window menu. */
@@ -52,6 +54,10 @@ static const wlmaker_window_menu_item_t _xdg_toplevel_menu_items[] = {
     { NULL, 0 }  // Sentinel.
 };
 
+static void _wlmaker_tl_menu_handle_menu_created(
+    struct wl_listener *listener_ptr,
+    void *data_ptr);
+
 /* == Exported methods ===================================================== */
 
 /* ------------------------------------------------------------------------- */
@@ -62,7 +68,40 @@ wlmaker_tl_menu_t *wlmaker_tl_menu_create(
     wlmaker_tl_menu_t *tl_menu_ptr = logged_calloc(
         1, sizeof(wlmaker_tl_menu_t));
     if (NULL == tl_menu_ptr) return NULL;
-    tl_menu_ptr->menu_ptr = wlmtk_window_menu(window_ptr);
+    tl_menu_ptr->server_ptr = server_ptr;
+
+    // The window menu is created on demand. Populate it then.
+    wlmtk_util_connect_listener_signal(
+        &wlmtk_window_events(window_ptr)->menu_created,
+        &tl_menu_ptr->menu_created_listener,
+        _wlmaker_tl_menu_handle_menu_created);
+    return tl_menu_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmaker_tl_menu_destroy(wlmaker_tl_menu_t *tl_menu_ptr)
+{
+    wlmtk_util_disconnect_listener(&tl_menu_ptr->menu_created_listener);
+    free(tl_menu_ptr);
+}
+
+/* == Local (static) methods =============================================== */
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Handles @ref wlmtk_window_events_t::menu_created: Adds the items.
+ *
+ * @param listener_ptr
+ * @param data_ptr            Points to the window's @ref wlmtk_menu_t.
+ */
+void _wlmaker_tl_menu_handle_menu_created(
+    struct wl_listener *listener_ptr,
+    void *data_ptr)
+{
+    wlmaker_tl_menu_t *tl_menu_ptr = BS_CONTAINER_OF(
+        listener_ptr, wlmaker_tl_menu_t, menu_created_listener);
+    wlmaker_server_t *server_ptr = tl_menu_ptr->server_ptr;
+    wlmtk_menu_t *menu_ptr = data_ptr;
 
     for (const wlmaker_window_menu_item_t *i_ptr = &_xdg_toplevel_menu_items[0];
          i_ptr->text_ptr != NULL;
@@ -75,23 +114,14 @@ wlmaker_tl_menu_t *wlmaker_tl_menu_create(
             server_ptr,
             server_ptr->env_ptr);
         if (NULL == action_item_ptr) {
-            wlmaker_tl_menu_destroy(tl_menu_ptr);
-            return NULL;
+            bs_log(BS_WARNING, "Failed wlmaker_action_item_create(\"%s\", ...)",
+                   i_ptr->text_ptr);
+            continue;
         }
         wlmtk_menu_add_item(
-            tl_menu_ptr->menu_ptr,
+            menu_ptr,
             wlmaker_action_item_menu_item(action_item_ptr));
     }
-
-    return tl_menu_ptr;
-}
-
-/* ------------------------------------------------------------------------- */
-void wlmaker_tl_menu_destroy(wlmaker_tl_menu_t *tl_menu_ptr)
-{
-    free(tl_menu_ptr);
 }
 
-/* == Local (static) methods =============================================== */
-
 /* == End of tl_menu.c ===================================================== */
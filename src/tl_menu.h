@@ -32,7 +32,8 @@ extern "C" {
 typedef struct _wlmaker_tl_menu_t wlmaker_tl_menu_t;
 
 /**
- * Creates a (window) menu for a toplevel (window).
+ * Creates a (window) menu for a toplevel (window). The items are added when
+ * the window creates its menu, see @ref wlmtk_window_events_t::menu_created.
  *
  * @param window_ptr
  * @param server_ptr
@@ -44,7 +45,7 @@ wlmaker_tl_menu_t *wlmaker_tl_menu_create(
     wlmaker_server_t *server_ptr);
 
 /**
- * Destroys the toplevel's menu.
+ * Destroys the toplevel's menu. Must be called before destroying the window.
  *
  * @param tl_menu_ptr
  */
@@ -293,8 +293,7 @@ void test_init_fini(bs_test_t *test_ptr)
         0, 2, 2, 20);
 
     // Update layout, test updated positions.
-    fe_ptr->dimensions.width = 200;
-    fe_ptr->dimensions.height = 120;
+    wlmtk_fake_element_set_dimensions(fe_ptr, 200, 120);
     wlmtk_container_update_layout(&bordered.super_container);
     test_rectangle_pos(
         test_ptr, bordered.northern_border_rectangle_ptr,
@@ -20,6 +20,9 @@
 
 #include "buffer.h"
 
+#include <math.h>
+
+#include "container.h"
 #include "util.h"
 
 #define WLR_USE_UNSTABLE
@@ -37,6 +40,10 @@ static void _wlmtk_buffer_element_get_dimensions(
     int *top_ptr,
     int *right_ptr,
     int *bottom_ptr);
+static void _wlmtk_buffer_logical_size(
+    wlmtk_buffer_t *buffer_ptr,
+    int *width_ptr,
+    int *height_ptr);
 static bool _wlmtk_buffer_element_pointer_motion(
     wlmtk_element_t *element_ptr,
     double x,
@@ -69,6 +76,7 @@ bool wlmtk_buffer_init(wlmtk_buffer_t *buffer_ptr,
     }
     buffer_ptr->orig_super_element_vmt = wlmtk_element_extend(
         &buffer_ptr->super_element, &buffer_element_vmt);
+    buffer_ptr->scale = 1.0;
     return true;
 }
 
@@ -93,7 +101,21 @@ void wlmtk_buffer_set(
     wlmtk_buffer_t *buffer_ptr,
     struct wlr_buffer *wlr_buffer_ptr)
 {
-    if (wlr_buffer_ptr == buffer_ptr->wlr_buffer_ptr) return;
+    wlmtk_buffer_set_scaled(buffer_ptr, wlr_buffer_ptr, 1.0);
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_buffer_set_scaled(
+    wlmtk_buffer_t *buffer_ptr,
+    struct wlr_buffer *wlr_buffer_ptr,
+    double scale)
+{
+    if (wlr_buffer_ptr == buffer_ptr->wlr_buffer_ptr &&
+        scale == buffer_ptr->scale) return;
+
+    // A change in dimensions must be reflected in the parent's geometry.
+    int old_width, old_height, width, height;
+    _wlmtk_buffer_logical_size(buffer_ptr, &old_width, &old_height);
 
     if (NULL != buffer_ptr->wlr_buffer_ptr) {
         wlr_buffer_unlock(buffer_ptr->wlr_buffer_ptr);
@@ -104,11 +126,25 @@ void wlmtk_buffer_set(
     } else {
         buffer_ptr->wlr_buffer_ptr = NULL;
     }
+    buffer_ptr->scale = scale;
+
+    _wlmtk_buffer_logical_size(buffer_ptr, &width, &height);
+    if (old_width != width || old_height != height) {
+        wlmtk_element_invalidate_parent_geometry(&buffer_ptr->super_element);
+    }
 
     if (NULL != buffer_ptr->wlr_scene_buffer_ptr) {
         wlr_scene_buffer_set_buffer(
             buffer_ptr->wlr_scene_buffer_ptr,
             buffer_ptr->wlr_buffer_ptr);
+        // 0x0 is the default: Show the buffer at its size in pixels.
+        if (1.0 != buffer_ptr->scale) {
+            wlr_scene_buffer_set_dest_size(
+                buffer_ptr->wlr_scene_buffer_ptr, width, height);
+        } else {
+            wlr_scene_buffer_set_dest_size(
+                buffer_ptr->wlr_scene_buffer_ptr, 0, 0);
+        }
     }
 }
 
@@ -141,6 +177,12 @@ struct wlr_scene_node *_wlmtk_buffer_element_create_scene_node(
         wlr_scene_tree_ptr,
         buffer_ptr->wlr_buffer_ptr);
     BS_ASSERT(NULL != buffer_ptr->wlr_scene_buffer_ptr);
+    if (1.0 != buffer_ptr->scale) {
+        int width, height;
+        _wlmtk_buffer_logical_size(buffer_ptr, &width, &height);
+        wlr_scene_buffer_set_dest_size(
+            buffer_ptr->wlr_scene_buffer_ptr, width, height);
+    }
 
     wlmtk_util_connect_listener_signal(
         &buffer_ptr->wlr_scene_buffer_ptr->node.events.destroy,
@@ -171,15 +213,34 @@ void _wlmtk_buffer_element_get_dimensions(
 
     if (NULL != left_ptr) *left_ptr = 0;
     if (NULL != top_ptr) *top_ptr = 0;
+    _wlmtk_buffer_logical_size(buffer_ptr, right_ptr, bottom_ptr);
+}
 
-    if (NULL == buffer_ptr->wlr_buffer_ptr) {
-        if (NULL != right_ptr) *right_ptr = 0;
-        if (NULL != bottom_ptr) *bottom_ptr = 0;
-        return;
+/* ------------------------------------------------------------------------- */
+/**
+ * Computes the size of the buffer in logical units, ie. scaled by
+ * `1 / scale`. That is 0x0 if there is no buffer.
+ *
+ * @param buffer_ptr
+ * @param width_ptr           May be NULL.
+ * @param height_ptr          May be NULL.
+ */
+void _wlmtk_buffer_logical_size(
+    wlmtk_buffer_t *buffer_ptr,
+    int *width_ptr,
+    int *height_ptr)
+{
+    int width = 0, height = 0;
+    if (NULL != buffer_ptr->wlr_buffer_ptr) {
+        width = buffer_ptr->wlr_buffer_ptr->width;
+        height = buffer_ptr->wlr_buffer_ptr->height;
+        if (1.0 != buffer_ptr->scale) {
+            width = lround(width / buffer_ptr->scale);
+            height = lround(height / buffer_ptr->scale);
+        }
     }
-
-    if (NULL != right_ptr) *right_ptr = buffer_ptr->wlr_buffer_ptr->width;
-    if (NULL != bottom_ptr) *bottom_ptr = buffer_ptr->wlr_buffer_ptr->height;
+    if (NULL != width_ptr) *width_ptr = width;
+    if (NULL != height_ptr) *height_ptr = height;
 }
 
 /* ------------------------------------------------------------------------- */
@@ -205,8 +266,9 @@ bool _wlmtk_buffer_element_pointer_motion(
     wlmtk_buffer_t *buffer_ptr = BS_CONTAINER_OF(
         element_ptr, wlmtk_buffer_t, super_element);
 
-    if (x < 0 || x >= buffer_ptr->wlr_buffer_ptr->width ||
-        y < 0 || y >= buffer_ptr->wlr_buffer_ptr->height) {
+    int width, height;
+    _wlmtk_buffer_logical_size(buffer_ptr, &width, &height);
+    if (x < 0 || x >= width || y < 0 || y >= height) {
         x = NAN;
         y = NAN;
     }
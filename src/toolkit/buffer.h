@@ -45,6 +45,8 @@ struct _wlmtk_buffer_t {
 
     /** WLR buffer holding the contents. */
     struct wlr_buffer        *wlr_buffer_ptr;
+    /** Pixels of `wlr_buffer_ptr` per logical unit. 1.0, unless scaled. */
+    double                    scale;
     /** Scene graph API node. Only set after calling `create_scene_node`. */
     struct wlr_scene_buffer  *wlr_scene_buffer_ptr;
 
@@ -82,6 +84,19 @@ void wlmtk_buffer_set(
     wlmtk_buffer_t *buffer_ptr,
     struct wlr_buffer *wlr_buffer_ptr);
 
+/**
+ * Sets (or updates) buffer contents, rendered at `scale`. The buffer is shown
+ * at `1 / scale` of its size in pixels, so HiDPI outputs get full detail.
+ *
+ * @param buffer_ptr
+ * @param wlr_buffer_ptr      As for @ref wlmtk_buffer_set.
+ * @param scale               Pixels of `wlr_buffer_ptr` per logical unit.
+ */
+void wlmtk_buffer_set_scaled(
+    wlmtk_buffer_t *buffer_ptr,
+    struct wlr_buffer *wlr_buffer_ptr,
+    double scale);
+
 /** @return the superclass' @ref wlmtk_element_t of `buffer_ptr`. */
 wlmtk_element_t *wlmtk_buffer_element(wlmtk_buffer_t *buffer_ptr);
 
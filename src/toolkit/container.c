@@ -29,6 +29,74 @@
 
 /* == Declarations ========================================================= */
 
+/** Containers with fewer visible elements are hit-tested by a linear scan. */
+#define WLMTK_CONTAINER_INDEX_MIN_ELEMENTS 8
+/** Maximum number of grid cells of the spatial index, per dimension. */
+#define WLMTK_CONTAINER_INDEX_MAX_CELLS 16
+/** Minimum width and height of a grid cell of the spatial index, in pixels. */
+#define WLMTK_CONTAINER_INDEX_MIN_CELL_SIZE 64
+
+/** An element of the spatial index. Coordinates relative to the container. */
+typedef struct {
+    /** The element. */
+    wlmtk_element_t           *element_ptr;
+    /** Horizontal position of the element. */
+    int                       x;
+    /** Vertical position of the element. */
+    int                       y;
+    /** Leftmost position of the element's pointer area. */
+    int                       x1;
+    /** Topmost position of the element's pointer area. */
+    int                       y1;
+    /** Rightmost position of the element's pointer area, exclusive. */
+    int                       x2;
+    /** Bottommost position of the element's pointer area, exclusive. */
+    int                       y2;
+} wlmtk_container_index_item_t;
+
+/**
+ * Spatial index of the container: A uniform grid over the pointer areas of
+ * all visible elements. Each cell lists the elements overlapping the cell, in
+ * stacking order. A lookup then only has to consider the elements of one cell.
+ */
+struct _wlmtk_container_index_t {
+    /** Whether the index must be rebuilt before the next lookup. */
+    bool                      dirty;
+    /** Whether the grid is in use. Otherwise: Use a linear scan. */
+    bool                      use_grid;
+    /** Lookups in progress. The index must not be rebuilt meanwhile. */
+    int                       lookups_in_progress;
+
+    /** The indexed elements, in stacking order: Topmost first. */
+    wlmtk_container_index_item_t *items_ptr;
+    /** Number of items in @ref wlmtk_container_index_t::items_ptr. */
+    size_t                    items;
+    /** Capacity of @ref wlmtk_container_index_t::items_ptr. */
+    size_t                    items_capacity;
+
+    /** Leftmost position of the grid, relative to the container. */
+    int                       x;
+    /** Topmost position of the grid, relative to the container. */
+    int                       y;
+    /** Width of a grid cell. */
+    int                       cell_width;
+    /** Height of a grid cell. */
+    int                       cell_height;
+    /** Number of columns of the grid. 0, if there is no item. */
+    int                       columns;
+    /** Number of rows of the grid. 0, if there is no item. */
+    int                       rows;
+
+    /** Offsets into `entries_ptr`, for each cell and one beyond the last. */
+    size_t                    *offsets_ptr;
+    /** Capacity of @ref wlmtk_container_index_t::offsets_ptr. */
+    size_t                    offsets_capacity;
+    /** Indices into `items_ptr`, in stacking order for each of the cells. */
+    size_t                    *entries_ptr;
+    /** Capacity of @ref wlmtk_container_index_t::entries_ptr. */
+    size_t                    entries_capacity;
+};
+
 static void _wlmtk_container_element_dlnode_destroy(
     bs_dllist_node_t *dlnode_ptr, void *ud_ptr);
 static struct wlr_scene_node *_wlmtk_container_element_create_scene_node(
@@ -69,6 +137,17 @@ static bool _wlmtk_container_element_keyboard_event(
     size_t key_syms_count,
     uint32_t modifiers);
 
+static struct wlr_box _wlmtk_container_union(
+    wlmtk_container_t *container_ptr,
+    void (*fn)(wlmtk_element_t *element_ptr,
+               int *left_ptr, int *top_ptr, int *right_ptr, int *bottom_ptr));
+static void _wlmtk_container_box_to_coordinates(
+    const struct wlr_box *box_ptr,
+    int *left_ptr,
+    int *top_ptr,
+    int *right_ptr,
+    int *bottom_ptr);
+
 static void handle_wlr_scene_tree_node_destroy(
     struct wl_listener *listener_ptr,
     __UNUSED__ void *data_ptr);
@@ -77,8 +156,32 @@ static bool update_pointer_focus_at(
     double x,
     double y,
     uint32_t time_msec);
+static bool _wlmtk_container_pointer_focus_element(
+    wlmtk_container_t *container_ptr,
+    wlmtk_element_t *element_ptr,
+    double x,
+    double y,
+    uint32_t time_msec);
 static void _wlmtk_container_update_layout(wlmtk_container_t *container_ptr);
 
+static wlmtk_container_index_t *_wlmtk_container_index(
+    wlmtk_container_t *container_ptr);
+static void _wlmtk_container_index_rebuild(
+    wlmtk_container_t *container_ptr,
+    wlmtk_container_index_t *index_ptr);
+static void _wlmtk_container_index_lookup(
+    wlmtk_container_index_t *index_ptr,
+    double x,
+    double y,
+    size_t *begin_ptr,
+    size_t *end_ptr);
+static void _wlmtk_container_index_destroy(wlmtk_container_index_t *index_ptr);
+static bool _wlmtk_container_index_reserve(
+    void **data_ptr_ptr,
+    size_t *capacity_ptr,
+    size_t size,
+    size_t element_size);
+
 /** Virtual method table for the container's super class: Element. */
 static const wlmtk_element_vmt_t container_element_vmt = {
     .create_scene_node = _wlmtk_container_element_create_scene_node,
@@ -159,6 +262,11 @@ void wlmtk_container_fini(wlmtk_container_t *container_ptr)
         _wlmtk_container_element_dlnode_destroy,
         container_ptr);
 
+    if (NULL != container_ptr->index_ptr) {
+        _wlmtk_container_index_destroy(container_ptr->index_ptr);
+        container_ptr->index_ptr = NULL;
+    }
+
     // For containers created with wlmtk_container_init_attached(): We also
     // need to remove references to the WLR scene tree.
     if (NULL != container_ptr->wlr_scene_tree_ptr) {
@@ -187,6 +295,7 @@ void wlmtk_container_add_element(
         &container_ptr->elements,
         wlmtk_dlnode_from_element(element_ptr));
     wlmtk_element_set_parent_container(element_ptr, container_ptr);
+    wlmtk_container_invalidate_geometry(container_ptr);
 
     wlmtk_container_update_layout(container_ptr);
 }
@@ -226,6 +335,7 @@ void wlmtk_container_add_element_atop(
                 reference_element_ptr->wlr_scene_node_ptr);
         }
     }
+    wlmtk_container_invalidate_geometry(container_ptr);
     wlmtk_container_update_layout(container_ptr);
 }
 
@@ -240,6 +350,7 @@ void wlmtk_container_remove_element(
     bs_dllist_remove(
         &container_ptr->elements,
         wlmtk_dlnode_from_element(element_ptr));
+    wlmtk_container_invalidate_geometry(container_ptr);
 
     if (container_ptr->pointer_grab_element_ptr == element_ptr) {
         _wlmtk_container_element_pointer_grab_cancel(
@@ -284,6 +395,7 @@ void wlmtk_container_raise_element_to_top(
     if (NULL != element_ptr->wlr_scene_node_ptr) {
         wlr_scene_node_raise_to_top(element_ptr->wlr_scene_node_ptr);
     }
+    wlmtk_container_invalidate_geometry(container_ptr);
 
     wlmtk_container_update_layout(container_ptr);
 }
@@ -380,6 +492,21 @@ void wlmtk_container_set_keyboard_focus_element(
     }
 }
 
+/* ------------------------------------------------------------------------- */
+void wlmtk_container_invalidate_geometry(wlmtk_container_t *container_ptr)
+{
+    // The dimensions and pointer area of the container may have changed,
+    // too. So the parent's geometry must be invalidated as well.
+    for (; NULL != container_ptr;
+         container_ptr = container_ptr->super_element.parent_container_ptr) {
+        container_ptr->dimensions_valid = false;
+        container_ptr->pointer_area_valid = false;
+        if (NULL != container_ptr->index_ptr) {
+            container_ptr->index_ptr->dirty = true;
+        }
+    }
+}
+
 /* ------------------------------------------------------------------------- */
 struct wlr_scene_tree *wlmtk_container_wlr_scene_tree(
     wlmtk_container_t *container_ptr)
@@ -462,31 +589,13 @@ void _wlmtk_container_element_get_dimensions(
     wlmtk_container_t *container_ptr = BS_CONTAINER_OF(
         element_ptr, wlmtk_container_t, super_element);
 
-    int left = INT32_MAX, top = INT32_MAX;
-    int right = INT32_MIN, bottom = INT32_MIN;
-    for (bs_dllist_node_t *dlnode_ptr = container_ptr->elements.head_ptr;
-         dlnode_ptr != NULL;
-         dlnode_ptr = dlnode_ptr->next_ptr) {
-        wlmtk_element_t *element_ptr = wlmtk_element_from_dlnode(dlnode_ptr);
-        if (!element_ptr->visible) continue;
-
-        int x_pos, y_pos;
-        wlmtk_element_get_position(element_ptr, &x_pos, &y_pos);
-        int x1, y1, x2, y2;
-        wlmtk_element_get_dimensions(element_ptr, &x1, &y1, &x2, &y2);
-        left = BS_MIN(left, x_pos + x1);
-        top = BS_MIN(top, y_pos + y1);
-        right = BS_MAX(right, x_pos + x2);
-        bottom = BS_MAX(bottom, y_pos + y2);
+    if (!container_ptr->dimensions_valid) {
+        container_ptr->dimensions = _wlmtk_container_union(
+            container_ptr, wlmtk_element_get_dimensions);
+        container_ptr->dimensions_valid = true;
     }
-
-    if (left >= right) { left = 0; right = 0; }
-    if (top >= bottom) { top = 0; bottom = 0; }
-
-    if (NULL != left_ptr) *left_ptr = left;
-    if (NULL != top_ptr) *top_ptr = top;
-    if (NULL != right_ptr) *right_ptr = right;
-    if (NULL != bottom_ptr) *bottom_ptr = bottom;
+    _wlmtk_container_box_to_coordinates(
+        &container_ptr->dimensions, left_ptr, top_ptr, right_ptr, bottom_ptr);
 }
 
 /* ------------------------------------------------------------------------- */
@@ -509,6 +618,32 @@ void _wlmtk_container_element_get_pointer_area(
     wlmtk_container_t *container_ptr = BS_CONTAINER_OF(
         element_ptr, wlmtk_container_t, super_element);
 
+    if (!container_ptr->pointer_area_valid) {
+        container_ptr->pointer_area = _wlmtk_container_union(
+            container_ptr, wlmtk_element_get_pointer_area);
+        container_ptr->pointer_area_valid = true;
+    }
+    _wlmtk_container_box_to_coordinates(
+        &container_ptr->pointer_area,
+        left_ptr, top_ptr, right_ptr, bottom_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Computes the union of the visible elements' boxes, as reported by `fn`.
+ *
+ * @param container_ptr
+ * @param fn                  Either @ref wlmtk_element_get_dimensions or
+ *                            @ref wlmtk_element_get_pointer_area.
+ *
+ * @return The union, relative to the container's position. An empty box at
+ *     the origin, if there is no visible element.
+ */
+struct wlr_box _wlmtk_container_union(
+    wlmtk_container_t *container_ptr,
+    void (*fn)(wlmtk_element_t *element_ptr,
+               int *left_ptr, int *top_ptr, int *right_ptr, int *bottom_ptr))
+{
     int left = INT32_MAX, top = INT32_MAX;
     int right = INT32_MIN, bottom = INT32_MIN;
     for (bs_dllist_node_t *dlnode_ptr = container_ptr->elements.head_ptr;
@@ -520,7 +655,7 @@ void _wlmtk_container_element_get_pointer_area(
         int x_pos, y_pos;
         wlmtk_element_get_position(element_ptr, &x_pos, &y_pos);
         int x1, y1, x2, y2;
-        wlmtk_element_get_pointer_area(element_ptr, &x1, &y1, &x2, &y2);
+        fn(element_ptr, &x1, &y1, &x2, &y2);
         left = BS_MIN(left, x_pos + x1);
         top = BS_MIN(top, y_pos + y1);
         right = BS_MAX(right, x_pos + x2);
@@ -530,10 +665,24 @@ void _wlmtk_container_element_get_pointer_area(
     if (left >= right) { left = 0; right = 0; }
     if (top >= bottom) { top = 0; bottom = 0; }
 
-    if (NULL != left_ptr) *left_ptr = left;
-    if (NULL != top_ptr) *top_ptr = top;
-    if (NULL != right_ptr) *right_ptr = right;
-    if (NULL != bottom_ptr) *bottom_ptr = bottom;
+    struct wlr_box box = {
+        .x = left, .y = top, .width = right - left, .height = bottom - top };
+    return box;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Stores the extents of `box_ptr` into each of the non-NULL arguments. */
+void _wlmtk_container_box_to_coordinates(
+    const struct wlr_box *box_ptr,
+    int *left_ptr,
+    int *top_ptr,
+    int *right_ptr,
+    int *bottom_ptr)
+{
+    if (NULL != left_ptr) *left_ptr = box_ptr->x;
+    if (NULL != top_ptr) *top_ptr = box_ptr->y;
+    if (NULL != right_ptr) *right_ptr = box_ptr->x + box_ptr->width;
+    if (NULL != bottom_ptr) *bottom_ptr = box_ptr->y + box_ptr->height;
 }
 
 /* ------------------------------------------------------------------------- */
@@ -796,34 +945,44 @@ bool update_pointer_focus_at(
         return true;
     }
 
-    for (bs_dllist_node_t *dlnode_ptr = container_ptr->elements.head_ptr;
-         dlnode_ptr != NULL;
-         dlnode_ptr = dlnode_ptr->next_ptr) {
-        wlmtk_element_t *element_ptr = wlmtk_element_from_dlnode(dlnode_ptr);
-
-        if (!element_ptr->visible) continue;
-
-        int x_pos, y_pos;
-        wlmtk_element_get_position(element_ptr, &x_pos, &y_pos);
-        int x1, y1, x2, y2;
-        wlmtk_element_get_pointer_area(element_ptr, &x1, &y1, &x2, &y2);
-        if (x_pos + x1 <= x && x < x_pos + x2 &&
-            y_pos + y1 <= y && y < y_pos + y2) {
-            if (!wlmtk_element_pointer_motion(
-                    element_ptr, x - x_pos, y - y_pos, time_msec)) {
-                continue;
+    wlmtk_container_index_t *index_ptr = _wlmtk_container_index(
+        container_ptr);
+    if (NULL != index_ptr) {
+        size_t begin, end;
+        _wlmtk_container_index_lookup(index_ptr, x, y, &begin, &end);
+        index_ptr->lookups_in_progress++;
+        for (size_t i = begin; i < end; ++i) {
+            wlmtk_container_index_item_t *item_ptr =
+                &index_ptr->items_ptr[index_ptr->entries_ptr[i]];
+            if (item_ptr->x1 <= x && x < item_ptr->x2 &&
+                item_ptr->y1 <= y && y < item_ptr->y2 &&
+                _wlmtk_container_pointer_focus_element(
+                    container_ptr, item_ptr->element_ptr,
+                    x - item_ptr->x, y - item_ptr->y, time_msec)) {
+                index_ptr->lookups_in_progress--;
+                return true;
             }
-
-            // There is a focus change. Invalidate coordinates in old element.
-            if (container_ptr->pointer_focus_element_ptr != element_ptr &&
-                NULL != container_ptr->pointer_focus_element_ptr) {
-                wlmtk_element_pointer_motion(
-                    container_ptr->pointer_focus_element_ptr,
-                    NAN, NAN, time_msec);
-
+        }
+        index_ptr->lookups_in_progress--;
+    } else {
+        for (bs_dllist_node_t *dlnode_ptr = container_ptr->elements.head_ptr;
+             dlnode_ptr != NULL;
+             dlnode_ptr = dlnode_ptr->next_ptr) {
+            wlmtk_element_t *element_ptr = wlmtk_element_from_dlnode(
+                dlnode_ptr);
+            if (!element_ptr->visible) continue;
+
+            int x_pos, y_pos;
+            wlmtk_element_get_position(element_ptr, &x_pos, &y_pos);
+            int x1, y1, x2, y2;
+            wlmtk_element_get_pointer_area(element_ptr, &x1, &y1, &x2, &y2);
+            if (x_pos + x1 <= x && x < x_pos + x2 &&
+                y_pos + y1 <= y && y < y_pos + y2 &&
+                _wlmtk_container_pointer_focus_element(
+                    container_ptr, element_ptr,
+                    x - x_pos, y - y_pos, time_msec)) {
+                return true;
             }
-            container_ptr->pointer_focus_element_ptr = element_ptr;
-            return true;
         }
     }
 
@@ -839,6 +998,41 @@ bool update_pointer_focus_at(
     return false;
 }
 
+/* ------------------------------------------------------------------------- */
+/**
+ * Passes the motion to `element_ptr`, and makes it the pointer focus element
+ * if it accepts the motion.
+ *
+ * @param container_ptr
+ * @param element_ptr
+ * @param x                   Horizontal position, relative to the element.
+ * @param y                   Vertical position, relative to the element.
+ * @param time_msec
+ *
+ * @return Whether the element accepted the motion.
+ */
+bool _wlmtk_container_pointer_focus_element(
+    wlmtk_container_t *container_ptr,
+    wlmtk_element_t *element_ptr,
+    double x,
+    double y,
+    uint32_t time_msec)
+{
+    if (!wlmtk_element_pointer_motion(element_ptr, x, y, time_msec)) {
+        return false;
+    }
+
+    // There is a focus change. Invalidate coordinates in old element.
+    if (container_ptr->pointer_focus_element_ptr != element_ptr &&
+        NULL != container_ptr->pointer_focus_element_ptr) {
+        wlmtk_element_pointer_motion(
+            container_ptr->pointer_focus_element_ptr,
+            NAN, NAN, time_msec);
+    }
+    container_ptr->pointer_focus_element_ptr = element_ptr;
+    return true;
+}
+
 /* ------------------------------------------------------------------------- */
 /**
  * Base implementation of wlmtk_container_vmt_t::update_layout. If there's
@@ -849,6 +1043,7 @@ bool update_pointer_focus_at(
  */
 void _wlmtk_container_update_layout(wlmtk_container_t *container_ptr)
 {
+    wlmtk_container_invalidate_geometry(container_ptr);
     if (NULL != container_ptr->super_element.parent_container_ptr) {
         wlmtk_container_update_layout(
             container_ptr->super_element.parent_container_ptr);
@@ -857,6 +1052,236 @@ void _wlmtk_container_update_layout(wlmtk_container_t *container_ptr)
     }
 }
 
+/* ------------------------------------------------------------------------- */
+/**
+ * Returns the spatial index of the container, rebuilt if needed.
+ *
+ * @param container_ptr
+ *
+ * @return Pointer to the index, or NULL if the elements are to be scanned
+ *     linearly: For containers with few elements, or on allocation failure.
+ */
+wlmtk_container_index_t *_wlmtk_container_index(
+    wlmtk_container_t *container_ptr)
+{
+    wlmtk_container_index_t *index_ptr = container_ptr->index_ptr;
+    if (NULL == index_ptr) {
+        index_ptr = logged_calloc(1, sizeof(wlmtk_container_index_t));
+        if (NULL == index_ptr) return NULL;
+        index_ptr->dirty = true;
+        container_ptr->index_ptr = index_ptr;
+    }
+
+    if (index_ptr->dirty) {
+        // Must not rebuild while iterating over the index. Use linear scan.
+        if (0 < index_ptr->lookups_in_progress) return NULL;
+        _wlmtk_container_index_rebuild(container_ptr, index_ptr);
+    }
+    return index_ptr->use_grid ? index_ptr : NULL;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Rebuilds the spatial index from the container's visible elements.
+ *
+ * The grid spans the bounding box of all pointer areas, with at most
+ * @ref WLMTK_CONTAINER_INDEX_MAX_CELLS cells in each dimension. Elements are
+ * visited from top to bottom, so each cell's entries are in stacking order.
+ *
+ * @param container_ptr
+ * @param index_ptr
+ */
+void _wlmtk_container_index_rebuild(
+    wlmtk_container_t *container_ptr,
+    wlmtk_container_index_t *index_ptr)
+{
+    index_ptr->dirty = false;
+    index_ptr->use_grid = false;
+    index_ptr->items = 0;
+    index_ptr->columns = 0;
+    index_ptr->rows = 0;
+
+    size_t visible_elements = 0;
+    for (bs_dllist_node_t *dlnode_ptr = container_ptr->elements.head_ptr;
+         dlnode_ptr != NULL;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        if (wlmtk_element_from_dlnode(dlnode_ptr)->visible) visible_elements++;
+    }
+    if (WLMTK_CONTAINER_INDEX_MIN_ELEMENTS > visible_elements) return;
+    if (!_wlmtk_container_index_reserve(
+            (void**)&index_ptr->items_ptr, &index_ptr->items_capacity,
+            visible_elements, sizeof(wlmtk_container_index_item_t))) return;
+
+    int left = INT32_MAX, top = INT32_MAX;
+    int right = INT32_MIN, bottom = INT32_MIN;
+    for (bs_dllist_node_t *dlnode_ptr = container_ptr->elements.head_ptr;
+         dlnode_ptr != NULL;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        wlmtk_element_t *element_ptr = wlmtk_element_from_dlnode(dlnode_ptr);
+        if (!element_ptr->visible) continue;
+
+        wlmtk_container_index_item_t *item_ptr =
+            &index_ptr->items_ptr[index_ptr->items];
+        item_ptr->element_ptr = element_ptr;
+        wlmtk_element_get_position(element_ptr, &item_ptr->x, &item_ptr->y);
+        int x1, y1, x2, y2;
+        wlmtk_element_get_pointer_area(element_ptr, &x1, &y1, &x2, &y2);
+        // An empty pointer area cannot be hit. Skip it.
+        if (x1 >= x2 || y1 >= y2) continue;
+        item_ptr->x1 = item_ptr->x + x1;
+        item_ptr->y1 = item_ptr->y + y1;
+        item_ptr->x2 = item_ptr->x + x2;
+        item_ptr->y2 = item_ptr->y + y2;
+
+        left = BS_MIN(left, item_ptr->x1);
+        top = BS_MIN(top, item_ptr->y1);
+        right = BS_MAX(right, item_ptr->x2);
+        bottom = BS_MAX(bottom, item_ptr->y2);
+        index_ptr->items++;
+    }
+
+    // No item: An empty grid. Lookups will not find anything.
+    if (0 == index_ptr->items) {
+        index_ptr->use_grid = true;
+        return;
+    }
+
+    index_ptr->x = left;
+    index_ptr->y = top;
+    index_ptr->columns = BS_MAX(1, BS_MIN(
+        WLMTK_CONTAINER_INDEX_MAX_CELLS,
+        (right - left) / WLMTK_CONTAINER_INDEX_MIN_CELL_SIZE));
+    index_ptr->rows = BS_MAX(1, BS_MIN(
+        WLMTK_CONTAINER_INDEX_MAX_CELLS,
+        (bottom - top) / WLMTK_CONTAINER_INDEX_MIN_CELL_SIZE));
+    index_ptr->cell_width =
+        (right - left + index_ptr->columns - 1) / index_ptr->columns;
+    index_ptr->cell_height =
+        (bottom - top + index_ptr->rows - 1) / index_ptr->rows;
+
+    size_t cells = index_ptr->columns * index_ptr->rows;
+    if (!_wlmtk_container_index_reserve(
+            (void**)&index_ptr->offsets_ptr, &index_ptr->offsets_capacity,
+            cells + 1, sizeof(size_t))) return;
+    memset(index_ptr->offsets_ptr, 0, (cells + 1) * sizeof(size_t));
+
+    // First pass: Count the items of each cell, at offsets_ptr[cell + 1].
+    for (size_t i = 0; i < index_ptr->items; ++i) {
+        wlmtk_container_index_item_t *item_ptr = &index_ptr->items_ptr[i];
+        int c1 = (item_ptr->x1 - index_ptr->x) / index_ptr->cell_width;
+        int c2 = (item_ptr->x2 - 1 - index_ptr->x) / index_ptr->cell_width;
+        int r1 = (item_ptr->y1 - index_ptr->y) / index_ptr->cell_height;
+        int r2 = (item_ptr->y2 - 1 - index_ptr->y) / index_ptr->cell_height;
+        for (int r = r1; r <= r2; ++r) {
+            for (int c = c1; c <= c2; ++c) {
+                index_ptr->offsets_ptr[r * index_ptr->columns + c + 1]++;
+            }
+        }
+    }
+    for (size_t cell = 1; cell <= cells; ++cell) {
+        index_ptr->offsets_ptr[cell] += index_ptr->offsets_ptr[cell - 1];
+    }
+    if (!_wlmtk_container_index_reserve(
+            (void**)&index_ptr->entries_ptr, &index_ptr->entries_capacity,
+            index_ptr->offsets_ptr[cells], sizeof(size_t))) return;
+
+    // Second pass: Store the entries. This advances each cell's offset to
+    // the start of the next cell, so they're shifted back by one thereafter.
+    for (size_t i = 0; i < index_ptr->items; ++i) {
+        wlmtk_container_index_item_t *item_ptr = &index_ptr->items_ptr[i];
+        int c1 = (item_ptr->x1 - index_ptr->x) / index_ptr->cell_width;
+        int c2 = (item_ptr->x2 - 1 - index_ptr->x) / index_ptr->cell_width;
+        int r1 = (item_ptr->y1 - index_ptr->y) / index_ptr->cell_height;
+        int r2 = (item_ptr->y2 - 1 - index_ptr->y) / index_ptr->cell_height;
+        for (int r = r1; r <= r2; ++r) {
+            for (int c = c1; c <= c2; ++c) {
+                size_t *offset_ptr =
+                    &index_ptr->offsets_ptr[r * index_ptr->columns + c];
+                index_ptr->entries_ptr[(*offset_ptr)++] = i;
+            }
+        }
+    }
+    memmove(&index_ptr->offsets_ptr[1], &index_ptr->offsets_ptr[0],
+            cells * sizeof(size_t));
+    index_ptr->offsets_ptr[0] = 0;
+
+    index_ptr->use_grid = true;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Looks up the cell covering (x, y).
+ *
+ * @param index_ptr
+ * @param x
+ * @param y
+ * @param begin_ptr           Set to the first entry of the cell.
+ * @param end_ptr             Set to one beyond the last entry of the cell.
+ *                            Equals `*begin_ptr`, if there is no such cell.
+ */
+void _wlmtk_container_index_lookup(
+    wlmtk_container_index_t *index_ptr,
+    double x,
+    double y,
+    size_t *begin_ptr,
+    size_t *end_ptr)
+{
+    *begin_ptr = 0;
+    *end_ptr = 0;
+
+    // Note: Comparisons with NAN are always false. That's the desired result.
+    if (!(index_ptr->x <= x &&
+          x < index_ptr->x + index_ptr->columns * index_ptr->cell_width &&
+          index_ptr->y <= y &&
+          y < index_ptr->y + index_ptr->rows * index_ptr->cell_height)) return;
+
+    int column = (x - index_ptr->x) / index_ptr->cell_width;
+    int row = (y - index_ptr->y) / index_ptr->cell_height;
+    size_t cell = row * index_ptr->columns + column;
+    *begin_ptr = index_ptr->offsets_ptr[cell];
+    *end_ptr = index_ptr->offsets_ptr[cell + 1];
+}
+
+/* ------------------------------------------------------------------------- */
+/** Destroys the spatial index. */
+void _wlmtk_container_index_destroy(wlmtk_container_index_t *index_ptr)
+{
+    if (NULL != index_ptr->entries_ptr) free(index_ptr->entries_ptr);
+    if (NULL != index_ptr->offsets_ptr) free(index_ptr->offsets_ptr);
+    if (NULL != index_ptr->items_ptr) free(index_ptr->items_ptr);
+    free(index_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Ensures `*data_ptr_ptr` holds at least `size` elements. Does not retain
+ * the contents when growing the allocation.
+ *
+ * @param data_ptr_ptr
+ * @param capacity_ptr
+ * @param size
+ * @param element_size
+ *
+ * @return true on success.
+ */
+bool _wlmtk_container_index_reserve(
+    void **data_ptr_ptr,
+    size_t *capacity_ptr,
+    size_t size,
+    size_t element_size)
+{
+    if (*capacity_ptr >= size && NULL != *data_ptr_ptr) return true;
+
+    if (NULL != *data_ptr_ptr) free(*data_ptr_ptr);
+    *capacity_ptr = BS_MAX(BS_MAX(size, 2 * *capacity_ptr), 1);
+    *data_ptr_ptr = logged_calloc(*capacity_ptr, element_size);
+    if (NULL == *data_ptr_ptr) {
+        *capacity_ptr = 0;
+        return false;
+    }
+    return true;
+}
+
 /* == Helper for unit tests: A fake container with a tree, as parent ======= */
 
 /** State of the "fake" parent container. Refers to a scene graph. */
@@ -926,6 +1351,8 @@ static void test_pointer_grab(bs_test_t *test_ptr);
 static void test_pointer_grab_events(bs_test_t *test_ptr);
 static void test_keyboard_event(bs_test_t *test_ptr);
 static void test_keyboard_focus(bs_test_t *test_ptr);
+static void test_index_lookup(bs_test_t *test_ptr);
+static void test_cached_geometry(bs_test_t *test_ptr);
 
 const bs_test_case_t wlmtk_container_test_cases[] = {
     { 1, "init_fini", test_init_fini },
@@ -942,6 +1369,8 @@ const bs_test_case_t wlmtk_container_test_cases[] = {
     { 1, "pointer_grab_events", test_pointer_grab_events },
     { 1, "keyboard_event", test_keyboard_event },
     { 1, "keyboard_focus", test_keyboard_focus },
+    { 1, "index_lookup", test_index_lookup },
+    { 1, "cached_geometry", test_cached_geometry },
     { 0, NULL, NULL }
 };
 
@@ -1952,4 +2381,156 @@ void test_keyboard_focus(bs_test_t *test_ptr)
     wlmtk_container_fini(&p);
 }
 
+/* ------------------------------------------------------------------------- */
+/** Returns the topmost visible element at (x, y), by linear scan. */
+static wlmtk_element_t *_test_element_at(
+    wlmtk_container_t *container_ptr, double x, double y)
+{
+    for (bs_dllist_node_t *dlnode_ptr = container_ptr->elements.head_ptr;
+         dlnode_ptr != NULL;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        wlmtk_element_t *element_ptr = wlmtk_element_from_dlnode(dlnode_ptr);
+        if (!element_ptr->visible) continue;
+
+        int x_pos, y_pos;
+        wlmtk_element_get_position(element_ptr, &x_pos, &y_pos);
+        int x1, y1, x2, y2;
+        wlmtk_element_get_pointer_area(element_ptr, &x1, &y1, &x2, &y2);
+        if (x_pos + x1 <= x && x < x_pos + x2 &&
+            y_pos + y1 <= y && y < y_pos + y2) return element_ptr;
+    }
+    return NULL;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Verifies pointer focus from the index matches a linear scan, on a grid. */
+static void _test_index_matches_scan(
+    bs_test_t *test_ptr, wlmtk_container_t *container_ptr)
+{
+    // Offset by 0.5: The fake element's motion excludes the topmost row.
+    for (double y = -300.5; y < 2300; y += 23) {
+        for (double x = -300.5; x < 2300; x += 29) {
+            wlmtk_element_pointer_motion(
+                &container_ptr->super_element, x, y, 7);
+            BS_TEST_VERIFY_EQ(
+                test_ptr,
+                _test_element_at(container_ptr, x, y),
+                container_ptr->pointer_focus_element_ptr);
+        }
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/** Tests that hit-testing through the spatial index matches linear scan. */
+void test_index_lookup(bs_test_t *test_ptr)
+{
+    wlmtk_container_t container;
+    BS_ASSERT(wlmtk_container_init(&container, NULL));
+    wlmtk_element_set_visible(&container.super_element, true);
+
+    // Pseudo-random, but reproducible placement of overlapping elements.
+    wlmtk_fake_element_t *fe_ptrs[40];
+    uint32_t seed = 42;
+    for (size_t i = 0; i < sizeof(fe_ptrs) / sizeof(fe_ptrs[0]); ++i) {
+        fe_ptrs[i] = wlmtk_fake_element_create();
+        BS_ASSERT(NULL != fe_ptrs[i]);
+        seed = seed * 1103515245 + 12345;
+        fe_ptrs[i]->dimensions.width = 1 + (seed >> 8) % 400;
+        seed = seed * 1103515245 + 12345;
+        fe_ptrs[i]->dimensions.height = 1 + (seed >> 8) % 300;
+        seed = seed * 1103515245 + 12345;
+        int x = (int)((seed >> 8) % 2000) - 200;
+        seed = seed * 1103515245 + 12345;
+        int y = (int)((seed >> 8) % 2000) - 200;
+        wlmtk_element_set_position(&fe_ptrs[i]->element, x, y);
+        wlmtk_element_set_visible(&fe_ptrs[i]->element, 0 != i % 7);
+        wlmtk_container_add_element(&container, &fe_ptrs[i]->element);
+    }
+
+    _test_index_matches_scan(test_ptr, &container);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, container.index_ptr);
+    BS_TEST_VERIFY_TRUE(test_ptr, container.index_ptr->use_grid);
+    BS_TEST_VERIFY_FALSE(test_ptr, container.index_ptr->dirty);
+
+    // Moving, raising and hiding must all invalidate the index.
+    wlmtk_element_set_position(&fe_ptrs[3]->element, 500, 500);
+    BS_TEST_VERIFY_TRUE(test_ptr, container.index_ptr->dirty);
+    wlmtk_container_raise_element_to_top(&container, &fe_ptrs[5]->element);
+    wlmtk_element_set_visible(&fe_ptrs[8]->element, false);
+    wlmtk_element_set_visible(&fe_ptrs[14]->element, true);
+    _test_index_matches_scan(test_ptr, &container);
+
+    // Resize and update layout, remove an element.
+    wlmtk_fake_element_set_dimensions(
+        fe_ptrs[10], 1500, fe_ptrs[10]->dimensions.height);
+    wlmtk_container_update_layout(&container);
+    BS_TEST_VERIFY_TRUE(test_ptr, container.index_ptr->dirty);
+    wlmtk_container_remove_element(&container, &fe_ptrs[11]->element);
+    wlmtk_element_destroy(&fe_ptrs[11]->element);
+    _test_index_matches_scan(test_ptr, &container);
+
+    // Will destroy the remaining elements.
+    wlmtk_container_fini(&container);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Tests that dimensions are cached, and invalidated through the parents. */
+void test_cached_geometry(bs_test_t *test_ptr)
+{
+    wlmtk_container_t parent, container;
+    BS_ASSERT(wlmtk_container_init(&parent, NULL));
+    BS_ASSERT(wlmtk_container_init(&container, NULL));
+    wlmtk_element_set_visible(&container.super_element, true);
+    wlmtk_container_add_element(&parent, &container.super_element);
+
+    wlmtk_fake_element_t *fe_ptr = wlmtk_fake_element_create();
+    fe_ptr->dimensions.width = 10;
+    fe_ptr->dimensions.height = 5;
+    wlmtk_element_set_visible(&fe_ptr->element, true);
+    wlmtk_container_add_element(&container, &fe_ptr->element);
+
+    struct wlr_box box = wlmtk_element_get_dimensions_box(
+        &parent.super_element);
+    BS_TEST_VERIFY_EQ(test_ptr, 10, box.width);
+    BS_TEST_VERIFY_TRUE(test_ptr, parent.dimensions_valid);
+    BS_TEST_VERIFY_TRUE(test_ptr, container.dimensions_valid);
+
+    // A change of the leaf's dimensions invalidates all parents.
+    wlmtk_fake_element_set_dimensions(fe_ptr, 20, 5);
+    BS_TEST_VERIFY_FALSE(test_ptr, container.dimensions_valid);
+    BS_TEST_VERIFY_FALSE(test_ptr, parent.dimensions_valid);
+    box = wlmtk_element_get_dimensions_box(&parent.super_element);
+    BS_TEST_VERIFY_EQ(test_ptr, 20, box.width);
+
+    // Updating the layout invalidates the container and it's parent.
+    wlmtk_container_update_layout(&container);
+    BS_TEST_VERIFY_FALSE(test_ptr, container.dimensions_valid);
+    BS_TEST_VERIFY_FALSE(test_ptr, parent.dimensions_valid);
+    box = wlmtk_element_get_dimensions_box(&parent.super_element);
+    BS_TEST_VERIFY_EQ(test_ptr, 20, box.width);
+
+    // Moving the element invalidates, too. So does the pointer area.
+    int l, t, r, b;
+    wlmtk_element_get_pointer_area(&parent.super_element, &l, &t, &r, &b);
+    BS_TEST_VERIFY_EQ(test_ptr, -1, l);
+    BS_TEST_VERIFY_TRUE(test_ptr, parent.pointer_area_valid);
+    wlmtk_element_set_position(&fe_ptr->element, 30, 40);
+    BS_TEST_VERIFY_FALSE(test_ptr, parent.pointer_area_valid);
+    wlmtk_element_get_pointer_area(&parent.super_element, &l, &t, &r, &b);
+    BS_TEST_VERIFY_EQ(test_ptr, 29, l);
+    BS_TEST_VERIFY_EQ(test_ptr, 38, t);
+    BS_TEST_VERIFY_EQ(test_ptr, 53, r);
+    BS_TEST_VERIFY_EQ(test_ptr, 49, b);
+
+    // And so does hiding it.
+    wlmtk_element_set_visible(&fe_ptr->element, false);
+    box = wlmtk_element_get_dimensions_box(&parent.super_element);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, box.width);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, box.height);
+
+    wlmtk_container_remove_element(&parent, &container.super_element);
+    wlmtk_container_fini(&container);
+    wlmtk_container_fini(&parent);
+}
+
 /* == End of container.c =================================================== */
@@ -27,6 +27,8 @@
 typedef struct _wlmtk_container_t wlmtk_container_t;
 /** Forward declaration: Container virtual method table. */
 typedef struct _wlmtk_container_vmt_t wlmtk_container_vmt_t;
+/** Forward declaration: Spatial index of the container's elements. */
+typedef struct _wlmtk_container_index_t wlmtk_container_index_t;
 
 #include "element.h"
 
@@ -82,6 +84,28 @@ struct _wlmtk_container_t {
     wlmtk_element_t           *left_button_element_ptr;
     /** Stores the element with current keyboard focus. May be NULL. */
     wlmtk_element_t           *keyboard_focus_element_ptr;
+
+    /**
+     * Spatial index over the pointer areas of the visible elements. Used for
+     * hit-testing on pointer motion. Created lazily, and rebuilt on the first
+     * lookup after @ref wlmtk_container_invalidate_geometry was called.
+     */
+    wlmtk_container_index_t   *index_ptr;
+
+    /**
+     * Cached union of the visible elements' dimensions, relative to the
+     * container's position. Valid if `dimensions_valid` is set.
+     */
+    struct wlr_box            dimensions;
+    /** Whether @ref wlmtk_container_t::dimensions is valid. */
+    bool                      dimensions_valid;
+    /**
+     * Cached union of the visible elements' pointer areas, relative to the
+     * container's position. Valid if `pointer_area_valid` is set.
+     */
+    struct wlr_box            pointer_area;
+    /** Whether @ref wlmtk_container_t::pointer_area is valid. */
+    bool                      pointer_area_valid;
 };
 
 /**
@@ -233,6 +257,20 @@ void wlmtk_container_set_keyboard_focus_element(
     wlmtk_container_t *container_ptr,
     wlmtk_element_t *element_ptr);
 
+/**
+ * Invalidates the cached geometry of the container and of all it's parents.
+ *
+ * This clears the cached dimensions and pointer area, and marks the spatial
+ * index for a rebuild. Must be called when position, visibility, dimensions
+ * or pointer area of an element change. This is done implicitly by
+ * @ref wlmtk_container_update_layout.
+ *
+ * Private: Should be called only by wlmtk_element_t and derived classes.
+ *
+ * @param container_ptr
+ */
+void wlmtk_container_invalidate_geometry(wlmtk_container_t *container_ptr);
+
 /**
  * Updates the layout of the container.
  *
@@ -241,6 +279,7 @@ void wlmtk_container_set_keyboard_focus_element(
 static inline void wlmtk_container_update_layout(
     wlmtk_container_t *container_ptr)
 {
+    wlmtk_container_invalidate_geometry(container_ptr);
     container_ptr->vmt.update_layout(container_ptr);
 }
 
@@ -270,12 +270,20 @@ void wlmtk_element_set_position(
     element_ptr->x = x;
     element_ptr->y = y;
 
+    wlmtk_element_invalidate_parent_geometry(element_ptr);
     if (NULL != element_ptr->parent_container_ptr) {
         wlmtk_container_update_pointer_focus(
             element_ptr->parent_container_ptr);
     }
 }
 
+/* ------------------------------------------------------------------------- */
+void wlmtk_element_invalidate_parent_geometry(wlmtk_element_t *element_ptr)
+{
+    if (NULL == element_ptr->parent_container_ptr) return;
+    wlmtk_container_invalidate_geometry(element_ptr->parent_container_ptr);
+}
+
 /* ------------------------------------------------------------------------- */
 bool wlmtk_element_pointer_motion(
     wlmtk_element_t *element_ptr,
@@ -491,6 +499,17 @@ void wlmtk_fake_element_grab_keyboard(wlmtk_fake_element_t *fake_element_ptr)
     }
 }
 
+/* ------------------------------------------------------------------------- */
+void wlmtk_fake_element_set_dimensions(
+    wlmtk_fake_element_t *fake_element_ptr,
+    int width,
+    int height)
+{
+    fake_element_ptr->dimensions.width = width;
+    fake_element_ptr->dimensions.height = height;
+    wlmtk_element_invalidate_parent_geometry(&fake_element_ptr->element);
+}
+
 /* ------------------------------------------------------------------------- */
 /** dtor for the "fake" element used for tests. */
 void fake_destroy(wlmtk_element_t *element_ptr)
@@ -345,6 +345,17 @@ void wlmtk_element_set_position(
     int x,
     int y);
 
+/**
+ * Invalidates the geometry cached by all parent containers of the element.
+ *
+ * Must be called by element implementations when their dimensions or pointer
+ * area change, so the parents' cached dimensions and pointer area are
+ * re-computed. @ref wlmtk_element_set_position does that implicitly.
+ *
+ * @param element_ptr
+ */
+void wlmtk_element_invalidate_parent_geometry(wlmtk_element_t *element_ptr);
+
 /**
  * Gets the area that the element on which the element accepts pointer events.
  *
@@ -537,6 +548,19 @@ wlmtk_fake_element_t *wlmtk_fake_element_create(void);
  */
 void wlmtk_fake_element_grab_keyboard(wlmtk_fake_element_t *fake_element_ptr);
 
+/**
+ * Sets width and height of @ref wlmtk_fake_element_t::dimensions and
+ * invalidates the parent's geometry, as a real element would.
+ *
+ * @param fake_element_ptr
+ * @param width
+ * @param height
+ */
+void wlmtk_fake_element_set_dimensions(
+    wlmtk_fake_element_t *fake_element_ptr,
+    int width,
+    int height);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
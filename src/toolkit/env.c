@@ -22,6 +22,8 @@
 
 #include <libbase/libbase.h>
 
+#include "image_loader.h"
+
 #define WLR_USE_UNSTABLE
 #include <wlr/types/wlr_cursor.h>
 #undef WLR_USE_UNSTABLE
@@ -36,6 +38,14 @@ struct _wlmtk_env_t {
     struct wlr_xcursor_manager *wlr_xcursor_manager_ptr;
     /** Points to a `wlr_seat`. */
     struct wlr_seat           *wlr_seat_ptr;
+    /** Points to the `wl_event_loop`. */
+    struct wl_event_loop      *wl_event_loop_ptr;
+    /** Image loader, created on first use. */
+    wlmtk_image_loader_t      *image_loader_ptr;
+    /** Icon theme, to look up icons by name. Not owned. */
+    wlmtk_icon_theme_t        *icon_theme_ptr;
+    /** Scale to render images at. See @ref wlmtk_env_set_scale. */
+    double                    scale;
 };
 
 /** Struct to identify a @ref wlmtk_env_cursor_t with the xcursor name. */
@@ -46,6 +56,9 @@ typedef struct {
     const char                *xcursor_name_ptr;
 } wlmtk_env_cursor_lookup_t;
 
+/** Number of worker threads for @ref wlmtk_env_image_loader. */
+static const unsigned _wlmtk_env_image_loader_threads = 2;
+
 /** Lookup table for xcursor names. */
 static const wlmtk_env_cursor_lookup_t _wlmtk_env_cursor_lookup[] = {
     { WLMTK_CURSOR_DEFAULT, "default" },
@@ -61,7 +74,8 @@ static const wlmtk_env_cursor_lookup_t _wlmtk_env_cursor_lookup[] = {
 wlmtk_env_t *wlmtk_env_create(
     struct wlr_cursor *wlr_cursor_ptr,
     struct wlr_xcursor_manager *wlr_xcursor_manager_ptr,
-    struct wlr_seat *wlr_seat_ptr)
+    struct wlr_seat *wlr_seat_ptr,
+    struct wl_event_loop *wl_event_loop_ptr)
 {
     wlmtk_env_t *env_ptr = logged_calloc(1, sizeof(wlmtk_env_t));
     if (NULL == env_ptr) return NULL;
@@ -69,6 +83,8 @@ wlmtk_env_t *wlmtk_env_create(
     env_ptr->wlr_cursor_ptr = wlr_cursor_ptr;
     env_ptr->wlr_xcursor_manager_ptr = wlr_xcursor_manager_ptr;
     env_ptr->wlr_seat_ptr = wlr_seat_ptr;
+    env_ptr->wl_event_loop_ptr = wl_event_loop_ptr;
+    env_ptr->scale = 1.0;
 
     return env_ptr;
 }
@@ -76,6 +92,10 @@ wlmtk_env_t *wlmtk_env_create(
 /* ------------------------------------------------------------------------- */
 void wlmtk_env_destroy(wlmtk_env_t *env_ptr)
 {
+    if (NULL != env_ptr->image_loader_ptr) {
+        wlmtk_image_loader_destroy(env_ptr->image_loader_ptr);
+        env_ptr->image_loader_ptr = NULL;
+    }
     free(env_ptr);
 }
 
@@ -107,4 +127,52 @@ struct wlr_seat *wlmtk_env_wlr_seat(wlmtk_env_t *env_ptr)
     return env_ptr->wlr_seat_ptr;
 }
 
+/* ------------------------------------------------------------------------- */
+struct wl_event_loop *wlmtk_env_wl_event_loop(wlmtk_env_t *env_ptr)
+{
+    if (NULL == env_ptr) return NULL;
+    return env_ptr->wl_event_loop_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+wlmtk_image_loader_t *wlmtk_env_image_loader(wlmtk_env_t *env_ptr)
+{
+    if (NULL == env_ptr || NULL == env_ptr->wl_event_loop_ptr) return NULL;
+    if (NULL == env_ptr->image_loader_ptr) {
+        env_ptr->image_loader_ptr = wlmtk_image_loader_create(
+            env_ptr->wl_event_loop_ptr,
+            _wlmtk_env_image_loader_threads,
+            NULL);
+    }
+    return env_ptr->image_loader_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_env_set_icon_theme(
+    wlmtk_env_t *env_ptr,
+    wlmtk_icon_theme_t *icon_theme_ptr)
+{
+    env_ptr->icon_theme_ptr = icon_theme_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+wlmtk_icon_theme_t *wlmtk_env_icon_theme(wlmtk_env_t *env_ptr)
+{
+    if (NULL == env_ptr) return NULL;
+    return env_ptr->icon_theme_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_env_set_scale(wlmtk_env_t *env_ptr, double scale)
+{
+    env_ptr->scale = 0 < scale ? scale : 1.0;
+}
+
+/* ------------------------------------------------------------------------- */
+double wlmtk_env_scale(wlmtk_env_t *env_ptr)
+{
+    if (NULL == env_ptr) return 1.0;
+    return env_ptr->scale;
+}
+
 /* == End of env.c ========================================================= */
@@ -29,6 +29,12 @@ struct wlr_cursor;
 struct wlr_seat;
 /** Forward declaration. */
 struct wlr_xcursor_manager;
+/** Forward declaration. */
+struct wl_event_loop;
+/** Forward declaration. */
+typedef struct _wlmtk_image_loader_t wlmtk_image_loader_t;
+/** Forward declaration. */
+typedef struct _wlmtk_icon_theme_t wlmtk_icon_theme_t;
 
 #ifdef __cplusplus
 extern "C" {
@@ -52,13 +58,15 @@ typedef enum {
  * @param wlr_cursor_ptr
  * @param wlr_xcursor_manager_ptr
  * @param wlr_seat_ptr
+ * @param wl_event_loop_ptr   Event loop, for elements that need timers.
  *
  * @return An environment state or NULL on error.
  */
 wlmtk_env_t *wlmtk_env_create(
     struct wlr_cursor *wlr_cursor_ptr,
     struct wlr_xcursor_manager *wlr_xcursor_manager_ptr,
-    struct wlr_seat *wlr_seat_ptr);
+    struct wlr_seat *wlr_seat_ptr,
+    struct wl_event_loop *wl_event_loop_ptr);
 
 /**
  * Destroys the environment state.
@@ -82,6 +90,64 @@ void wlmtk_env_set_cursor(wlmtk_env_t *env_ptr, wlmtk_env_cursor_t cursor);
  */
 struct wlr_seat *wlmtk_env_wlr_seat(wlmtk_env_t *env_ptr);
 
+/**
+ * Returns the event loop.
+ *
+ * @param env_ptr             May be NULL.
+ *
+ * @return Pointer to the `wl_event_loop`, or NULL if `env_ptr` is NULL.
+ */
+struct wl_event_loop *wlmtk_env_wl_event_loop(wlmtk_env_t *env_ptr);
+
+/**
+ * Returns the image loader. Created on first use.
+ *
+ * @param env_ptr             May be NULL.
+ *
+ * @return Pointer to the @ref wlmtk_image_loader_t, or NULL if `env_ptr` is
+ *     NULL, has no event loop, or on error.
+ */
+wlmtk_image_loader_t *wlmtk_env_image_loader(wlmtk_env_t *env_ptr);
+
+/**
+ * Sets the icon theme, for looking up icons by name.
+ *
+ * @param env_ptr
+ * @param icon_theme_ptr      The icon theme, or NULL. Not owned: Must outlive
+ *                            the environment, or be reset before destroyed.
+ */
+void wlmtk_env_set_icon_theme(
+    wlmtk_env_t *env_ptr,
+    wlmtk_icon_theme_t *icon_theme_ptr);
+
+/**
+ * Returns the icon theme.
+ *
+ * @param env_ptr             May be NULL.
+ *
+ * @return Pointer to the @ref wlmtk_icon_theme_t, or NULL if `env_ptr` is
+ *     NULL or none was set.
+ */
+wlmtk_icon_theme_t *wlmtk_env_icon_theme(wlmtk_env_t *env_ptr);
+
+/**
+ * Sets the scale that images are rendered at. Usually the largest scale of
+ * all outputs. Applies to images created from then on.
+ *
+ * @param env_ptr
+ * @param scale               Scale. Values <= 0 are taken as 1.0.
+ */
+void wlmtk_env_set_scale(wlmtk_env_t *env_ptr, double scale);
+
+/**
+ * Returns the scale that images are rendered at.
+ *
+ * @param env_ptr             May be NULL.
+ *
+ * @return The scale, or 1.0 if `env_ptr` is NULL or no scale was set.
+ */
+double wlmtk_env_scale(wlmtk_env_t *env_ptr);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -21,6 +21,7 @@
 #include "gfxbuf.h"
 
 #include <drm_fourcc.h>
+#include <sys/mman.h>
 
 #define WLR_USE_UNSTABLE
 #include <wlr/interfaces/wlr_buffer.h>
@@ -35,6 +36,11 @@ typedef struct {
 
     /** The actual graphics buffer. */
     bs_gfxbuf_t               *gfxbuf_ptr;
+
+    /** Memory mapping holding the pixels, for an unmanaged `gfxbuf_ptr`. */
+    void                      *map_ptr;
+    /** Size of the mapping at `map_ptr`. */
+    size_t                    map_size;
 } wlmaker_gfxbuf_t;
 
 static wlmaker_gfxbuf_t *wlmaker_gfxbuf_from_wlr_buffer(
@@ -83,6 +89,40 @@ struct wlr_buffer *bs_gfxbuf_create_wlr_buffer(
     return &gfxbuf_ptr->wlr_buffer;
 }
 
+/* ------------------------------------------------------------------------- */
+struct wlr_buffer *bs_gfxbuf_create_wlr_buffer_from_mmap(
+    unsigned width,
+    unsigned height,
+    unsigned pixels_per_line,
+    void *map_ptr,
+    size_t map_size,
+    size_t offset)
+{
+    wlmaker_gfxbuf_t *gfxbuf_ptr = logged_calloc(1, sizeof(wlmaker_gfxbuf_t));
+    if (NULL == gfxbuf_ptr) {
+        munmap(map_ptr, map_size);
+        return NULL;
+    }
+    gfxbuf_ptr->map_ptr = map_ptr;
+    gfxbuf_ptr->map_size = map_size;
+
+    wlr_buffer_init(
+        &gfxbuf_ptr->wlr_buffer,
+        &wlmaker_gfxbuf_impl,
+        width,
+        height);
+
+    gfxbuf_ptr->gfxbuf_ptr = bs_gfxbuf_create_unmanaged(
+        width, height, pixels_per_line,
+        (uint32_t*)((uint8_t*)map_ptr + offset));
+    if (NULL == gfxbuf_ptr->gfxbuf_ptr) {
+        wlmaker_gfxbuf_impl_destroy(&gfxbuf_ptr->wlr_buffer);
+        return NULL;
+    }
+
+    return &gfxbuf_ptr->wlr_buffer;
+}
+
 /* ------------------------------------------------------------------------- */
 void wlr_buffer_drop_nullify(struct wlr_buffer **wlr_buffer_ptr_ptr)
 {
@@ -150,6 +190,10 @@ void wlmaker_gfxbuf_impl_destroy(
         bs_gfxbuf_destroy(gfxbuf_ptr->gfxbuf_ptr);
         gfxbuf_ptr->gfxbuf_ptr = NULL;
     }
+    if (NULL != gfxbuf_ptr->map_ptr) {
+        munmap(gfxbuf_ptr->map_ptr, gfxbuf_ptr->map_size);
+        gfxbuf_ptr->map_ptr = NULL;
+    }
 
     free(gfxbuf_ptr);
 }
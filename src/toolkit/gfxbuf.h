@@ -45,6 +45,29 @@ struct wlr_buffer *bs_gfxbuf_create_wlr_buffer(
     unsigned width,
     unsigned height);
 
+/**
+ * Creates a wlroots buffer for ARGB32 pixels held in a memory mapping.
+ *
+ * @param width
+ * @param height
+ * @param pixels_per_line
+ * @param map_ptr             Start of the mapping, as returned by mmap(2).
+ *                            The buffer takes ownership, and unmaps it when
+ *                            destroyed. Will be unmapped on error, too.
+ * @param map_size            Size of the mapping.
+ * @param offset              Offset of the pixel data within the mapping.
+ *                            Must be a multiple of sizeof(uint32_t).
+ *
+ * @return A struct wlr_buffer. Must be released using wlr_buffer_drop().
+ */
+struct wlr_buffer *bs_gfxbuf_create_wlr_buffer_from_mmap(
+    unsigned width,
+    unsigned height,
+    unsigned pixels_per_line,
+    void *map_ptr,
+    size_t map_size,
+    size_t offset);
+
 /**
  * Drops a WLR buffer, and sets the pointer to NULL.
  *
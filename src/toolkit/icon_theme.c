@@ -0,0 +1,1360 @@
+/* ========================================================================= */
+/**
+ * @file icon_theme.c
+ *
+ * @copyright
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/// mkostemp(3) is a GNU extension, need this macro.
+#define _GNU_SOURCE
+
+#include "icon_theme.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <ftw.h>
+#include <limits.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "util.h"
+
+/* == Declarations ========================================================= */
+
+/**
+ * Header of the index. Followed by the tables of stamps, entries and names,
+ * and by the string pool. Offsets are from the start of the index, string
+ * offsets from the start of the pool. Stored in host byte order.
+ */
+typedef struct {
+    /** Identifies the format, see @ref _wlmtk_icon_theme_magic. */
+    char                      magic[8];
+    /** Theme name and base directories the index was built for. */
+    uint32_t                  config_offset;
+    /** Number of @ref wlmtk_icon_theme_stamp_t. */
+    uint32_t                  stamps;
+    /** Offset of the first @ref wlmtk_icon_theme_stamp_t. */
+    uint32_t                  stamps_offset;
+    /** Number of @ref wlmtk_icon_theme_entry_t. */
+    uint32_t                  entries;
+    /** Offset of the first @ref wlmtk_icon_theme_entry_t. */
+    uint32_t                  entries_offset;
+    /** Number of @ref wlmtk_icon_theme_name_t. */
+    uint32_t                  names;
+    /** Offset of the first @ref wlmtk_icon_theme_name_t. */
+    uint32_t                  names_offset;
+    /** Offset of the string pool. */
+    uint32_t                  strings_offset;
+    /** Size of the string pool. */
+    uint32_t                  strings_size;
+    /** Padding, to keep the tables aligned. */
+    uint32_t                  reserved;
+} wlmtk_icon_theme_header_t;
+
+/**
+ * A file or directory the index was built from, with its mtime. The index
+ * is stale if any of them changed. Icon directories hold the icon files.
+ */
+typedef struct {
+    /** Modification time: Seconds. -1 if it did not exist. */
+    int64_t                   mtime_sec;
+    /** Modification time: Nanoseconds. -1 if it did not exist. */
+    int64_t                   mtime_nsec;
+    /** Path of the file or directory. */
+    uint32_t                  path_offset;
+    /** Padding, to keep the table aligned. */
+    uint32_t                  reserved;
+} wlmtk_icon_theme_stamp_t;
+
+/** An icon file: `<stamp path>/<name>.png`. */
+typedef struct {
+    /** Index of the @ref wlmtk_icon_theme_stamp_t of the directory. */
+    uint32_t                  stamp;
+    /** Nominal size of the icon directory. */
+    uint16_t                  size;
+    /** Smallest size the icon may be used for. */
+    uint16_t                  min_size;
+    /** Largest size the icon may be used for. */
+    uint16_t                  max_size;
+    /** Scale of the icon directory. */
+    uint16_t                  scale;
+    /** Position of the theme in the inheritance order. Lower is better. */
+    uint16_t                  rank;
+    /** Padding. */
+    uint16_t                  reserved;
+} wlmtk_icon_theme_entry_t;
+
+/** An icon name, with its entries. Sorted by name. */
+typedef struct {
+    /** The icon name. */
+    uint32_t                  name_offset;
+    /** Index of the first @ref wlmtk_icon_theme_entry_t. Sorted by rank. */
+    uint32_t                  first_entry;
+    /** Number of entries. */
+    uint32_t                  entries;
+} wlmtk_icon_theme_name_t;
+
+/** State of the icon theme. */
+struct _wlmtk_icon_theme_t {
+    /** The index. Memory-mapped, or allocated. */
+    uint8_t                   *data_ptr;
+    /** Size of the index. */
+    size_t                    size;
+    /** Whether `data_ptr` is a mapping, to be released by munmap(2). */
+    bool                      mapped;
+};
+
+/** A directory of a theme, as listed in its `index.theme`. */
+typedef struct {
+    /** Name of the directory, relative to the theme. */
+    char                      *name_ptr;
+    /** Nominal size. */
+    int                       size;
+    /** Scale. */
+    int                       scale;
+    /** Type: 'F'ixed, 'S'calable or 'T'hreshold. */
+    char                      type;
+    /** Minimum size, for scalable directories. */
+    int                       min_size;
+    /** Maximum size, for scalable directories. */
+    int                       max_size;
+    /** Threshold, for threshold directories. */
+    int                       threshold;
+} wlmtk_icon_theme_dir_t;
+
+/** An icon found while building the index. */
+typedef struct {
+    /** Name of the icon. */
+    char                      *name_ptr;
+    /** The entry, as it will be stored. */
+    wlmtk_icon_theme_entry_t  entry;
+    /** Order of discovery, to keep the sort stable. */
+    size_t                    seq;
+} wlmtk_icon_theme_build_entry_t;
+
+/** A stamp found while building the index. */
+typedef struct {
+    /** Path of the file or directory. */
+    char                      *path_ptr;
+    /** Its modification time. */
+    struct timespec           mtime;
+} wlmtk_icon_theme_build_stamp_t;
+
+/** State while building the index. */
+typedef struct {
+    /** Theme names, in order of inheritance. */
+    char                      **themes_ptr;
+    /** Number of themes. */
+    size_t                    themes;
+    /** Stamps. */
+    wlmtk_icon_theme_build_stamp_t *stamps_ptr;
+    /** Number of stamps. */
+    size_t                    stamps;
+    /** Entries. */
+    wlmtk_icon_theme_build_entry_t *entries_ptr;
+    /** Number of entries. */
+    size_t                    entries;
+} wlmtk_icon_theme_builder_t;
+
+static bool _wlmtk_icon_theme_load(
+    wlmtk_icon_theme_t *icon_theme_ptr,
+    const char *index_path_ptr,
+    const char *config_ptr);
+static bool _wlmtk_icon_theme_valid(
+    const uint8_t *data_ptr,
+    size_t size,
+    const char *config_ptr);
+static bool _wlmtk_icon_theme_build(
+    wlmtk_icon_theme_t *icon_theme_ptr,
+    const char *theme_name_ptr,
+    const char **base_dirs_ptr,
+    const char *unthemed_dir_ptr,
+    const char *config_ptr);
+static bool _wlmtk_icon_theme_builder_add_theme(
+    wlmtk_icon_theme_builder_t *builder_ptr,
+    const char *theme_name_ptr);
+static bool _wlmtk_icon_theme_builder_scan_theme(
+    wlmtk_icon_theme_builder_t *builder_ptr,
+    size_t rank,
+    const char **base_dirs_ptr);
+static bool _wlmtk_icon_theme_builder_scan_dir(
+    wlmtk_icon_theme_builder_t *builder_ptr,
+    const char *path_ptr,
+    const wlmtk_icon_theme_dir_t *dir_ptr,
+    size_t rank);
+static bool _wlmtk_icon_theme_builder_add_stamp(
+    wlmtk_icon_theme_builder_t *builder_ptr,
+    const char *path_ptr);
+static bool _wlmtk_icon_theme_builder_serialize(
+    wlmtk_icon_theme_builder_t *builder_ptr,
+    const char *config_ptr,
+    uint8_t **data_ptr_ptr,
+    size_t *size_ptr);
+static void _wlmtk_icon_theme_builder_fini(
+    wlmtk_icon_theme_builder_t *builder_ptr);
+static bool _wlmtk_icon_theme_parse(
+    const char *path_ptr,
+    char **inherits_ptr_ptr,
+    wlmtk_icon_theme_dir_t **dirs_ptr_ptr,
+    size_t *dirs_ptr);
+static void _wlmtk_icon_theme_dirs_destroy(
+    wlmtk_icon_theme_dir_t *dirs_ptr,
+    size_t dirs);
+static void _wlmtk_icon_theme_write(
+    const char *index_path_ptr,
+    const uint8_t *data_ptr,
+    size_t size);
+static bool _wlmtk_icon_theme_append(
+    char **str_ptr_ptr,
+    const char *fmt_ptr,
+    ...);
+static bool _wlmtk_icon_theme_grow(
+    void **array_ptr_ptr,
+    size_t elements,
+    size_t element_size);
+static int _wlmtk_icon_theme_build_entry_cmp(
+    const void *a_ptr,
+    const void *b_ptr);
+static char *_wlmtk_icon_theme_default_base_dirs(void);
+static unsigned _wlmtk_icon_theme_distance(
+    const wlmtk_icon_theme_entry_t *entry_ptr,
+    int size,
+    int scale);
+
+/* == Data ================================================================= */
+
+/** Identifies the file format, including its version. */
+static const char _wlmtk_icon_theme_magic[8] = "WLMICO01";
+/** Theme that is always searched, after all others. */
+static const char *_wlmtk_icon_theme_fallback_ptr = "hicolor";
+/** Directory with unthemed icons, searched with the default base dirs. */
+static const char *_wlmtk_icon_theme_pixmaps_ptr = "/usr/share/pixmaps";
+/** Name of the index file within the cache directory. */
+static const char *_wlmtk_icon_theme_index_name_ptr = "icon-theme.idx";
+
+/* == Exported methods ===================================================== */
+
+/* ------------------------------------------------------------------------- */
+wlmtk_icon_theme_t *wlmtk_icon_theme_create(
+    const char *theme_name_ptr,
+    const char **base_dirs_ptr,
+    const char *index_path_ptr)
+{
+    wlmtk_icon_theme_t *icon_theme_ptr = logged_calloc(
+        1, sizeof(wlmtk_icon_theme_t));
+    if (NULL == icon_theme_ptr) return NULL;
+
+    char index_path[PATH_MAX];
+    if (NULL == index_path_ptr) {
+        char cache_dir[PATH_MAX];
+        if (wlmtk_util_cache_dir(cache_dir, sizeof(cache_dir))) {
+            int rv = snprintf(index_path, sizeof(index_path), "%s/%s",
+                              cache_dir, _wlmtk_icon_theme_index_name_ptr);
+            if (0 <= rv && (size_t)rv < sizeof(index_path)) {
+                index_path_ptr = index_path;
+            }
+        }
+    }
+
+    // The default base dirs, as one string: Each dir terminated by '\n'.
+    char *default_base_dirs_ptr = NULL;
+    const char **default_base_dirs_ptr_ptr = NULL;
+    const char *unthemed_dir_ptr = NULL;
+    if (NULL == base_dirs_ptr) {
+        default_base_dirs_ptr = _wlmtk_icon_theme_default_base_dirs();
+        size_t dirs = 0;
+        for (char *c_ptr = default_base_dirs_ptr;
+             NULL != c_ptr && '\0' != *c_ptr; ++c_ptr) {
+            if ('\n' == *c_ptr) ++dirs;
+        }
+        default_base_dirs_ptr_ptr = logged_calloc(dirs + 1, sizeof(char*));
+        if (NULL == default_base_dirs_ptr ||
+            NULL == default_base_dirs_ptr_ptr) {
+            free(default_base_dirs_ptr_ptr);
+            free(default_base_dirs_ptr);
+            wlmtk_icon_theme_destroy(icon_theme_ptr);
+            return NULL;
+        }
+        char *dir_ptr = default_base_dirs_ptr;
+        for (size_t i = 0; i < dirs; ++i) {
+            default_base_dirs_ptr_ptr[i] = dir_ptr;
+            dir_ptr = strchr(dir_ptr, '\n');
+            *dir_ptr++ = '\0';
+        }
+        base_dirs_ptr = default_base_dirs_ptr_ptr;
+        unthemed_dir_ptr = _wlmtk_icon_theme_pixmaps_ptr;
+    }
+
+    // An index built for another theme or other base dirs is stale.
+    char *config_ptr = NULL;
+    bool rv = (
+        _wlmtk_icon_theme_append(&config_ptr, "%s\n", theme_name_ptr) &&
+        _wlmtk_icon_theme_append(
+            &config_ptr, "%s\n",
+            NULL != unthemed_dir_ptr ? unthemed_dir_ptr : ""));
+    for (const char **dir_ptr_ptr = base_dirs_ptr;
+         rv && NULL != *dir_ptr_ptr; ++dir_ptr_ptr) {
+        rv = _wlmtk_icon_theme_append(&config_ptr, "%s\n", *dir_ptr_ptr);
+    }
+
+    if (rv && (NULL == index_path_ptr ||
+               !_wlmtk_icon_theme_load(
+                   icon_theme_ptr, index_path_ptr, config_ptr))) {
+        rv = _wlmtk_icon_theme_build(
+            icon_theme_ptr, theme_name_ptr, base_dirs_ptr,
+            unthemed_dir_ptr, config_ptr);
+        if (rv && NULL != index_path_ptr) {
+            _wlmtk_icon_theme_write(
+                index_path_ptr,
+                icon_theme_ptr->data_ptr,
+                icon_theme_ptr->size);
+        }
+    }
+
+    if (NULL != config_ptr) free(config_ptr);
+    if (NULL != default_base_dirs_ptr_ptr) free(default_base_dirs_ptr_ptr);
+    if (NULL != default_base_dirs_ptr) free(default_base_dirs_ptr);
+    if (!rv) {
+        wlmtk_icon_theme_destroy(icon_theme_ptr);
+        return NULL;
+    }
+    return icon_theme_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_icon_theme_destroy(wlmtk_icon_theme_t *icon_theme_ptr)
+{
+    if (NULL != icon_theme_ptr->data_ptr) {
+        if (icon_theme_ptr->mapped) {
+            munmap(icon_theme_ptr->data_ptr, icon_theme_ptr->size);
+        } else {
+            free(icon_theme_ptr->data_ptr);
+        }
+        icon_theme_ptr->data_ptr = NULL;
+    }
+    free(icon_theme_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+char *wlmtk_icon_theme_lookup(
+    wlmtk_icon_theme_t *icon_theme_ptr,
+    const char *name_ptr,
+    int size,
+    int scale,
+    char *path_ptr)
+{
+    if (NULL == icon_theme_ptr) return NULL;
+    const uint8_t *data_ptr = icon_theme_ptr->data_ptr;
+    const wlmtk_icon_theme_header_t *header_ptr = (const void*)data_ptr;
+    const char *strings_ptr = (const char*)(
+        data_ptr + header_ptr->strings_offset);
+    const wlmtk_icon_theme_name_t *names_ptr = (const void*)(
+        data_ptr + header_ptr->names_offset);
+    const wlmtk_icon_theme_entry_t *entries_ptr = (const void*)(
+        data_ptr + header_ptr->entries_offset);
+    const wlmtk_icon_theme_stamp_t *stamps_ptr = (const void*)(
+        data_ptr + header_ptr->stamps_offset);
+
+    // Binary search for the name.
+    const wlmtk_icon_theme_name_t *found_name_ptr = NULL;
+    size_t lower = 0, upper = header_ptr->names;
+    while (lower < upper) {
+        size_t middle = lower + (upper - lower) / 2;
+        int rv = strcmp(name_ptr, strings_ptr + names_ptr[middle].name_offset);
+        if (0 == rv) {
+            found_name_ptr = &names_ptr[middle];
+            break;
+        }
+        if (0 > rv) {
+            upper = middle;
+        } else {
+            lower = middle + 1;
+        }
+    }
+    if (NULL == found_name_ptr) return NULL;
+
+    // Entries are sorted by rank: Only consider the first theme's.
+    const wlmtk_icon_theme_entry_t *best_entry_ptr = NULL;
+    unsigned best_distance = UINT_MAX;
+    for (uint32_t i = 0; i < found_name_ptr->entries; ++i) {
+        const wlmtk_icon_theme_entry_t *entry_ptr =
+            &entries_ptr[found_name_ptr->first_entry + i];
+        if (NULL != best_entry_ptr &&
+            entry_ptr->rank != best_entry_ptr->rank) break;
+        unsigned distance = _wlmtk_icon_theme_distance(
+            entry_ptr, size, scale);
+        if (distance < best_distance) {
+            best_entry_ptr = entry_ptr;
+            best_distance = distance;
+        }
+        if (0 == distance) break;
+    }
+    if (NULL == best_entry_ptr) return NULL;
+
+    int rv = snprintf(
+        path_ptr, PATH_MAX, "%s/%s.png",
+        strings_ptr + stamps_ptr[best_entry_ptr->stamp].path_offset,
+        name_ptr);
+    if (0 > rv || PATH_MAX <= rv) return NULL;
+    return path_ptr;
+}
+
+/* == Local (static) methods =============================================== */
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Memory-maps the index at `index_path_ptr`, if it is valid and current.
+ *
+ * @param icon_theme_ptr
+ * @param index_path_ptr
+ * @param config_ptr          Theme and base directories of the index.
+ *
+ * @return true if the index was mapped.
+ */
+bool _wlmtk_icon_theme_load(
+    wlmtk_icon_theme_t *icon_theme_ptr,
+    const char *index_path_ptr,
+    const char *config_ptr)
+{
+    int fd = open(index_path_ptr, O_RDONLY | O_CLOEXEC);
+    if (0 > fd) return false;
+    struct stat stat_buf;
+    if (0 != fstat(fd, &stat_buf) ||
+        (size_t)stat_buf.st_size < sizeof(wlmtk_icon_theme_header_t)) {
+        close(fd);
+        return false;
+    }
+    size_t size = stat_buf.st_size;
+    void *data_ptr = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (MAP_FAILED == data_ptr) {
+        bs_log(BS_WARNING | BS_ERRNO, "Failed mmap(NULL, %zu, ..., %s)",
+               size, index_path_ptr);
+        return false;
+    }
+
+    if (!_wlmtk_icon_theme_valid(data_ptr, size, config_ptr)) {
+        munmap(data_ptr, size);
+        return false;
+    }
+    icon_theme_ptr->data_ptr = data_ptr;
+    icon_theme_ptr->size = size;
+    icon_theme_ptr->mapped = true;
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Verifies the index is consistent, built for `config_ptr`, and that none
+ * of its stamps changed.
+ *
+ * @param data_ptr
+ * @param size
+ * @param config_ptr
+ *
+ * @return true if the index can be used.
+ */
+bool _wlmtk_icon_theme_valid(
+    const uint8_t *data_ptr,
+    size_t size,
+    const char *config_ptr)
+{
+    const wlmtk_icon_theme_header_t *header_ptr = (const void*)data_ptr;
+    if (0 != memcmp(header_ptr->magic, _wlmtk_icon_theme_magic,
+                    sizeof(header_ptr->magic))) return false;
+
+    // Tables and string pool must be within bounds, strings terminated.
+    if ((uint64_t)header_ptr->stamps_offset +
+        (uint64_t)header_ptr->stamps * sizeof(wlmtk_icon_theme_stamp_t) >
+        size ||
+        (uint64_t)header_ptr->entries_offset +
+        (uint64_t)header_ptr->entries * sizeof(wlmtk_icon_theme_entry_t) >
+        size ||
+        (uint64_t)header_ptr->names_offset +
+        (uint64_t)header_ptr->names * sizeof(wlmtk_icon_theme_name_t) >
+        size ||
+        (uint64_t)header_ptr->strings_offset + header_ptr->strings_size >
+        size ||
+        0 == header_ptr->strings_size ||
+        0 != header_ptr->stamps_offset % sizeof(int64_t) ||
+        0 != header_ptr->entries_offset % sizeof(uint32_t) ||
+        0 != header_ptr->names_offset % sizeof(uint32_t)) return false;
+    const char *strings_ptr = (const char*)(
+        data_ptr + header_ptr->strings_offset);
+    if ('\0' != strings_ptr[header_ptr->strings_size - 1]) return false;
+
+    const wlmtk_icon_theme_stamp_t *stamps_ptr = (const void*)(
+        data_ptr + header_ptr->stamps_offset);
+    for (uint32_t i = 0; i < header_ptr->stamps; ++i) {
+        if (stamps_ptr[i].path_offset >= header_ptr->strings_size) {
+            return false;
+        }
+    }
+    const wlmtk_icon_theme_entry_t *entries_ptr = (const void*)(
+        data_ptr + header_ptr->entries_offset);
+    for (uint32_t i = 0; i < header_ptr->entries; ++i) {
+        if (entries_ptr[i].stamp >= header_ptr->stamps) return false;
+    }
+    const wlmtk_icon_theme_name_t *names_ptr = (const void*)(
+        data_ptr + header_ptr->names_offset);
+    for (uint32_t i = 0; i < header_ptr->names; ++i) {
+        if (names_ptr[i].name_offset >= header_ptr->strings_size ||
+            (uint64_t)names_ptr[i].first_entry + names_ptr[i].entries >
+            header_ptr->entries) return false;
+    }
+
+    if (header_ptr->config_offset >= header_ptr->strings_size ||
+        0 != strcmp(strings_ptr + header_ptr->config_offset, config_ptr)) {
+        return false;
+    }
+    for (uint32_t i = 0; i < header_ptr->stamps; ++i) {
+        struct stat stat_buf;
+        struct timespec mtime = { .tv_sec = -1, .tv_nsec = -1 };
+        if (0 == stat(strings_ptr + stamps_ptr[i].path_offset, &stat_buf)) {
+            mtime = stat_buf.st_mtim;
+        }
+        if (mtime.tv_sec != stamps_ptr[i].mtime_sec ||
+            mtime.tv_nsec != stamps_ptr[i].mtime_nsec) {
+            bs_log(BS_INFO, "Icon theme index stale: %s changed.",
+                   strings_ptr + stamps_ptr[i].path_offset);
+            return false;
+        }
+    }
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Builds the index, by scanning all themes' directories. Stores it as
+ * allocated memory in `icon_theme_ptr`.
+ *
+ * @param icon_theme_ptr
+ * @param theme_name_ptr
+ * @param base_dirs_ptr
+ * @param unthemed_dir_ptr    Directory holding unthemed icons, or NULL.
+ * @param config_ptr
+ *
+ * @return true on success.
+ */
+bool _wlmtk_icon_theme_build(
+    wlmtk_icon_theme_t *icon_theme_ptr,
+    const char *theme_name_ptr,
+    const char **base_dirs_ptr,
+    const char *unthemed_dir_ptr,
+    const char *config_ptr)
+{
+    wlmtk_icon_theme_builder_t builder = { 0 };
+
+    bool rv = _wlmtk_icon_theme_builder_add_theme(&builder, theme_name_ptr);
+    // Inherited themes are appended while scanning.
+    for (size_t i = 0; rv && i < builder.themes; ++i) {
+        rv = _wlmtk_icon_theme_builder_scan_theme(&builder, i, base_dirs_ptr);
+        if (rv && i + 1 == builder.themes) {
+            rv = _wlmtk_icon_theme_builder_add_theme(
+                &builder, _wlmtk_icon_theme_fallback_ptr);
+        }
+    }
+    if (rv && NULL != unthemed_dir_ptr) {
+        wlmtk_icon_theme_dir_t dir = {
+            .size = 0, .scale = 1, .min_size = 0, .max_size = UINT16_MAX
+        };
+        rv = _wlmtk_icon_theme_builder_scan_dir(
+            &builder, unthemed_dir_ptr, &dir, builder.themes);
+    }
+
+    if (rv) {
+        rv = _wlmtk_icon_theme_builder_serialize(
+            &builder, config_ptr,
+            &icon_theme_ptr->data_ptr, &icon_theme_ptr->size);
+        icon_theme_ptr->mapped = false;
+    }
+    if (rv) {
+        bs_log(BS_INFO, "Indexed %zu icons of %zu themes, %zu directories.",
+               builder.entries, builder.themes, builder.stamps);
+    }
+    _wlmtk_icon_theme_builder_fini(&builder);
+    return rv;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Appends `theme_name_ptr` to the themes, unless it is listed already. */
+bool _wlmtk_icon_theme_builder_add_theme(
+    wlmtk_icon_theme_builder_t *builder_ptr,
+    const char *theme_name_ptr)
+{
+    for (size_t i = 0; i < builder_ptr->themes; ++i) {
+        if (0 == strcmp(builder_ptr->themes_ptr[i], theme_name_ptr)) {
+            return true;
+        }
+    }
+    if (!_wlmtk_icon_theme_grow((void**)&builder_ptr->themes_ptr,
+                                builder_ptr->themes + 1, sizeof(char*))) {
+        return false;
+    }
+    char *name_ptr = logged_strdup(theme_name_ptr);
+    if (NULL == name_ptr) return false;
+    builder_ptr->themes_ptr[builder_ptr->themes++] = name_ptr;
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Scans the theme at position `rank`: Parses its `index.theme`, appends the
+ * inherited themes, and scans each of its directories in all base dirs.
+ *
+ * @param builder_ptr
+ * @param rank
+ * @param base_dirs_ptr
+ *
+ * @return true on success, also if the theme is not installed.
+ */
+bool _wlmtk_icon_theme_builder_scan_theme(
+    wlmtk_icon_theme_builder_t *builder_ptr,
+    size_t rank,
+    const char **base_dirs_ptr)
+{
+    char path[PATH_MAX];
+    char *inherits_ptr = NULL;
+    wlmtk_icon_theme_dir_t *dirs_ptr = NULL;
+    size_t dirs = 0;
+    bool rv = true;
+
+    // The first `index.theme` found is used. Stamps are kept for all: One
+    // could be added in a directory of higher precedence.
+    for (const char **base_dir_ptr_ptr = base_dirs_ptr;
+         rv && NULL != *base_dir_ptr_ptr; ++base_dir_ptr_ptr) {
+        int len = snprintf(path, sizeof(path), "%s/%s/index.theme",
+                           *base_dir_ptr_ptr,
+                           builder_ptr->themes_ptr[rank]);
+        if (0 > len || (size_t)len >= sizeof(path)) continue;
+        rv = _wlmtk_icon_theme_builder_add_stamp(builder_ptr, path);
+        if (rv && NULL == dirs_ptr) {
+            _wlmtk_icon_theme_parse(path, &inherits_ptr, &dirs_ptr, &dirs);
+        }
+    }
+
+    for (char *token_ptr = inherits_ptr, *next_ptr = NULL;
+         rv && NULL != token_ptr && '\0' != *token_ptr;
+         token_ptr = next_ptr) {
+        next_ptr = strchr(token_ptr, ',');
+        if (NULL != next_ptr) {
+            *next_ptr++ = '\0';
+        } else {
+            next_ptr = token_ptr + strlen(token_ptr);
+        }
+        if ('\0' != *token_ptr) {
+            rv = _wlmtk_icon_theme_builder_add_theme(builder_ptr, token_ptr);
+        }
+    }
+
+    for (const char **base_dir_ptr_ptr = base_dirs_ptr;
+         rv && NULL != *base_dir_ptr_ptr; ++base_dir_ptr_ptr) {
+        int len = snprintf(path, sizeof(path), "%s/%s",
+                           *base_dir_ptr_ptr, builder_ptr->themes_ptr[rank]);
+        if (0 > len || (size_t)len >= sizeof(path)) continue;
+        rv = _wlmtk_icon_theme_builder_add_stamp(builder_ptr, path);
+
+        for (size_t i = 0; rv && i < dirs; ++i) {
+            len = snprintf(path, sizeof(path), "%s/%s/%s",
+                           *base_dir_ptr_ptr, builder_ptr->themes_ptr[rank],
+                           dirs_ptr[i].name_ptr);
+            if (0 > len || (size_t)len >= sizeof(path)) continue;
+            rv = _wlmtk_icon_theme_builder_scan_dir(
+                builder_ptr, path, &dirs_ptr[i], rank);
+        }
+    }
+
+    if (NULL != inherits_ptr) free(inherits_ptr);
+    _wlmtk_icon_theme_dirs_destroy(dirs_ptr, dirs);
+    return rv;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Adds the directory at `path_ptr` as stamp, and all PNG files in it as
+ * entries.
+ *
+ * @param builder_ptr
+ * @param path_ptr
+ * @param dir_ptr             Sizes of the directory.
+ * @param rank
+ *
+ * @return true on success, also if the directory does not exist.
+ */
+bool _wlmtk_icon_theme_builder_scan_dir(
+    wlmtk_icon_theme_builder_t *builder_ptr,
+    const char *path_ptr,
+    const wlmtk_icon_theme_dir_t *dir_ptr,
+    size_t rank)
+{
+    if (!_wlmtk_icon_theme_builder_add_stamp(builder_ptr, path_ptr)) {
+        return false;
+    }
+    uint32_t stamp = builder_ptr->stamps - 1;
+
+    DIR *dirstream_ptr = opendir(path_ptr);
+    if (NULL == dirstream_ptr) return true;
+
+    int min_size = dir_ptr->size, max_size = dir_ptr->size;
+    switch (dir_ptr->type) {
+    case 'F':
+        break;
+    case 'S':
+        min_size = dir_ptr->min_size;
+        max_size = dir_ptr->max_size;
+        break;
+    default:
+        min_size = dir_ptr->size - dir_ptr->threshold;
+        max_size = dir_ptr->size + dir_ptr->threshold;
+        break;
+    }
+    wlmtk_icon_theme_entry_t entry = {
+        .stamp = stamp,
+        .size = BS_MIN(BS_MAX(dir_ptr->size, 0), UINT16_MAX),
+        .min_size = BS_MIN(BS_MAX(min_size, 0), UINT16_MAX),
+        .max_size = BS_MIN(BS_MAX(max_size, 0), UINT16_MAX),
+        .scale = BS_MIN(BS_MAX(dir_ptr->scale, 1), UINT16_MAX),
+        .rank = BS_MIN(rank, UINT16_MAX)
+    };
+
+    bool rv = true;
+    struct dirent *dirent_ptr;
+    while (rv && NULL != (dirent_ptr = readdir(dirstream_ptr))) {
+        size_t len = strlen(dirent_ptr->d_name);
+        if (len <= 4 || 0 != strcmp(dirent_ptr->d_name + len - 4, ".png")) {
+            continue;
+        }
+
+        rv = _wlmtk_icon_theme_grow(
+            (void**)&builder_ptr->entries_ptr, builder_ptr->entries + 1,
+            sizeof(wlmtk_icon_theme_build_entry_t));
+        if (!rv) break;
+        wlmtk_icon_theme_build_entry_t *build_entry_ptr =
+            &builder_ptr->entries_ptr[builder_ptr->entries];
+        build_entry_ptr->name_ptr = logged_calloc(1, len - 3);
+        if (NULL == build_entry_ptr->name_ptr) {
+            rv = false;
+            break;
+        }
+        memcpy(build_entry_ptr->name_ptr, dirent_ptr->d_name, len - 4);
+        build_entry_ptr->entry = entry;
+        build_entry_ptr->seq = builder_ptr->entries++;
+    }
+    closedir(dirstream_ptr);
+    return rv;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Adds a stamp for `path_ptr`. Records a non-existing path, too. */
+bool _wlmtk_icon_theme_builder_add_stamp(
+    wlmtk_icon_theme_builder_t *builder_ptr,
+    const char *path_ptr)
+{
+    if (!_wlmtk_icon_theme_grow(
+            (void**)&builder_ptr->stamps_ptr, builder_ptr->stamps + 1,
+            sizeof(wlmtk_icon_theme_build_stamp_t))) return false;
+    wlmtk_icon_theme_build_stamp_t *stamp_ptr =
+        &builder_ptr->stamps_ptr[builder_ptr->stamps];
+
+    stamp_ptr->path_ptr = logged_strdup(path_ptr);
+    if (NULL == stamp_ptr->path_ptr) return false;
+    struct stat stat_buf;
+    if (0 == stat(path_ptr, &stat_buf)) {
+        stamp_ptr->mtime = stat_buf.st_mtim;
+    } else {
+        stamp_ptr->mtime.tv_sec = -1;
+        stamp_ptr->mtime.tv_nsec = -1;
+    }
+    ++builder_ptr->stamps;
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Serializes the builder's contents into the index format.
+ *
+ * @param builder_ptr         Entries will be sorted.
+ * @param config_ptr
+ * @param data_ptr_ptr        Will hold the index. Must be free()-ed.
+ * @param size_ptr            Will hold the size of the index.
+ *
+ * @return true on success.
+ */
+bool _wlmtk_icon_theme_builder_serialize(
+    wlmtk_icon_theme_builder_t *builder_ptr,
+    const char *config_ptr,
+    uint8_t **data_ptr_ptr,
+    size_t *size_ptr)
+{
+    qsort(builder_ptr->entries_ptr, builder_ptr->entries,
+          sizeof(wlmtk_icon_theme_build_entry_t),
+          _wlmtk_icon_theme_build_entry_cmp);
+
+    size_t names = 0;
+    size_t strings_size = strlen(config_ptr) + 1;
+    for (size_t i = 0; i < builder_ptr->stamps; ++i) {
+        strings_size += strlen(builder_ptr->stamps_ptr[i].path_ptr) + 1;
+    }
+    for (size_t i = 0; i < builder_ptr->entries; ++i) {
+        if (0 < i && 0 == strcmp(builder_ptr->entries_ptr[i - 1].name_ptr,
+                                 builder_ptr->entries_ptr[i].name_ptr)) {
+            continue;
+        }
+        strings_size += strlen(builder_ptr->entries_ptr[i].name_ptr) + 1;
+        ++names;
+    }
+
+    wlmtk_icon_theme_header_t header = {
+        .stamps = builder_ptr->stamps,
+        .entries = builder_ptr->entries,
+        .names = names,
+    };
+    memcpy(header.magic, _wlmtk_icon_theme_magic, sizeof(header.magic));
+    header.stamps_offset = sizeof(header);
+    header.entries_offset = header.stamps_offset +
+        header.stamps * sizeof(wlmtk_icon_theme_stamp_t);
+    header.names_offset = header.entries_offset +
+        header.entries * sizeof(wlmtk_icon_theme_entry_t);
+    header.strings_offset = header.names_offset +
+        header.names * sizeof(wlmtk_icon_theme_name_t);
+    header.strings_size = strings_size;
+    size_t size = (size_t)header.strings_offset + strings_size;
+    if (UINT32_MAX < size) {
+        bs_log(BS_ERROR, "Icon theme index too large: %zu bytes", size);
+        return false;
+    }
+
+    uint8_t *data_ptr = logged_calloc(1, size);
+    if (NULL == data_ptr) return false;
+    memcpy(data_ptr, &header, sizeof(header));
+    wlmtk_icon_theme_stamp_t *stamps_ptr = (void*)(
+        data_ptr + header.stamps_offset);
+    wlmtk_icon_theme_entry_t *entries_ptr = (void*)(
+        data_ptr + header.entries_offset);
+    wlmtk_icon_theme_name_t *names_ptr = (void*)(
+        data_ptr + header.names_offset);
+    char *strings_ptr = (char*)(data_ptr + header.strings_offset);
+
+    size_t string_pos = 0;
+    ((wlmtk_icon_theme_header_t*)data_ptr)->config_offset = string_pos;
+    strcpy(strings_ptr + string_pos, config_ptr);
+    string_pos += strlen(config_ptr) + 1;
+
+    for (size_t i = 0; i < builder_ptr->stamps; ++i) {
+        const wlmtk_icon_theme_build_stamp_t *s_ptr =
+            &builder_ptr->stamps_ptr[i];
+        stamps_ptr[i].mtime_sec = s_ptr->mtime.tv_sec;
+        stamps_ptr[i].mtime_nsec = s_ptr->mtime.tv_nsec;
+        stamps_ptr[i].path_offset = string_pos;
+        strcpy(strings_ptr + string_pos, s_ptr->path_ptr);
+        string_pos += strlen(s_ptr->path_ptr) + 1;
+    }
+
+    wlmtk_icon_theme_name_t *name_ptr = names_ptr - 1;
+    for (size_t i = 0; i < builder_ptr->entries; ++i) {
+        const wlmtk_icon_theme_build_entry_t *e_ptr =
+            &builder_ptr->entries_ptr[i];
+        entries_ptr[i] = e_ptr->entry;
+        if (0 < i && 0 == strcmp(builder_ptr->entries_ptr[i - 1].name_ptr,
+                                 e_ptr->name_ptr)) {
+            ++name_ptr->entries;
+            continue;
+        }
+        ++name_ptr;
+        name_ptr->name_offset = string_pos;
+        name_ptr->first_entry = i;
+        name_ptr->entries = 1;
+        strcpy(strings_ptr + string_pos, e_ptr->name_ptr);
+        string_pos += strlen(e_ptr->name_ptr) + 1;
+    }
+    BS_ASSERT(string_pos == strings_size);
+
+    *data_ptr_ptr = data_ptr;
+    *size_ptr = size;
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Releases all resources held by the builder. */
+void _wlmtk_icon_theme_builder_fini(wlmtk_icon_theme_builder_t *builder_ptr)
+{
+    for (size_t i = 0; i < builder_ptr->themes; ++i) {
+        free(builder_ptr->themes_ptr[i]);
+    }
+    if (NULL != builder_ptr->themes_ptr) free(builder_ptr->themes_ptr);
+    for (size_t i = 0; i < builder_ptr->stamps; ++i) {
+        free(builder_ptr->stamps_ptr[i].path_ptr);
+    }
+    if (NULL != builder_ptr->stamps_ptr) free(builder_ptr->stamps_ptr);
+    for (size_t i = 0; i < builder_ptr->entries; ++i) {
+        free(builder_ptr->entries_ptr[i].name_ptr);
+    }
+    if (NULL != builder_ptr->entries_ptr) free(builder_ptr->entries_ptr);
+    *builder_ptr = (wlmtk_icon_theme_builder_t){ 0 };
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Parses an `index.theme` file: The inherited themes, and the directories
+ * with their sizes.
+ *
+ * @param path_ptr
+ * @param inherits_ptr_ptr    Will hold the comma-separated list of
+ *                            inherited themes, or NULL. Must be free()-ed.
+ * @param dirs_ptr_ptr        Will hold the directories. Must be released by
+ *                            @ref _wlmtk_icon_theme_dirs_destroy.
+ * @param dirs_ptr            Will hold the number of directories.
+ *
+ * @return true on success.
+ */
+bool _wlmtk_icon_theme_parse(
+    const char *path_ptr,
+    char **inherits_ptr_ptr,
+    wlmtk_icon_theme_dir_t **dirs_ptr_ptr,
+    size_t *dirs_ptr)
+{
+    FILE *file_ptr = fopen(path_ptr, "re");
+    if (NULL == file_ptr) return false;
+
+    // All sections are recorded. Only those listed in `Directories` or
+    // `ScaledDirectories` are kept at the end.
+    char *directories_ptr = NULL;
+    wlmtk_icon_theme_dir_t *sections_ptr = NULL;
+    size_t sections = 0;
+    wlmtk_icon_theme_dir_t *section_ptr = NULL;
+    bool in_icon_theme = false;
+    bool rv = true;
+
+    char *line_ptr = NULL;
+    size_t line_size = 0;
+    while (rv && 0 <= getline(&line_ptr, &line_size, file_ptr)) {
+        line_ptr[strcspn(line_ptr, "\r\n")] = '\0';
+        if ('[' == line_ptr[0]) {
+            char *end_ptr = strchr(line_ptr, ']');
+            if (NULL == end_ptr) continue;
+            *end_ptr = '\0';
+            in_icon_theme = (0 == strcmp(line_ptr + 1, "Icon Theme"));
+            section_ptr = NULL;
+            if (in_icon_theme) continue;
+
+            rv = _wlmtk_icon_theme_grow(
+                (void**)&sections_ptr, sections + 1,
+                sizeof(wlmtk_icon_theme_dir_t));
+            if (!rv) break;
+            section_ptr = &sections_ptr[sections++];
+            *section_ptr = (wlmtk_icon_theme_dir_t){
+                .size = -1, .scale = 1, .type = 'T',
+                .min_size = -1, .max_size = -1, .threshold = 2 };
+            section_ptr->name_ptr = logged_strdup(line_ptr + 1);
+            rv = NULL != section_ptr->name_ptr;
+            continue;
+        }
+
+        char *value_ptr = strchr(line_ptr, '=');
+        if (NULL == value_ptr) continue;
+        *value_ptr++ = '\0';
+        char *key_ptr = line_ptr;
+        key_ptr[strcspn(key_ptr, " \t")] = '\0';
+        value_ptr += strspn(value_ptr, " \t");
+
+        if (in_icon_theme) {
+            if (0 == strcmp(key_ptr, "Inherits") &&
+                NULL == *inherits_ptr_ptr) {
+                *inherits_ptr_ptr = logged_strdup(value_ptr);
+            } else if (0 == strcmp(key_ptr, "Directories") ||
+                       0 == strcmp(key_ptr, "ScaledDirectories")) {
+                rv = _wlmtk_icon_theme_append(
+                    &directories_ptr, "%s,", value_ptr);
+            }
+        } else if (NULL != section_ptr) {
+            if (0 == strcmp(key_ptr, "Size")) {
+                section_ptr->size = atoi(value_ptr);
+            } else if (0 == strcmp(key_ptr, "Scale")) {
+                section_ptr->scale = atoi(value_ptr);
+            } else if (0 == strcmp(key_ptr, "MinSize")) {
+                section_ptr->min_size = atoi(value_ptr);
+            } else if (0 == strcmp(key_ptr, "MaxSize")) {
+                section_ptr->max_size = atoi(value_ptr);
+            } else if (0 == strcmp(key_ptr, "Threshold")) {
+                section_ptr->threshold = atoi(value_ptr);
+            } else if (0 == strcmp(key_ptr, "Type")) {
+                section_ptr->type = value_ptr[0];
+            }
+        }
+    }
+    if (NULL != line_ptr) free(line_ptr);
+    fclose(file_ptr);
+
+    // Keeps the listed sections with a size. Unlisted ones are released.
+    size_t dirs = 0;
+    for (size_t i = 0; rv && i < sections; ++i) {
+        wlmtk_icon_theme_dir_t *s_ptr = &sections_ptr[i];
+        bool listed = false;
+        size_t len = strlen(s_ptr->name_ptr);
+        for (const char *c_ptr = directories_ptr;
+             NULL != c_ptr && !listed && '\0' != *c_ptr;
+             c_ptr = strchr(c_ptr, ',') + 1) {
+            listed = (0 == strncmp(c_ptr, s_ptr->name_ptr, len) &&
+                      ',' == c_ptr[len]);
+        }
+        if (!listed || 0 > s_ptr->size) {
+            free(s_ptr->name_ptr);
+            continue;
+        }
+        if (0 > s_ptr->min_size) s_ptr->min_size = s_ptr->size;
+        if (0 > s_ptr->max_size) s_ptr->max_size = s_ptr->size;
+        sections_ptr[dirs++] = *s_ptr;
+    }
+    if (NULL != directories_ptr) free(directories_ptr);
+
+    if (!rv) {
+        _wlmtk_icon_theme_dirs_destroy(sections_ptr, sections);
+        return false;
+    }
+    *dirs_ptr_ptr = sections_ptr;
+    *dirs_ptr = dirs;
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Destroys the array of directories, as returned from the parser. */
+void _wlmtk_icon_theme_dirs_destroy(
+    wlmtk_icon_theme_dir_t *dirs_ptr,
+    size_t dirs)
+{
+    if (NULL == dirs_ptr) return;
+    for (size_t i = 0; i < dirs; ++i) free(dirs_ptr[i].name_ptr);
+    free(dirs_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Writes the index to `index_path_ptr`, through a temporary file that is
+ * renamed into place. Not fatal on failure: The index is then rebuilt on
+ * next start.
+ *
+ * @param index_path_ptr
+ * @param data_ptr
+ * @param size
+ */
+void _wlmtk_icon_theme_write(
+    const char *index_path_ptr,
+    const uint8_t *data_ptr,
+    size_t size)
+{
+    char tmp_path[PATH_MAX];
+    int rv = snprintf(tmp_path, sizeof(tmp_path), "%s.XXXXXX",
+                      index_path_ptr);
+    if (0 > rv || (size_t)rv >= sizeof(tmp_path)) return;
+    int fd = mkostemp(tmp_path, O_CLOEXEC);
+    if (0 > fd) {
+        bs_log(BS_WARNING | BS_ERRNO, "Failed mkostemp(%s, O_CLOEXEC)",
+               tmp_path);
+        return;
+    }
+
+    bool written = true;
+    for (size_t pos = 0; written && pos < size; ) {
+        ssize_t n = write(fd, data_ptr + pos, size - pos);
+        if (0 > n && EINTR == errno) continue;
+        written = 0 <= n;
+        if (written) pos += n;
+    }
+    if (0 != close(fd)) written = false;
+
+    if (!written || 0 != rename(tmp_path, index_path_ptr)) {
+        bs_log(BS_WARNING | BS_ERRNO, "Failed to write %s", index_path_ptr);
+        unlink(tmp_path);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Appends the formatted string to `*str_ptr_ptr`, re-allocating as needed.
+ *
+ * @param str_ptr_ptr         Points to the string, or to NULL. Must be
+ *                            free()-ed, also on failure.
+ * @param fmt_ptr
+ *
+ * @return true on success.
+ */
+bool _wlmtk_icon_theme_append(char **str_ptr_ptr, const char *fmt_ptr, ...)
+{
+    va_list ap;
+    va_start(ap, fmt_ptr);
+    int len = vsnprintf(NULL, 0, fmt_ptr, ap);
+    va_end(ap);
+    if (0 > len) return false;
+
+    size_t pos = NULL != *str_ptr_ptr ? strlen(*str_ptr_ptr) : 0;
+    char *str_ptr = realloc(*str_ptr_ptr, pos + len + 1);
+    if (NULL == str_ptr) {
+        bs_log(BS_ERROR | BS_ERRNO, "Failed realloc(%p, %zu)",
+               *str_ptr_ptr, pos + len + 1);
+        return false;
+    }
+    *str_ptr_ptr = str_ptr;
+
+    va_start(ap, fmt_ptr);
+    vsnprintf(str_ptr + pos, len + 1, fmt_ptr, ap);
+    va_end(ap);
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Grows the array at `*array_ptr_ptr`, to hold at least `elements`. */
+bool _wlmtk_icon_theme_grow(
+    void **array_ptr_ptr,
+    size_t elements,
+    size_t element_size)
+{
+    // Capacity is the next power of two: Grows when `elements` reaches it.
+    if (0 != ((elements - 1) & elements) && 1 < elements) return true;
+    void *array_ptr = realloc(*array_ptr_ptr,
+                              BS_MAX(elements, 1u) * 2 * element_size);
+    if (NULL == array_ptr) {
+        bs_log(BS_ERROR | BS_ERRNO, "Failed realloc(%p, %zu)",
+               *array_ptr_ptr, BS_MAX(elements, 1u) * 2 * element_size);
+        return false;
+    }
+    *array_ptr_ptr = array_ptr;
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Orders entries by name, then rank, then order of discovery. */
+int _wlmtk_icon_theme_build_entry_cmp(const void *a_ptr, const void *b_ptr)
+{
+    const wlmtk_icon_theme_build_entry_t *e1_ptr = a_ptr;
+    const wlmtk_icon_theme_build_entry_t *e2_ptr = b_ptr;
+    int rv = strcmp(e1_ptr->name_ptr, e2_ptr->name_ptr);
+    if (0 != rv) return rv;
+    if (e1_ptr->entry.rank != e2_ptr->entry.rank) {
+        return e1_ptr->entry.rank < e2_ptr->entry.rank ? -1 : 1;
+    }
+    if (e1_ptr->seq != e2_ptr->seq) return e1_ptr->seq < e2_ptr->seq ? -1 : 1;
+    return 0;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Returns the XDG base directories for icons: `$HOME/.icons`,
+ * `$XDG_DATA_HOME/icons` and `icons` in each of `$XDG_DATA_DIRS`.
+ *
+ * @return The directories, each terminated by '\n'. Must be free()-ed.
+ */
+char *_wlmtk_icon_theme_default_base_dirs(void)
+{
+    const char *home_ptr = getenv("HOME");
+    const char *data_home_ptr = getenv("XDG_DATA_HOME");
+    const char *data_dirs_ptr = getenv("XDG_DATA_DIRS");
+    if (NULL == data_dirs_ptr || '\0' == *data_dirs_ptr) {
+        data_dirs_ptr = "/usr/local/share:/usr/share";
+    }
+
+    char *dirs_ptr = NULL;
+    bool rv = true;
+    if (NULL != home_ptr) {
+        rv = _wlmtk_icon_theme_append(&dirs_ptr, "%s/.icons\n", home_ptr);
+    }
+    if (rv && NULL != data_home_ptr && '/' == *data_home_ptr) {
+        rv = _wlmtk_icon_theme_append(
+            &dirs_ptr, "%s/icons\n", data_home_ptr);
+    } else if (rv && NULL != home_ptr) {
+        rv = _wlmtk_icon_theme_append(
+            &dirs_ptr, "%s/.local/share/icons\n", home_ptr);
+    }
+    for (const char *c_ptr = data_dirs_ptr; rv && '\0' != *c_ptr; ) {
+        size_t len = strcspn(c_ptr, ":");
+        // Only absolute paths are valid.
+        if ('/' == *c_ptr) {
+            rv = _wlmtk_icon_theme_append(
+                &dirs_ptr, "%.*s/icons\n", (int)len, c_ptr);
+        }
+        c_ptr += len;
+        if (':' == *c_ptr) ++c_ptr;
+    }
+    if (!rv && NULL != dirs_ptr) {
+        free(dirs_ptr);
+        dirs_ptr = NULL;
+    }
+    return dirs_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Distance of the entry's sizes from `size`. 0 if it matches. */
+unsigned _wlmtk_icon_theme_distance(
+    const wlmtk_icon_theme_entry_t *entry_ptr,
+    int size,
+    int scale)
+{
+    int s = size * scale;
+    int min_size = entry_ptr->min_size * entry_ptr->scale;
+    int max_size = entry_ptr->max_size * entry_ptr->scale;
+    if (s < min_size) return min_size - s;
+    if (s > max_size) return s - max_size;
+    // Within range, but other scale: Prefer the matching scale.
+    return entry_ptr->scale == scale ? 0 : 1;
+}
+
+/* == Unit tests =========================================================== */
+
+static void test_lookup(bs_test_t *test_ptr);
+
+const bs_test_case_t wlmtk_icon_theme_test_cases[] = {
+    { 1, "lookup", test_lookup },
+    { 0, NULL, NULL }
+};
+
+/* ------------------------------------------------------------------------- */
+/** Writes `content_ptr` into `dir_ptr`/`name_ptr`, creating directories. */
+static bool _wlmtk_icon_theme_test_write(
+    const char *dir_ptr,
+    const char *name_ptr,
+    const char *content_ptr)
+{
+    char path[PATH_MAX];
+    snprintf(path, sizeof(path), "%s/%s", dir_ptr, name_ptr);
+    *strrchr(path, '/') = '\0';
+    if (!wlmtk_util_mkdirs(path)) return false;
+    snprintf(path, sizeof(path), "%s/%s", dir_ptr, name_ptr);
+    FILE *file_ptr = fopen(path, "w");
+    if (NULL == file_ptr) return false;
+    fputs(content_ptr, file_ptr);
+    return 0 == fclose(file_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Callback for nftw(3): Removes the file or directory. */
+static int _wlmtk_icon_theme_test_remove(
+    const char *path_ptr,
+    __UNUSED__ const struct stat *stat_ptr,
+    __UNUSED__ int type,
+    __UNUSED__ struct FTW *ftw_ptr)
+{
+    return remove(path_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Exercises index building, lookup, and rebuilding once stale. */
+void test_lookup(bs_test_t *test_ptr)
+{
+    char dir[] = "/tmp/wlmtk_icon_theme_test_XXXXXX";
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, mkdtemp(dir));
+    char base[PATH_MAX], index[PATH_MAX], path[PATH_MAX];
+    snprintf(base, sizeof(base), "%s/icons", dir);
+    snprintf(index, sizeof(index), "%s/icon-theme.idx", dir);
+    const char *base_dirs[] = { base, NULL };
+
+    BS_TEST_VERIFY_TRUE(test_ptr, _wlmtk_icon_theme_test_write(
+        base, "test/index.theme",
+        "[Icon Theme]\n"
+        "Name=Test\n"
+        "Inherits=other\n"
+        "Directories=16x16/apps,48x48/apps,scalable/apps\n"
+        "\n"
+        "[16x16/apps]\n"
+        "Size=16\n"
+        "Type=Fixed\n"
+        "\n"
+        "[48x48/apps]\n"
+        "Size=48\n"
+        "\n"
+        "[scalable/apps]\n"
+        "Size=64\n"
+        "MinSize=8\n"
+        "MaxSize=512\n"
+        "Type=Scalable\n"));
+    BS_TEST_VERIFY_TRUE(test_ptr, _wlmtk_icon_theme_test_write(
+        base, "other/index.theme",
+        "[Icon Theme]\n"
+        "Directories=32x32/apps\n"
+        "[32x32/apps]\n"
+        "Size=32\n"));
+    BS_TEST_VERIFY_TRUE(test_ptr, _wlmtk_icon_theme_test_write(
+        base, "test/16x16/apps/a.png", ""));
+    BS_TEST_VERIFY_TRUE(test_ptr, _wlmtk_icon_theme_test_write(
+        base, "test/48x48/apps/a.png", ""));
+    BS_TEST_VERIFY_TRUE(test_ptr, _wlmtk_icon_theme_test_write(
+        base, "test/scalable/apps/c.svg", ""));
+    BS_TEST_VERIFY_TRUE(test_ptr, _wlmtk_icon_theme_test_write(
+        base, "other/32x32/apps/a.png", ""));
+    BS_TEST_VERIFY_TRUE(test_ptr, _wlmtk_icon_theme_test_write(
+        base, "other/32x32/apps/b.png", ""));
+
+    wlmtk_icon_theme_t *icon_theme_ptr = wlmtk_icon_theme_create(
+        "test", base_dirs, index);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, icon_theme_ptr);
+    BS_TEST_VERIFY_FALSE(test_ptr, icon_theme_ptr->mapped);
+
+    // Exact, and closest size. Inherited theme. Not indexed: SVG.
+    char expected[PATH_MAX];
+    snprintf(expected, sizeof(expected), "%s/test/16x16/apps/a.png", base);
+    BS_TEST_VERIFY_STREQ(test_ptr, expected, wlmtk_icon_theme_lookup(
+                             icon_theme_ptr, "a", 16, 1, path));
+    snprintf(expected, sizeof(expected), "%s/test/48x48/apps/a.png", base);
+    BS_TEST_VERIFY_STREQ(test_ptr, expected, wlmtk_icon_theme_lookup(
+                             icon_theme_ptr, "a", 40, 1, path));
+    snprintf(expected, sizeof(expected), "%s/other/32x32/apps/b.png", base);
+    BS_TEST_VERIFY_STREQ(test_ptr, expected, wlmtk_icon_theme_lookup(
+                             icon_theme_ptr, "b", 16, 1, path));
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, wlmtk_icon_theme_lookup(
+                          icon_theme_ptr, "c", 64, 1, path));
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, wlmtk_icon_theme_lookup(
+                          icon_theme_ptr, "d", 48, 1, path));
+    wlmtk_icon_theme_destroy(icon_theme_ptr);
+
+    // Unchanged: Memory-maps the index.
+    icon_theme_ptr = wlmtk_icon_theme_create("test", base_dirs, index);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, icon_theme_ptr);
+    BS_TEST_VERIFY_TRUE(test_ptr, icon_theme_ptr->mapped);
+    snprintf(expected, sizeof(expected), "%s/other/32x32/apps/b.png", base);
+    BS_TEST_VERIFY_STREQ(test_ptr, expected, wlmtk_icon_theme_lookup(
+                             icon_theme_ptr, "b", 16, 1, path));
+    wlmtk_icon_theme_destroy(icon_theme_ptr);
+
+    // Another icon: Directory mtime changes, and the index is rebuilt.
+    BS_TEST_VERIFY_TRUE(test_ptr, _wlmtk_icon_theme_test_write(
+        base, "test/48x48/apps/d.png", ""));
+    snprintf(path, sizeof(path), "%s/test/48x48/apps", base);
+    struct timespec times[2] = { { .tv_sec = 1 }, { .tv_sec = 1 } };
+    BS_TEST_VERIFY_EQ(test_ptr, 0, utimensat(AT_FDCWD, path, times, 0));
+    icon_theme_ptr = wlmtk_icon_theme_create("test", base_dirs, index);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, icon_theme_ptr);
+    BS_TEST_VERIFY_FALSE(test_ptr, icon_theme_ptr->mapped);
+    snprintf(expected, sizeof(expected), "%s/test/48x48/apps/d.png", base);
+    BS_TEST_VERIFY_STREQ(test_ptr, expected, wlmtk_icon_theme_lookup(
+                             icon_theme_ptr, "d", 48, 1, path));
+    wlmtk_icon_theme_destroy(icon_theme_ptr);
+
+    // Other theme: Rebuilt as well.
+    icon_theme_ptr = wlmtk_icon_theme_create("other", base_dirs, index);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, icon_theme_ptr);
+    BS_TEST_VERIFY_FALSE(test_ptr, icon_theme_ptr->mapped);
+    snprintf(expected, sizeof(expected), "%s/other/32x32/apps/a.png", base);
+    BS_TEST_VERIFY_STREQ(test_ptr, expected, wlmtk_icon_theme_lookup(
+                             icon_theme_ptr, "a", 16, 1, path));
+    wlmtk_icon_theme_destroy(icon_theme_ptr);
+
+    BS_TEST_VERIFY_EQ(test_ptr, 0, nftw(dir, _wlmtk_icon_theme_test_remove,
+                                        16, FTW_DEPTH | FTW_PHYS));
+}
+
+/* == End of icon_theme.c ================================================== */
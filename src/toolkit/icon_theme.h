@@ -0,0 +1,96 @@
+/* ========================================================================= */
+/**
+ * @file icon_theme.h
+ *
+ * @copyright
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __WLMTK_ICON_THEME_H__
+#define __WLMTK_ICON_THEME_H__
+
+#include <libbase/libbase.h>
+
+/** Forward declaration: Icon theme. */
+typedef struct _wlmtk_icon_theme_t wlmtk_icon_theme_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+/**
+ * Creates an icon theme: Looks up icons by freedesktop name.
+ *
+ * Icons are found through an index of the installed themes, which maps each
+ * icon name to the files of each size. The index is memory-mapped from
+ * `index_path_ptr`. It is rebuilt if the theme or base directories changed,
+ * or if any of the indexed directories' mtime changed.
+ *
+ * Only PNG icons are indexed.
+ *
+ * @param theme_name_ptr      Name of the theme. Inherited themes and the
+ *                            `hicolor` theme are searched, too.
+ * @param base_dirs_ptr       NULL-terminated array of base directories to
+ *                            search for themes. NULL for the XDG defaults,
+ *                            which also include `/usr/share/pixmaps`.
+ * @param index_path_ptr      Path of the index file. NULL for `icon-theme.idx`
+ *                            in @ref wlmtk_util_cache_dir. If the index file
+ *                            cannot be written, it is held in memory.
+ *
+ * @return Pointer to the icon theme, or NULL on error.
+ */
+wlmtk_icon_theme_t *wlmtk_icon_theme_create(
+    const char *theme_name_ptr,
+    const char **base_dirs_ptr,
+    const char *index_path_ptr);
+
+/**
+ * Destroys the icon theme.
+ *
+ * @param icon_theme_ptr
+ */
+void wlmtk_icon_theme_destroy(wlmtk_icon_theme_t *icon_theme_ptr);
+
+/**
+ * Looks up the icon file best matching `name_ptr` and `size`.
+ *
+ * Follows the freedesktop icon theme specification: The first theme holding
+ * the icon is used, and within it, the closest size. Unthemed icons, eg.
+ * from `/usr/share/pixmaps`, are used only if no theme has the icon.
+ *
+ * @param icon_theme_ptr      May be NULL.
+ * @param name_ptr            Icon name, without extension.
+ * @param size                Desired size, in pixels.
+ * @param scale               Desired scale.
+ * @param path_ptr            Buffer of at least PATH_MAX bytes.
+ *
+ * @return `path_ptr` holding the path of the icon file, or NULL if not
+ *     found.
+ */
+char *wlmtk_icon_theme_lookup(
+    wlmtk_icon_theme_t *icon_theme_ptr,
+    const char *name_ptr,
+    int size,
+    int scale,
+    char *path_ptr);
+
+/** Unit test cases. */
+extern const bs_test_case_t wlmtk_icon_theme_test_cases[];
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif /* __WLMTK_ICON_THEME_H__ */
+/* == End of icon_theme.h ================================================== */
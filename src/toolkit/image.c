@@ -20,8 +20,15 @@
 
 #include "image.h"
 
+#include <limits.h>
+#include <math.h>
+
 #include "buffer.h"
+#include "container.h"
 #include "gfxbuf.h"
+#include "icon_theme.h"
+#include "image_cache.h"
+#include "image_loader.h"
 
 /* == Declarations ========================================================= */
 
@@ -29,13 +36,23 @@
 struct _wlmtk_image_t {
     /** The image's superclass: A buffer. */
     wlmtk_buffer_t            super_buffer;
+    /** Request to the image loader, while loading asynchronously. */
+    wlmtk_image_loader_request_t *request_ptr;
+    /** Scale the image is rendered at. From @ref wlmtk_env_scale. */
+    double                    scale;
 };
 
-struct wlr_buffer *_wlmtk_image_create_wlr_buffer_from_image(
-    const char *path_ptr,
+static wlmtk_image_t *_wlmtk_image_create(wlmtk_env_t *env_ptr);
+static const char *_wlmtk_image_resolve(
+    const char *image_path_ptr,
     int width,
-    int height);
-
+    int height,
+    double scale,
+    wlmtk_env_t *env_ptr,
+    char *path_ptr);
+static void _wlmtk_image_handle_loaded(
+    struct wlr_buffer *wlr_buffer_ptr,
+    void *ud_ptr);
 static void _wlmtk_image_element_destroy(wlmtk_element_t *element_ptr);
 
 /* == Data ================================================================= */
@@ -45,6 +62,9 @@ static const wlmtk_element_vmt_t _wlmtk_image_element_vmt = {
     .destroy = _wlmtk_image_element_destroy,
 };
 
+/** Size to look up icons by name for, if created without dimensions. */
+static const int _wlmtk_image_default_icon_size = 48;
+
 /* == Exported methods ===================================================== */
 
 /* ------------------------------------------------------------------------- */
@@ -62,33 +82,73 @@ wlmtk_image_t *wlmtk_image_create_scaled(
     int height,
     wlmtk_env_t *env_ptr)
 {
-    wlmtk_image_t *image_ptr = logged_calloc(1, sizeof(wlmtk_image_t));
+    wlmtk_image_t *image_ptr = _wlmtk_image_create(env_ptr);
     if (NULL == image_ptr) return NULL;
 
-    if (!wlmtk_buffer_init(&image_ptr->super_buffer, env_ptr)) {
+    char path[PATH_MAX];
+    image_path_ptr = _wlmtk_image_resolve(
+        image_path_ptr, width, height, image_ptr->scale, env_ptr, path);
+
+    // Images of the same icon share the decoded buffer.
+    struct wlr_buffer *wlr_buffer_ptr = wlmtk_image_cache_get(
+        image_path_ptr, width, height, image_ptr->scale);
+    if (NULL == wlr_buffer_ptr) {
         wlmtk_image_destroy(image_ptr);
         return NULL;
     }
-    wlmtk_element_extend(
-        wlmtk_image_element(image_ptr),
-        &_wlmtk_image_element_vmt);
+    wlmtk_buffer_set_scaled(
+        &image_ptr->super_buffer, wlr_buffer_ptr, image_ptr->scale);
+    wlr_buffer_unlock(wlr_buffer_ptr);
 
-    struct wlr_buffer *wlr_buffer_ptr =
-        _wlmtk_image_create_wlr_buffer_from_image(
-            image_path_ptr, width, height);
-    if (NULL == wlr_buffer_ptr) {
+    return image_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+wlmtk_image_t *wlmtk_image_create_async(
+    const char *image_path_ptr,
+    int width,
+    int height,
+    wlmtk_env_t *env_ptr)
+{
+    wlmtk_image_loader_t *loader_ptr = wlmtk_env_image_loader(env_ptr);
+    if (NULL == loader_ptr) {
+        return wlmtk_image_create_scaled(
+            image_path_ptr, width, height, env_ptr);
+    }
+
+    wlmtk_image_t *image_ptr = _wlmtk_image_create(env_ptr);
+    if (NULL == image_ptr) return NULL;
+
+    char path[PATH_MAX];
+    image_path_ptr = _wlmtk_image_resolve(
+        image_path_ptr, width, height, image_ptr->scale, env_ptr, path);
+
+    struct wlr_buffer *wlr_buffer_ptr = wlmtk_image_cache_lookup(
+        image_path_ptr, width, height, image_ptr->scale);
+    if (NULL != wlr_buffer_ptr) {
+        wlmtk_buffer_set_scaled(
+            &image_ptr->super_buffer, wlr_buffer_ptr, image_ptr->scale);
+        wlr_buffer_unlock(wlr_buffer_ptr);
+        return image_ptr;
+    }
+
+    image_ptr->request_ptr = wlmtk_image_loader_request(
+        loader_ptr, image_path_ptr, width, height, image_ptr->scale,
+        _wlmtk_image_handle_loaded, image_ptr);
+    if (NULL == image_ptr->request_ptr) {
         wlmtk_image_destroy(image_ptr);
         return NULL;
     }
-    wlmtk_buffer_set(&image_ptr->super_buffer, wlr_buffer_ptr);
-    wlr_buffer_drop(wlr_buffer_ptr);
-
     return image_ptr;
 }
 
 /* ------------------------------------------------------------------------- */
 void wlmtk_image_destroy(wlmtk_image_t *image_ptr)
 {
+    if (NULL != image_ptr->request_ptr) {
+        wlmtk_image_loader_cancel(image_ptr->request_ptr);
+        image_ptr->request_ptr = NULL;
+    }
     wlmtk_buffer_fini(&image_ptr->super_buffer);
     free(image_ptr);
 }
@@ -101,74 +161,76 @@ wlmtk_element_t *wlmtk_image_element(wlmtk_image_t *image_ptr)
 
 /* == Local (static) methods =============================================== */
 
+/* ------------------------------------------------------------------------- */
+/** Creates the image, without contents. */
+wlmtk_image_t *_wlmtk_image_create(wlmtk_env_t *env_ptr)
+{
+    wlmtk_image_t *image_ptr = logged_calloc(1, sizeof(wlmtk_image_t));
+    if (NULL == image_ptr) return NULL;
+
+    if (!wlmtk_buffer_init(&image_ptr->super_buffer, env_ptr)) {
+        wlmtk_image_destroy(image_ptr);
+        return NULL;
+    }
+    wlmtk_element_extend(
+        wlmtk_image_element(image_ptr),
+        &_wlmtk_image_element_vmt);
+    image_ptr->scale = wlmtk_env_scale(env_ptr);
+    return image_ptr;
+}
+
 /* ------------------------------------------------------------------------- */
 /**
- * Creates a wlr_buffer that holds the image loaded from path, at that image's
- * size.
+ * Resolves an icon name through the icon theme. Paths are kept as-is.
  *
- * @param path_ptr
- * @param width               Desired width of the image. 0 0r negative to use
- *                            the image's native width.
- * @param height              Desired height of the image. 0 0r negative to use
- *                            the image's native height.
+ * @param image_path_ptr
+ * @param width
+ * @param height
+ * @param scale               Scale of the output, to pick HiDPI variants.
+ * @param env_ptr
+ * @param path_ptr            Buffer of PATH_MAX bytes, for the resolved path.
  *
- * @return the wlr_buffer or NULL on error.
+ * @return The icon file's path, or `image_path_ptr` if it is a path or was
+ *     not found in the theme.
  */
-struct wlr_buffer *_wlmtk_image_create_wlr_buffer_from_image(
-    const char *path_ptr,
+const char *_wlmtk_image_resolve(
+    const char *image_path_ptr,
     int width,
-    int height)
+    int height,
+    double scale,
+    wlmtk_env_t *env_ptr,
+    char *path_ptr)
 {
-    cairo_surface_t *icon_surface_ptr = cairo_image_surface_create_from_png(
-        path_ptr);
-    if (NULL == icon_surface_ptr) {
-        bs_log(BS_ERROR, "Failed cairo_image_surface_create_from_png(%s).",
-               path_ptr);
-        return false;
-    }
-    if (CAIRO_STATUS_SUCCESS != cairo_surface_status(icon_surface_ptr)) {
-        bs_log(BS_ERROR,
-               "Bad surface after cairo_image_surface_create_from_png(%s): %s",
-               path_ptr,
-               cairo_status_to_string(cairo_surface_status(icon_surface_ptr)));
-        cairo_surface_destroy(icon_surface_ptr);
-        return NULL;
-    }
-
-    int w = width;
-    if (0 >= w) {
-        w = cairo_image_surface_get_width(icon_surface_ptr);
-    }
-    int h = height;
-    if (0 >= h) {
-        h = cairo_image_surface_get_height(icon_surface_ptr);
-    }
+    if (NULL != strchr(image_path_ptr, '/')) return image_path_ptr;
 
-    struct wlr_buffer *wlr_buffer_ptr = bs_gfxbuf_create_wlr_buffer(w, h);
-    if (NULL == wlr_buffer_ptr) {
-        cairo_surface_destroy(icon_surface_ptr);
-        return NULL;
-    }
-    cairo_t *cairo_ptr = cairo_create_from_wlr_buffer(wlr_buffer_ptr);
-    if (NULL == cairo_ptr) {
-        wlr_buffer_drop(wlr_buffer_ptr);
-        cairo_surface_destroy(icon_surface_ptr);
-        return NULL;
-    }
+    int size = BS_MAX(width, height);
+    if (0 >= size) size = _wlmtk_image_default_icon_size;
+    const char *resolved_path_ptr = wlmtk_icon_theme_lookup(
+        wlmtk_env_icon_theme(env_ptr), image_path_ptr, size,
+        BS_MAX(1, (int)ceil(scale)), path_ptr);
+    return NULL != resolved_path_ptr ? resolved_path_ptr : image_path_ptr;
+}
 
-    cairo_surface_set_device_scale(
-        icon_surface_ptr,
-        (double)cairo_image_surface_get_width(icon_surface_ptr) / w,
-        (double)cairo_image_surface_get_height(icon_surface_ptr) / h);
+/* ------------------------------------------------------------------------- */
+/** Callback for @ref wlmtk_image_loader_request: Sets the loaded image. */
+void _wlmtk_image_handle_loaded(
+    struct wlr_buffer *wlr_buffer_ptr,
+    void *ud_ptr)
+{
+    wlmtk_image_t *image_ptr = ud_ptr;
+    image_ptr->request_ptr = NULL;
 
-    cairo_set_source_surface(cairo_ptr, icon_surface_ptr, 0, 0);
-    cairo_rectangle(cairo_ptr, 0, 0, w, h);
-    cairo_fill(cairo_ptr);
-    cairo_stroke(cairo_ptr);
+    // Keeps the image blank on failure. The loader logged the cause.
+    if (NULL == wlr_buffer_ptr) return;
+    wlmtk_buffer_set_scaled(
+        &image_ptr->super_buffer, wlr_buffer_ptr, image_ptr->scale);
 
-    cairo_destroy(cairo_ptr);
-    cairo_surface_destroy(icon_surface_ptr);
-    return wlr_buffer_ptr;
+    // Dimensions changed: Parent may have to re-position the image.
+    wlmtk_container_t *parent_container_ptr =
+        wlmtk_image_element(image_ptr)->parent_container_ptr;
+    if (NULL != parent_container_ptr) {
+        wlmtk_container_update_layout(parent_container_ptr);
+    }
 }
 
 /* ------------------------------------------------------------------------- */
@@ -182,9 +244,13 @@ void _wlmtk_image_element_destroy(wlmtk_element_t *element_ptr)
 
 /* == Unit tests =========================================================== */
 static void test_create_destroy(bs_test_t *test_ptr);
+static void test_create_async(bs_test_t *test_ptr);
+static void test_create_hidpi(bs_test_t *test_ptr);
 
 const bs_test_case_t wlmtk_image_test_cases[] = {
     { 1, "create_destroy", test_create_destroy },
+    { 1, "create_async", test_create_async },
+    { 1, "create_hidpi", test_create_hidpi },
     { 0, NULL, NULL }
 };
 
@@ -209,4 +275,85 @@ void test_create_destroy(bs_test_t *test_ptr)
     wlmtk_image_destroy(image_ptr);
 }
 
+/* ------------------------------------------------------------------------- */
+/** Exercises asynchronous loading, completed through the event loop. */
+void test_create_async(bs_test_t *test_ptr)
+{
+    struct wl_event_loop *wl_event_loop_ptr = wl_event_loop_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, wl_event_loop_ptr);
+    wlmtk_env_t *env_ptr = wlmtk_env_create(
+        NULL, NULL, NULL, wl_event_loop_ptr);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, env_ptr);
+
+    wlmtk_image_t *image_ptr = wlmtk_image_create_async(
+        bs_test_resolve_path("toolkit/test_icon.png"), 0, 0, env_ptr);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, image_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, image_ptr->super_buffer.wlr_buffer_ptr);
+
+    for (int i = 0;
+         i < 100 && NULL == image_ptr->super_buffer.wlr_buffer_ptr;
+         ++i) {
+        wl_event_loop_dispatch(wl_event_loop_ptr, 10);
+    }
+    BS_TEST_VERIFY_NEQ_OR_RETURN(
+        test_ptr, NULL, image_ptr->super_buffer.wlr_buffer_ptr);
+    BS_TEST_VERIFY_GFXBUF_EQUALS_PNG(
+        test_ptr,
+        bs_gfxbuf_from_wlr_buffer(image_ptr->super_buffer.wlr_buffer_ptr),
+        "toolkit/test_icon.png");
+
+    // Now cached: Loaded right away.
+    wlmtk_image_t *image2_ptr = wlmtk_image_create_async(
+        bs_test_resolve_path("toolkit/test_icon.png"), 0, 0, env_ptr);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, image2_ptr);
+    BS_TEST_VERIFY_EQ(
+        test_ptr,
+        image_ptr->super_buffer.wlr_buffer_ptr,
+        image2_ptr->super_buffer.wlr_buffer_ptr);
+    wlmtk_image_destroy(image2_ptr);
+
+    // Destroyed while loading: Cancels the request.
+    wlmtk_image_destroy(image_ptr);
+    image_ptr = wlmtk_image_create_async(
+        bs_test_resolve_path("toolkit/test_icon.png"), 0, 0, env_ptr);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, image_ptr);
+    wlmtk_image_destroy(image_ptr);
+
+    wlmtk_env_destroy(env_ptr);
+    wl_event_loop_destroy(wl_event_loop_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Verifies images are rendered at the environment's scale. */
+void test_create_hidpi(bs_test_t *test_ptr)
+{
+    wlmtk_env_t *env_ptr = wlmtk_env_create(NULL, NULL, NULL, NULL);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, env_ptr);
+    wlmtk_env_set_scale(env_ptr, 2.0);
+
+    wlmtk_image_t *image_ptr = wlmtk_image_create_scaled(
+        bs_test_resolve_path("toolkit/test_icon.png"), 8, 8, env_ptr);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, image_ptr);
+
+    // Twice the pixels, for the same logical size.
+    struct wlr_buffer *wlr_buffer_ptr = image_ptr->super_buffer.wlr_buffer_ptr;
+    BS_TEST_VERIFY_EQ(test_ptr, 16, wlr_buffer_ptr->width);
+    BS_TEST_VERIFY_EQ(test_ptr, 16, wlr_buffer_ptr->height);
+    struct wlr_box box = wlmtk_element_get_dimensions_box(
+        wlmtk_image_element(image_ptr));
+    BS_TEST_VERIFY_EQ(test_ptr, 8, box.width);
+    BS_TEST_VERIFY_EQ(test_ptr, 8, box.height);
+
+    // The 1x image is a separate cache entry.
+    wlmtk_image_t *image1x_ptr = wlmtk_image_create_scaled(
+        bs_test_resolve_path("toolkit/test_icon.png"), 8, 8, NULL);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, image1x_ptr);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, 8, image1x_ptr->super_buffer.wlr_buffer_ptr->width);
+    wlmtk_image_destroy(image1x_ptr);
+
+    wlmtk_image_destroy(image_ptr);
+    wlmtk_env_destroy(env_ptr);
+}
+
 /* == End of image.c ======================================================= */
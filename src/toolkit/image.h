@@ -47,7 +47,9 @@ wlmtk_image_t *wlmtk_image_create(
 /**
  * Creates a toolkit image, scaled while preserving aspect ratio.
  *
- * @param image_path_ptr
+ * @param image_path_ptr      Path to the image. Or, a freedesktop icon name
+ *                            without '/', looked up via the icon theme of
+ *                            `env_ptr`. See @ref wlmtk_env_icon_theme.
  * @param width
  * @param height
  * @param env_ptr
@@ -60,6 +62,27 @@ wlmtk_image_t *wlmtk_image_create_scaled(
     int height,
     wlmtk_env_t *env_ptr);
 
+/**
+ * Creates a toolkit image, scaled while preserving aspect ratio, and loads
+ * it asynchronously.
+ *
+ * The image is blank until loaded through @ref wlmtk_env_image_loader.
+ * Returns a loaded image if it is cached already, or if `env_ptr` has no
+ * image loader.
+ *
+ * @param image_path_ptr      As for @ref wlmtk_image_create_scaled.
+ * @param width
+ * @param height
+ * @param env_ptr
+ *
+ * @return Pointer to the toolkit image or NULL on error.
+ */
+wlmtk_image_t *wlmtk_image_create_async(
+    const char *image_path_ptr,
+    int width,
+    int height,
+    wlmtk_env_t *env_ptr);
+
 /**
  * Destroys the toolkit image.
  *
@@ -0,0 +1,415 @@
+/* ========================================================================= */
+/**
+ * @file image_cache.c
+ *
+ * @copyright
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "image_cache.h"
+
+#include <math.h>
+
+#include "gfxbuf.h"
+#include "raster_cache.h"
+#include "util.h"
+
+/* == Declarations ========================================================= */
+
+/** Key of a cached image. */
+typedef struct {
+    /** Path the image is loaded from. */
+    const char                *path_ptr;
+    /** Width, or 0 for the image's native width. */
+    int                       width;
+    /** Height, or 0 for the image's native height. */
+    int                       height;
+    /** Scale of the output. */
+    double                    scale;
+} wlmtk_image_cache_key_t;
+
+/** An entry of the image cache. */
+typedef struct {
+    /** Node of @ref _wlmtk_image_cache_tree_ptr. */
+    bs_avltree_node_t         avlnode;
+    /** The key. Owns a copy of the path. */
+    wlmtk_image_cache_key_t   key;
+    /** The cached buffer. Not locked by the entry. */
+    struct wlr_buffer         *wlr_buffer_ptr;
+    /** Listener for `destroy` of the buffer: Evicts the entry. */
+    struct wl_listener        buffer_destroy_listener;
+} wlmtk_image_cache_entry_t;
+
+static wlmtk_image_cache_entry_t *_wlmtk_image_cache_entry_create(
+    const wlmtk_image_cache_key_t *key_ptr,
+    struct wlr_buffer *wlr_buffer_ptr);
+static void _wlmtk_image_cache_entry_destroy(
+    wlmtk_image_cache_entry_t *entry_ptr);
+static void _wlmtk_image_cache_handle_buffer_destroy(
+    struct wl_listener *listener_ptr,
+    void *data_ptr);
+static void _wlmtk_image_cache_release_tree(void);
+static int _wlmtk_image_cache_node_cmp(
+    const bs_avltree_node_t *node_ptr,
+    const void *key_ptr);
+static struct wlr_buffer *_wlmtk_image_cache_decode(
+    const char *path_ptr,
+    int width,
+    int height,
+    double scale);
+
+/* == Data ================================================================= */
+
+/**
+ * Cached images, as @ref wlmtk_image_cache_entry_t. Created on first use,
+ * and destroyed once the last entry is evicted.
+ */
+static bs_avltree_t *_wlmtk_image_cache_tree_ptr = NULL;
+/** Number of entries in @ref _wlmtk_image_cache_tree_ptr. */
+static size_t _wlmtk_image_cache_entry_count = 0;
+
+/* == Exported methods ===================================================== */
+
+/* ------------------------------------------------------------------------- */
+struct wlr_buffer *wlmtk_image_cache_get(
+    const char *path_ptr,
+    int width,
+    int height,
+    double scale)
+{
+    struct wlr_buffer *wlr_buffer_ptr = wlmtk_image_cache_lookup(
+        path_ptr, width, height, scale);
+    if (NULL != wlr_buffer_ptr) return wlr_buffer_ptr;
+
+    wlr_buffer_ptr = wlmtk_image_cache_load(path_ptr, width, height, scale);
+    if (NULL == wlr_buffer_ptr) return NULL;
+    return wlmtk_image_cache_add(
+        path_ptr, width, height, scale, wlr_buffer_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+struct wlr_buffer *wlmtk_image_cache_lookup(
+    const char *path_ptr,
+    int width,
+    int height,
+    double scale)
+{
+    if (NULL == _wlmtk_image_cache_tree_ptr) return NULL;
+
+    wlmtk_image_cache_key_t key = {
+        .path_ptr = path_ptr,
+        .width = BS_MAX(width, 0),
+        .height = BS_MAX(height, 0),
+        .scale = scale
+    };
+    bs_avltree_node_t *avlnode_ptr = bs_avltree_lookup(
+        _wlmtk_image_cache_tree_ptr, &key);
+    if (NULL == avlnode_ptr) return NULL;
+    return wlr_buffer_lock(BS_CONTAINER_OF(
+        avlnode_ptr, wlmtk_image_cache_entry_t, avlnode)->wlr_buffer_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+struct wlr_buffer *wlmtk_image_cache_add(
+    const char *path_ptr,
+    int width,
+    int height,
+    double scale,
+    struct wlr_buffer *wlr_buffer_ptr)
+{
+    // Another load of the same key may have completed first.
+    struct wlr_buffer *cached_wlr_buffer_ptr = wlmtk_image_cache_lookup(
+        path_ptr, width, height, scale);
+    if (NULL != cached_wlr_buffer_ptr) {
+        wlr_buffer_drop(wlr_buffer_ptr);
+        return cached_wlr_buffer_ptr;
+    }
+
+    // Hand out the only lock: The buffer is destroyed once all users unlock.
+    wlr_buffer_lock(wlr_buffer_ptr);
+    wlr_buffer_drop(wlr_buffer_ptr);
+
+    if (NULL == _wlmtk_image_cache_tree_ptr) {
+        // Entries are destroyed when their buffer is, not through the tree.
+        _wlmtk_image_cache_tree_ptr = bs_avltree_create(
+            _wlmtk_image_cache_node_cmp, NULL);
+        // Still usable, just not shared.
+        if (NULL == _wlmtk_image_cache_tree_ptr) return wlr_buffer_ptr;
+    }
+
+    wlmtk_image_cache_key_t key = {
+        .path_ptr = path_ptr,
+        .width = BS_MAX(width, 0),
+        .height = BS_MAX(height, 0),
+        .scale = scale
+    };
+    wlmtk_image_cache_entry_t *entry_ptr = _wlmtk_image_cache_entry_create(
+        &key, wlr_buffer_ptr);
+    if (NULL == entry_ptr) {
+        _wlmtk_image_cache_release_tree();
+        return wlr_buffer_ptr;
+    }
+    if (!bs_avltree_insert(_wlmtk_image_cache_tree_ptr, &entry_ptr->key,
+                           &entry_ptr->avlnode, false)) {
+        _wlmtk_image_cache_entry_destroy(entry_ptr);
+        _wlmtk_image_cache_release_tree();
+        return wlr_buffer_ptr;
+    }
+    ++_wlmtk_image_cache_entry_count;
+    return wlr_buffer_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+struct wlr_buffer *wlmtk_image_cache_load(
+    const char *path_ptr,
+    int width,
+    int height,
+    double scale)
+{
+    struct wlr_buffer *wlr_buffer_ptr = wlmtk_raster_cache_load(
+        path_ptr, width, height, scale);
+    if (NULL != wlr_buffer_ptr) return wlr_buffer_ptr;
+
+    wlr_buffer_ptr = _wlmtk_image_cache_decode(path_ptr, width, height, scale);
+    if (NULL != wlr_buffer_ptr) {
+        // Not fatal if it fails: The image will just be decoded next time.
+        wlmtk_raster_cache_store(
+            path_ptr, width, height, scale, wlr_buffer_ptr);
+    }
+    return wlr_buffer_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+size_t wlmtk_image_cache_entries(void)
+{
+    return _wlmtk_image_cache_entry_count;
+}
+
+/* == Local (static) methods =============================================== */
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Creates a cache entry. Copies the key's path and listens for the buffer's
+ * destruction.
+ *
+ * @param key_ptr
+ * @param wlr_buffer_ptr
+ *
+ * @return Pointer to the entry, or NULL on error.
+ */
+wlmtk_image_cache_entry_t *_wlmtk_image_cache_entry_create(
+    const wlmtk_image_cache_key_t *key_ptr,
+    struct wlr_buffer *wlr_buffer_ptr)
+{
+    wlmtk_image_cache_entry_t *entry_ptr = logged_calloc(
+        1, sizeof(wlmtk_image_cache_entry_t));
+    if (NULL == entry_ptr) return NULL;
+
+    entry_ptr->key = *key_ptr;
+    entry_ptr->key.path_ptr = logged_strdup(key_ptr->path_ptr);
+    if (NULL == entry_ptr->key.path_ptr) {
+        free(entry_ptr);
+        return NULL;
+    }
+
+    entry_ptr->wlr_buffer_ptr = wlr_buffer_ptr;
+    wlmtk_util_connect_listener_signal(
+        &wlr_buffer_ptr->events.destroy,
+        &entry_ptr->buffer_destroy_listener,
+        _wlmtk_image_cache_handle_buffer_destroy);
+    return entry_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Destroys the entry. Does not remove it from the tree. */
+void _wlmtk_image_cache_entry_destroy(wlmtk_image_cache_entry_t *entry_ptr)
+{
+    wlmtk_util_disconnect_listener(&entry_ptr->buffer_destroy_listener);
+    if (NULL != entry_ptr->key.path_ptr) {
+        // Safe: We own the copy, see _wlmtk_image_cache_entry_create.
+        free((char*)entry_ptr->key.path_ptr);
+        entry_ptr->key.path_ptr = NULL;
+    }
+    free(entry_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Handles `destroy` of the buffer: Nobody uses it, evicts the entry. */
+void _wlmtk_image_cache_handle_buffer_destroy(
+    struct wl_listener *listener_ptr,
+    __UNUSED__ void *data_ptr)
+{
+    wlmtk_image_cache_entry_t *entry_ptr = BS_CONTAINER_OF(
+        listener_ptr, wlmtk_image_cache_entry_t, buffer_destroy_listener);
+
+    bs_avltree_delete(_wlmtk_image_cache_tree_ptr, &entry_ptr->key);
+    --_wlmtk_image_cache_entry_count;
+    _wlmtk_image_cache_entry_destroy(entry_ptr);
+    _wlmtk_image_cache_release_tree();
+}
+
+/* ------------------------------------------------------------------------- */
+/** Destroys @ref _wlmtk_image_cache_tree_ptr, if there are no entries. */
+void _wlmtk_image_cache_release_tree(void)
+{
+    if (0 < _wlmtk_image_cache_entry_count ||
+        NULL == _wlmtk_image_cache_tree_ptr) return;
+    bs_avltree_destroy(_wlmtk_image_cache_tree_ptr);
+    _wlmtk_image_cache_tree_ptr = NULL;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Comparator for @ref _wlmtk_image_cache_tree_ptr nodes. */
+int _wlmtk_image_cache_node_cmp(
+    const bs_avltree_node_t *node_ptr,
+    const void *key_ptr)
+{
+    const wlmtk_image_cache_key_t *k1_ptr = &BS_CONTAINER_OF(
+        node_ptr, wlmtk_image_cache_entry_t, avlnode)->key;
+    const wlmtk_image_cache_key_t *k2_ptr = key_ptr;
+
+    if (k1_ptr->width != k2_ptr->width) {
+        return k1_ptr->width < k2_ptr->width ? -1 : 1;
+    }
+    if (k1_ptr->height != k2_ptr->height) {
+        return k1_ptr->height < k2_ptr->height ? -1 : 1;
+    }
+    if (k1_ptr->scale != k2_ptr->scale) {
+        return k1_ptr->scale < k2_ptr->scale ? -1 : 1;
+    }
+    return strcmp(k1_ptr->path_ptr, k2_ptr->path_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Decodes the PNG image at `path_ptr` and scales it.
+ *
+ * @param path_ptr
+ * @param width               Desired width of the image. 0 to use the
+ *                            image's native width.
+ * @param height              Desired height of the image. 0 to use the
+ *                            image's native height.
+ * @param scale
+ *
+ * @return the wlr_buffer or NULL on error.
+ */
+struct wlr_buffer *_wlmtk_image_cache_decode(
+    const char *path_ptr,
+    int width,
+    int height,
+    double scale)
+{
+    cairo_surface_t *icon_surface_ptr = cairo_image_surface_create_from_png(
+        path_ptr);
+    if (NULL == icon_surface_ptr) {
+        bs_log(BS_ERROR, "Failed cairo_image_surface_create_from_png(%s).",
+               path_ptr);
+        return NULL;
+    }
+    if (CAIRO_STATUS_SUCCESS != cairo_surface_status(icon_surface_ptr)) {
+        bs_log(BS_ERROR,
+               "Bad surface after cairo_image_surface_create_from_png(%s): %s",
+               path_ptr,
+               cairo_status_to_string(cairo_surface_status(icon_surface_ptr)));
+        cairo_surface_destroy(icon_surface_ptr);
+        return NULL;
+    }
+
+    int w = width;
+    if (0 >= w) {
+        w = cairo_image_surface_get_width(icon_surface_ptr);
+    }
+    w = BS_MAX(1, lround(w * scale));
+    int h = height;
+    if (0 >= h) {
+        h = cairo_image_surface_get_height(icon_surface_ptr);
+    }
+    h = BS_MAX(1, lround(h * scale));
+
+    struct wlr_buffer *wlr_buffer_ptr = bs_gfxbuf_create_wlr_buffer(w, h);
+    if (NULL == wlr_buffer_ptr) {
+        cairo_surface_destroy(icon_surface_ptr);
+        return NULL;
+    }
+    cairo_t *cairo_ptr = cairo_create_from_wlr_buffer(wlr_buffer_ptr);
+    if (NULL == cairo_ptr) {
+        wlr_buffer_drop(wlr_buffer_ptr);
+        cairo_surface_destroy(icon_surface_ptr);
+        return NULL;
+    }
+
+    cairo_surface_set_device_scale(
+        icon_surface_ptr,
+        (double)cairo_image_surface_get_width(icon_surface_ptr) / w,
+        (double)cairo_image_surface_get_height(icon_surface_ptr) / h);
+
+    cairo_set_source_surface(cairo_ptr, icon_surface_ptr, 0, 0);
+    cairo_rectangle(cairo_ptr, 0, 0, w, h);
+    cairo_fill(cairo_ptr);
+    cairo_stroke(cairo_ptr);
+
+    cairo_destroy(cairo_ptr);
+    cairo_surface_destroy(icon_surface_ptr);
+    return wlr_buffer_ptr;
+}
+
+/* == Unit tests =========================================================== */
+
+static void test_get(bs_test_t *test_ptr);
+
+const bs_test_case_t wlmtk_image_cache_test_cases[] = {
+    { 1, "get", test_get },
+    { 0, NULL, NULL }
+};
+
+/* ------------------------------------------------------------------------- */
+/** Exercises sharing and eviction of cached images. */
+void test_get(bs_test_t *test_ptr)
+{
+    const char *path_ptr = bs_test_resolve_path("toolkit/test_icon.png");
+
+    struct wlr_buffer *b1_ptr = wlmtk_image_cache_get(path_ptr, 0, 0, 1.0);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, b1_ptr);
+    BS_TEST_VERIFY_GFXBUF_EQUALS_PNG(
+        test_ptr, bs_gfxbuf_from_wlr_buffer(b1_ptr), "toolkit/test_icon.png");
+    BS_TEST_VERIFY_EQ(test_ptr, 1, wlmtk_image_cache_entries());
+
+    // Same key: Shares the buffer.
+    struct wlr_buffer *b2_ptr = wlmtk_image_cache_get(path_ptr, 0, 0, 1.0);
+    BS_TEST_VERIFY_EQ(test_ptr, b1_ptr, b2_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, wlmtk_image_cache_entries());
+
+    // Other scale: A new entry.
+    struct wlr_buffer *b3_ptr = wlmtk_image_cache_get(path_ptr, 0, 0, 2.0);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, b3_ptr);
+    BS_TEST_VERIFY_NEQ(test_ptr, b1_ptr, b3_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 2 * b1_ptr->width, b3_ptr->width);
+    BS_TEST_VERIFY_EQ(test_ptr, 2, wlmtk_image_cache_entries());
+
+    // Evicted once no longer used.
+    wlr_buffer_unlock(b3_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, wlmtk_image_cache_entries());
+    wlr_buffer_unlock(b2_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, wlmtk_image_cache_entries());
+    wlr_buffer_unlock(b1_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, wlmtk_image_cache_entries());
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, _wlmtk_image_cache_tree_ptr);
+
+    BS_TEST_VERIFY_EQ(
+        test_ptr, NULL, wlmtk_image_cache_get("/nonexistent.png", 0, 0, 1.0));
+    BS_TEST_VERIFY_EQ(test_ptr, 0, wlmtk_image_cache_entries());
+}
+
+/* == End of image_cache.c ================================================= */
@@ -0,0 +1,127 @@
+/* ========================================================================= */
+/**
+ * @file image_cache.h
+ *
+ * @copyright
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __WLMTK_IMAGE_CACHE_H__
+#define __WLMTK_IMAGE_CACHE_H__
+
+#include <libbase/libbase.h>
+
+/** Forward declaration. */
+struct wlr_buffer;
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+/**
+ * Returns the image loaded from `path_ptr`, scaled to the given size.
+ *
+ * Images are cached process-wide, keyed by path, size and scale. Users of
+ * the same key share the same buffer, which must not be modified. An entry
+ * is evicted once its buffer is no longer locked by any user.
+ *
+ * @param path_ptr
+ * @param width               Width of the image. 0 or negative to use the
+ *                            image's native width.
+ * @param height              Height of the image. 0 or negative to use the
+ *                            image's native height.
+ * @param scale               Scale of the output. The buffer will have
+ *                            `width * scale` by `height * scale` pixels.
+ *
+ * @return A locked wlr_buffer, to be released by wlr_buffer_unlock(). NULL
+ *     on error.
+ */
+struct wlr_buffer *wlmtk_image_cache_get(
+    const char *path_ptr,
+    int width,
+    int height,
+    double scale);
+
+/**
+ * Looks up an image in the cache, without loading it.
+ *
+ * @param path_ptr
+ * @param width
+ * @param height
+ * @param scale
+ *
+ * @return A locked wlr_buffer, to be released by wlr_buffer_unlock(). NULL
+ *     if the image is not cached.
+ */
+struct wlr_buffer *wlmtk_image_cache_lookup(
+    const char *path_ptr,
+    int width,
+    int height,
+    double scale);
+
+/**
+ * Adds a loaded image to the cache.
+ *
+ * If the key is already cached, `wlr_buffer_ptr` is dropped and the cached
+ * buffer is returned instead.
+ *
+ * @param path_ptr
+ * @param width
+ * @param height
+ * @param scale
+ * @param wlr_buffer_ptr      As returned from @ref wlmtk_image_cache_load.
+ *                            The cache takes ownership.
+ *
+ * @return A locked wlr_buffer, to be released by wlr_buffer_unlock().
+ */
+struct wlr_buffer *wlmtk_image_cache_add(
+    const char *path_ptr,
+    int width,
+    int height,
+    double scale,
+    struct wlr_buffer *wlr_buffer_ptr);
+
+/**
+ * Loads the image from `path_ptr` and scales it, bypassing the cache.
+ *
+ * Uses the on-disk cache, if enabled through @ref wlmtk_raster_cache_init.
+ * May be called from any thread.
+ *
+ * @param path_ptr
+ * @param width               Width of the image. 0 or negative to use the
+ *                            image's native width.
+ * @param height              Height of the image. 0 or negative to use the
+ *                            image's native height.
+ * @param scale
+ *
+ * @return A wlr_buffer, to be released by wlr_buffer_drop(). NULL on error.
+ */
+struct wlr_buffer *wlmtk_image_cache_load(
+    const char *path_ptr,
+    int width,
+    int height,
+    double scale);
+
+/** @return Number of images currently held in the cache. */
+size_t wlmtk_image_cache_entries(void);
+
+/** Unit test cases. */
+extern const bs_test_case_t wlmtk_image_cache_test_cases[];
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif /* __WLMTK_IMAGE_CACHE_H__ */
+/* == End of image_cache.h ================================================= */
@@ -0,0 +1,456 @@
+/* ========================================================================= */
+/**
+ * @file image_loader.c
+ *
+ * @copyright
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "image_loader.h"
+
+#include <errno.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <wayland-server-core.h>
+
+#include "gfxbuf.h"
+#include "image_cache.h"
+
+/* == Declarations ========================================================= */
+
+/** State of the image loader. */
+struct _wlmtk_image_loader_t {
+    /** Loads the image. Called from the worker threads. */
+    wlmtk_image_loader_load_t load;
+    /** Worker threads. */
+    pthread_t                 *threads_ptr;
+    /** Number of worker threads started. */
+    unsigned                  threads;
+
+    /** Guards `pending`, `completed`, `shutdown` and request states. */
+    pthread_mutex_t           mutex;
+    /** Signalled when a request is pending, or on shutdown. */
+    pthread_cond_t            cond;
+    /** Requests not yet picked up by a worker. */
+    bs_dllist_t               pending;
+    /** Requests loaded by a worker, awaiting the callback. */
+    bs_dllist_t               completed;
+    /** Tells the workers to exit. */
+    bool                      shutdown;
+
+    /** Signalled by the workers when a request completed. */
+    int                       eventfd;
+    /** Event source for `eventfd`. */
+    struct wl_event_source    *wl_event_source_ptr;
+};
+
+/** State of a request. */
+typedef enum {
+    /** In @ref _wlmtk_image_loader_t::pending. */
+    WLMTK_IMAGE_LOADER_REQUEST_PENDING,
+    /** Being loaded by a worker. */
+    WLMTK_IMAGE_LOADER_REQUEST_LOADING,
+    /** In @ref _wlmtk_image_loader_t::completed. */
+    WLMTK_IMAGE_LOADER_REQUEST_COMPLETED
+} wlmtk_image_loader_request_state_t;
+
+/** State of a request to the image loader. */
+struct _wlmtk_image_loader_request_t {
+    /** Element of @ref _wlmtk_image_loader_t::pending or `completed`. */
+    bs_dllist_node_t          dlnode;
+    /** Back-link to the loader. */
+    wlmtk_image_loader_t      *loader_ptr;
+    /** State. Guarded by @ref _wlmtk_image_loader_t::mutex. */
+    wlmtk_image_loader_request_state_t state;
+    /** Whether the request got cancelled while loading or completed. */
+    bool                      cancelled;
+
+    /** Path to load the image from. */
+    char                      *path_ptr;
+    /** Width of the image. */
+    int                       width;
+    /** Height of the image. */
+    int                       height;
+    /** Scale of the image. */
+    double                    scale;
+    /** Callback for completion. */
+    wlmtk_image_loader_callback_t callback;
+    /** Argument to `callback`. */
+    void                      *ud_ptr;
+
+    /** The loaded image. Set by the worker. */
+    struct wlr_buffer         *wlr_buffer_ptr;
+};
+
+static void *_wlmtk_image_loader_worker(void *arg_ptr);
+static int _wlmtk_image_loader_handle_eventfd(
+    int fd,
+    uint32_t mask,
+    void *data_ptr);
+static void _wlmtk_image_loader_request_complete(
+    wlmtk_image_loader_request_t *request_ptr);
+static void _wlmtk_image_loader_request_destroy(
+    wlmtk_image_loader_request_t *request_ptr);
+
+/* == Exported methods ===================================================== */
+
+/* ------------------------------------------------------------------------- */
+wlmtk_image_loader_t *wlmtk_image_loader_create(
+    struct wl_event_loop *wl_event_loop_ptr,
+    unsigned threads,
+    wlmtk_image_loader_load_t load)
+{
+    wlmtk_image_loader_t *loader_ptr = logged_calloc(
+        1, sizeof(wlmtk_image_loader_t));
+    if (NULL == loader_ptr) return NULL;
+    loader_ptr->load = NULL != load ? load : wlmtk_image_cache_load;
+    loader_ptr->eventfd = -1;
+    pthread_mutex_init(&loader_ptr->mutex, NULL);
+    pthread_cond_init(&loader_ptr->cond, NULL);
+
+    loader_ptr->eventfd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (0 > loader_ptr->eventfd) {
+        bs_log(BS_ERROR | BS_ERRNO, "Failed eventfd(0, EFD_CLOEXEC | "
+               "EFD_NONBLOCK)");
+        wlmtk_image_loader_destroy(loader_ptr);
+        return NULL;
+    }
+    loader_ptr->wl_event_source_ptr = wl_event_loop_add_fd(
+        wl_event_loop_ptr,
+        loader_ptr->eventfd,
+        WL_EVENT_READABLE,
+        _wlmtk_image_loader_handle_eventfd,
+        loader_ptr);
+    if (NULL == loader_ptr->wl_event_source_ptr) {
+        bs_log(BS_ERROR, "Failed wl_event_loop_add_fd(%p, %d, ...)",
+               wl_event_loop_ptr, loader_ptr->eventfd);
+        wlmtk_image_loader_destroy(loader_ptr);
+        return NULL;
+    }
+
+    loader_ptr->threads_ptr = logged_calloc(
+        BS_MAX(threads, 1u), sizeof(pthread_t));
+    if (NULL == loader_ptr->threads_ptr) {
+        wlmtk_image_loader_destroy(loader_ptr);
+        return NULL;
+    }
+    for (unsigned i = 0; i < BS_MAX(threads, 1u); ++i) {
+        int rv = pthread_create(&loader_ptr->threads_ptr[i], NULL,
+                                _wlmtk_image_loader_worker, loader_ptr);
+        if (0 != rv) {
+            errno = rv;
+            bs_log(BS_ERROR | BS_ERRNO, "Failed pthread_create()");
+            wlmtk_image_loader_destroy(loader_ptr);
+            return NULL;
+        }
+        ++loader_ptr->threads;
+    }
+    return loader_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_image_loader_destroy(wlmtk_image_loader_t *loader_ptr)
+{
+    pthread_mutex_lock(&loader_ptr->mutex);
+    loader_ptr->shutdown = true;
+    pthread_cond_broadcast(&loader_ptr->cond);
+    pthread_mutex_unlock(&loader_ptr->mutex);
+    for (unsigned i = 0; i < loader_ptr->threads; ++i) {
+        pthread_join(loader_ptr->threads_ptr[i], NULL);
+    }
+    loader_ptr->threads = 0;
+    if (NULL != loader_ptr->threads_ptr) {
+        free(loader_ptr->threads_ptr);
+        loader_ptr->threads_ptr = NULL;
+    }
+
+    // Workers are gone: No more locking needed.
+    bs_dllist_node_t *dlnode_ptr;
+    while (NULL != (dlnode_ptr = bs_dllist_pop_front(&loader_ptr->pending))) {
+        _wlmtk_image_loader_request_destroy(BS_CONTAINER_OF(
+            dlnode_ptr, wlmtk_image_loader_request_t, dlnode));
+    }
+    while (NULL != (dlnode_ptr = bs_dllist_pop_front(
+                        &loader_ptr->completed))) {
+        _wlmtk_image_loader_request_destroy(BS_CONTAINER_OF(
+            dlnode_ptr, wlmtk_image_loader_request_t, dlnode));
+    }
+
+    if (NULL != loader_ptr->wl_event_source_ptr) {
+        wl_event_source_remove(loader_ptr->wl_event_source_ptr);
+        loader_ptr->wl_event_source_ptr = NULL;
+    }
+    if (0 <= loader_ptr->eventfd) {
+        close(loader_ptr->eventfd);
+        loader_ptr->eventfd = -1;
+    }
+    pthread_cond_destroy(&loader_ptr->cond);
+    pthread_mutex_destroy(&loader_ptr->mutex);
+    free(loader_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+wlmtk_image_loader_request_t *wlmtk_image_loader_request(
+    wlmtk_image_loader_t *loader_ptr,
+    const char *path_ptr,
+    int width,
+    int height,
+    double scale,
+    wlmtk_image_loader_callback_t callback,
+    void *ud_ptr)
+{
+    wlmtk_image_loader_request_t *request_ptr = logged_calloc(
+        1, sizeof(wlmtk_image_loader_request_t));
+    if (NULL == request_ptr) return NULL;
+    request_ptr->loader_ptr = loader_ptr;
+    request_ptr->path_ptr = logged_strdup(path_ptr);
+    if (NULL == request_ptr->path_ptr) {
+        _wlmtk_image_loader_request_destroy(request_ptr);
+        return NULL;
+    }
+    request_ptr->width = width;
+    request_ptr->height = height;
+    request_ptr->scale = scale;
+    request_ptr->callback = callback;
+    request_ptr->ud_ptr = ud_ptr;
+
+    pthread_mutex_lock(&loader_ptr->mutex);
+    request_ptr->state = WLMTK_IMAGE_LOADER_REQUEST_PENDING;
+    bs_dllist_push_back(&loader_ptr->pending, &request_ptr->dlnode);
+    pthread_cond_signal(&loader_ptr->cond);
+    pthread_mutex_unlock(&loader_ptr->mutex);
+    return request_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_image_loader_cancel(wlmtk_image_loader_request_t *request_ptr)
+{
+    wlmtk_image_loader_t *loader_ptr = request_ptr->loader_ptr;
+
+    pthread_mutex_lock(&loader_ptr->mutex);
+    if (WLMTK_IMAGE_LOADER_REQUEST_PENDING == request_ptr->state) {
+        bs_dllist_remove(&loader_ptr->pending, &request_ptr->dlnode);
+        pthread_mutex_unlock(&loader_ptr->mutex);
+        _wlmtk_image_loader_request_destroy(request_ptr);
+        return;
+    }
+    // Owned by a worker, or in `completed`: Gets destroyed on completion.
+    request_ptr->cancelled = true;
+    pthread_mutex_unlock(&loader_ptr->mutex);
+}
+
+/* == Local (static) methods =============================================== */
+
+/* ------------------------------------------------------------------------- */
+/** Worker thread: Loads pending requests, until shutdown. */
+void *_wlmtk_image_loader_worker(void *arg_ptr)
+{
+    wlmtk_image_loader_t *loader_ptr = arg_ptr;
+
+    pthread_mutex_lock(&loader_ptr->mutex);
+    while (true) {
+        while (!loader_ptr->shutdown &&
+               bs_dllist_empty(&loader_ptr->pending)) {
+            pthread_cond_wait(&loader_ptr->cond, &loader_ptr->mutex);
+        }
+        if (loader_ptr->shutdown) break;
+
+        wlmtk_image_loader_request_t *request_ptr = BS_CONTAINER_OF(
+            bs_dllist_pop_front(&loader_ptr->pending),
+            wlmtk_image_loader_request_t, dlnode);
+        request_ptr->state = WLMTK_IMAGE_LOADER_REQUEST_LOADING;
+        pthread_mutex_unlock(&loader_ptr->mutex);
+
+        request_ptr->wlr_buffer_ptr = loader_ptr->load(
+            request_ptr->path_ptr,
+            request_ptr->width,
+            request_ptr->height,
+            request_ptr->scale);
+
+        pthread_mutex_lock(&loader_ptr->mutex);
+        request_ptr->state = WLMTK_IMAGE_LOADER_REQUEST_COMPLETED;
+        bs_dllist_push_back(&loader_ptr->completed, &request_ptr->dlnode);
+        uint64_t value = 1;
+        if (sizeof(value) != write(loader_ptr->eventfd, &value,
+                                   sizeof(value))) {
+            bs_log(BS_WARNING | BS_ERRNO, "Failed write(%d, ...)",
+                   loader_ptr->eventfd);
+        }
+    }
+    pthread_mutex_unlock(&loader_ptr->mutex);
+    return NULL;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Handles the eventfd: Completes all requests that the workers loaded. */
+int _wlmtk_image_loader_handle_eventfd(
+    int fd,
+    __UNUSED__ uint32_t mask,
+    void *data_ptr)
+{
+    wlmtk_image_loader_t *loader_ptr = data_ptr;
+    BS_ASSERT(fd == loader_ptr->eventfd);
+
+    uint64_t value;
+    if (0 > read(fd, &value, sizeof(value)) && EAGAIN != errno) {
+        bs_log(BS_WARNING | BS_ERRNO, "Failed read(%d, ...)", fd);
+    }
+
+    while (true) {
+        pthread_mutex_lock(&loader_ptr->mutex);
+        bs_dllist_node_t *dlnode_ptr = bs_dllist_pop_front(
+            &loader_ptr->completed);
+        pthread_mutex_unlock(&loader_ptr->mutex);
+        if (NULL == dlnode_ptr) break;
+
+        _wlmtk_image_loader_request_complete(BS_CONTAINER_OF(
+            dlnode_ptr, wlmtk_image_loader_request_t, dlnode));
+    }
+    return 0;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Completes the request: Adds the image to the cache, invokes the callback,
+ * and destroys the request.
+ *
+ * @param request_ptr
+ */
+void _wlmtk_image_loader_request_complete(
+    wlmtk_image_loader_request_t *request_ptr)
+{
+    // Only this thread sets `cancelled`, no locking needed.
+    if (request_ptr->cancelled) {
+        _wlmtk_image_loader_request_destroy(request_ptr);
+        return;
+    }
+
+    struct wlr_buffer *wlr_buffer_ptr = NULL;
+    if (NULL != request_ptr->wlr_buffer_ptr) {
+        wlr_buffer_ptr = wlmtk_image_cache_add(
+            request_ptr->path_ptr,
+            request_ptr->width,
+            request_ptr->height,
+            request_ptr->scale,
+            request_ptr->wlr_buffer_ptr);
+        request_ptr->wlr_buffer_ptr = NULL;
+    }
+
+    request_ptr->callback(wlr_buffer_ptr, request_ptr->ud_ptr);
+    if (NULL != wlr_buffer_ptr) wlr_buffer_unlock(wlr_buffer_ptr);
+    _wlmtk_image_loader_request_destroy(request_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Destroys the request, and the image it holds, if any. */
+void _wlmtk_image_loader_request_destroy(
+    wlmtk_image_loader_request_t *request_ptr)
+{
+    if (NULL != request_ptr->wlr_buffer_ptr) {
+        wlr_buffer_drop(request_ptr->wlr_buffer_ptr);
+        request_ptr->wlr_buffer_ptr = NULL;
+    }
+    if (NULL != request_ptr->path_ptr) {
+        free(request_ptr->path_ptr);
+        request_ptr->path_ptr = NULL;
+    }
+    free(request_ptr);
+}
+
+/* == Unit tests =========================================================== */
+
+static void test_slow(bs_test_t *test_ptr);
+
+const bs_test_case_t wlmtk_image_loader_test_cases[] = {
+    { 1, "slow", test_slow },
+    { 0, NULL, NULL }
+};
+
+/** Delay of @ref _wlmtk_image_loader_test_slow_load, in microseconds. */
+static const useconds_t _wlmtk_image_loader_test_delay_usec = 50000;
+
+/* ------------------------------------------------------------------------- */
+/** A deliberately slow loader: Sleeps, then returns a blank buffer. */
+static struct wlr_buffer *_wlmtk_image_loader_test_slow_load(
+    __UNUSED__ const char *path_ptr,
+    int width,
+    int height,
+    __UNUSED__ double scale)
+{
+    usleep(_wlmtk_image_loader_test_delay_usec);
+    return bs_gfxbuf_create_wlr_buffer(width, height);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Test callback: Records the width and counts completions. */
+static void _wlmtk_image_loader_test_callback(
+    struct wlr_buffer *wlr_buffer_ptr,
+    void *ud_ptr)
+{
+    int *width_ptr = ud_ptr;
+    *width_ptr = NULL != wlr_buffer_ptr ? wlr_buffer_ptr->width : -1;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Loads through a slow loader, verifies it completes on the event loop. */
+void test_slow(bs_test_t *test_ptr)
+{
+    struct wl_event_loop *wl_event_loop_ptr = wl_event_loop_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, wl_event_loop_ptr);
+    wlmtk_image_loader_t *loader_ptr = wlmtk_image_loader_create(
+        wl_event_loop_ptr, 2, _wlmtk_image_loader_test_slow_load);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, loader_ptr);
+
+    int w1 = 0, w2 = 0, w3 = 0;
+    wlmtk_image_loader_request_t *r1_ptr = wlmtk_image_loader_request(
+        loader_ptr, "slow", 10, 10, 1.0,
+        _wlmtk_image_loader_test_callback, &w1);
+    wlmtk_image_loader_request_t *r2_ptr = wlmtk_image_loader_request(
+        loader_ptr, "slow", 20, 20, 1.0,
+        _wlmtk_image_loader_test_callback, &w2);
+    wlmtk_image_loader_request_t *r3_ptr = wlmtk_image_loader_request(
+        loader_ptr, "slow", 30, 30, 1.0,
+        _wlmtk_image_loader_test_callback, &w3);
+    BS_TEST_VERIFY_NEQ(test_ptr, NULL, r1_ptr);
+    BS_TEST_VERIFY_NEQ(test_ptr, NULL, r2_ptr);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, r3_ptr);
+
+    // Requests return right away; nothing completes outside the loop.
+    BS_TEST_VERIFY_EQ(test_ptr, 0, w1);
+    wlmtk_image_loader_cancel(r2_ptr);
+
+    for (int i = 0; i < 100 && (0 == w1 || 0 == w3); ++i) {
+        wl_event_loop_dispatch(wl_event_loop_ptr, 10);
+    }
+    BS_TEST_VERIFY_EQ(test_ptr, 10, w1);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, w2);
+    BS_TEST_VERIFY_EQ(test_ptr, 30, w3);
+
+    // Callbacks did not retain the buffers: Evicted from the cache.
+    BS_TEST_VERIFY_EQ(test_ptr, 0, wlmtk_image_cache_entries());
+
+    // Outstanding at destroy: Discarded without callback.
+    int w4 = 0;
+    wlmtk_image_loader_request(
+        loader_ptr, "slow", 40, 40, 1.0,
+        _wlmtk_image_loader_test_callback, &w4);
+    wlmtk_image_loader_destroy(loader_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, w4);
+    wl_event_loop_destroy(wl_event_loop_ptr);
+}
+
+/* == End of image_loader.c ================================================ */
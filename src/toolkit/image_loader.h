@@ -0,0 +1,126 @@
+/* ========================================================================= */
+/**
+ * @file image_loader.h
+ *
+ * @copyright
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __WLMTK_IMAGE_LOADER_H__
+#define __WLMTK_IMAGE_LOADER_H__
+
+#include <libbase/libbase.h>
+
+/** Forward declaration: Image loader. */
+typedef struct _wlmtk_image_loader_t wlmtk_image_loader_t;
+/** Forward declaration: A request to the image loader. */
+typedef struct _wlmtk_image_loader_request_t wlmtk_image_loader_request_t;
+
+/** Forward declaration. */
+struct wlr_buffer;
+/** Forward declaration. */
+struct wl_event_loop;
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+/**
+ * Loads an image. Called from a worker thread; must not touch shared state.
+ *
+ * @see wlmtk_image_cache_load, which is the default.
+ */
+typedef struct wlr_buffer *(*wlmtk_image_loader_load_t)(
+    const char *path_ptr,
+    int width,
+    int height,
+    double scale);
+
+/**
+ * Callback for a completed request. Called from the event loop.
+ *
+ * @param wlr_buffer_ptr      The loaded image, or NULL on error. Is unlocked
+ *                            after the callback returns; the callback must
+ *                            lock it to retain it.
+ * @param ud_ptr
+ */
+typedef void (*wlmtk_image_loader_callback_t)(
+    struct wlr_buffer *wlr_buffer_ptr,
+    void *ud_ptr);
+
+/**
+ * Creates an image loader: A pool of worker threads that load and scale
+ * images, and report completion on the event loop.
+ *
+ * Loaded images are added to the image cache, see @ref wlmtk_image_cache_add.
+ *
+ * @param wl_event_loop_ptr
+ * @param threads             Number of worker threads.
+ * @param load                Loads the image, or NULL to use
+ *                            @ref wlmtk_image_cache_load.
+ *
+ * @return Pointer to the image loader, or NULL on error.
+ */
+wlmtk_image_loader_t *wlmtk_image_loader_create(
+    struct wl_event_loop *wl_event_loop_ptr,
+    unsigned threads,
+    wlmtk_image_loader_load_t load);
+
+/**
+ * Destroys the image loader. Waits for the worker threads to finish their
+ * current load. Outstanding requests are discarded without callback.
+ *
+ * @param loader_ptr
+ */
+void wlmtk_image_loader_destroy(wlmtk_image_loader_t *loader_ptr);
+
+/**
+ * Requests an image to be loaded.
+ *
+ * @param loader_ptr
+ * @param path_ptr
+ * @param width
+ * @param height
+ * @param scale
+ * @param callback            Called from the event loop once loaded.
+ * @param ud_ptr              Passed to `callback`.
+ *
+ * @return The request. Remains valid until `callback` is invoked, or until
+ *     it is cancelled through @ref wlmtk_image_loader_cancel. NULL on error.
+ */
+wlmtk_image_loader_request_t *wlmtk_image_loader_request(
+    wlmtk_image_loader_t *loader_ptr,
+    const char *path_ptr,
+    int width,
+    int height,
+    double scale,
+    wlmtk_image_loader_callback_t callback,
+    void *ud_ptr);
+
+/**
+ * Cancels the request. Its callback will not be invoked.
+ *
+ * @param request_ptr
+ */
+void wlmtk_image_loader_cancel(wlmtk_image_loader_request_t *request_ptr);
+
+/** Unit test cases. */
+extern const bs_test_case_t wlmtk_image_loader_test_cases[];
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif /* __WLMTK_IMAGE_LOADER_H__ */
+/* == End of image_loader.h ================================================ */
@@ -41,6 +41,11 @@ struct _wlmtk_menu_style_t {
     wlmtk_margin_style_t      border;
     /** Item's style. */
     wlmtk_menu_item_style_t   item;
+    /**
+     * Delay for destroying a menu created on demand, once it was hidden, in
+     * milliseconds. 0 to keep it.
+     */
+    uint64_t                  release_delay;
 };
 
 /** State of the menu. */
@@ -65,6 +65,7 @@ static const wlmtk_menu_item_style_t _wlmtk_menu_item_test_style = {
     .enabled_text_color = 0xfff0f060,
     .highlighted_text_color = 0xff204080,
     .disabled_text_color = 0xff807060,
+    .width = 80,
 };
 
 /* == Exported methods ===================================================== */
@@ -77,6 +78,7 @@ bool wlmtk_menu_item_init(
 {
     memset(menu_item_ptr, 0, sizeof(wlmtk_menu_item_t));
     menu_item_ptr->style = *style_ptr;
+    menu_item_ptr->width = style_ptr->width;
 
     if (!wlmtk_buffer_init(&menu_item_ptr->super_buffer, env_ptr)) {
         wlmtk_menu_item_fini(menu_item_ptr);
@@ -454,6 +456,7 @@ void test_init_fini(bs_test_t *test_ptr)
     BS_TEST_VERIFY_TRUE_OR_RETURN(
         test_ptr,
         wlmtk_menu_item_init(&item, &_wlmtk_menu_item_test_style, NULL));
+    BS_TEST_VERIFY_EQ(test_ptr, 80, item.width);
 
     bs_dllist_node_t *dlnode_ptr = wlmtk_dlnode_from_menu_item(&item);
     BS_TEST_VERIFY_EQ(test_ptr, dlnode_ptr, &item.dlnode);
@@ -481,7 +484,6 @@ void test_buffers(bs_test_t *test_ptr)
         test_ptr,
         wlmtk_menu_item_init(&item, &_wlmtk_menu_item_test_style, NULL));
 
-    item.width = 80;
     wlmtk_menu_item_set_text(&item, "Menu item");
 
     bs_gfxbuf_t *g;
@@ -514,7 +516,6 @@ void test_pointer(bs_test_t *test_ptr)
         .button = BTN_LEFT, .type = WLMTK_BUTTON_CLICK };
 
     item.style = _wlmtk_menu_item_test_style;
-    item.width = 80;
     wlmtk_menu_item_set_text(&item, "Menu item");
 
     // Initial state: enabled.
@@ -571,7 +572,6 @@ void test_clicked(bs_test_t *test_ptr)
     wlmtk_fake_menu_item_t *fi_ptr = wlmtk_fake_menu_item_create();
     BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, fi_ptr);
     fi_ptr->menu_item.style = _wlmtk_menu_item_test_style;
-    fi_ptr->menu_item.width = 80;
     wlmtk_menu_item_set_text(&fi_ptr->menu_item, "Menu item");
     wlmtk_element_t *e = wlmtk_menu_item_element(&fi_ptr->menu_item);
     wlmtk_button_event_t b = { .button = BTN_LEFT, .type = WLMTK_BUTTON_CLICK };
@@ -626,7 +626,6 @@ void test_right_click(bs_test_t *test_ptr)
     wlmtk_fake_menu_item_t *fi_ptr = wlmtk_fake_menu_item_create();
     BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, fi_ptr);
     fi_ptr->menu_item.style = _wlmtk_menu_item_test_style;
-    fi_ptr->menu_item.width = 80;
     wlmtk_menu_item_set_text(&fi_ptr->menu_item, "Menu item");
     wlmtk_element_t *e = wlmtk_menu_item_element(&fi_ptr->menu_item);
     wlmtk_button_event_t b = { .button = BTN_LEFT, .type = WLMTK_BUTTON_CLICK };
@@ -38,6 +38,7 @@ struct _wlmtk_popup_menu_t {
     wlmtk_element_vmt_t       orig_element_vmt;
 };
 
+static void _wlmtk_popup_menu_element_destroy(wlmtk_element_t *element_ptr);
 static bool _wlmtk_popup_menu_element_pointer_button(
     wlmtk_element_t *element_ptr,
     const wlmtk_button_event_t *button_event_ptr);
@@ -46,6 +47,7 @@ static bool _wlmtk_popup_menu_element_pointer_button(
 
 /** The superclass' element virtual method table. */
 static const wlmtk_element_vmt_t _wlmtk_popup_menu_element_vmt = {
+    .destroy = _wlmtk_popup_menu_element_destroy,
     .pointer_button = _wlmtk_popup_menu_element_pointer_button
 };
 
@@ -110,6 +112,22 @@ wlmtk_menu_t *wlmtk_popup_menu_menu(wlmtk_popup_menu_t *popup_menu_ptr)
 
 /* == Local (static) methods =============================================== */
 
+/* ------------------------------------------------------------------------- */
+/**
+ * Implements @ref wlmtk_element_vmt_t::destroy. Routes to the popup menu's
+ * dtor. Permits popup menus to be owned by the container they're added to.
+ *
+ * @param element_ptr
+ */
+void _wlmtk_popup_menu_element_destroy(wlmtk_element_t *element_ptr)
+{
+    wlmtk_popup_menu_t *popup_menu_ptr = BS_CONTAINER_OF(
+        element_ptr,
+        wlmtk_popup_menu_t,
+        super_popup.super_container.super_element);
+    wlmtk_popup_menu_destroy(popup_menu_ptr);
+}
+
 /* ------------------------------------------------------------------------- */
 /**
  * If the menu is in right-click mode, acts on right-button events and signals
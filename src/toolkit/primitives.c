@@ -21,6 +21,169 @@
 #include "primitives.h"
 
 #include <libbase/libbase.h>
+#include <float.h>
+#include <math.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+/** Whether to build the SSE2 and AVX2 kernels. */
+#define WLMAKER_PRIMITIVES_X86
+#include <immintrin.h>
+#endif  // defined(__x86_64__) || defined(__i386__)
+
+#if defined(__aarch64__)
+/** Whether to build the NEON kernel. */
+#define WLMAKER_PRIMITIVES_NEON
+#include <arm_neon.h>
+#include <sys/auxv.h>
+#endif  // defined(__aarch64__)
+
+#include "text_cache.h"
+
+/* == Declarations ========================================================= */
+
+/**
+ * Interpolation parameters for one segment of a gradient, between two
+ * stops. Channels are in order alpha, red, green, blue.
+ */
+typedef struct {
+    /** Slope of each channel, per unit of the gradient parameter. */
+    float                     slope[4];
+    /** Base of each channel, at gradient parameter 0. */
+    float                     base[4];
+} wlmaker_primitives_gradient_segment_t;
+
+/**
+ * A linear gradient from the origin to (dx, dy), with two color stops and
+ * padded beyond. Evaluated the same way as pixman does for cairo.
+ */
+typedef struct {
+    /** Segments: Before the first stop, between the stops, and after. */
+    wlmaker_primitives_gradient_segment_t segments[3];
+    /** Horizontal extent of the gradient, in 16.16 fixed point. */
+    int64_t                   dx;
+    /** Vertical extent of the gradient, in 16.16 fixed point. */
+    int64_t                   dy;
+    /** Scale from the dot product to the 16.16 gradient parameter. */
+    double                    invden;
+    /** Increment of the gradient parameter per pixel, horizontally. */
+    double                    inc;
+} wlmaker_primitives_gradient_t;
+
+/** Computes `width` pixels of a row, from gradient parameter `t` onwards. */
+typedef void (*wlmaker_primitives_gradient_row_t)(
+    const wlmaker_primitives_gradient_t *gradient_ptr,
+    int64_t t,
+    int64_t width,
+    uint32_t *row_ptr);
+
+/** A gradient row kernel, for a set of CPU features. */
+typedef struct {
+    /** Name of the kernel, for logs. */
+    const char                *name_ptr;
+    /** Returns whether the CPU supports the kernel. */
+    bool                      (*supported)(void);
+    /** Computes a row. Results are identical across all kernels. */
+    wlmaker_primitives_gradient_row_t row;
+} wlmaker_primitives_kernel_t;
+
+static void _wlmaker_primitives_cairo_fill_pattern(
+    cairo_t *cairo_ptr,
+    int x,
+    int y,
+    unsigned width,
+    unsigned height,
+    const wlmtk_style_fill_t *fill_ptr);
+static bool _wlmaker_primitives_fill_pixels(
+    uint32_t *data_ptr,
+    unsigned pixels_per_line,
+    unsigned buffer_width,
+    unsigned buffer_height,
+    int x,
+    int y,
+    unsigned width,
+    unsigned height,
+    const wlmtk_style_fill_t *fill_ptr);
+static void _wlmaker_primitives_gradient_init(
+    wlmaker_primitives_gradient_t *gradient_ptr,
+    double x,
+    double y,
+    uint32_t from,
+    uint32_t to);
+static void _wlmaker_primitives_gradient_segment_init(
+    wlmaker_primitives_gradient_segment_t *segment_ptr,
+    int64_t left_x,
+    int64_t right_x,
+    uint32_t left_color,
+    uint32_t right_color);
+static uint32_t _wlmaker_primitives_gradient_pixel(
+    const wlmaker_primitives_gradient_t *gradient_ptr,
+    int64_t t);
+static const wlmaker_primitives_kernel_t *_wlmaker_primitives_kernel(void);
+static bool _wlmaker_primitives_gradient_row_fits(
+    const wlmaker_primitives_gradient_t *gradient_ptr,
+    int64_t t,
+    int64_t width);
+static bool _wlmaker_primitives_scalar_supported(void);
+static void _wlmaker_primitives_gradient_row_scalar(
+    const wlmaker_primitives_gradient_t *gradient_ptr,
+    int64_t t,
+    int64_t width,
+    uint32_t *row_ptr);
+#if defined(WLMAKER_PRIMITIVES_X86)
+static bool _wlmaker_primitives_sse2_supported(void);
+static void _wlmaker_primitives_gradient_row_sse2(
+    const wlmaker_primitives_gradient_t *gradient_ptr,
+    int64_t t,
+    int64_t width,
+    uint32_t *row_ptr);
+static bool _wlmaker_primitives_avx2_supported(void);
+static void _wlmaker_primitives_gradient_row_avx2(
+    const wlmaker_primitives_gradient_t *gradient_ptr,
+    int64_t t,
+    int64_t width,
+    uint32_t *row_ptr);
+#endif  // defined(WLMAKER_PRIMITIVES_X86)
+#if defined(WLMAKER_PRIMITIVES_NEON)
+static bool _wlmaker_primitives_neon_supported(void);
+static void _wlmaker_primitives_gradient_row_neon(
+    const wlmaker_primitives_gradient_t *gradient_ptr,
+    int64_t t,
+    int64_t width,
+    uint32_t *row_ptr);
+#endif  // defined(WLMAKER_PRIMITIVES_NEON)
+static void _wlmaker_primitives_adgradient_end(
+    unsigned width,
+    unsigned height,
+    double *x_ptr,
+    double *y_ptr);
+static bool _wlmaker_primitives_device_offset(
+    cairo_t *cairo_ptr,
+    int *x_ptr,
+    int *y_ptr);
+static bool _wlmaker_primitives_unclipped(cairo_t *cairo_ptr);
+
+/* == Data ================================================================= */
+
+/** Gradient row kernels, in order of preference. The last one always works. */
+static const wlmaker_primitives_kernel_t _wlmaker_primitives_kernels[] = {
+#if defined(WLMAKER_PRIMITIVES_X86)
+    { "avx2", _wlmaker_primitives_avx2_supported,
+      _wlmaker_primitives_gradient_row_avx2 },
+    { "sse2", _wlmaker_primitives_sse2_supported,
+      _wlmaker_primitives_gradient_row_sse2 },
+#endif  // defined(WLMAKER_PRIMITIVES_X86)
+#if defined(WLMAKER_PRIMITIVES_NEON)
+    { "neon", _wlmaker_primitives_neon_supported,
+      _wlmaker_primitives_gradient_row_neon },
+#endif  // defined(WLMAKER_PRIMITIVES_NEON)
+    { "scalar", _wlmaker_primitives_scalar_supported,
+      _wlmaker_primitives_gradient_row_scalar },
+};
+
+/** The kernel in use. Selected by @ref _wlmaker_primitives_kernel. */
+static const wlmaker_primitives_kernel_t *_wlmaker_primitives_kernel_ptr = NULL;
 
 /* == Exported methods ===================================================== */
 
@@ -44,84 +207,86 @@ void wlmaker_primitives_cairo_fill_at(
     unsigned height,
     const wlmtk_style_fill_t *fill_ptr)
 {
-    cairo_pattern_t *cairo_pattern_ptr;
-    float r, g, b, alpha;
-    switch (fill_ptr->type) {
-    case WLMTK_STYLE_COLOR_SOLID:
-        bs_gfxbuf_argb8888_to_floats(
-            fill_ptr->param.solid.color, &r, &g, &b, &alpha);
-        cairo_pattern_ptr = cairo_pattern_create_rgba(r, g, b, alpha);
-        break;
-
-    case WLMTK_STYLE_COLOR_HGRADIENT:
-        cairo_pattern_ptr = cairo_pattern_create_linear(0, 0, width, 0);
-        bs_gfxbuf_argb8888_to_floats(
-            fill_ptr->param.hgradient.from, &r, &g, &b, &alpha);
-        cairo_pattern_add_color_stop_rgba(
-            cairo_pattern_ptr, 0, r, g, b, alpha);
-        bs_gfxbuf_argb8888_to_floats(
-            fill_ptr->param.hgradient.to, &r, &g, &b, &alpha);
-        cairo_pattern_add_color_stop_rgba(
-            cairo_pattern_ptr, 1, r, g, b, alpha);
-        break;
+    // Writes the pixels directly, if cairo would not transform, clip or
+    // blend them.
+    cairo_surface_t *surface_ptr = cairo_get_target(cairo_ptr);
+    int offset_x, offset_y;
+    cairo_operator_t op = cairo_get_operator(cairo_ptr);
+    if (CAIRO_SURFACE_TYPE_IMAGE == cairo_surface_get_type(surface_ptr) &&
+        CAIRO_FORMAT_ARGB32 == cairo_image_surface_get_format(surface_ptr) &&
+        _wlmaker_primitives_device_offset(cairo_ptr, &offset_x, &offset_y) &&
+        0 == offset_x && 0 == offset_y &&
+        (CAIRO_OPERATOR_OVER == op || CAIRO_OPERATOR_SOURCE == op) &&
+        _wlmaker_primitives_unclipped(cairo_ptr)) {
+        cairo_surface_flush(surface_ptr);
+        if (_wlmaker_primitives_fill_pixels(
+                (uint32_t*)cairo_image_surface_get_data(surface_ptr),
+                cairo_image_surface_get_stride(surface_ptr) / sizeof(uint32_t),
+                cairo_image_surface_get_width(surface_ptr),
+                cairo_image_surface_get_height(surface_ptr),
+                x, y, width, height, fill_ptr)) {
+            cairo_surface_mark_dirty_rectangle(
+                surface_ptr, x, y, width, height);
+            return;
+        }
+    }
 
-    case WLMTK_STYLE_COLOR_VGRADIENT:
-        cairo_pattern_ptr = cairo_pattern_create_linear(0, 0, 0, height);
-        bs_gfxbuf_argb8888_to_floats(
-            fill_ptr->param.vgradient.from, &r, &g, &b, &alpha);
-        cairo_pattern_add_color_stop_rgba(
-            cairo_pattern_ptr, 0, r, g, b, alpha);
-        bs_gfxbuf_argb8888_to_floats(
-            fill_ptr->param.vgradient.to, &r, &g, &b, &alpha);
-        cairo_pattern_add_color_stop_rgba(
-            cairo_pattern_ptr, 1, r, g, b, alpha);
-        break;
+    _wlmaker_primitives_cairo_fill_pattern(
+        cairo_ptr, x, y, width, height, fill_ptr);
+}
 
-    case WLMTK_STYLE_COLOR_DGRADIENT:
-        cairo_pattern_ptr = cairo_pattern_create_linear(0, 0, width, height);
-        bs_gfxbuf_argb8888_to_floats(
-            fill_ptr->param.dgradient.from, &r, &g, &b, &alpha);
-        cairo_pattern_add_color_stop_rgba(
-            cairo_pattern_ptr, 0, r, g, b, alpha);
-        bs_gfxbuf_argb8888_to_floats(
-            fill_ptr->param.dgradient.to, &r, &g, &b, &alpha);
-        cairo_pattern_add_color_stop_rgba(
-            cairo_pattern_ptr, 1, r, g, b, alpha);
-        break;
+/* ------------------------------------------------------------------------- */
+bool wlmaker_primitives_gfxbuf_fill_at(
+    bs_gfxbuf_t *gfxbuf_ptr,
+    int x,
+    int y,
+    unsigned width,
+    unsigned height,
+    const wlmtk_style_fill_t *fill_ptr)
+{
+    return _wlmaker_primitives_fill_pixels(
+        gfxbuf_ptr->data_ptr,
+        gfxbuf_ptr->pixels_per_line,
+        gfxbuf_ptr->width,
+        gfxbuf_ptr->height,
+        x, y, width, height, fill_ptr);
+}
 
-    case WLMTK_STYLE_COLOR_ADGRADIENT: {
-        // Some geometry needed to compute the destination point for cairo's
-        // interpolation. It is on the line that crosses the bottom-right
-        // corner and lies parallel to the top-right -> bottom-left diaginal;
-        // and on a perpendicular intersection from the top-left corner.
-        double x = 2 * height * height * width /
-            BS_MAX(1.0, width * width + height * height);
-        double y = 2 * height * width * width /
-            BS_MAX(1.0, width * width + height * height);
-        cairo_pattern_ptr = cairo_pattern_create_linear(0, 0, x, y);
-        bs_gfxbuf_argb8888_to_floats(
-            fill_ptr->param.dgradient.from, &r, &g, &b, &alpha);
-        cairo_pattern_add_color_stop_rgba(
-            cairo_pattern_ptr, 0, r, g, b, alpha);
-        bs_gfxbuf_argb8888_to_floats(
-            fill_ptr->param.dgradient.to, &r, &g, &b, &alpha);
-        cairo_pattern_add_color_stop_rgba(
-            cairo_pattern_ptr, 1, r, g, b, alpha);
-    }
-        break;
+/* ------------------------------------------------------------------------- */
+bool wlmaker_primitives_fill_is_columnar(const wlmtk_style_fill_t *fill_ptr)
+{
+    return (WLMTK_STYLE_COLOR_SOLID == fill_ptr->type ||
+            WLMTK_STYLE_COLOR_VGRADIENT == fill_ptr->type);
+}
 
-    default:
-        bs_log(BS_FATAL, "Unsupported fill_type %d", fill_ptr->type);
-        BS_ABORT();
+/* ------------------------------------------------------------------------- */
+void wlmaker_primitives_copy_area(
+    bs_gfxbuf_t *dest_gfxbuf_ptr,
+    unsigned dest_x,
+    unsigned dest_y,
+    const bs_gfxbuf_t *src_gfxbuf_ptr,
+    unsigned src_x,
+    unsigned src_y,
+    unsigned width,
+    unsigned height)
+{
+    if (1 != src_gfxbuf_ptr->width) {
+        bs_gfxbuf_copy_area(
+            dest_gfxbuf_ptr, dest_x, dest_y,
+            src_gfxbuf_ptr, src_x, src_y, width, height);
         return;
     }
 
-    cairo_save(cairo_ptr);
-    cairo_set_source(cairo_ptr, cairo_pattern_ptr);
-    cairo_pattern_destroy(cairo_pattern_ptr);
-    cairo_rectangle(cairo_ptr, x, y, width, height);
-    cairo_fill(cairo_ptr);
-    cairo_restore(cairo_ptr);
+    BS_ASSERT(dest_x + width <= dest_gfxbuf_ptr->width);
+    BS_ASSERT(dest_y + height <= dest_gfxbuf_ptr->height);
+    BS_ASSERT(src_y + height <= src_gfxbuf_ptr->height);
+    for (unsigned y = 0; y < height; ++y) {
+        uint32_t pixel = src_gfxbuf_ptr->data_ptr[
+            (src_y + y) * src_gfxbuf_ptr->pixels_per_line];
+        uint32_t *dest_ptr = dest_gfxbuf_ptr->data_ptr +
+            (dest_y + y) * dest_gfxbuf_ptr->pixels_per_line + dest_x;
+        for (unsigned x = 0; x < width; ++x) dest_ptr[x] = pixel;
+    }
 }
 
 /* ------------------------------------------------------------------------- */
@@ -255,6 +420,23 @@ void wlmaker_primitives_draw_text(
     uint32_t color,
     const char *text_ptr)
 {
+    // Composites the cached mask, if that is pixel-exact: No scaling, and
+    // the text's origin on a pixel boundary.
+    int offset_x, offset_y;
+    if (_wlmaker_primitives_device_offset(cairo_ptr, &offset_x, &offset_y)) {
+        int mask_x, mask_y;
+        cairo_surface_t *mask_ptr = wlmtk_text_cache_get(
+            font_style_ptr, text_ptr, &mask_x, &mask_y);
+        if (NULL != mask_ptr) {
+            cairo_save(cairo_ptr);
+            cairo_set_source_argb8888(cairo_ptr, color);
+            cairo_mask_surface(cairo_ptr, mask_ptr, x + mask_x, y + mask_y);
+            cairo_restore(cairo_ptr);
+            cairo_surface_destroy(mask_ptr);
+            return;
+        }
+    }
+
     cairo_save(cairo_ptr);
     cairo_select_font_face(
         cairo_ptr,
@@ -272,7 +454,773 @@ void wlmaker_primitives_draw_text(
 
 /* == Local (static) methods =============================================== */
 
+/* ------------------------------------------------------------------------- */
+/**
+ * Fills the rectangle through a cairo pattern. Handles all cases, including
+ * translucent colors and transformed or clipped cairos.
+ *
+ * @param cairo_ptr
+ * @param x
+ * @param y
+ * @param width
+ * @param height
+ * @param fill_ptr
+ */
+void _wlmaker_primitives_cairo_fill_pattern(
+    cairo_t *cairo_ptr,
+    int x,
+    int y,
+    unsigned width,
+    unsigned height,
+    const wlmtk_style_fill_t *fill_ptr)
+{
+    cairo_pattern_t *cairo_pattern_ptr;
+    float r, g, b, alpha;
+    switch (fill_ptr->type) {
+    case WLMTK_STYLE_COLOR_SOLID:
+        bs_gfxbuf_argb8888_to_floats(
+            fill_ptr->param.solid.color, &r, &g, &b, &alpha);
+        cairo_pattern_ptr = cairo_pattern_create_rgba(r, g, b, alpha);
+        break;
+
+    case WLMTK_STYLE_COLOR_HGRADIENT:
+        cairo_pattern_ptr = cairo_pattern_create_linear(0, 0, width, 0);
+        bs_gfxbuf_argb8888_to_floats(
+            fill_ptr->param.hgradient.from, &r, &g, &b, &alpha);
+        cairo_pattern_add_color_stop_rgba(
+            cairo_pattern_ptr, 0, r, g, b, alpha);
+        bs_gfxbuf_argb8888_to_floats(
+            fill_ptr->param.hgradient.to, &r, &g, &b, &alpha);
+        cairo_pattern_add_color_stop_rgba(
+            cairo_pattern_ptr, 1, r, g, b, alpha);
+        break;
+
+    case WLMTK_STYLE_COLOR_VGRADIENT:
+        cairo_pattern_ptr = cairo_pattern_create_linear(0, 0, 0, height);
+        bs_gfxbuf_argb8888_to_floats(
+            fill_ptr->param.vgradient.from, &r, &g, &b, &alpha);
+        cairo_pattern_add_color_stop_rgba(
+            cairo_pattern_ptr, 0, r, g, b, alpha);
+        bs_gfxbuf_argb8888_to_floats(
+            fill_ptr->param.vgradient.to, &r, &g, &b, &alpha);
+        cairo_pattern_add_color_stop_rgba(
+            cairo_pattern_ptr, 1, r, g, b, alpha);
+        break;
+
+    case WLMTK_STYLE_COLOR_DGRADIENT:
+        cairo_pattern_ptr = cairo_pattern_create_linear(0, 0, width, height);
+        bs_gfxbuf_argb8888_to_floats(
+            fill_ptr->param.dgradient.from, &r, &g, &b, &alpha);
+        cairo_pattern_add_color_stop_rgba(
+            cairo_pattern_ptr, 0, r, g, b, alpha);
+        bs_gfxbuf_argb8888_to_floats(
+            fill_ptr->param.dgradient.to, &r, &g, &b, &alpha);
+        cairo_pattern_add_color_stop_rgba(
+            cairo_pattern_ptr, 1, r, g, b, alpha);
+        break;
+
+    case WLMTK_STYLE_COLOR_ADGRADIENT: {
+        double end_x, end_y;
+        _wlmaker_primitives_adgradient_end(width, height, &end_x, &end_y);
+        cairo_pattern_ptr = cairo_pattern_create_linear(0, 0, end_x, end_y);
+        bs_gfxbuf_argb8888_to_floats(
+            fill_ptr->param.dgradient.from, &r, &g, &b, &alpha);
+        cairo_pattern_add_color_stop_rgba(
+            cairo_pattern_ptr, 0, r, g, b, alpha);
+        bs_gfxbuf_argb8888_to_floats(
+            fill_ptr->param.dgradient.to, &r, &g, &b, &alpha);
+        cairo_pattern_add_color_stop_rgba(
+            cairo_pattern_ptr, 1, r, g, b, alpha);
+    }
+        break;
+
+    default:
+        bs_log(BS_FATAL, "Unsupported fill_type %d", fill_ptr->type);
+        BS_ABORT();
+        return;
+    }
+
+    cairo_save(cairo_ptr);
+    cairo_set_source(cairo_ptr, cairo_pattern_ptr);
+    cairo_pattern_destroy(cairo_pattern_ptr);
+    cairo_rectangle(cairo_ptr, x, y, width, height);
+    cairo_fill(cairo_ptr);
+    cairo_restore(cairo_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Fills the rectangle by writing the pixels directly, without cairo.
+ *
+ * The result is identical to what @ref _wlmaker_primitives_cairo_fill_pattern
+ * renders into an untransformed and unclipped image surface: Gradients are
+ * evaluated with the same arithmetic as pixman, including the fixed-point
+ * rounding, and relative to the buffer's origin. Horizontal gradients are
+ * computed once and copied to all rows, vertical gradients are one color per
+ * row.
+ *
+ * @param data_ptr
+ * @param pixels_per_line
+ * @param buffer_width
+ * @param buffer_height
+ * @param x
+ * @param y
+ * @param width
+ * @param height
+ * @param fill_ptr
+ *
+ * @return false if the fill has translucent colors, or is too large for
+ *     pixman's fixed-point format. Then, nothing was written.
+ */
+bool _wlmaker_primitives_fill_pixels(
+    uint32_t *data_ptr,
+    unsigned pixels_per_line,
+    unsigned buffer_width,
+    unsigned buffer_height,
+    int x,
+    int y,
+    unsigned width,
+    unsigned height,
+    const wlmtk_style_fill_t *fill_ptr)
+{
+    if (INT16_MAX < width || INT16_MAX < height ||
+        INT16_MAX < buffer_width || INT16_MAX < buffer_height) return false;
+
+    uint32_t from, to;
+    double end_x = 0, end_y = 0;
+    switch (fill_ptr->type) {
+    case WLMTK_STYLE_COLOR_SOLID:
+        from = to = fill_ptr->param.solid.color;
+        break;
+    case WLMTK_STYLE_COLOR_HGRADIENT:
+        from = fill_ptr->param.hgradient.from;
+        to = fill_ptr->param.hgradient.to;
+        end_x = width;
+        break;
+    case WLMTK_STYLE_COLOR_VGRADIENT:
+        from = fill_ptr->param.vgradient.from;
+        to = fill_ptr->param.vgradient.to;
+        end_y = height;
+        break;
+    case WLMTK_STYLE_COLOR_DGRADIENT:
+        from = fill_ptr->param.dgradient.from;
+        to = fill_ptr->param.dgradient.to;
+        end_x = width;
+        end_y = height;
+        break;
+    case WLMTK_STYLE_COLOR_ADGRADIENT:
+        from = fill_ptr->param.dgradient.from;
+        to = fill_ptr->param.dgradient.to;
+        _wlmaker_primitives_adgradient_end(width, height, &end_x, &end_y);
+        break;
+    default:
+        return false;
+    }
+    // Blending of translucent colors is left to cairo.
+    if (0xff000000 != (from & to & 0xff000000)) return false;
+
+    int64_t x0 = BS_MAX(x, 0);
+    int64_t y0 = BS_MAX(y, 0);
+    int64_t x1 = BS_MIN((int64_t)x + width, (int64_t)buffer_width);
+    int64_t y1 = BS_MIN((int64_t)y + height, (int64_t)buffer_height);
+    if (x0 >= x1 || y0 >= y1) return true;
+    int64_t w = x1 - x0;
+
+    if (WLMTK_STYLE_COLOR_SOLID == fill_ptr->type) {
+        for (int64_t py = y0; py < y1; ++py) {
+            uint32_t *row_ptr = data_ptr + py * pixels_per_line + x0;
+            for (int64_t i = 0; i < w; ++i) row_ptr[i] = from;
+        }
+        return true;
+    }
+
+    wlmaker_primitives_gradient_t gradient;
+    _wlmaker_primitives_gradient_init(&gradient, end_x, end_y, from, to);
+    wlmaker_primitives_gradient_row_t row = _wlmaker_primitives_kernel()->row;
+    for (int64_t py = y0; py < y1; ++py) {
+        uint32_t *row_ptr = data_ptr + py * pixels_per_line + x0;
+        if (py > y0 && 0 == gradient.dy) {
+            memcpy(row_ptr, data_ptr + y0 * pixels_per_line + x0,
+                   w * sizeof(uint32_t));
+            continue;
+        }
+
+        // Parameter at the center of the row's first pixel, then stepping
+        // by a truncated multiple of the increment. As pixman does.
+        int32_t vx = x0 * 65536 + 32768;
+        int32_t vy = py * 65536 + 32768;
+        int64_t t = (gradient.dx * vx + gradient.dy * vy) * gradient.invden;
+        if (0 == (int64_t)(gradient.inc * w)) {
+            uint32_t pixel = _wlmaker_primitives_gradient_pixel(&gradient, t);
+            for (int64_t i = 0; i < w; ++i) row_ptr[i] = pixel;
+            continue;
+        }
+        row(&gradient, t, w, row_ptr);
+    }
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Initializes a linear gradient from the origin to (x, y), with opaque
+ * colors `from` and `to` at either end.
+ *
+ * @param gradient_ptr
+ * @param x
+ * @param y
+ * @param from
+ * @param to
+ */
+void _wlmaker_primitives_gradient_init(
+    wlmaker_primitives_gradient_t *gradient_ptr,
+    double x,
+    double y,
+    uint32_t from,
+    uint32_t to)
+{
+    // Rounds to 16.16 fixed point, as cairo does when handing to pixman.
+    gradient_ptr->dx = lrint(x * 65536.0);
+    gradient_ptr->dy = lrint(y * 65536.0);
+    int64_t l = gradient_ptr->dx * gradient_ptr->dx +
+        gradient_ptr->dy * gradient_ptr->dy;
+    if (0 == l) {
+        gradient_ptr->invden = 0;
+        gradient_ptr->inc = 0;
+    } else {
+        gradient_ptr->invden = 65536 * (double)65536 / (l * (double)65536);
+        gradient_ptr->inc = (gradient_ptr->dx * 65536) * gradient_ptr->invden;
+    }
+
+    _wlmaker_primitives_gradient_segment_init(
+        &gradient_ptr->segments[0], INT32_MIN, 0, from, from);
+    _wlmaker_primitives_gradient_segment_init(
+        &gradient_ptr->segments[1], 0, 65536, from, to);
+    _wlmaker_primitives_gradient_segment_init(
+        &gradient_ptr->segments[2], 65536, INT32_MAX, to, to);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Initializes the interpolation between two stops, at 16.16 fixed-point
+ * positions `left_x` and `right_x`. Padding segments extend to INT32_MIN or
+ * INT32_MAX, and are constant.
+ *
+ * @param segment_ptr
+ * @param left_x
+ * @param right_x
+ * @param left_color
+ * @param right_color
+ */
+void _wlmaker_primitives_gradient_segment_init(
+    wlmaker_primitives_gradient_segment_t *segment_ptr,
+    int64_t left_x,
+    int64_t right_x,
+    uint32_t left_color,
+    uint32_t right_color)
+{
+    // Channels in 16 bit, as cairo hands them to pixman. Then scaled back.
+    float l[4], r[4];
+    for (int i = 0; i < 4; ++i) {
+        int shift = 24 - 8 * i;
+        l[i] = (((left_color >> shift) & 0xff) * 257) * (1.0f / 257.0f);
+        r[i] = (((right_color >> shift) & 0xff) * 257) * (1.0f / 257.0f);
+    }
+
+    float lx = left_x * (1.0f / 65536.0f);
+    float rx = right_x * (1.0f / 65536.0f);
+    if ((-FLT_MIN < rx - lx && rx - lx < FLT_MIN) ||
+        INT32_MIN == left_x || INT32_MAX == right_x) {
+        for (int i = 0; i < 4; ++i) {
+            segment_ptr->slope[i] = 0.0f;
+            segment_ptr->base[i] = (l[i] + r[i]) / 510.0f;
+        }
+        return;
+    }
+
+    float w_rec = 1.0f / (rx - lx);
+    for (int i = 0; i < 4; ++i) {
+        segment_ptr->base[i] =
+            (l[i] * rx - r[i] * lx) * w_rec * (1.0f / 255.0f);
+        segment_ptr->slope[i] = (r[i] - l[i]) * w_rec * (1.0f / 255.0f);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Computes the premultiplied ARGB32 pixel at gradient parameter `t`.
+ *
+ * @param gradient_ptr
+ * @param t                   Gradient parameter, in 16.16 fixed point.
+ *
+ * @return The pixel value.
+ */
+uint32_t _wlmaker_primitives_gradient_pixel(
+    const wlmaker_primitives_gradient_t *gradient_ptr,
+    int64_t t)
+{
+    const wlmaker_primitives_gradient_segment_t *s_ptr =
+        &gradient_ptr->segments[(0 <= t) + (65536 <= t)];
+    float y = t * (1.0f / 65536.0f);
+
+    float a = 255.0f * (s_ptr->slope[0] * y + s_ptr->base[0]);
+    float r = a * (s_ptr->slope[1] * y + s_ptr->base[1]);
+    float g = a * (s_ptr->slope[2] * y + s_ptr->base[2]);
+    float b = a * (s_ptr->slope[3] * y + s_ptr->base[3]);
+    return ((((uint32_t)(a + 0.5f)) << 24) & 0xff000000) |
+        ((((uint32_t)(r + 0.5f)) << 16) & 0x00ff0000) |
+        ((((uint32_t)(g + 0.5f)) << 8) & 0x0000ff00) |
+        (((uint32_t)(b + 0.5f)) & 0x000000ff);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Returns the gradient row kernel to use: The first one of
+ * @ref _wlmaker_primitives_kernels that the CPU supports.
+ *
+ * @return Pointer to the kernel.
+ */
+const wlmaker_primitives_kernel_t *_wlmaker_primitives_kernel(void)
+{
+    if (NULL != _wlmaker_primitives_kernel_ptr) {
+        return _wlmaker_primitives_kernel_ptr;
+    }
+
+    const wlmaker_primitives_kernel_t *kernel_ptr = _wlmaker_primitives_kernels;
+    while (!kernel_ptr->supported()) ++kernel_ptr;
+    bs_log(BS_DEBUG, "Gradient fill: Using %s kernel.", kernel_ptr->name_ptr);
+    _wlmaker_primitives_kernel_ptr = kernel_ptr;
+    return kernel_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Returns whether the row's gradient parameters all fit in 32 bit, as the
+ * vector kernels compute them.
+ *
+ * @param gradient_ptr
+ * @param t                   Gradient parameter of the row's first pixel.
+ * @param width
+ *
+ * @return true if the vector kernels can compute the row.
+ */
+bool _wlmaker_primitives_gradient_row_fits(
+    const wlmaker_primitives_gradient_t *gradient_ptr,
+    int64_t t,
+    int64_t width)
+{
+    // The parameter steps linearly, so checking both ends suffices.
+    int64_t end_t = t + (int64_t)(gradient_ptr->inc * width);
+    return (-(INT64_C(1) << 30) <= BS_MIN(t, end_t) &&
+            BS_MAX(t, end_t) <= (INT64_C(1) << 30));
+}
+
+/* ------------------------------------------------------------------------- */
+/** @return true: The scalar kernel works everywhere. */
+bool _wlmaker_primitives_scalar_supported(void)
+{
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Computes a row of gradient pixels, one at a time. Implements
+ * @ref wlmaker_primitives_gradient_row_t.
+ *
+ * @param gradient_ptr
+ * @param t
+ * @param width
+ * @param row_ptr
+ */
+void _wlmaker_primitives_gradient_row_scalar(
+    const wlmaker_primitives_gradient_t *gradient_ptr,
+    int64_t t,
+    int64_t width,
+    uint32_t *row_ptr)
+{
+    for (int64_t i = 0; i < width; ++i) {
+        row_ptr[i] = _wlmaker_primitives_gradient_pixel(
+            gradient_ptr, t + (int64_t)(gradient_ptr->inc * i));
+    }
+}
+
+#if defined(WLMAKER_PRIMITIVES_X86)
+/* ------------------------------------------------------------------------- */
+/** @return Whether the CPU supports SSE2. */
+bool _wlmaker_primitives_sse2_supported(void)
+{
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse2");
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Computes a row of gradient pixels, four at a time, with SSE2. Implements
+ * @ref wlmaker_primitives_gradient_row_t.
+ *
+ * Follows @ref _wlmaker_primitives_gradient_pixel operation by operation, so
+ * that the result is identical. The segment is picked per pixel by masks.
+ *
+ * @param gradient_ptr
+ * @param t
+ * @param width
+ * @param row_ptr
+ */
+__attribute__((target("sse2")))
+void _wlmaker_primitives_gradient_row_sse2(
+    const wlmaker_primitives_gradient_t *gradient_ptr,
+    int64_t t,
+    int64_t width,
+    uint32_t *row_ptr)
+{
+    if (!_wlmaker_primitives_gradient_row_fits(gradient_ptr, t, width)) {
+        _wlmaker_primitives_gradient_row_scalar(
+            gradient_ptr, t, width, row_ptr);
+        return;
+    }
+
+    const wlmaker_primitives_gradient_segment_t *s_ptr =
+        gradient_ptr->segments;
+    const __m128d inc = _mm_set1_pd(gradient_ptr->inc);
+    const __m128i t0 = _mm_set1_epi32(t);
+    int64_t i = 0;
+    __m128d idx_lo = _mm_set_pd(1, 0);
+    __m128d idx_hi = _mm_set_pd(3, 2);
+    for (; i + 4 <= width; i += 4) {
+        __m128i tt = _mm_add_epi32(
+            t0,
+            _mm_unpacklo_epi64(
+                _mm_cvttpd_epi32(_mm_mul_pd(inc, idx_lo)),
+                _mm_cvttpd_epi32(_mm_mul_pd(inc, idx_hi))));
+        idx_lo = _mm_add_pd(idx_lo, _mm_set1_pd(4));
+        idx_hi = _mm_add_pd(idx_hi, _mm_set1_pd(4));
+
+        // Masks for the segment: 0 <= t, and 65536 <= t.
+        __m128 m1 = _mm_castsi128_ps(_mm_cmpgt_epi32(tt, _mm_set1_epi32(-1)));
+        __m128 m2 = _mm_castsi128_ps(
+            _mm_cmpgt_epi32(tt, _mm_set1_epi32(65535)));
+        __m128 y = _mm_mul_ps(_mm_cvtepi32_ps(tt),
+                              _mm_set1_ps(1.0f / 65536.0f));
+
+        __m128 v[4];
+        for (int c = 0; c < 4; ++c) {
+            __m128 slope = _mm_set1_ps(s_ptr[0].slope[c]);
+            slope = _mm_or_ps(_mm_andnot_ps(m1, slope),
+                              _mm_and_ps(m1, _mm_set1_ps(s_ptr[1].slope[c])));
+            slope = _mm_or_ps(_mm_andnot_ps(m2, slope),
+                              _mm_and_ps(m2, _mm_set1_ps(s_ptr[2].slope[c])));
+            __m128 base = _mm_set1_ps(s_ptr[0].base[c]);
+            base = _mm_or_ps(_mm_andnot_ps(m1, base),
+                             _mm_and_ps(m1, _mm_set1_ps(s_ptr[1].base[c])));
+            base = _mm_or_ps(_mm_andnot_ps(m2, base),
+                             _mm_and_ps(m2, _mm_set1_ps(s_ptr[2].base[c])));
+            v[c] = _mm_add_ps(_mm_mul_ps(slope, y), base);
+        }
+
+        const __m128 half = _mm_set1_ps(0.5f);
+        __m128 a = _mm_mul_ps(_mm_set1_ps(255.0f), v[0]);
+        __m128i ai = _mm_cvttps_epi32(_mm_add_ps(a, half));
+        __m128i ri = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(a, v[1]), half));
+        __m128i gi = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(a, v[2]), half));
+        __m128i bi = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(a, v[3]), half));
+        __m128i pixels = _mm_or_si128(
+            _mm_or_si128(
+                _mm_slli_epi32(ai, 24),
+                _mm_and_si128(_mm_slli_epi32(ri, 16),
+                              _mm_set1_epi32(0x00ff0000))),
+            _mm_or_si128(
+                _mm_and_si128(_mm_slli_epi32(gi, 8),
+                              _mm_set1_epi32(0x0000ff00)),
+                _mm_and_si128(bi, _mm_set1_epi32(0x000000ff))));
+        _mm_storeu_si128((__m128i*)(row_ptr + i), pixels);
+    }
+    for (; i < width; ++i) {
+        row_ptr[i] = _wlmaker_primitives_gradient_pixel(
+            gradient_ptr, t + (int64_t)(gradient_ptr->inc * i));
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/** @return Whether the CPU supports AVX2. */
+bool _wlmaker_primitives_avx2_supported(void)
+{
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Computes a row of gradient pixels, eight at a time, with AVX2. Implements
+ * @ref wlmaker_primitives_gradient_row_t. Same as the SSE2 kernel, on wider
+ * vectors.
+ *
+ * Deliberately not targeting FMA: The scalar code multiplies and adds with
+ * separate rounding, and so must the kernels.
+ *
+ * @param gradient_ptr
+ * @param t
+ * @param width
+ * @param row_ptr
+ */
+__attribute__((target("avx2")))
+void _wlmaker_primitives_gradient_row_avx2(
+    const wlmaker_primitives_gradient_t *gradient_ptr,
+    int64_t t,
+    int64_t width,
+    uint32_t *row_ptr)
+{
+    if (!_wlmaker_primitives_gradient_row_fits(gradient_ptr, t, width)) {
+        _wlmaker_primitives_gradient_row_scalar(
+            gradient_ptr, t, width, row_ptr);
+        return;
+    }
+
+    const wlmaker_primitives_gradient_segment_t *s_ptr =
+        gradient_ptr->segments;
+    const __m256d inc = _mm256_set1_pd(gradient_ptr->inc);
+    const __m256i t0 = _mm256_set1_epi32(t);
+    int64_t i = 0;
+    __m256d idx_lo = _mm256_set_pd(3, 2, 1, 0);
+    __m256d idx_hi = _mm256_set_pd(7, 6, 5, 4);
+    for (; i + 8 <= width; i += 8) {
+        __m256i tt = _mm256_add_epi32(
+            t0,
+            _mm256_inserti128_si256(
+                _mm256_castsi128_si256(
+                    _mm256_cvttpd_epi32(_mm256_mul_pd(inc, idx_lo))),
+                _mm256_cvttpd_epi32(_mm256_mul_pd(inc, idx_hi)),
+                1));
+        idx_lo = _mm256_add_pd(idx_lo, _mm256_set1_pd(8));
+        idx_hi = _mm256_add_pd(idx_hi, _mm256_set1_pd(8));
+
+        // Masks for the segment: 0 <= t, and 65536 <= t.
+        __m256 m1 = _mm256_castsi256_ps(
+            _mm256_cmpgt_epi32(tt, _mm256_set1_epi32(-1)));
+        __m256 m2 = _mm256_castsi256_ps(
+            _mm256_cmpgt_epi32(tt, _mm256_set1_epi32(65535)));
+        __m256 y = _mm256_mul_ps(_mm256_cvtepi32_ps(tt),
+                                 _mm256_set1_ps(1.0f / 65536.0f));
+
+        __m256 v[4];
+        for (int c = 0; c < 4; ++c) {
+            __m256 slope = _mm256_blendv_ps(
+                _mm256_blendv_ps(_mm256_set1_ps(s_ptr[0].slope[c]),
+                                 _mm256_set1_ps(s_ptr[1].slope[c]), m1),
+                _mm256_set1_ps(s_ptr[2].slope[c]), m2);
+            __m256 base = _mm256_blendv_ps(
+                _mm256_blendv_ps(_mm256_set1_ps(s_ptr[0].base[c]),
+                                 _mm256_set1_ps(s_ptr[1].base[c]), m1),
+                _mm256_set1_ps(s_ptr[2].base[c]), m2);
+            v[c] = _mm256_add_ps(_mm256_mul_ps(slope, y), base);
+        }
+
+        const __m256 half = _mm256_set1_ps(0.5f);
+        __m256 a = _mm256_mul_ps(_mm256_set1_ps(255.0f), v[0]);
+        __m256i ai = _mm256_cvttps_epi32(_mm256_add_ps(a, half));
+        __m256i ri = _mm256_cvttps_epi32(
+            _mm256_add_ps(_mm256_mul_ps(a, v[1]), half));
+        __m256i gi = _mm256_cvttps_epi32(
+            _mm256_add_ps(_mm256_mul_ps(a, v[2]), half));
+        __m256i bi = _mm256_cvttps_epi32(
+            _mm256_add_ps(_mm256_mul_ps(a, v[3]), half));
+        __m256i pixels = _mm256_or_si256(
+            _mm256_or_si256(
+                _mm256_slli_epi32(ai, 24),
+                _mm256_and_si256(_mm256_slli_epi32(ri, 16),
+                                 _mm256_set1_epi32(0x00ff0000))),
+            _mm256_or_si256(
+                _mm256_and_si256(_mm256_slli_epi32(gi, 8),
+                                 _mm256_set1_epi32(0x0000ff00)),
+                _mm256_and_si256(bi, _mm256_set1_epi32(0x000000ff))));
+        _mm256_storeu_si256((__m256i*)(row_ptr + i), pixels);
+    }
+    for (; i < width; ++i) {
+        row_ptr[i] = _wlmaker_primitives_gradient_pixel(
+            gradient_ptr, t + (int64_t)(gradient_ptr->inc * i));
+    }
+}
+#endif  // defined(WLMAKER_PRIMITIVES_X86)
+
+#if defined(WLMAKER_PRIMITIVES_NEON)
+/* ------------------------------------------------------------------------- */
+/** @return Whether the CPU supports Advanced SIMD (NEON). */
+bool _wlmaker_primitives_neon_supported(void)
+{
+    return 0 != (getauxval(AT_HWCAP) & HWCAP_ASIMD);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Computes a row of gradient pixels, four at a time, with NEON. Implements
+ * @ref wlmaker_primitives_gradient_row_t. Same as the SSE2 kernel.
+ *
+ * @param gradient_ptr
+ * @param t
+ * @param width
+ * @param row_ptr
+ */
+void _wlmaker_primitives_gradient_row_neon(
+    const wlmaker_primitives_gradient_t *gradient_ptr,
+    int64_t t,
+    int64_t width,
+    uint32_t *row_ptr)
+{
+    if (!_wlmaker_primitives_gradient_row_fits(gradient_ptr, t, width)) {
+        _wlmaker_primitives_gradient_row_scalar(
+            gradient_ptr, t, width, row_ptr);
+        return;
+    }
+
+    const wlmaker_primitives_gradient_segment_t *s_ptr =
+        gradient_ptr->segments;
+    const float64x2_t inc = vdupq_n_f64(gradient_ptr->inc);
+    const int32x4_t t0 = vdupq_n_s32(t);
+    int64_t i = 0;
+    const double idx[4] = { 0, 1, 2, 3 };
+    float64x2_t idx_lo = vld1q_f64(&idx[0]);
+    float64x2_t idx_hi = vld1q_f64(&idx[2]);
+    for (; i + 4 <= width; i += 4) {
+        int32x4_t tt = vaddq_s32(
+            t0,
+            vcombine_s32(
+                vmovn_s64(vcvtq_s64_f64(vmulq_f64(inc, idx_lo))),
+                vmovn_s64(vcvtq_s64_f64(vmulq_f64(inc, idx_hi)))));
+        idx_lo = vaddq_f64(idx_lo, vdupq_n_f64(4));
+        idx_hi = vaddq_f64(idx_hi, vdupq_n_f64(4));
+
+        // Masks for the segment: 0 <= t, and 65536 <= t.
+        uint32x4_t m1 = vcgeq_s32(tt, vdupq_n_s32(0));
+        uint32x4_t m2 = vcgeq_s32(tt, vdupq_n_s32(65536));
+        float32x4_t y = vmulq_f32(vcvtq_f32_s32(tt),
+                                  vdupq_n_f32(1.0f / 65536.0f));
+
+        float32x4_t v[4];
+        for (int c = 0; c < 4; ++c) {
+            float32x4_t slope = vbslq_f32(
+                m2, vdupq_n_f32(s_ptr[2].slope[c]),
+                vbslq_f32(m1, vdupq_n_f32(s_ptr[1].slope[c]),
+                          vdupq_n_f32(s_ptr[0].slope[c])));
+            float32x4_t base = vbslq_f32(
+                m2, vdupq_n_f32(s_ptr[2].base[c]),
+                vbslq_f32(m1, vdupq_n_f32(s_ptr[1].base[c]),
+                          vdupq_n_f32(s_ptr[0].base[c])));
+            v[c] = vaddq_f32(vmulq_f32(slope, y), base);
+        }
+
+        const float32x4_t half = vdupq_n_f32(0.5f);
+        float32x4_t a = vmulq_f32(vdupq_n_f32(255.0f), v[0]);
+        uint32x4_t ai = vcvtq_u32_f32(vaddq_f32(a, half));
+        uint32x4_t ri = vcvtq_u32_f32(vaddq_f32(vmulq_f32(a, v[1]), half));
+        uint32x4_t gi = vcvtq_u32_f32(vaddq_f32(vmulq_f32(a, v[2]), half));
+        uint32x4_t bi = vcvtq_u32_f32(vaddq_f32(vmulq_f32(a, v[3]), half));
+        uint32x4_t pixels = vorrq_u32(
+            vorrq_u32(
+                vshlq_n_u32(ai, 24),
+                vandq_u32(vshlq_n_u32(ri, 16), vdupq_n_u32(0x00ff0000))),
+            vorrq_u32(
+                vandq_u32(vshlq_n_u32(gi, 8), vdupq_n_u32(0x0000ff00)),
+                vandq_u32(bi, vdupq_n_u32(0x000000ff))));
+        vst1q_u32(row_ptr + i, pixels);
+    }
+    for (; i < width; ++i) {
+        row_ptr[i] = _wlmaker_primitives_gradient_pixel(
+            gradient_ptr, t + (int64_t)(gradient_ptr->inc * i));
+    }
+}
+#endif  // defined(WLMAKER_PRIMITIVES_NEON)
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Computes the end point of the Window Maker style diagonal gradient.
+ *
+ * It is on the line that crosses the bottom-right corner and lies parallel
+ * to the top-right -> bottom-left diagonal; and on a perpendicular
+ * intersection from the top-left corner.
+ *
+ * @param width
+ * @param height
+ * @param x_ptr
+ * @param y_ptr
+ */
+void _wlmaker_primitives_adgradient_end(
+    unsigned width,
+    unsigned height,
+    double *x_ptr,
+    double *y_ptr)
+{
+    *x_ptr = 2 * height * height * width /
+        BS_MAX(1.0, width * width + height * height);
+    *y_ptr = 2 * height * width * width /
+        BS_MAX(1.0, width * width + height * height);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Computes the offset from user space to device pixels, if the cairo maps
+ * user space to device pixels 1:1.
+ *
+ * @param cairo_ptr
+ * @param x_ptr
+ * @param y_ptr
+ *
+ * @return false if the cairo scales, rotates or shears, or if the offset is
+ *     not a whole number of pixels.
+ */
+bool _wlmaker_primitives_device_offset(
+    cairo_t *cairo_ptr,
+    int *x_ptr,
+    int *y_ptr)
+{
+    cairo_matrix_t matrix;
+    cairo_get_matrix(cairo_ptr, &matrix);
+    double sx, sy, ox, oy;
+    cairo_surface_get_device_scale(cairo_get_target(cairo_ptr), &sx, &sy);
+    cairo_surface_get_device_offset(cairo_get_target(cairo_ptr), &ox, &oy);
+    ox += matrix.x0;
+    oy += matrix.y0;
+    if (1 != matrix.xx || 0 != matrix.yx || 0 != matrix.xy ||
+        1 != matrix.yy || 1 != sx || 1 != sy ||
+        ox != floor(ox) || oy != floor(oy)) return false;
+    *x_ptr = ox;
+    *y_ptr = oy;
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Returns whether the clip of `cairo_ptr` covers all of its target surface.
+ *
+ * The clip extents alone are not sufficient: A non-rectangular clip, like a
+ * rounded rectangle, may have extents covering the whole surface. So the
+ * clip must be representable as a single rectangle covering the surface.
+ *
+ * @param cairo_ptr           Must target an image surface.
+ *
+ * @return true if no pixel of the surface is clipped.
+ */
+bool _wlmaker_primitives_unclipped(cairo_t *cairo_ptr)
+{
+    cairo_surface_t *surface_ptr = cairo_get_target(cairo_ptr);
+    cairo_rectangle_list_t *list_ptr = cairo_copy_clip_rectangle_list(
+        cairo_ptr);
+    bool unclipped = (
+        CAIRO_STATUS_SUCCESS == list_ptr->status &&
+        1 == list_ptr->num_rectangles &&
+        0 >= list_ptr->rectangles[0].x &&
+        0 >= list_ptr->rectangles[0].y &&
+        cairo_image_surface_get_width(surface_ptr) <=
+        list_ptr->rectangles[0].x + list_ptr->rectangles[0].width &&
+        cairo_image_surface_get_height(surface_ptr) <=
+        list_ptr->rectangles[0].y + list_ptr->rectangles[0].height);
+    cairo_rectangle_list_destroy(list_ptr);
+    return unclipped;
+}
+
+/* == Unit tests =========================================================== */
+
 static void test_fill(bs_test_t *test_ptr);
+static void test_fill_gfxbuf(bs_test_t *test_ptr);
+static void test_fill_clipped(bs_test_t *test_ptr);
+static void test_copy_area(bs_test_t *test_ptr);
 static void test_close(bs_test_t *test_ptr);
 static void test_close_large(bs_test_t *test_ptr);
 static void test_minimize(bs_test_t *test_ptr);
@@ -283,6 +1231,9 @@ static void test_window_title(bs_test_t *test_ptr);
 /** Unit tests. */
 const bs_test_case_t   wlmaker_primitives_test_cases[] = {
     { 1, "fill", test_fill },
+    { 1, "fill_gfxbuf", test_fill_gfxbuf },
+    { 1, "fill_clipped", test_fill_clipped },
+    { 1, "copy_area", test_copy_area },
     { 1, "close", test_close },
     { 1, "close_large", test_close_large },
     { 1, "minimize", test_minimize },
@@ -294,6 +1245,14 @@ const bs_test_case_t   wlmaker_primitives_test_cases[] = {
     { 0, NULL, NULL }
 };
 
+static void benchmark_fill(bs_test_t *test_ptr);
+
+/** Benchmarks. Not run as unit tests, see toolkit_benchmark.c. */
+const bs_test_case_t   wlmaker_primitives_benchmark_cases[] = {
+    { 1, "fill", benchmark_fill },
+    { 0, NULL, NULL }
+};
+
 /** Verifies the fill styles */
 void test_fill(bs_test_t *test_ptr)
 {
@@ -350,6 +1309,275 @@ void test_fill(bs_test_t *test_ptr)
     bs_gfxbuf_destroy(gfxbuf_ptr);
 }
 
+/** Verifies a clip with extents covering the surface is still respected. */
+void test_fill_clipped(bs_test_t *test_ptr)
+{
+    bs_gfxbuf_t *gfxbuf_ptr = bs_gfxbuf_create(16, 8);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, gfxbuf_ptr);
+    bs_gfxbuf_clear(gfxbuf_ptr, 0xff000000);
+    cairo_t *cairo_ptr = cairo_create_from_bs_gfxbuf(gfxbuf_ptr);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, cairo_ptr);
+
+    // An L-shaped clip: Its extents cover all, but not the bottom right.
+    cairo_rectangle(cairo_ptr, 0, 0, 8, 8);
+    cairo_rectangle(cairo_ptr, 8, 0, 8, 4);
+    cairo_clip(cairo_ptr);
+    wlmtk_style_fill_t fill = {
+        .type = WLMTK_STYLE_COLOR_SOLID,
+        .param = { .solid = { .color = 0xff4080c0} }
+    };
+    wlmaker_primitives_cairo_fill(cairo_ptr, &fill);
+    cairo_destroy(cairo_ptr);
+
+    BS_TEST_VERIFY_EQ(test_ptr, 0xff4080c0,
+                      *bs_gfxbuf_pixel_at(gfxbuf_ptr, 0, 7));
+    BS_TEST_VERIFY_EQ(test_ptr, 0xff4080c0,
+                      *bs_gfxbuf_pixel_at(gfxbuf_ptr, 15, 0));
+    BS_TEST_VERIFY_EQ(test_ptr, 0xff000000,
+                      *bs_gfxbuf_pixel_at(gfxbuf_ptr, 15, 7));
+    bs_gfxbuf_destroy(gfxbuf_ptr);
+}
+
+/** Fill styles for @ref test_fill_gfxbuf and @ref benchmark_fill. */
+static const wlmtk_style_fill_t _wlmaker_primitives_test_fills[] = {
+    { .type = WLMTK_STYLE_COLOR_SOLID,
+      .param = { .solid = { .color = 0xff4080c0 } } },
+    { .type = WLMTK_STYLE_COLOR_HGRADIENT,
+      .param = { .hgradient = { .from = 0xff102040, .to = 0xff4080ff } } },
+    { .type = WLMTK_STYLE_COLOR_VGRADIENT,
+      .param = { .vgradient = { .from = 0xff102040, .to = 0xff4080ff } } },
+    { .type = WLMTK_STYLE_COLOR_DGRADIENT,
+      .param = { .dgradient = { .from = 0xff102040, .to = 0xff4080ff } } },
+    { .type = WLMTK_STYLE_COLOR_ADGRADIENT,
+      .param = { .dgradient = { .from = 0xff102040, .to = 0xff4080ff } } },
+    { .type = WLMTK_STYLE_COLOR_HGRADIENT,
+      .param = { .hgradient = { .from = 0xff4080ff, .to = 0xff000000 } } },
+    { .type = WLMTK_STYLE_COLOR_DGRADIENT,
+      .param = { .dgradient = { .from = 0xffffffff, .to = 0xff010203 } } },
+};
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Compares the direct fill with the currently selected kernel against the
+ * fill through cairo, for all of @ref _wlmaker_primitives_test_fills.
+ *
+ * @param test_ptr
+ * @param cairo_gfxbuf_ptr    64x32 buffer, target of `cairo_ptr`.
+ * @param gfxbuf_ptr          64x32 buffer, for the direct fill.
+ * @param cairo_ptr
+ */
+static void _wlmaker_primitives_test_fill_kernel(
+    bs_test_t *test_ptr,
+    bs_gfxbuf_t *cairo_gfxbuf_ptr,
+    bs_gfxbuf_t *gfxbuf_ptr,
+    cairo_t *cairo_ptr)
+{
+    // Rectangles within a 64x32 buffer: Full, inset, odd, clipped, tiny.
+    static const struct { int x, y; unsigned w, h; } rects[] = {
+        { 0, 0, 64, 32 }, { 3, 2, 37, 13 }, { 5, 7, 59, 25 },
+        { -7, -3, 50, 20 }, { 40, 20, 40, 30 }, { 1, 1, 1, 1 },
+        { 0, 0, 64, 1 }, { 0, 0, 1, 32 }, { 10, 10, 0, 5 },
+    };
+
+    for (size_t f = 0;
+         f < sizeof(_wlmaker_primitives_test_fills) /
+             sizeof(wlmtk_style_fill_t); ++f) {
+        const wlmtk_style_fill_t *fill_ptr =
+            &_wlmaker_primitives_test_fills[f];
+        for (size_t r = 0; r < sizeof(rects) / sizeof(rects[0]); ++r) {
+            bs_gfxbuf_clear(cairo_gfxbuf_ptr, 0xff204060);
+            bs_gfxbuf_clear(gfxbuf_ptr, 0xff204060);
+
+            _wlmaker_primitives_cairo_fill_pattern(
+                cairo_ptr, rects[r].x, rects[r].y, rects[r].w, rects[r].h,
+                fill_ptr);
+            cairo_surface_flush(cairo_get_target(cairo_ptr));
+            BS_TEST_VERIFY_TRUE(
+                test_ptr,
+                wlmaker_primitives_gfxbuf_fill_at(
+                    gfxbuf_ptr, rects[r].x, rects[r].y, rects[r].w,
+                    rects[r].h, fill_ptr));
+
+            for (unsigned y = 0; y < gfxbuf_ptr->height; ++y) {
+                for (unsigned x = 0; x < gfxbuf_ptr->width; ++x) {
+                    uint32_t expected = *bs_gfxbuf_pixel_at(
+                        cairo_gfxbuf_ptr, x, y);
+                    uint32_t actual = *bs_gfxbuf_pixel_at(gfxbuf_ptr, x, y);
+                    if (expected == actual) continue;
+                    bs_log(BS_ERROR, "Kernel %s, fill %zu, rect %zu: "
+                           "Differs at (%u, %u)",
+                           _wlmaker_primitives_kernel_ptr->name_ptr,
+                           f, r, x, y);
+                    BS_TEST_VERIFY_EQ(test_ptr, expected, actual);
+                    y = gfxbuf_ptr->height;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Verifies the direct fill is pixel-identical to filling through cairo, with
+ * each of the kernels.
+ */
+void test_fill_gfxbuf(bs_test_t *test_ptr)
+{
+    bs_gfxbuf_t *cairo_gfxbuf_ptr = bs_gfxbuf_create(64, 32);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, cairo_gfxbuf_ptr);
+    bs_gfxbuf_t *gfxbuf_ptr = bs_gfxbuf_create(64, 32);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, gfxbuf_ptr);
+    cairo_t *cairo_ptr = cairo_create_from_bs_gfxbuf(cairo_gfxbuf_ptr);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, cairo_ptr);
+
+    // Every kernel the CPU supports must match.
+    for (size_t k = 0;
+         k < sizeof(_wlmaker_primitives_kernels) /
+             sizeof(wlmaker_primitives_kernel_t); ++k) {
+        if (!_wlmaker_primitives_kernels[k].supported()) continue;
+        _wlmaker_primitives_kernel_ptr = &_wlmaker_primitives_kernels[k];
+        _wlmaker_primitives_test_fill_kernel(
+            test_ptr, cairo_gfxbuf_ptr, gfxbuf_ptr, cairo_ptr);
+    }
+    _wlmaker_primitives_kernel_ptr = NULL;
+
+    // Translucent colors are not handled, and leave the buffer untouched.
+    wlmtk_style_fill_t fill = {
+        .type = WLMTK_STYLE_COLOR_VGRADIENT,
+        .param = { .vgradient = { .from = 0xff102040, .to = 0x804080ff } }
+    };
+    bs_gfxbuf_clear(gfxbuf_ptr, 0xff204060);
+    BS_TEST_VERIFY_FALSE(
+        test_ptr,
+        wlmaker_primitives_gfxbuf_fill_at(gfxbuf_ptr, 0, 0, 64, 32, &fill));
+    BS_TEST_VERIFY_EQ(test_ptr, 0xff204060,
+                      *bs_gfxbuf_pixel_at(gfxbuf_ptr, 0, 0));
+
+    cairo_destroy(cairo_ptr);
+    bs_gfxbuf_destroy(gfxbuf_ptr);
+    bs_gfxbuf_destroy(cairo_gfxbuf_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** @return monotonic time, in microseconds. */
+static uint64_t _wlmaker_primitives_test_usec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Times filling a titlebar-sized buffer through a cairo pattern, and directly
+ * with each of the kernels supported by the CPU. Reports the speedup of the
+ * direct path over cairo.
+ */
+void benchmark_fill(bs_test_t *test_ptr)
+{
+    const int rounds = 1000;
+    bs_gfxbuf_t *gfxbuf_ptr = bs_gfxbuf_create(640, 22);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, gfxbuf_ptr);
+    cairo_t *cairo_ptr = cairo_create_from_bs_gfxbuf(gfxbuf_ptr);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, cairo_ptr);
+
+    for (size_t f = 0;
+         f < sizeof(_wlmaker_primitives_test_fills) /
+             sizeof(wlmtk_style_fill_t); ++f) {
+        const wlmtk_style_fill_t *fill_ptr =
+            &_wlmaker_primitives_test_fills[f];
+
+        uint64_t start_usec = _wlmaker_primitives_test_usec();
+        for (int i = 0; i < rounds; ++i) {
+            _wlmaker_primitives_cairo_fill_pattern(
+                cairo_ptr, 0, 0, 640, 22, fill_ptr);
+            cairo_surface_flush(cairo_get_target(cairo_ptr));
+        }
+        uint64_t cairo_usec = _wlmaker_primitives_test_usec() - start_usec;
+
+        for (size_t k = 0;
+             k < sizeof(_wlmaker_primitives_kernels) /
+                 sizeof(wlmaker_primitives_kernel_t); ++k) {
+            if (!_wlmaker_primitives_kernels[k].supported()) continue;
+            _wlmaker_primitives_kernel_ptr = &_wlmaker_primitives_kernels[k];
+
+            start_usec = _wlmaker_primitives_test_usec();
+            for (int i = 0; i < rounds; ++i) {
+                BS_TEST_VERIFY_TRUE(
+                    test_ptr,
+                    wlmaker_primitives_gfxbuf_fill_at(
+                        gfxbuf_ptr, 0, 0, 640, 22, fill_ptr));
+            }
+            uint64_t direct_usec = BS_MAX(
+                _wlmaker_primitives_test_usec() - start_usec, 1);
+
+            bs_log(BS_INFO, "Fill %zu (type %d), 640x22, average of %d: "
+                   "cairo %.2f us, %s %.2f us, speedup %.1fx.",
+                   f, fill_ptr->type, rounds,
+                   (double)cairo_usec / rounds,
+                   _wlmaker_primitives_kernel_ptr->name_ptr,
+                   (double)direct_usec / rounds,
+                   (double)cairo_usec / direct_usec);
+        }
+        _wlmaker_primitives_kernel_ptr = NULL;
+    }
+
+    cairo_destroy(cairo_ptr);
+    bs_gfxbuf_destroy(gfxbuf_ptr);
+}
+
+/** Verifies that columnar fills stretch from 1 pixel to the full width. */
+void test_copy_area(bs_test_t *test_ptr)
+{
+    bs_gfxbuf_t *column_gfxbuf_ptr = bs_gfxbuf_create(1, 32);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, column_gfxbuf_ptr);
+    bs_gfxbuf_t *full_gfxbuf_ptr = bs_gfxbuf_create(64, 32);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, full_gfxbuf_ptr);
+    bs_gfxbuf_t *gfxbuf_ptr = bs_gfxbuf_create(40, 32);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, gfxbuf_ptr);
+    bs_gfxbuf_t *expected_gfxbuf_ptr = bs_gfxbuf_create(40, 32);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, expected_gfxbuf_ptr);
+
+    size_t columnar_fills = 0;
+    for (size_t f = 0;
+         f < sizeof(_wlmaker_primitives_test_fills) /
+             sizeof(wlmtk_style_fill_t); ++f) {
+        const wlmtk_style_fill_t *fill_ptr =
+            &_wlmaker_primitives_test_fills[f];
+        if (!wlmaker_primitives_fill_is_columnar(fill_ptr)) continue;
+        ++columnar_fills;
+
+        BS_TEST_VERIFY_TRUE(
+            test_ptr,
+            wlmaker_primitives_gfxbuf_fill_at(
+                column_gfxbuf_ptr, 0, 0, 1, 32, fill_ptr));
+        BS_TEST_VERIFY_TRUE(
+            test_ptr,
+            wlmaker_primitives_gfxbuf_fill_at(
+                full_gfxbuf_ptr, 0, 0, 64, 32, fill_ptr));
+
+        // Cuts a strip out of each, leaving a margin around the strip.
+        bs_gfxbuf_clear(gfxbuf_ptr, 0xff204060);
+        bs_gfxbuf_clear(expected_gfxbuf_ptr, 0xff204060);
+        wlmaker_primitives_copy_area(
+            gfxbuf_ptr, 2, 1, column_gfxbuf_ptr, 17, 1, 36, 30);
+        wlmaker_primitives_copy_area(
+            expected_gfxbuf_ptr, 2, 1, full_gfxbuf_ptr, 17, 1, 36, 30);
+        BS_TEST_VERIFY_EQ(
+            test_ptr, 0,
+            memcmp(expected_gfxbuf_ptr->data_ptr, gfxbuf_ptr->data_ptr,
+                   sizeof(uint32_t) * gfxbuf_ptr->pixels_per_line *
+                   gfxbuf_ptr->height));
+    }
+    BS_TEST_VERIFY_EQ(test_ptr, 2, columnar_fills);
+
+    bs_gfxbuf_destroy(expected_gfxbuf_ptr);
+    bs_gfxbuf_destroy(gfxbuf_ptr);
+    bs_gfxbuf_destroy(full_gfxbuf_ptr);
+    bs_gfxbuf_destroy(column_gfxbuf_ptr);
+}
+
 /** Verifies the looks of the "close" icon. */
 void test_close(bs_test_t *test_ptr)
 {
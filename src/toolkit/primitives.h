@@ -57,6 +57,71 @@ void wlmaker_primitives_cairo_fill_at(
     unsigned height,
     const wlmtk_style_fill_t *fill_ptr);
 
+/**
+ * Fills the graphics buffer with the specified style at the rectangle,
+ * writing the pixels directly instead of going through cairo.
+ *
+ * The result is pixel-identical to @ref wlmaker_primitives_cairo_fill_at on
+ * an untransformed cairo of the same buffer, which uses this for opaque
+ * fills already. Gradients start at the buffer's origin, not at (x, y).
+ *
+ * @param gfxbuf_ptr
+ * @param x
+ * @param y
+ * @param width
+ * @param height
+ * @param fill_ptr
+ *
+ * @return false if the fill has translucent colors, or exceeds 32767 pixels
+ *     in either dimension. Then, nothing was written, and the caller should
+ *     use @ref wlmaker_primitives_cairo_fill_at instead.
+ */
+bool wlmaker_primitives_gfxbuf_fill_at(
+    bs_gfxbuf_t *gfxbuf_ptr,
+    int x,
+    int y,
+    unsigned width,
+    unsigned height,
+    const wlmtk_style_fill_t *fill_ptr);
+
+/**
+ * Returns whether the fill is the same in every column. This holds for the
+ * SOLID and VGRADIENT fills: They can be drawn into a buffer just 1 pixel
+ * wide, and get stretched from there by @ref wlmaker_primitives_copy_area.
+ *
+ * @param fill_ptr
+ *
+ * @return true if the fill does not vary along the x axis.
+ */
+bool wlmaker_primitives_fill_is_columnar(const wlmtk_style_fill_t *fill_ptr);
+
+/**
+ * Copies an area of a background into `dest_gfxbuf_ptr`.
+ *
+ * If `src_gfxbuf_ptr` is 1 pixel wide, it holds a columnar fill (see
+ * @ref wlmaker_primitives_fill_is_columnar): That column is then stretched
+ * across the area, and `src_x` is ignored. Otherwise, this is equivalent to
+ * `bs_gfxbuf_copy_area`.
+ *
+ * @param dest_gfxbuf_ptr
+ * @param dest_x
+ * @param dest_y
+ * @param src_gfxbuf_ptr
+ * @param src_x
+ * @param src_y
+ * @param width
+ * @param height
+ */
+void wlmaker_primitives_copy_area(
+    bs_gfxbuf_t *dest_gfxbuf_ptr,
+    unsigned dest_x,
+    unsigned dest_y,
+    const bs_gfxbuf_t *src_gfxbuf_ptr,
+    unsigned src_x,
+    unsigned src_y,
+    unsigned width,
+    unsigned height);
+
 /**
  * Sets the bezel color.
  *
@@ -148,6 +213,10 @@ void wlmaker_primitives_draw_window_title(
 /**
  * Draws the text with given parameters into the `cairo_t` at (x, y).
  *
+ * The text is rendered once into an alpha mask held by the text cache, and
+ * composited from there. Falls back to rendering directly, if the cairo is
+ * scaled or not aligned to pixels.
+ *
  * @param cairo_ptr
  * @param x
  * @param y
@@ -165,6 +234,8 @@ void wlmaker_primitives_draw_text(
 
 /** Unit tests. */
 extern const bs_test_case_t   wlmaker_primitives_test_cases[];
+/** Benchmarks: Direct fill against cairo. */
+extern const bs_test_case_t   wlmaker_primitives_benchmark_cases[];
 
 #ifdef __cplusplus
 }  // extern "C"
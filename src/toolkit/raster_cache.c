@@ -0,0 +1,631 @@
+/* ========================================================================= */
+/**
+ * @file raster_cache.c
+ *
+ * @copyright
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/// mkostemp(3) is a GNU extension, need this macro.
+#define _GNU_SOURCE
+
+#include "raster_cache.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "gfxbuf.h"
+#include "util.h"
+
+/* == Declarations ========================================================= */
+
+/**
+ * Header of a cached image file. Followed by the source path, and by the
+ * pixels at `data_offset`. Stored in host byte order: The cache is local.
+ */
+typedef struct {
+    /** Identifies the format, see @ref _wlmtk_raster_cache_magic. */
+    char                      magic[8];
+    /** Width of the image, in pixels. */
+    uint32_t                  width;
+    /** Height of the image, in pixels. */
+    uint32_t                  height;
+    /** Requested width, as in the key. */
+    int32_t                   key_width;
+    /** Requested height, as in the key. */
+    int32_t                   key_height;
+    /** Requested scale, as in the key. */
+    double                    key_scale;
+    /** Modification time of the source: Seconds. */
+    int64_t                   mtime_sec;
+    /** Modification time of the source: Nanoseconds. */
+    int64_t                   mtime_nsec;
+    /** Size of the source, in bytes. */
+    int64_t                   source_size;
+    /** Length of the source path that follows the header. */
+    uint32_t                  path_len;
+    /** Offset of the pixels from the start of the file. */
+    uint32_t                  data_offset;
+} wlmtk_raster_cache_header_t;
+
+/** A file in the cache directory, as candidate for pruning. */
+typedef struct {
+    /** Name of the file, within the cache directory. */
+    char                      *name_ptr;
+    /** Last access. The oldest files are pruned first. */
+    struct timespec           atime;
+    /** Size of the file, in bytes. */
+    size_t                    size;
+} wlmtk_raster_cache_file_t;
+
+static void _wlmtk_raster_cache_prune(
+    const char *dir_ptr,
+    size_t max_bytes);
+static bool _wlmtk_raster_cache_file_obsolete(int dir_fd, const char *name_ptr);
+static int _wlmtk_raster_cache_file_compare(
+    const void *f1_ptr,
+    const void *f2_ptr);
+static bool _wlmtk_raster_cache_file_path(
+    const char *path_ptr,
+    int width,
+    int height,
+    double scale,
+    char *file_path_ptr,
+    size_t size);
+static bool _wlmtk_raster_cache_header_matches(
+    const wlmtk_raster_cache_header_t *header_ptr,
+    const char *path_ptr,
+    int width,
+    int height,
+    double scale,
+    const struct stat *stat_ptr,
+    size_t file_size);
+static bool _wlmtk_raster_cache_write(int fd, const void *data_ptr, size_t n);
+
+/* == Data ================================================================= */
+
+/** Identifies the file format, including its version. */
+static const char _wlmtk_raster_cache_magic[8] = "WLMRAS01";
+/** Alignment of the pixel data within the file. */
+static const size_t _wlmtk_raster_cache_data_alignment = 64;
+
+/** Size limit of the cache directory. Least recently used files go first. */
+static const size_t _wlmtk_raster_cache_max_bytes = 64 * 1024 * 1024;
+/** Age after which a temporary file is taken as left over from a crash. */
+static const time_t _wlmtk_raster_cache_tmp_max_age_sec = 3600;
+
+/** Directory holding the cached images. NULL if the cache is disabled. */
+static char *_wlmtk_raster_cache_dir_ptr = NULL;
+
+/* == Exported methods ===================================================== */
+
+/* ------------------------------------------------------------------------- */
+bool wlmtk_raster_cache_init(const char *dir_ptr)
+{
+    char path[PATH_MAX];
+    if (NULL == dir_ptr) {
+        if (!wlmtk_util_cache_dir(path, sizeof(path))) return false;
+        dir_ptr = path;
+    } else if (!wlmtk_util_mkdirs(dir_ptr)) {
+        return false;
+    }
+
+    wlmtk_raster_cache_fini();
+    _wlmtk_raster_cache_prune(dir_ptr, _wlmtk_raster_cache_max_bytes);
+    _wlmtk_raster_cache_dir_ptr = logged_strdup(dir_ptr);
+    if (NULL == _wlmtk_raster_cache_dir_ptr) return false;
+    bs_log(BS_INFO, "Caching scaled images in %s",
+           _wlmtk_raster_cache_dir_ptr);
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_raster_cache_fini(void)
+{
+    if (NULL != _wlmtk_raster_cache_dir_ptr) {
+        free(_wlmtk_raster_cache_dir_ptr);
+        _wlmtk_raster_cache_dir_ptr = NULL;
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+struct wlr_buffer *wlmtk_raster_cache_load(
+    const char *path_ptr,
+    int width,
+    int height,
+    double scale)
+{
+    char file_path[PATH_MAX];
+    if (!_wlmtk_raster_cache_file_path(path_ptr, width, height, scale,
+                                       file_path, sizeof(file_path))) {
+        return NULL;
+    }
+
+    struct stat source_stat;
+    if (0 != stat(path_ptr, &source_stat)) return NULL;
+
+    int fd = open(file_path, O_RDONLY | O_CLOEXEC);
+    if (0 > fd) {
+        if (ENOENT != errno) {
+            bs_log(BS_WARNING | BS_ERRNO, "Failed open(%s, O_RDONLY)",
+                   file_path);
+        }
+        return NULL;
+    }
+    struct stat file_stat;
+    if (0 != fstat(fd, &file_stat) ||
+        (size_t)file_stat.st_size < sizeof(wlmtk_raster_cache_header_t)) {
+        close(fd);
+        return NULL;
+    }
+
+    // Private and writable: Users may draw into the buffer, but won't
+    // modify the file. Pages are loaded on first access.
+    size_t map_size = file_stat.st_size;
+    void *map_ptr = mmap(NULL, map_size, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (MAP_FAILED == map_ptr) {
+        bs_log(BS_WARNING | BS_ERRNO, "Failed mmap(NULL, %zu, ..., %s)",
+               map_size, file_path);
+        return NULL;
+    }
+
+    const wlmtk_raster_cache_header_t *header_ptr = map_ptr;
+    if (!_wlmtk_raster_cache_header_matches(
+            header_ptr, path_ptr, width, height, scale,
+            &source_stat, map_size)) {
+        // Stale or mismatched. Will be overwritten by the next store.
+        munmap(map_ptr, map_size);
+        return NULL;
+    }
+    return bs_gfxbuf_create_wlr_buffer_from_mmap(
+        header_ptr->width, header_ptr->height, header_ptr->width,
+        map_ptr, map_size, header_ptr->data_offset);
+}
+
+/* ------------------------------------------------------------------------- */
+bool wlmtk_raster_cache_store(
+    const char *path_ptr,
+    int width,
+    int height,
+    double scale,
+    struct wlr_buffer *wlr_buffer_ptr)
+{
+    char file_path[PATH_MAX];
+    if (NULL == _wlmtk_raster_cache_dir_ptr) return true;
+    if (!_wlmtk_raster_cache_file_path(path_ptr, width, height, scale,
+                                       file_path, sizeof(file_path))) {
+        return false;
+    }
+
+    struct stat source_stat;
+    if (0 != stat(path_ptr, &source_stat)) {
+        bs_log(BS_WARNING | BS_ERRNO, "Failed stat(%s, ...)", path_ptr);
+        return false;
+    }
+
+    bs_gfxbuf_t *gfxbuf_ptr = bs_gfxbuf_from_wlr_buffer(wlr_buffer_ptr);
+    size_t path_len = strlen(path_ptr);
+    size_t data_offset = sizeof(wlmtk_raster_cache_header_t) + path_len;
+    data_offset = ((data_offset + _wlmtk_raster_cache_data_alignment - 1) /
+                   _wlmtk_raster_cache_data_alignment *
+                   _wlmtk_raster_cache_data_alignment);
+    wlmtk_raster_cache_header_t header = {
+        .width = gfxbuf_ptr->width,
+        .height = gfxbuf_ptr->height,
+        .key_width = BS_MAX(width, 0),
+        .key_height = BS_MAX(height, 0),
+        .key_scale = scale,
+        .mtime_sec = source_stat.st_mtim.tv_sec,
+        .mtime_nsec = source_stat.st_mtim.tv_nsec,
+        .source_size = source_stat.st_size,
+        .path_len = path_len,
+        .data_offset = data_offset
+    };
+    memcpy(header.magic, _wlmtk_raster_cache_magic, sizeof(header.magic));
+
+    // Written to a temporary file first, then renamed: Concurrent loads see
+    // either the old or the new file, never a partial one.
+    char tmp_path[PATH_MAX];
+    int rv = snprintf(tmp_path, sizeof(tmp_path), "%s/.tmp-XXXXXX",
+                      _wlmtk_raster_cache_dir_ptr);
+    if (0 > rv || (size_t)rv >= sizeof(tmp_path)) return false;
+    int fd = mkostemp(tmp_path, O_CLOEXEC);
+    if (0 > fd) {
+        bs_log(BS_WARNING | BS_ERRNO, "Failed mkostemp(%s, O_CLOEXEC)",
+               tmp_path);
+        return false;
+    }
+
+    static const uint8_t padding[64] = { 0 };
+    bool written =
+        _wlmtk_raster_cache_write(fd, &header, sizeof(header)) &&
+        _wlmtk_raster_cache_write(fd, path_ptr, path_len) &&
+        _wlmtk_raster_cache_write(
+            fd, padding, data_offset - sizeof(header) - path_len);
+    for (uint32_t y = 0; written && y < gfxbuf_ptr->height; ++y) {
+        written = _wlmtk_raster_cache_write(
+            fd, bs_gfxbuf_pixel_at(gfxbuf_ptr, 0, y),
+            gfxbuf_ptr->width * sizeof(uint32_t));
+    }
+    if (0 != close(fd)) written = false;
+
+    if (!written || 0 != rename(tmp_path, file_path)) {
+        bs_log(BS_WARNING | BS_ERRNO, "Failed to store %s", file_path);
+        unlink(tmp_path);
+        return false;
+    }
+    return true;
+}
+
+/* == Local (static) methods =============================================== */
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Prunes the cache directory: Removes files of sources that changed or are
+ * gone, temporary files left over, and then the least recently used files
+ * until the directory holds at most `max_bytes`.
+ *
+ * Only touches files that look like ours: Other caches may share the
+ * directory.
+ *
+ * @param dir_ptr
+ * @param max_bytes
+ */
+void _wlmtk_raster_cache_prune(const char *dir_ptr, size_t max_bytes)
+{
+    DIR *dir_stream_ptr = opendir(dir_ptr);
+    if (NULL == dir_stream_ptr) {
+        bs_log(BS_WARNING | BS_ERRNO, "Failed opendir(%s)", dir_ptr);
+        return;
+    }
+    int dir_fd = dirfd(dir_stream_ptr);
+
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    wlmtk_raster_cache_file_t *files_ptr = NULL;
+    size_t files = 0, capacity = 0, total_bytes = 0;
+    struct dirent *dirent_ptr;
+    while (NULL != (dirent_ptr = readdir(dir_stream_ptr))) {
+        const char *name_ptr = dirent_ptr->d_name;
+        size_t len = strlen(name_ptr);
+        bool is_tmp = 0 == strncmp(name_ptr, ".tmp-", 5);
+        if (!is_tmp &&
+            (21 != len || 0 != strcmp(name_ptr + 16, ".argb"))) continue;
+
+        struct stat file_stat;
+        if (0 != fstatat(dir_fd, name_ptr, &file_stat, AT_SYMLINK_NOFOLLOW) ||
+            !S_ISREG(file_stat.st_mode)) continue;
+        if (is_tmp) {
+            if (now.tv_sec - file_stat.st_mtim.tv_sec >
+                _wlmtk_raster_cache_tmp_max_age_sec) {
+                unlinkat(dir_fd, name_ptr, 0);
+            }
+            continue;
+        }
+        if (_wlmtk_raster_cache_file_obsolete(dir_fd, name_ptr)) {
+            unlinkat(dir_fd, name_ptr, 0);
+            continue;
+        }
+
+        if (files >= capacity) {
+            capacity = BS_MAX(2 * capacity, 64u);
+            wlmtk_raster_cache_file_t *new_files_ptr = realloc(
+                files_ptr, capacity * sizeof(wlmtk_raster_cache_file_t));
+            if (NULL == new_files_ptr) break;
+            files_ptr = new_files_ptr;
+        }
+        files_ptr[files].name_ptr = logged_strdup(name_ptr);
+        if (NULL == files_ptr[files].name_ptr) break;
+        files_ptr[files].atime = file_stat.st_atim;
+        files_ptr[files].size = file_stat.st_size;
+        total_bytes += file_stat.st_size;
+        ++files;
+    }
+
+    if (total_bytes > max_bytes) {
+        qsort(files_ptr, files, sizeof(wlmtk_raster_cache_file_t),
+              _wlmtk_raster_cache_file_compare);
+        for (size_t i = 0; i < files && total_bytes > max_bytes; ++i) {
+            if (0 == unlinkat(dir_fd, files_ptr[i].name_ptr, 0)) {
+                total_bytes -= files_ptr[i].size;
+            }
+        }
+    }
+
+    for (size_t i = 0; i < files; ++i) free(files_ptr[i].name_ptr);
+    if (NULL != files_ptr) free(files_ptr);
+    closedir(dir_stream_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Returns whether the cache file is of an unknown format, or its source
+ * changed or is gone. Such files can never be hit again.
+ *
+ * @param dir_fd
+ * @param name_ptr
+ *
+ * @return true if obsolete.
+ */
+bool _wlmtk_raster_cache_file_obsolete(int dir_fd, const char *name_ptr)
+{
+    int fd = openat(dir_fd, name_ptr, O_RDONLY | O_CLOEXEC);
+    if (0 > fd) return false;
+    struct stat file_stat;
+    if (0 != fstat(fd, &file_stat)) {
+        close(fd);
+        return false;
+    }
+
+    // Header and source path, contiguous, as expected by the matcher.
+    char buf[sizeof(wlmtk_raster_cache_header_t) + PATH_MAX];
+    ssize_t n = pread(fd, buf, sizeof(buf) - 1, 0);
+    close(fd);
+    if (0 > n) return false;
+    const wlmtk_raster_cache_header_t *header_ptr = (void*)buf;
+    if ((size_t)n < sizeof(wlmtk_raster_cache_header_t) ||
+        header_ptr->path_len >= PATH_MAX ||
+        sizeof(wlmtk_raster_cache_header_t) + header_ptr->path_len >
+        (size_t)n) return true;
+
+    char path[PATH_MAX];
+    memcpy(path, header_ptr + 1, header_ptr->path_len);
+    path[header_ptr->path_len] = '\0';
+    struct stat source_stat;
+    if (0 != stat(path, &source_stat)) return true;
+    return !_wlmtk_raster_cache_header_matches(
+        header_ptr, path,
+        header_ptr->key_width, header_ptr->key_height, header_ptr->key_scale,
+        &source_stat, file_stat.st_size);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Orders @ref wlmtk_raster_cache_file_t by access time, oldest first. */
+int _wlmtk_raster_cache_file_compare(const void *f1_ptr, const void *f2_ptr)
+{
+    const struct timespec *t1_ptr =
+        &((const wlmtk_raster_cache_file_t*)f1_ptr)->atime;
+    const struct timespec *t2_ptr =
+        &((const wlmtk_raster_cache_file_t*)f2_ptr)->atime;
+    if (t1_ptr->tv_sec != t2_ptr->tv_sec) {
+        return t1_ptr->tv_sec < t2_ptr->tv_sec ? -1 : 1;
+    }
+    if (t1_ptr->tv_nsec != t2_ptr->tv_nsec) {
+        return t1_ptr->tv_nsec < t2_ptr->tv_nsec ? -1 : 1;
+    }
+    return 0;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Computes the path of the cache file for the key.
+ *
+ * The file name is a 64-bit FNV-1a hash of the key. The source's mtime and
+ * size are not part of it: A changed source overwrites its stale entry.
+ *
+ * @param path_ptr
+ * @param width
+ * @param height
+ * @param scale
+ * @param file_path_ptr
+ * @param size                Size of `file_path_ptr`.
+ *
+ * @return true on success, false if the cache is disabled or the path did
+ *     not fit.
+ */
+bool _wlmtk_raster_cache_file_path(
+    const char *path_ptr,
+    int width,
+    int height,
+    double scale,
+    char *file_path_ptr,
+    size_t size)
+{
+    if (NULL == _wlmtk_raster_cache_dir_ptr) return false;
+
+    int32_t key[2] = { BS_MAX(width, 0), BS_MAX(height, 0) };
+    uint64_t hash = UINT64_C(0xcbf29ce484222325);
+    for (const char *c_ptr = path_ptr; *c_ptr; ++c_ptr) {
+        hash = (hash ^ (uint8_t)*c_ptr) * UINT64_C(0x100000001b3);
+    }
+    for (size_t i = 0; i < sizeof(key); ++i) {
+        hash = (hash ^ ((uint8_t*)key)[i]) * UINT64_C(0x100000001b3);
+    }
+    for (size_t i = 0; i < sizeof(scale); ++i) {
+        hash = (hash ^ ((uint8_t*)&scale)[i]) * UINT64_C(0x100000001b3);
+    }
+
+    int rv = snprintf(file_path_ptr, size, "%s/%016"PRIx64".argb",
+                      _wlmtk_raster_cache_dir_ptr, hash);
+    return 0 <= rv && (size_t)rv < size;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Returns whether the header is valid, and matches key and source. */
+bool _wlmtk_raster_cache_header_matches(
+    const wlmtk_raster_cache_header_t *header_ptr,
+    const char *path_ptr,
+    int width,
+    int height,
+    double scale,
+    const struct stat *stat_ptr,
+    size_t file_size)
+{
+    if (0 != memcmp(header_ptr->magic, _wlmtk_raster_cache_magic,
+                    sizeof(header_ptr->magic)) ||
+        header_ptr->key_width != BS_MAX(width, 0) ||
+        header_ptr->key_height != BS_MAX(height, 0) ||
+        header_ptr->key_scale != scale ||
+        header_ptr->mtime_sec != stat_ptr->st_mtim.tv_sec ||
+        header_ptr->mtime_nsec != stat_ptr->st_mtim.tv_nsec ||
+        header_ptr->source_size != stat_ptr->st_size) return false;
+
+    // Hash collision: Another source with the same file name.
+    size_t path_len = strlen(path_ptr);
+    if (header_ptr->path_len != path_len ||
+        sizeof(wlmtk_raster_cache_header_t) + path_len > file_size ||
+        0 != memcmp(header_ptr + 1, path_ptr, path_len)) return false;
+
+    return (0 == header_ptr->data_offset % sizeof(uint32_t) &&
+            header_ptr->data_offset <= file_size &&
+            (uint64_t)header_ptr->width * header_ptr->height *
+            sizeof(uint32_t) <= file_size - header_ptr->data_offset);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Writes all `n` bytes at `data_ptr` to `fd`. */
+bool _wlmtk_raster_cache_write(int fd, const void *data_ptr, size_t n)
+{
+    const uint8_t *ptr = data_ptr;
+    while (0 < n) {
+        ssize_t written = write(fd, ptr, n);
+        if (0 > written) {
+            if (EINTR == errno) continue;
+            return false;
+        }
+        ptr += written;
+        n -= written;
+    }
+    return true;
+}
+
+/* == Unit tests =========================================================== */
+
+static void test_store_load(bs_test_t *test_ptr);
+static void test_prune(bs_test_t *test_ptr);
+
+const bs_test_case_t wlmtk_raster_cache_test_cases[] = {
+    { 1, "store_load", test_store_load },
+    { 1, "prune", test_prune },
+    { 0, NULL, NULL }
+};
+
+/* ------------------------------------------------------------------------- */
+/** Stores an image and loads it back through a mapping. */
+void test_store_load(bs_test_t *test_ptr)
+{
+    char dir[] = "/tmp/wlmtk_raster_cache_test_XXXXXX";
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, mkdtemp(dir));
+    char cache_dir[PATH_MAX];
+    snprintf(cache_dir, sizeof(cache_dir), "%s/sub/dir", dir);
+    const char *path_ptr = bs_test_resolve_path("toolkit/test_icon.png");
+
+    // Disabled: Stores are no-ops, loads miss.
+    struct wlr_buffer *wlr_buffer_ptr = bs_gfxbuf_create_wlr_buffer(3, 2);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, wlr_buffer_ptr);
+    bs_gfxbuf_t *gfxbuf_ptr = bs_gfxbuf_from_wlr_buffer(wlr_buffer_ptr);
+    bs_gfxbuf_clear(gfxbuf_ptr, 0x80402010);
+    *bs_gfxbuf_pixel_at(gfxbuf_ptr, 2, 1) = 0xff00ff00;
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_raster_cache_store(
+                            path_ptr, 3, 2, 1.0, wlr_buffer_ptr));
+    BS_TEST_VERIFY_EQ(test_ptr, NULL,
+                      wlmtk_raster_cache_load(path_ptr, 3, 2, 1.0));
+
+    BS_TEST_VERIFY_TRUE_OR_RETURN(test_ptr,
+                                  wlmtk_raster_cache_init(cache_dir));
+    BS_TEST_VERIFY_EQ(test_ptr, NULL,
+                      wlmtk_raster_cache_load(path_ptr, 3, 2, 1.0));
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_raster_cache_store(
+                            path_ptr, 3, 2, 1.0, wlr_buffer_ptr));
+    wlr_buffer_drop(wlr_buffer_ptr);
+
+    wlr_buffer_ptr = wlmtk_raster_cache_load(path_ptr, 3, 2, 1.0);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, wlr_buffer_ptr);
+    gfxbuf_ptr = bs_gfxbuf_from_wlr_buffer(wlr_buffer_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 3, gfxbuf_ptr->width);
+    BS_TEST_VERIFY_EQ(test_ptr, 2, gfxbuf_ptr->height);
+    BS_TEST_VERIFY_EQ(test_ptr, 0x80402010,
+                      *bs_gfxbuf_pixel_at(gfxbuf_ptr, 0, 0));
+    BS_TEST_VERIFY_EQ(test_ptr, 0xff00ff00,
+                      *bs_gfxbuf_pixel_at(gfxbuf_ptr, 2, 1));
+    wlr_buffer_drop(wlr_buffer_ptr);
+
+    // Other key: Misses.
+    BS_TEST_VERIFY_EQ(test_ptr, NULL,
+                      wlmtk_raster_cache_load(path_ptr, 3, 2, 2.0));
+    BS_TEST_VERIFY_EQ(test_ptr, NULL,
+                      wlmtk_raster_cache_load(path_ptr, 2, 2, 1.0));
+
+    char file_path[PATH_MAX];
+    BS_TEST_VERIFY_TRUE(test_ptr, _wlmtk_raster_cache_file_path(
+                            path_ptr, 3, 2, 1.0,
+                            file_path, sizeof(file_path)));
+    BS_TEST_VERIFY_EQ(test_ptr, 0, unlink(file_path));
+    wlmtk_raster_cache_fini();
+
+    BS_TEST_VERIFY_EQ(test_ptr, 0, rmdir(cache_dir));
+    snprintf(cache_dir, sizeof(cache_dir), "%s/sub", dir);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, rmdir(cache_dir));
+    BS_TEST_VERIFY_EQ(test_ptr, 0, rmdir(dir));
+}
+
+/* ------------------------------------------------------------------------- */
+/** Prunes obsolete files, then by size. Leaves other files alone. */
+void test_prune(bs_test_t *test_ptr)
+{
+    char dir[] = "/tmp/wlmtk_raster_cache_test_XXXXXX";
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, mkdtemp(dir));
+    const char *path_ptr = bs_test_resolve_path("toolkit/test_icon.png");
+
+    BS_TEST_VERIFY_TRUE_OR_RETURN(test_ptr, wlmtk_raster_cache_init(dir));
+    struct wlr_buffer *wlr_buffer_ptr = bs_gfxbuf_create_wlr_buffer(3, 2);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, wlr_buffer_ptr);
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_raster_cache_store(
+                            path_ptr, 3, 2, 1.0, wlr_buffer_ptr));
+    wlr_buffer_drop(wlr_buffer_ptr);
+    char file_path[PATH_MAX];
+    BS_TEST_VERIFY_TRUE(test_ptr, _wlmtk_raster_cache_file_path(
+                            path_ptr, 3, 2, 1.0,
+                            file_path, sizeof(file_path)));
+    wlmtk_raster_cache_fini();
+
+    // An entry in an unknown format, and a file that is not ours.
+    char obsolete_path[PATH_MAX], other_path[PATH_MAX];
+    snprintf(obsolete_path, sizeof(obsolete_path),
+             "%s/0123456789abcdef.argb", dir);
+    snprintf(other_path, sizeof(other_path), "%s/other", dir);
+    for (int i = 0; i < 2; ++i) {
+        FILE *file_ptr = fopen(0 == i ? obsolete_path : other_path, "w");
+        BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, file_ptr);
+        fputs("garbage", file_ptr);
+        fclose(file_ptr);
+    }
+
+    // Obsolete files are removed, valid and other files are kept.
+    _wlmtk_raster_cache_prune(dir, SIZE_MAX);
+    BS_TEST_VERIFY_NEQ(test_ptr, 0, access(obsolete_path, F_OK));
+    BS_TEST_VERIFY_EQ(test_ptr, 0, access(file_path, F_OK));
+    BS_TEST_VERIFY_EQ(test_ptr, 0, access(other_path, F_OK));
+
+    // Above the size limit: Removes the cached images, only.
+    _wlmtk_raster_cache_prune(dir, 0);
+    BS_TEST_VERIFY_NEQ(test_ptr, 0, access(file_path, F_OK));
+    BS_TEST_VERIFY_EQ(test_ptr, 0, unlink(other_path));
+
+    BS_TEST_VERIFY_EQ(test_ptr, 0, rmdir(dir));
+}
+
+/* == End of raster_cache.c ================================================ */
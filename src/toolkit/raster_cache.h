@@ -0,0 +1,102 @@
+/* ========================================================================= */
+/**
+ * @file raster_cache.h
+ *
+ * @copyright
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __WLMTK_RASTER_CACHE_H__
+#define __WLMTK_RASTER_CACHE_H__
+
+#include <libbase/libbase.h>
+
+/** Forward declaration. */
+struct wlr_buffer;
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+/**
+ * Enables the on-disk cache of scaled images.
+ *
+ * Each image is stored as raw premultiplied ARGB32 pixels, keyed by source
+ * path, target size and scale, and tagged with the source's mtime and size.
+ * Cached images are memory-mapped, without decoding.
+ *
+ * Prunes the directory first: Files whose source changed or is gone are
+ * removed, and then the least recently used ones, to keep the directory
+ * within a size limit.
+ *
+ * Must be called before any image is loaded, and not concurrently with
+ * @ref wlmtk_raster_cache_load or @ref wlmtk_raster_cache_store.
+ *
+ * @param dir_ptr             Directory to store the images in. Will be
+ *                            created, if needed. NULL for the default of
+ *                            `$XDG_CACHE_HOME/wlmaker`, or
+ *                            `$HOME/.cache/wlmaker`.
+ *
+ * @return true on success.
+ */
+bool wlmtk_raster_cache_init(const char *dir_ptr);
+
+/** Disables the on-disk cache. Files are kept. */
+void wlmtk_raster_cache_fini(void);
+
+/**
+ * Loads a scaled image from the on-disk cache. Thread-safe.
+ *
+ * @param path_ptr            Path of the source image.
+ * @param width
+ * @param height
+ * @param scale
+ *
+ * @return A wlr_buffer, to be released by wlr_buffer_drop(). NULL if the
+ *     cache is disabled, has no entry, or the source changed since.
+ */
+struct wlr_buffer *wlmtk_raster_cache_load(
+    const char *path_ptr,
+    int width,
+    int height,
+    double scale);
+
+/**
+ * Stores a scaled image in the on-disk cache. Thread-safe.
+ *
+ * @param path_ptr            Path of the source image.
+ * @param width
+ * @param height
+ * @param scale
+ * @param wlr_buffer_ptr      The scaled image. Must have been created by
+ *                            @ref bs_gfxbuf_create_wlr_buffer.
+ *
+ * @return true on success, or if the cache is disabled.
+ */
+bool wlmtk_raster_cache_store(
+    const char *path_ptr,
+    int width,
+    int height,
+    double scale,
+    struct wlr_buffer *wlr_buffer_ptr);
+
+/** Unit test cases. */
+extern const bs_test_case_t wlmtk_raster_cache_test_cases[];
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif /* __WLMTK_RASTER_CACHE_H__ */
+/* == End of raster_cache.h ================================================ */
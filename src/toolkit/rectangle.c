@@ -117,6 +117,10 @@ void wlmtk_rectangle_set_size(
     int width,
     int height)
 {
+    if (rectangle_ptr->width != width || rectangle_ptr->height != height) {
+        wlmtk_element_invalidate_parent_geometry(
+            &rectangle_ptr->super_element);
+    }
     rectangle_ptr->width = width;
     rectangle_ptr->height = height;
 
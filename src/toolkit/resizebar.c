@@ -167,7 +167,6 @@ bool wlmtk_resizebar_set_width(
     if (resizebar_ptr->width == width) return true;
     if (!redraw_buffers(resizebar_ptr, width)) return false;
     BS_ASSERT(width == resizebar_ptr->width);
-    BS_ASSERT(width == resizebar_ptr->gfxbuf_ptr->width);
 
     int right_corner_width = BS_MIN(
         (int)width, (int)resizebar_ptr->style.corner_width);
@@ -232,13 +231,27 @@ void _wlmtk_resizebar_element_destroy(wlmtk_element_t *element_ptr)
 }
 
 /* ------------------------------------------------------------------------- */
-/** Redraws the resizebar's background in appropriate size. */
+/**
+ * Redraws the resizebar's background in appropriate size.
+ *
+ * A fill that is the same in every column is drawn just 1 pixel wide, once.
+ * The areas stretch it, see @ref wlmaker_primitives_copy_area.
+ */
 bool redraw_buffers(wlmtk_resizebar_t *resizebar_ptr, unsigned width)
 {
     cairo_t *cairo_ptr;
 
+    unsigned gfxbuf_width = width;
+    if (wlmaker_primitives_fill_is_columnar(&resizebar_ptr->style.fill)) {
+        gfxbuf_width = 1;
+        if (NULL != resizebar_ptr->gfxbuf_ptr) {
+            resizebar_ptr->width = width;
+            return true;
+        }
+    }
+
     bs_gfxbuf_t *gfxbuf_ptr = bs_gfxbuf_create(
-        width, resizebar_ptr->style.height);
+        gfxbuf_width, resizebar_ptr->style.height);
     if (NULL == gfxbuf_ptr) return false;
     cairo_ptr = cairo_create_from_bs_gfxbuf(gfxbuf_ptr);
     if (NULL == cairo_ptr) {
@@ -307,6 +320,8 @@ void test_variable_width(bs_test_t *test_ptr)
     // Sufficient space for all the elements.
     BS_TEST_VERIFY_TRUE(
         test_ptr, wlmtk_resizebar_set_width(resizebar_ptr, 33));
+    // A solid fill: The background is just one column, stretched.
+    BS_TEST_VERIFY_EQ(test_ptr, 1, resizebar_ptr->gfxbuf_ptr->width);
     BS_TEST_VERIFY_TRUE(test_ptr, left_elem_ptr->visible);
     BS_TEST_VERIFY_TRUE(test_ptr, center_elem_ptr->visible);
     BS_TEST_VERIFY_TRUE(test_ptr, right_elem_ptr->visible);
@@ -283,7 +283,7 @@ struct wlr_buffer *create_buffer(
         width, style_ptr->height);
     if (NULL == wlr_buffer_ptr) return NULL;
 
-    bs_gfxbuf_copy_area(
+    wlmaker_primitives_copy_area(
         bs_gfxbuf_from_wlr_buffer(wlr_buffer_ptr), 0, 0,
         gfxbuf_ptr, position, 0, width, style_ptr->height);
 
@@ -59,7 +59,8 @@ void wlmtk_resizebar_area_destroy(
  * Redraws the element, with updated position and width.
  *
  * @param resizebar_area_ptr
- * @param gfxbuf_ptr
+ * @param gfxbuf_ptr          Resizebar background. May be 1 pixel wide, for
+ *                            a columnar fill that gets stretched.
  * @param position
  * @param width
  * @param style_ptr
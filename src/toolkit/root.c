@@ -129,6 +129,7 @@ wlmtk_root_t *wlmtk_root_create(
     wl_signal_init(&root_ptr->events.window_mapped);
     wl_signal_init(&root_ptr->events.window_unmapped);
     wl_signal_init(&root_ptr->events.unclaimed_button_event);
+    wl_signal_init(&root_ptr->events.pre_frame);
     return root_ptr;
 }
 
@@ -160,6 +161,14 @@ wlmtk_root_events_t *wlmtk_root_events(wlmtk_root_t *root_ptr)
     return &root_ptr->events;
 }
 
+/* ------------------------------------------------------------------------- */
+void wlmtk_root_pre_frame(
+    wlmtk_root_t *root_ptr,
+    struct wlr_output *wlr_output_ptr)
+{
+    wl_signal_emit(&root_ptr->events.pre_frame, wlr_output_ptr);
+}
+
 /* ------------------------------------------------------------------------- */
 void wlmtk_root_set_extents(
     wlmtk_root_t *root_ptr,
@@ -29,6 +29,8 @@ typedef struct _wlmtk_root_t wlmtk_root_t;
 
 /** Forward declaration: Wlroots scene. */
 struct wlr_scene;
+/** Forward declaration: Wlroots output. */
+struct wlr_output;
 
 #ifdef __cplusplus
 extern "C" {
@@ -51,6 +53,12 @@ typedef struct {
 
     /** An unclaimed pointer event. Arg: @ref wlmtk_button_event_t. */
     struct wl_signal          unclaimed_button_event;
+
+    /**
+     * Triggers right before an output renders a frame. For deferred work that
+     * needs to be done at most once per frame. Data: The `struct wlr_output`.
+     */
+    struct wl_signal          pre_frame;
 } wlmtk_root_events_t;
 
 /**
@@ -81,6 +89,17 @@ void wlmtk_root_destroy(wlmtk_root_t *root_ptr);
  */
 wlmtk_root_events_t *wlmtk_root_events(wlmtk_root_t *root_ptr);
 
+/**
+ * Signals that `wlr_output_ptr` is about to render a frame: Emits
+ * @ref wlmtk_root_events_t::pre_frame.
+ *
+ * @param root_ptr
+ * @param wlr_output_ptr
+ */
+void wlmtk_root_pre_frame(
+    wlmtk_root_t *root_ptr,
+    struct wlr_output *wlr_output_ptr);
+
 /**
  * Sets the extents of root (and all workspaces thereof).
  *
@@ -687,6 +687,9 @@ void _wlmtk_surface_handle_surface_unmap(
 /**
  * Surface commits a new size: Store the size, and update the parent's layout.
  *
+ * Most commits just update the surface's contents. The parent's layout is
+ * updated only if the size or the extents (including subsurfaces) changed.
+ *
  * @param surface_ptr
  * @param width
  * @param height
@@ -696,12 +699,19 @@ void _wlmtk_surface_commit_size(
     int width,
     int height)
 {
-    if (surface_ptr->committed_width != width ||
-        surface_ptr->committed_height != height) {
-        surface_ptr->committed_width = width;
-        surface_ptr->committed_height = height;
+    struct wlr_box extents = { .width = width, .height = height };
+    if (NULL != surface_ptr->wlr_surface_ptr) {
+        wlr_surface_get_extends(surface_ptr->wlr_surface_ptr, &extents);
     }
 
+    if (surface_ptr->committed_width == width &&
+        surface_ptr->committed_height == height &&
+        wlr_box_equal(&surface_ptr->committed_extents, &extents)) return;
+
+    surface_ptr->committed_width = width;
+    surface_ptr->committed_height = height;
+    surface_ptr->committed_extents = extents;
+
     if (NULL != surface_ptr->super_element.parent_container_ptr) {
         wlmtk_container_update_layout(
             surface_ptr->super_element.parent_container_ptr);
@@ -63,6 +63,8 @@ struct _wlmtk_surface_t {
     int                       committed_width;
     /** Committed height of the surface, in pixels. */
     int                       committed_height;
+    /** Extents of surface and subsurfaces, as of the last commit. */
+    struct wlr_box            committed_extents;
 
     /** Listener for the `events.commit` signal of `wlr_surface`. */
     struct wl_listener        surface_commit_listener;
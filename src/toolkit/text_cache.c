@@ -0,0 +1,470 @@
+/* ========================================================================= */
+/**
+ * @file text_cache.c
+ *
+ * @copyright
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "text_cache.h"
+
+#include <inttypes.h>
+#include <math.h>
+
+/* == Declarations ========================================================= */
+
+/** Key of a cached text. */
+typedef struct {
+    /** Font face family name. */
+    const char                *face_ptr;
+    /** Weight. */
+    wlmtk_style_font_weight_t weight;
+    /** Size of the font, in pixels per "em" square side. */
+    uint64_t                  size;
+    /** The text. */
+    const char                *text_ptr;
+} wlmtk_text_cache_key_t;
+
+/** An entry of the text cache. */
+typedef struct {
+    /** Node of @ref _wlmtk_text_cache_tree_ptr. */
+    bs_avltree_node_t         avlnode;
+    /** Node of @ref _wlmtk_text_cache_lru. */
+    bs_dllist_node_t          dlnode;
+    /** The key. Owns a copy of the face and the text. */
+    wlmtk_text_cache_key_t    key;
+    /** The mask. NULL if the text has no visible pixels. */
+    cairo_surface_t           *surface_ptr;
+    /** Horizontal offset of the mask from the text's origin. */
+    int                       x;
+    /** Vertical offset of the mask from the text's baseline. */
+    int                       y;
+    /** Size of the mask and the entry itself, in bytes. Never 0. */
+    size_t                    bytes;
+} wlmtk_text_cache_entry_t;
+
+static wlmtk_text_cache_entry_t *_wlmtk_text_cache_entry_create(
+    const wlmtk_text_cache_key_t *key_ptr);
+static void _wlmtk_text_cache_entry_destroy(
+    wlmtk_text_cache_entry_t *entry_ptr);
+static void _wlmtk_text_cache_remove(wlmtk_text_cache_entry_t *entry_ptr);
+static void _wlmtk_text_cache_evict(void);
+static bool _wlmtk_text_cache_render(wlmtk_text_cache_entry_t *entry_ptr);
+static void _wlmtk_text_cache_set_font(
+    cairo_t *cairo_ptr,
+    const wlmtk_text_cache_key_t *key_ptr);
+static int _wlmtk_text_cache_node_cmp(
+    const bs_avltree_node_t *node_ptr,
+    const void *key_ptr);
+static void _wlmtk_text_cache_node_destroy(bs_avltree_node_t *node_ptr);
+
+/* == Data ================================================================= */
+
+/** Cached texts, as @ref wlmtk_text_cache_entry_t. Created on first use. */
+static bs_avltree_t *_wlmtk_text_cache_tree_ptr = NULL;
+/** Entries in order of use. The head is the most recently used. */
+static bs_dllist_t _wlmtk_text_cache_lru = {};
+/** Limit for the total size of all cached entries. */
+static size_t _wlmtk_text_cache_max_bytes = 1 << 20;
+/** Statistics. */
+static wlmtk_text_cache_stats_t _wlmtk_text_cache_stats = {};
+
+/* == Exported methods ===================================================== */
+
+/* ------------------------------------------------------------------------- */
+cairo_surface_t *wlmtk_text_cache_get(
+    const wlmtk_style_font_t *font_style_ptr,
+    const char *text_ptr,
+    int *x_ptr,
+    int *y_ptr)
+{
+    if (NULL == _wlmtk_text_cache_tree_ptr) {
+        _wlmtk_text_cache_tree_ptr = bs_avltree_create(
+            _wlmtk_text_cache_node_cmp,
+            _wlmtk_text_cache_node_destroy);
+        if (NULL == _wlmtk_text_cache_tree_ptr) return NULL;
+    }
+
+    wlmtk_text_cache_key_t key = {
+        .face_ptr = font_style_ptr->face,
+        .weight = font_style_ptr->weight,
+        .size = font_style_ptr->size,
+        .text_ptr = text_ptr
+    };
+    wlmtk_text_cache_entry_t *entry_ptr;
+    bs_avltree_node_t *avlnode_ptr = bs_avltree_lookup(
+        _wlmtk_text_cache_tree_ptr, &key);
+    if (NULL != avlnode_ptr) {
+        ++_wlmtk_text_cache_stats.hits;
+        entry_ptr = BS_CONTAINER_OF(
+            avlnode_ptr, wlmtk_text_cache_entry_t, avlnode);
+        bs_dllist_remove(&_wlmtk_text_cache_lru, &entry_ptr->dlnode);
+        bs_dllist_push_front(&_wlmtk_text_cache_lru, &entry_ptr->dlnode);
+    } else {
+        ++_wlmtk_text_cache_stats.misses;
+        entry_ptr = _wlmtk_text_cache_entry_create(&key);
+        if (NULL == entry_ptr) return NULL;
+        if (!bs_avltree_insert(_wlmtk_text_cache_tree_ptr, &entry_ptr->key,
+                               &entry_ptr->avlnode, false)) {
+            _wlmtk_text_cache_entry_destroy(entry_ptr);
+            return NULL;
+        }
+        bs_dllist_push_front(&_wlmtk_text_cache_lru, &entry_ptr->dlnode);
+        ++_wlmtk_text_cache_stats.entries;
+        _wlmtk_text_cache_stats.bytes += entry_ptr->bytes;
+    }
+
+    if (NULL == entry_ptr->surface_ptr) {
+        _wlmtk_text_cache_evict();
+        return NULL;
+    }
+    *x_ptr = entry_ptr->x;
+    *y_ptr = entry_ptr->y;
+    // Keeps the just-used entry: Evicting it would drop the last reference.
+    cairo_surface_t *surface_ptr = cairo_surface_reference(
+        entry_ptr->surface_ptr);
+    _wlmtk_text_cache_evict();
+    return surface_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_text_cache_set_limit(size_t max_bytes)
+{
+    _wlmtk_text_cache_max_bytes = max_bytes;
+    _wlmtk_text_cache_evict();
+}
+
+/* ------------------------------------------------------------------------- */
+wlmtk_text_cache_stats_t wlmtk_text_cache_stats(void)
+{
+    return _wlmtk_text_cache_stats;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_text_cache_fini(void)
+{
+    if (0 < _wlmtk_text_cache_stats.hits + _wlmtk_text_cache_stats.misses) {
+        bs_log(BS_INFO, "Text cache: %"PRIu64" hits, %"PRIu64" misses, "
+               "%zu entries, %zu bytes.",
+               _wlmtk_text_cache_stats.hits,
+               _wlmtk_text_cache_stats.misses,
+               _wlmtk_text_cache_stats.entries,
+               _wlmtk_text_cache_stats.bytes);
+    }
+
+    if (NULL != _wlmtk_text_cache_tree_ptr) {
+        bs_avltree_destroy(_wlmtk_text_cache_tree_ptr);
+        _wlmtk_text_cache_tree_ptr = NULL;
+    }
+    _wlmtk_text_cache_lru = (bs_dllist_t){};
+    _wlmtk_text_cache_stats = (wlmtk_text_cache_stats_t){};
+}
+
+/* == Local (static) methods =============================================== */
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Creates a cache entry. Copies the key's face and text, and renders the
+ * text into the mask.
+ *
+ * @param key_ptr
+ *
+ * @return Pointer to the entry, or NULL on error.
+ */
+wlmtk_text_cache_entry_t *_wlmtk_text_cache_entry_create(
+    const wlmtk_text_cache_key_t *key_ptr)
+{
+    wlmtk_text_cache_entry_t *entry_ptr = logged_calloc(
+        1, sizeof(wlmtk_text_cache_entry_t));
+    if (NULL == entry_ptr) return NULL;
+
+    entry_ptr->key = *key_ptr;
+    entry_ptr->key.face_ptr = logged_strdup(key_ptr->face_ptr);
+    entry_ptr->key.text_ptr = logged_strdup(key_ptr->text_ptr);
+    if (NULL == entry_ptr->key.face_ptr ||
+        NULL == entry_ptr->key.text_ptr ||
+        !_wlmtk_text_cache_render(entry_ptr)) {
+        _wlmtk_text_cache_entry_destroy(entry_ptr);
+        return NULL;
+    }
+    // Charges the entry's own memory: Blank texts have no mask, but must
+    // still count towards the limit.
+    entry_ptr->bytes += sizeof(wlmtk_text_cache_entry_t) +
+        strlen(entry_ptr->key.face_ptr) + 1 +
+        strlen(entry_ptr->key.text_ptr) + 1;
+    return entry_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Destroys the entry. Does not remove it from the tree or the LRU list. */
+void _wlmtk_text_cache_entry_destroy(wlmtk_text_cache_entry_t *entry_ptr)
+{
+    if (NULL != entry_ptr->surface_ptr) {
+        cairo_surface_destroy(entry_ptr->surface_ptr);
+        entry_ptr->surface_ptr = NULL;
+    }
+    // Safe: We own the copies, see _wlmtk_text_cache_entry_create.
+    if (NULL != entry_ptr->key.text_ptr) {
+        free((char*)entry_ptr->key.text_ptr);
+        entry_ptr->key.text_ptr = NULL;
+    }
+    if (NULL != entry_ptr->key.face_ptr) {
+        free((char*)entry_ptr->key.face_ptr);
+        entry_ptr->key.face_ptr = NULL;
+    }
+    free(entry_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Removes the entry from the cache, and destroys it. */
+void _wlmtk_text_cache_remove(wlmtk_text_cache_entry_t *entry_ptr)
+{
+    bs_avltree_delete(_wlmtk_text_cache_tree_ptr, &entry_ptr->key);
+    bs_dllist_remove(&_wlmtk_text_cache_lru, &entry_ptr->dlnode);
+    --_wlmtk_text_cache_stats.entries;
+    _wlmtk_text_cache_stats.bytes -= entry_ptr->bytes;
+    _wlmtk_text_cache_entry_destroy(entry_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Evicts least recently used entries, until within the limit. */
+void _wlmtk_text_cache_evict(void)
+{
+    while (_wlmtk_text_cache_stats.bytes > _wlmtk_text_cache_max_bytes &&
+           NULL != _wlmtk_text_cache_lru.tail_ptr) {
+        _wlmtk_text_cache_remove(BS_CONTAINER_OF(
+            _wlmtk_text_cache_lru.tail_ptr,
+            wlmtk_text_cache_entry_t, dlnode));
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Renders the entry's text into an alpha mask, just covering the text's ink
+ * extents. Rendering is identical to `cairo_show_text` onto an image surface
+ * at an integer position.
+ *
+ * @param entry_ptr
+ *
+ * @return true on success.
+ */
+bool _wlmtk_text_cache_render(wlmtk_text_cache_entry_t *entry_ptr)
+{
+    // Measures the text on a scratch surface.
+    cairo_surface_t *surface_ptr = cairo_image_surface_create(
+        CAIRO_FORMAT_A8, 1, 1);
+    cairo_t *cairo_ptr = cairo_create(surface_ptr);
+    cairo_surface_destroy(surface_ptr);
+    _wlmtk_text_cache_set_font(cairo_ptr, &entry_ptr->key);
+    cairo_text_extents_t extents;
+    cairo_text_extents(cairo_ptr, entry_ptr->key.text_ptr, &extents);
+    cairo_status_t status = cairo_status(cairo_ptr);
+    cairo_destroy(cairo_ptr);
+    if (CAIRO_STATUS_SUCCESS != status) {
+        bs_log(BS_ERROR, "Failed cairo_text_extents(\"%s\"): %s",
+               entry_ptr->key.text_ptr, cairo_status_to_string(status));
+        return false;
+    }
+    if (0 >= extents.width || 0 >= extents.height) return true;
+
+    // One pixel of margin, for antialiasing beyond the ink extents.
+    entry_ptr->x = floor(extents.x_bearing) - 1;
+    entry_ptr->y = floor(extents.y_bearing) - 1;
+    int width = ceil(extents.x_bearing + extents.width) + 1 - entry_ptr->x;
+    int height = ceil(extents.y_bearing + extents.height) + 1 - entry_ptr->y;
+
+    surface_ptr = cairo_image_surface_create(CAIRO_FORMAT_A8, width, height);
+    if (CAIRO_STATUS_SUCCESS != cairo_surface_status(surface_ptr)) {
+        bs_log(BS_ERROR, "Failed cairo_image_surface_create(A8, %d, %d): %s",
+               width, height,
+               cairo_status_to_string(cairo_surface_status(surface_ptr)));
+        cairo_surface_destroy(surface_ptr);
+        return false;
+    }
+    cairo_ptr = cairo_create(surface_ptr);
+    _wlmtk_text_cache_set_font(cairo_ptr, &entry_ptr->key);
+    cairo_move_to(cairo_ptr, -entry_ptr->x, -entry_ptr->y);
+    cairo_show_text(cairo_ptr, entry_ptr->key.text_ptr);
+    cairo_destroy(cairo_ptr);
+    cairo_surface_flush(surface_ptr);
+
+    entry_ptr->surface_ptr = surface_ptr;
+    entry_ptr->bytes = (size_t)cairo_image_surface_get_stride(surface_ptr) *
+        (size_t)height;
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Selects the key's font face, weight and size into `cairo_ptr`. */
+void _wlmtk_text_cache_set_font(
+    cairo_t *cairo_ptr,
+    const wlmtk_text_cache_key_t *key_ptr)
+{
+    cairo_select_font_face(
+        cairo_ptr,
+        key_ptr->face_ptr,
+        CAIRO_FONT_SLANT_NORMAL,
+        wlmtk_style_font_weight_cairo_from_wlmtk(key_ptr->weight));
+    cairo_set_font_size(cairo_ptr, key_ptr->size);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Comparator for @ref _wlmtk_text_cache_tree_ptr nodes. */
+int _wlmtk_text_cache_node_cmp(
+    const bs_avltree_node_t *node_ptr,
+    const void *key_ptr)
+{
+    const wlmtk_text_cache_key_t *k1_ptr = &BS_CONTAINER_OF(
+        node_ptr, wlmtk_text_cache_entry_t, avlnode)->key;
+    const wlmtk_text_cache_key_t *k2_ptr = key_ptr;
+
+    if (k1_ptr->size != k2_ptr->size) {
+        return k1_ptr->size < k2_ptr->size ? -1 : 1;
+    }
+    if (k1_ptr->weight != k2_ptr->weight) {
+        return k1_ptr->weight < k2_ptr->weight ? -1 : 1;
+    }
+    int rv = strcmp(k1_ptr->face_ptr, k2_ptr->face_ptr);
+    if (0 != rv) return rv;
+    return strcmp(k1_ptr->text_ptr, k2_ptr->text_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Destructor for @ref _wlmtk_text_cache_tree_ptr nodes. */
+void _wlmtk_text_cache_node_destroy(bs_avltree_node_t *node_ptr)
+{
+    _wlmtk_text_cache_entry_destroy(BS_CONTAINER_OF(
+        node_ptr, wlmtk_text_cache_entry_t, avlnode));
+}
+
+/* == Unit tests =========================================================== */
+
+static void test_get(bs_test_t *test_ptr);
+static void test_evict(bs_test_t *test_ptr);
+
+const bs_test_case_t wlmtk_text_cache_test_cases[] = {
+    { 1, "get", test_get },
+    { 1, "evict", test_evict },
+    { 0, NULL, NULL }
+};
+
+/** Font used in the tests. */
+static const wlmtk_style_font_t _wlmtk_text_cache_test_font = {
+    .face = "Helvetica",
+    .weight = WLMTK_FONT_WEIGHT_BOLD,
+    .size = 15
+};
+
+/* ------------------------------------------------------------------------- */
+/** Exercises lookup, sharing and the statistics. */
+void test_get(bs_test_t *test_ptr)
+{
+    int x, y;
+    cairo_surface_t *s1_ptr = wlmtk_text_cache_get(
+        &_wlmtk_text_cache_test_font, "Title", &x, &y);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, s1_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, CAIRO_FORMAT_A8,
+                      cairo_image_surface_get_format(s1_ptr));
+    BS_TEST_VERIFY_TRUE(test_ptr, 0 > y);
+    wlmtk_text_cache_stats_t stats = wlmtk_text_cache_stats();
+    BS_TEST_VERIFY_EQ(test_ptr, 0, stats.hits);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, stats.misses);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, stats.entries);
+    BS_TEST_VERIFY_EQ(
+        test_ptr,
+        (size_t)cairo_image_surface_get_stride(s1_ptr) *
+        (size_t)cairo_image_surface_get_height(s1_ptr) +
+        sizeof(wlmtk_text_cache_entry_t) +
+        sizeof("Helvetica") + sizeof("Title"),
+        stats.bytes);
+
+    // Same key: Shares the mask.
+    int x2, y2;
+    cairo_surface_t *s2_ptr = wlmtk_text_cache_get(
+        &_wlmtk_text_cache_test_font, "Title", &x2, &y2);
+    BS_TEST_VERIFY_EQ(test_ptr, s1_ptr, s2_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, x, x2);
+    BS_TEST_VERIFY_EQ(test_ptr, y, y2);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, wlmtk_text_cache_stats().hits);
+
+    // Other weight: A new entry.
+    wlmtk_style_font_t font = _wlmtk_text_cache_test_font;
+    font.weight = WLMTK_FONT_WEIGHT_NORMAL;
+    cairo_surface_t *s3_ptr = wlmtk_text_cache_get(&font, "Title", &x2, &y2);
+    BS_TEST_VERIFY_NEQ(test_ptr, NULL, s3_ptr);
+    BS_TEST_VERIFY_NEQ(test_ptr, s1_ptr, s3_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 2, wlmtk_text_cache_stats().entries);
+
+    // Blank text: Nothing to draw, but cached nonetheless.
+    BS_TEST_VERIFY_EQ(
+        test_ptr, NULL,
+        wlmtk_text_cache_get(&_wlmtk_text_cache_test_font, " ", &x2, &y2));
+    BS_TEST_VERIFY_EQ(test_ptr, 3, wlmtk_text_cache_stats().entries);
+
+    if (NULL != s3_ptr) cairo_surface_destroy(s3_ptr);
+    cairo_surface_destroy(s2_ptr);
+    cairo_surface_destroy(s1_ptr);
+    wlmtk_text_cache_fini();
+    BS_TEST_VERIFY_EQ(test_ptr, 0, wlmtk_text_cache_stats().entries);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Verifies entries are evicted in least-recently-used order. */
+void test_evict(bs_test_t *test_ptr)
+{
+    const wlmtk_style_font_t *f_ptr = &_wlmtk_text_cache_test_font;
+    cairo_surface_t *s_ptr;
+    int x, y;
+
+    s_ptr = wlmtk_text_cache_get(f_ptr, "A", &x, &y);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, s_ptr);
+    cairo_surface_destroy(s_ptr);
+    s_ptr = wlmtk_text_cache_get(f_ptr, "B", &x, &y);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, s_ptr);
+    cairo_surface_destroy(s_ptr);
+    s_ptr = wlmtk_text_cache_get(f_ptr, "A", &x, &y);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, s_ptr);
+    cairo_surface_destroy(s_ptr);
+    wlmtk_text_cache_stats_t stats = wlmtk_text_cache_stats();
+    BS_TEST_VERIFY_EQ(test_ptr, 1, stats.hits);
+    BS_TEST_VERIFY_EQ(test_ptr, 2, stats.misses);
+    BS_TEST_VERIFY_EQ(test_ptr, 2, stats.entries);
+
+    // Just below the current size: Evicts "B", which was used least recently.
+    wlmtk_text_cache_set_limit(stats.bytes - 1);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, wlmtk_text_cache_stats().entries);
+    s_ptr = wlmtk_text_cache_get(f_ptr, "A", &x, &y);
+    if (NULL != s_ptr) cairo_surface_destroy(s_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 2, wlmtk_text_cache_stats().hits);
+
+    // A limit of zero still returns a mask, but keeps nothing.
+    wlmtk_text_cache_set_limit(0);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, wlmtk_text_cache_stats().entries);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, wlmtk_text_cache_stats().bytes);
+    s_ptr = wlmtk_text_cache_get(f_ptr, "B", &x, &y);
+    BS_TEST_VERIFY_NEQ(test_ptr, NULL, s_ptr);
+    if (NULL != s_ptr) cairo_surface_destroy(s_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, wlmtk_text_cache_stats().entries);
+
+    // Blank texts have no mask, but are not kept beyond the limit either.
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, wlmtk_text_cache_get(f_ptr, " ", &x, &y));
+    BS_TEST_VERIFY_EQ(test_ptr, 0, wlmtk_text_cache_stats().entries);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, wlmtk_text_cache_stats().bytes);
+
+    wlmtk_text_cache_set_limit(1 << 20);
+    wlmtk_text_cache_fini();
+}
+
+/* == End of text_cache.c ================================================== */
@@ -0,0 +1,93 @@
+/* ========================================================================= */
+/**
+ * @file text_cache.h
+ *
+ * @copyright
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __WLMTK_TEXT_CACHE_H__
+#define __WLMTK_TEXT_CACHE_H__
+
+#include <cairo.h>
+#include <libbase/libbase.h>
+
+#include "style.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+/** Statistics of the text cache. */
+typedef struct {
+    /** Number of lookups that found a rendered text. */
+    uint64_t                  hits;
+    /** Number of lookups that had to render the text. */
+    uint64_t                  misses;
+    /** Number of texts currently held in the cache. */
+    size_t                    entries;
+    /** Total size of the currently held masks and entries, in bytes. */
+    size_t                    bytes;
+} wlmtk_text_cache_stats_t;
+
+/**
+ * Returns the text rendered as an alpha mask, for compositing with any color.
+ *
+ * Masks are cached process-wide, keyed by font face, weight, size and the
+ * text. Entries are evicted in least-recently-used order, once their total
+ * size, masks included, exceeds the limit set by
+ * @ref wlmtk_text_cache_set_limit.
+ *
+ * Not thread-safe: Must only be called from the main thread.
+ *
+ * @param font_style_ptr
+ * @param text_ptr
+ * @param x_ptr               Set to the horizontal offset of the mask from
+ *                            the text's origin.
+ * @param y_ptr               Set to the vertical offset of the mask from the
+ *                            text's baseline. Usually negative.
+ *
+ * @return An image surface of format CAIRO_FORMAT_A8, to be released by
+ *     cairo_surface_destroy(). NULL if the text has no visible pixels, or on
+ *     error.
+ */
+cairo_surface_t *wlmtk_text_cache_get(
+    const wlmtk_style_font_t *font_style_ptr,
+    const char *text_ptr,
+    int *x_ptr,
+    int *y_ptr);
+
+/**
+ * Sets the limit for the total size of cached entries. Evicts entries, if the
+ * cache is already above the new limit.
+ *
+ * @param max_bytes
+ */
+void wlmtk_text_cache_set_limit(size_t max_bytes);
+
+/** @return Statistics of the text cache. */
+wlmtk_text_cache_stats_t wlmtk_text_cache_stats(void);
+
+/** Logs the statistics, and releases all cached masks. */
+void wlmtk_text_cache_fini(void);
+
+/** Unit test cases. */
+extern const bs_test_case_t wlmtk_text_cache_test_cases[];
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif /* __WLMTK_TEXT_CACHE_H__ */
+/* == End of text_cache.h ================================================== */
@@ -26,6 +26,9 @@
 /* == Declarations ========================================================= */
 
 static void _wlmtk_tile_update_layout(wlmtk_container_t *container_ptr);
+static void _wlmtk_tile_center_element(
+    wlmtk_tile_t *tile_ptr,
+    wlmtk_element_t *element_ptr);
 
 static struct wlr_buffer *_wlmtk_tile_create_buffer(
     const wlmtk_tile_style_t *style_ptr);
@@ -137,10 +140,7 @@ void wlmtk_tile_set_content(
             bs_log(BS_WARNING, "Content size %d x %d > tile size %"PRIu64,
                    box.width, box.height, tile_ptr->style.size);
         }
-        wlmtk_element_set_position(
-            element_ptr,
-            ((int)tile_ptr->style.size - box.width) / 2,
-            ((int)tile_ptr->style.size - box.height) / 2);
+        _wlmtk_tile_center_element(tile_ptr, element_ptr);
     }
 }
 
@@ -168,10 +168,7 @@ void wlmtk_tile_set_overlay(
             bs_log(BS_WARNING, "Overlay size %d x %d > tile size %"PRIu64,
                    box.width, box.height, tile_ptr->style.size);
         }
-        wlmtk_element_set_position(
-            element_ptr,
-            ((int)tile_ptr->style.size - box.width) / 2,
-            ((int)tile_ptr->style.size - box.height) / 2);
+        _wlmtk_tile_center_element(tile_ptr, element_ptr);
     }
 }
 
@@ -184,9 +181,34 @@ wlmtk_element_t *wlmtk_tile_element(wlmtk_tile_t *tile_ptr)
 /* == Local (static) methods =============================================== */
 
 /* ------------------------------------------------------------------------- */
-/** Handles requests to update layout. Called when elements are added. */
-void _wlmtk_tile_update_layout(__UNUSED__ wlmtk_container_t *container_ptr)
+/**
+ * Handles requests to update layout. Called when elements are added, or
+ * when they change dimensions (eg. an image that finished loading).
+ */
+void _wlmtk_tile_update_layout(wlmtk_container_t *container_ptr)
+{
+    wlmtk_tile_t *tile_ptr = BS_CONTAINER_OF(
+        container_ptr, wlmtk_tile_t, super_container);
+
+    if (NULL != tile_ptr->content_element_ptr) {
+        _wlmtk_tile_center_element(tile_ptr, tile_ptr->content_element_ptr);
+    }
+    if (NULL != tile_ptr->overlay_element_ptr) {
+        _wlmtk_tile_center_element(tile_ptr, tile_ptr->overlay_element_ptr);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/** Positions `element_ptr` at the center of the tile. */
+void _wlmtk_tile_center_element(
+    wlmtk_tile_t *tile_ptr,
+    wlmtk_element_t *element_ptr)
 {
+    struct wlr_box box = wlmtk_element_get_dimensions_box(element_ptr);
+    wlmtk_element_set_position(
+        element_ptr,
+        ((int)tile_ptr->style.size - box.width) / 2,
+        ((int)tile_ptr->style.size - box.height) / 2);
 }
 
 /* ------------------------------------------------------------------------- */
@@ -243,6 +265,13 @@ static void test_init_fini(bs_test_t *test_ptr)
     BS_TEST_VERIFY_EQ(test_ptr, 8, x);
     BS_TEST_VERIFY_EQ(test_ptr, 14, y);
 
+    // Content changes dimensions: Gets re-centered.
+    wlmtk_fake_element_set_dimensions(fe_ptr, 32, 32);
+    wlmtk_container_update_layout(&tile.super_container);
+    wlmtk_element_get_position(&fe_ptr->element, &x, &y);
+    BS_TEST_VERIFY_EQ(test_ptr, 16, x);
+    BS_TEST_VERIFY_EQ(test_ptr, 16, y);
+
     wlmtk_tile_fini(&tile);
 }
 
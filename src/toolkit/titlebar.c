@@ -26,6 +26,7 @@
 #include "gfxbuf.h"
 #include "primitives.h"
 #include "titlebar_button.h"
+#include "titlebar_cache.h"
 #include "titlebar_title.h"
 #include "window.h"
 
@@ -50,10 +51,16 @@ struct _wlmtk_titlebar_t {
     /** Close button. */
     wlmtk_titlebar_button_t  *close_button_ptr;
 
-    /** Titlebar background, when focussed. */
-    bs_gfxbuf_t               *focussed_gfxbuf_ptr;
-    /** Titlebar background, when blurred. */
-    bs_gfxbuf_t               *blurred_gfxbuf_ptr;
+    /** Titlebar background, when focussed. Locked. NULL until needed. */
+    struct wlr_buffer         *focussed_wlr_buffer_ptr;
+    /** Titlebar background, when blurred. Locked. NULL until needed. */
+    struct wlr_buffer         *blurred_wlr_buffer_ptr;
+    /** The shared cache of rendered buffers, or NULL. */
+    wlmtk_titlebar_cache_t    *cache_ptr;
+    /** Hash of @ref wlmtk_titlebar_t::style, as key into the cache. */
+    uint64_t                  style_hash;
+    /** Timer for releasing the buffers of the variant not shown, or NULL. */
+    struct wl_event_source    *release_timer_event_source_ptr;
 
     /** Current width of the title bar. */
     unsigned                  width;
@@ -79,6 +86,13 @@ static bool redraw_buffers(
     wlmtk_titlebar_t *titlebar_ptr,
     unsigned width);
 static bool redraw(wlmtk_titlebar_t *titlebar_ptr);
+static struct wlr_buffer *_wlmtk_titlebar_create_background(
+    wlmtk_titlebar_t *titlebar_ptr,
+    unsigned width,
+    bool activated);
+static wlmtk_titlebar_cache_t *_wlmtk_titlebar_cache_ref(void);
+static int _wlmtk_titlebar_handle_release_timer(void *data_ptr);
+static void _wlmtk_titlebar_cache_unref(void);
 
 /* == Data ================================================================= */
 
@@ -87,6 +101,14 @@ static const wlmtk_element_vmt_t titlebar_element_vmt = {
     .destroy = _wlmtk_titlebar_element_destroy
 };
 
+/** Size limit for the rendered buffers cached across all titlebars. */
+static const size_t _wlmtk_titlebar_cache_max_bytes = 8 * 1024 * 1024;
+
+/** Cache of rendered backgrounds and titles, shared by all titlebars. */
+static wlmtk_titlebar_cache_t *_wlmtk_titlebar_cache_ptr = NULL;
+/** Number of titlebars referencing @ref _wlmtk_titlebar_cache_ptr. */
+static unsigned _wlmtk_titlebar_cache_references = 0;
+
 /** Default properties: All buttons shown. */
 static const uint32_t _wlmtk_titlebar_default_properties =
     WLMTK_TITLEBAR_PROPERTY_ICONIFY |
@@ -105,6 +127,9 @@ wlmtk_titlebar_t *wlmtk_titlebar_create(
     if (NULL == titlebar_ptr) return NULL;
     memcpy(&titlebar_ptr->style, style_ptr, sizeof(wlmtk_titlebar_style_t));
     titlebar_ptr->title_ptr = wlmtk_window_get_title(window_ptr);
+    titlebar_ptr->style_hash = wlmtk_titlebar_style_hash(style_ptr);
+    // A missing cache is not fatal: We'll just render every time.
+    titlebar_ptr->cache_ptr = _wlmtk_titlebar_cache_ref();
 
     if (!wlmtk_box_init(&titlebar_ptr->super_box, env_ptr,
                         WLMTK_BOX_HORIZONTAL,
@@ -116,6 +141,23 @@ wlmtk_titlebar_t *wlmtk_titlebar_create(
         &titlebar_ptr->super_box.super_container.super_element,
         &titlebar_element_vmt);
 
+    struct wl_event_loop *wl_event_loop_ptr = wlmtk_env_wl_event_loop(env_ptr);
+    if (0 < titlebar_ptr->style.inactive_release_delay &&
+        NULL != wl_event_loop_ptr) {
+        titlebar_ptr->release_timer_event_source_ptr = wl_event_loop_add_timer(
+            wl_event_loop_ptr,
+            _wlmtk_titlebar_handle_release_timer,
+            titlebar_ptr);
+        if (NULL == titlebar_ptr->release_timer_event_source_ptr) {
+            bs_log(BS_ERROR, "Failed wl_event_loop_add_timer(%p, %p, %p)",
+                   wl_event_loop_ptr,
+                   _wlmtk_titlebar_handle_release_timer,
+                   titlebar_ptr);
+            wlmtk_titlebar_destroy(titlebar_ptr);
+            return NULL;
+        }
+    }
+
     titlebar_ptr->titlebar_title_ptr = wlmtk_titlebar_title_create(
         env_ptr, window_ptr);
     if (NULL == titlebar_ptr->titlebar_title_ptr) {
@@ -161,6 +203,11 @@ wlmtk_titlebar_t *wlmtk_titlebar_create(
 /* ------------------------------------------------------------------------- */
 void wlmtk_titlebar_destroy(wlmtk_titlebar_t *titlebar_ptr)
 {
+    if (NULL != titlebar_ptr->release_timer_event_source_ptr) {
+        wl_event_source_remove(titlebar_ptr->release_timer_event_source_ptr);
+        titlebar_ptr->release_timer_event_source_ptr = NULL;
+    }
+
     if (NULL != titlebar_ptr->close_button_ptr) {
         wlmtk_box_remove_element(
             &titlebar_ptr->super_box,
@@ -185,17 +232,22 @@ void wlmtk_titlebar_destroy(wlmtk_titlebar_t *titlebar_ptr)
         titlebar_ptr->titlebar_title_ptr = NULL;
     }
 
-    if (NULL != titlebar_ptr->blurred_gfxbuf_ptr) {
-        bs_gfxbuf_destroy(titlebar_ptr->blurred_gfxbuf_ptr);
-        titlebar_ptr->blurred_gfxbuf_ptr = NULL;
+    if (NULL != titlebar_ptr->blurred_wlr_buffer_ptr) {
+        wlr_buffer_unlock(titlebar_ptr->blurred_wlr_buffer_ptr);
+        titlebar_ptr->blurred_wlr_buffer_ptr = NULL;
     }
-    if (NULL != titlebar_ptr->focussed_gfxbuf_ptr) {
-        bs_gfxbuf_destroy(titlebar_ptr->focussed_gfxbuf_ptr);
-        titlebar_ptr->focussed_gfxbuf_ptr = NULL;
+    if (NULL != titlebar_ptr->focussed_wlr_buffer_ptr) {
+        wlr_buffer_unlock(titlebar_ptr->focussed_wlr_buffer_ptr);
+        titlebar_ptr->focussed_wlr_buffer_ptr = NULL;
     }
 
     wlmtk_box_fini(&titlebar_ptr->super_box);
 
+    if (NULL != titlebar_ptr->cache_ptr) {
+        _wlmtk_titlebar_cache_unref();
+        titlebar_ptr->cache_ptr = NULL;
+    }
+
     free(titlebar_ptr);
 }
 
@@ -238,12 +290,33 @@ void wlmtk_titlebar_set_activated(
 {
     if (titlebar_ptr->activated == activated) return;
     titlebar_ptr->activated = activated;
+
+    // First time in this state: Draw the background, and pass it on.
+    struct wlr_buffer **wlr_buffer_ptr_ptr = activated ?
+        &titlebar_ptr->focussed_wlr_buffer_ptr :
+        &titlebar_ptr->blurred_wlr_buffer_ptr;
+    if (0 < titlebar_ptr->width && NULL == *wlr_buffer_ptr_ptr) {
+        *wlr_buffer_ptr_ptr = _wlmtk_titlebar_create_background(
+            titlebar_ptr, titlebar_ptr->width, activated);
+        if (NULL == *wlr_buffer_ptr_ptr || !redraw(titlebar_ptr)) {
+            bs_log(BS_WARNING, "Titlebar %p: Failed to draw %s background",
+                   titlebar_ptr, activated ? "focussed" : "blurred");
+        }
+    }
+
     wlmtk_titlebar_button_set_activated(
         titlebar_ptr->minimize_button_ptr, titlebar_ptr->activated);
     wlmtk_titlebar_title_set_activated(
         titlebar_ptr->titlebar_title_ptr, titlebar_ptr->activated);
     wlmtk_titlebar_button_set_activated(
         titlebar_ptr->close_button_ptr, titlebar_ptr->activated);
+
+    // (Re-)arms the timer for releasing the variant that is now hidden.
+    if (NULL != titlebar_ptr->release_timer_event_source_ptr) {
+        wl_event_source_timer_update(
+            titlebar_ptr->release_timer_event_source_ptr,
+            titlebar_ptr->style.inactive_release_delay);
+    }
 }
 
 /* ------------------------------------------------------------------------- */
@@ -320,44 +393,32 @@ void _wlmtk_titlebar_compute_positions(wlmtk_titlebar_t *titlebar_ptr)
 }
 
 /* ------------------------------------------------------------------------- */
-/** Redraws the titlebar's background in appropriate size. */
+/**
+ * Redraws the titlebar's background in appropriate size. Re-uses backgrounds
+ * from the shared cache, if available there.
+ *
+ * Only the background of the current state (focussed or blurred) is drawn.
+ * The other one is drawn once @ref wlmtk_titlebar_set_activated needs it.
+ */
 bool redraw_buffers(wlmtk_titlebar_t *titlebar_ptr, unsigned width)
 {
-    cairo_t *cairo_ptr;
+    struct wlr_buffer *wlr_buffer_ptr = _wlmtk_titlebar_create_background(
+        titlebar_ptr, width, titlebar_ptr->activated);
+    if (NULL == wlr_buffer_ptr) return false;
 
-    bs_gfxbuf_t *focussed_gfxbuf_ptr = bs_gfxbuf_create(
-        width, titlebar_ptr->style.height);
-    if (NULL == focussed_gfxbuf_ptr) return false;
-    cairo_ptr = cairo_create_from_bs_gfxbuf(focussed_gfxbuf_ptr);
-    if (NULL == cairo_ptr) {
-        bs_gfxbuf_destroy(focussed_gfxbuf_ptr);
-        return false;
+    if (NULL != titlebar_ptr->focussed_wlr_buffer_ptr) {
+        wlr_buffer_unlock(titlebar_ptr->focussed_wlr_buffer_ptr);
+        titlebar_ptr->focussed_wlr_buffer_ptr = NULL;
     }
-    wlmaker_primitives_cairo_fill(
-        cairo_ptr, &titlebar_ptr->style.focussed_fill);
-    cairo_destroy(cairo_ptr);
-
-    bs_gfxbuf_t *blurred_gfxbuf_ptr = bs_gfxbuf_create(
-        width, titlebar_ptr->style.height);
-    if (NULL == blurred_gfxbuf_ptr) return false;
-    cairo_ptr = cairo_create_from_bs_gfxbuf(blurred_gfxbuf_ptr);
-    if (NULL == cairo_ptr) {
-        bs_gfxbuf_destroy(blurred_gfxbuf_ptr);
-        bs_gfxbuf_destroy(focussed_gfxbuf_ptr);
-        return false;
+    if (NULL != titlebar_ptr->blurred_wlr_buffer_ptr) {
+        wlr_buffer_unlock(titlebar_ptr->blurred_wlr_buffer_ptr);
+        titlebar_ptr->blurred_wlr_buffer_ptr = NULL;
     }
-    wlmaker_primitives_cairo_fill(
-        cairo_ptr, &titlebar_ptr->style.blurred_fill);
-    cairo_destroy(cairo_ptr);
-
-    if (NULL != titlebar_ptr->focussed_gfxbuf_ptr) {
-        bs_gfxbuf_destroy(titlebar_ptr->focussed_gfxbuf_ptr);
-    }
-    titlebar_ptr->focussed_gfxbuf_ptr = focussed_gfxbuf_ptr;
-    if (NULL != titlebar_ptr->blurred_gfxbuf_ptr) {
-        bs_gfxbuf_destroy(titlebar_ptr->blurred_gfxbuf_ptr);
+    if (titlebar_ptr->activated) {
+        titlebar_ptr->focussed_wlr_buffer_ptr = wlr_buffer_ptr;
+    } else {
+        titlebar_ptr->blurred_wlr_buffer_ptr = wlr_buffer_ptr;
     }
-    titlebar_ptr->blurred_gfxbuf_ptr = blurred_gfxbuf_ptr;
     titlebar_ptr->width = width;
     return true;
 }
@@ -371,13 +432,15 @@ bool redraw(wlmtk_titlebar_t *titlebar_ptr)
 
     if (!wlmtk_titlebar_title_redraw(
             titlebar_ptr->titlebar_title_ptr,
-            titlebar_ptr->focussed_gfxbuf_ptr,
-            titlebar_ptr->blurred_gfxbuf_ptr,
+            titlebar_ptr->focussed_wlr_buffer_ptr,
+            titlebar_ptr->blurred_wlr_buffer_ptr,
             titlebar_ptr->title_position,
             titlebar_ptr->title_width,
             titlebar_ptr->activated,
             titlebar_ptr->title_ptr,
-            &titlebar_ptr->style)) {
+            &titlebar_ptr->style,
+            titlebar_ptr->style_hash,
+            titlebar_ptr->cache_ptr)) {
         return false;
     }
     wlmtk_element_set_visible(
@@ -386,8 +449,8 @@ bool redraw(wlmtk_titlebar_t *titlebar_ptr)
     if (0 < titlebar_ptr->title_position) {
         if (!wlmtk_titlebar_button_redraw(
                 titlebar_ptr->minimize_button_ptr,
-                titlebar_ptr->focussed_gfxbuf_ptr,
-                titlebar_ptr->blurred_gfxbuf_ptr,
+                titlebar_ptr->focussed_wlr_buffer_ptr,
+                titlebar_ptr->blurred_wlr_buffer_ptr,
                 0,
                 &titlebar_ptr->style)) {
             return false;
@@ -404,8 +467,8 @@ bool redraw(wlmtk_titlebar_t *titlebar_ptr)
     if (titlebar_ptr->close_position < (int)titlebar_ptr->width) {
         if (!wlmtk_titlebar_button_redraw(
                 titlebar_ptr->close_button_ptr,
-                titlebar_ptr->focussed_gfxbuf_ptr,
-                titlebar_ptr->blurred_gfxbuf_ptr,
+                titlebar_ptr->focussed_wlr_buffer_ptr,
+                titlebar_ptr->blurred_wlr_buffer_ptr,
                 titlebar_ptr->close_position,
                 &titlebar_ptr->style)) {
             return false;
@@ -422,6 +485,107 @@ bool redraw(wlmtk_titlebar_t *titlebar_ptr)
     return true;
 }
 
+/* ------------------------------------------------------------------------- */
+/**
+ * Returns the titlebar background, from the cache or freshly rendered.
+ *
+ * A fill that is the same in every column is rendered just 1 pixel wide. The
+ * title and buttons stretch it when cutting their strips, so that background
+ * is shared by titlebars of any width, and is not redrawn on resize.
+ *
+ * @param titlebar_ptr
+ * @param width
+ * @param activated           Whether to use the focussed or blurred fill.
+ *
+ * @return A locked `struct wlr_buffer`, to be released by calling
+ *     `wlr_buffer_unlock`. Or NULL on error.
+ */
+struct wlr_buffer *_wlmtk_titlebar_create_background(
+    wlmtk_titlebar_t *titlebar_ptr,
+    unsigned width,
+    bool activated)
+{
+    const wlmtk_style_fill_t *fill_ptr = activated ?
+        &titlebar_ptr->style.focussed_fill :
+        &titlebar_ptr->style.blurred_fill;
+    if (wlmaker_primitives_fill_is_columnar(fill_ptr)) width = 1;
+
+    const wlmtk_titlebar_cache_key_t key = {
+        .style_hash = titlebar_ptr->style_hash,
+        .style_ptr = &titlebar_ptr->style,
+        .activated = activated,
+        .titlebar_width = width,
+        .width = width
+    };
+    if (NULL != titlebar_ptr->cache_ptr) {
+        struct wlr_buffer *wlr_buffer_ptr = wlmtk_titlebar_cache_lookup(
+            titlebar_ptr->cache_ptr, &key);
+        if (NULL != wlr_buffer_ptr) return wlr_buffer_ptr;
+    }
+
+    struct wlr_buffer *wlr_buffer_ptr = bs_gfxbuf_create_wlr_buffer(
+        width, titlebar_ptr->style.height);
+    if (NULL == wlr_buffer_ptr) return NULL;
+    cairo_t *cairo_ptr = cairo_create_from_wlr_buffer(wlr_buffer_ptr);
+    if (NULL == cairo_ptr) {
+        wlr_buffer_drop(wlr_buffer_ptr);
+        return NULL;
+    }
+    wlmaker_primitives_cairo_fill(cairo_ptr, fill_ptr);
+    cairo_destroy(cairo_ptr);
+
+    // Swap the creator's reference for a lock, so the buffer is released
+    // once neither we nor the cache hold it.
+    struct wlr_buffer *locked_wlr_buffer_ptr = wlr_buffer_lock(wlr_buffer_ptr);
+    wlr_buffer_drop(wlr_buffer_ptr);
+    if (NULL != titlebar_ptr->cache_ptr) {
+        wlmtk_titlebar_cache_insert(
+            titlebar_ptr->cache_ptr, &key, locked_wlr_buffer_ptr);
+    }
+    return locked_wlr_buffer_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Handles the release timer: Releases the buffers of the variant (focussed
+ * or blurred) that is not shown. They get re-drawn when needed.
+ *
+ * @param data_ptr            Points to the @ref wlmtk_titlebar_t.
+ *
+ * @return 0.
+ */
+int _wlmtk_titlebar_handle_release_timer(void *data_ptr)
+{
+    wlmtk_titlebar_t *titlebar_ptr = data_ptr;
+    wlmtk_titlebar_button_release_inactive(titlebar_ptr->minimize_button_ptr);
+    wlmtk_titlebar_title_release_inactive(titlebar_ptr->titlebar_title_ptr);
+    wlmtk_titlebar_button_release_inactive(titlebar_ptr->close_button_ptr);
+    return 0;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Returns the shared titlebar cache. Creates it, if there is none yet. */
+wlmtk_titlebar_cache_t *_wlmtk_titlebar_cache_ref(void)
+{
+    if (NULL == _wlmtk_titlebar_cache_ptr) {
+        _wlmtk_titlebar_cache_ptr = wlmtk_titlebar_cache_create(
+            _wlmtk_titlebar_cache_max_bytes);
+        if (NULL == _wlmtk_titlebar_cache_ptr) return NULL;
+    }
+    ++_wlmtk_titlebar_cache_references;
+    return _wlmtk_titlebar_cache_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Releases a reference to the shared cache. Destroys it with the last. */
+void _wlmtk_titlebar_cache_unref(void)
+{
+    BS_ASSERT(0 < _wlmtk_titlebar_cache_references);
+    if (0 < --_wlmtk_titlebar_cache_references) return;
+    wlmtk_titlebar_cache_destroy(_wlmtk_titlebar_cache_ptr);
+    _wlmtk_titlebar_cache_ptr = NULL;
+}
+
 /* == Unit tests =========================================================== */
 
 static void test_create_destroy(bs_test_t *test_ptr);
@@ -482,9 +646,20 @@ void test_variable_width(bs_test_t *test_ptr)
     wlmtk_element_get_dimensions(title_elem_ptr, NULL, NULL, &width, NULL);
     BS_TEST_VERIFY_EQ(test_ptr, 41, width);
     BS_TEST_VERIFY_EQ(test_ptr, 67, close_elem_ptr->x);
+    // Solid fills: The background is one column, and kept across resizes.
+    // Only the blurred background is drawn, as the titlebar is not focussed.
+    struct wlr_buffer *wlr_buffer_ptr = titlebar_ptr->blurred_wlr_buffer_ptr;
+    BS_TEST_VERIFY_EQ_OR_RETURN(test_ptr, 1, wlr_buffer_ptr->width);
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, titlebar_ptr->focussed_wlr_buffer_ptr);
 
     // Width sufficient only for 1 button.
     BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_titlebar_set_width(titlebar_ptr, 67));
+    BS_TEST_VERIFY_EQ(
+        test_ptr, wlr_buffer_ptr, titlebar_ptr->blurred_wlr_buffer_ptr);
+
+    // Focussed background is drawn once the titlebar gets activated.
+    wlmtk_titlebar_set_activated(titlebar_ptr, true);
+    BS_TEST_VERIFY_NEQ(test_ptr, NULL, titlebar_ptr->focussed_wlr_buffer_ptr);
     BS_TEST_VERIFY_TRUE(test_ptr, title_elem_ptr->visible);
     BS_TEST_VERIFY_FALSE(test_ptr, minimize_elem_ptr->visible);
     BS_TEST_VERIFY_TRUE(test_ptr, close_elem_ptr->visible);
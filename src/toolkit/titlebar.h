@@ -52,6 +52,11 @@ typedef struct {
     wlmtk_margin_style_t      margin;
     /** Font style for the titlebar's title. */
     wlmtk_style_font_t       font;
+    /**
+     * Delay before releasing the buffers of the variant (focussed or
+     * blurred) that is not shown, in milliseconds. 0 to keep them.
+     */
+    uint64_t                  inactive_release_delay;
 } wlmtk_titlebar_style_t;
 
 #include "window.h"
@@ -45,17 +45,32 @@ struct _wlmtk_titlebar_button_t {
     /** For drawing the button contents. */
     wlmtk_titlebar_button_draw_t draw;
 
-    /** WLR buffer of the button when focussed & released. */
+    /** WLR buffer of the button when focussed & released. NULL or locked. */
     struct wlr_buffer         *focussed_released_wlr_buffer_ptr;
-    /** WLR buffer of the button when focussed & pressed. */
+    /** WLR buffer of the button when focussed & pressed. NULL or locked. */
     struct wlr_buffer         *focussed_pressed_wlr_buffer_ptr;
-    /** WLR buffer of the button when blurred. */
+    /** WLR buffer of the button when blurred. NULL or locked. */
     struct wlr_buffer         *blurred_wlr_buffer_ptr;
+
+    /** Titlebar background when focussed, to draw from. Locked. */
+    struct wlr_buffer         *focussed_background_wlr_buffer_ptr;
+    /** Titlebar background when blurred, to draw from. Locked. */
+    struct wlr_buffer         *blurred_background_wlr_buffer_ptr;
+    /** Position of the button, relative to the titlebar. */
+    int                       position;
+    /** Style of the titlebar. Must outlive the button. */
+    const wlmtk_titlebar_style_t *style_ptr;
 };
 
 static void titlebar_button_element_destroy(wlmtk_element_t *element_ptr);
 static void titlebar_button_clicked(wlmtk_button_t *button_ptr);
 static void update_buffers(wlmtk_titlebar_button_t *titlebar_button_ptr);
+static struct wlr_buffer *shown_background(
+    wlmtk_titlebar_button_t *titlebar_button_ptr);
+static bool draw_variant(
+    wlmtk_titlebar_button_t *titlebar_button_ptr,
+    bool focussed);
+static void release_buffer(struct wlr_buffer **wlr_buffer_ptr_ptr);
 static struct wlr_buffer *create_buf(
     bs_gfxbuf_t *gfxbuf_ptr,
     int position,
@@ -113,14 +128,13 @@ wlmtk_titlebar_button_t *wlmtk_titlebar_button_create(
 void wlmtk_titlebar_button_destroy(
     wlmtk_titlebar_button_t *titlebar_button_ptr)
 {
-    wlr_buffer_drop_nullify(
-        &titlebar_button_ptr->focussed_released_wlr_buffer_ptr);
-    wlr_buffer_drop_nullify(
-        &titlebar_button_ptr->focussed_pressed_wlr_buffer_ptr);
-    wlr_buffer_drop_nullify(
-        &titlebar_button_ptr->blurred_wlr_buffer_ptr);
-
     wlmtk_button_fini(&titlebar_button_ptr->super_button);
+
+    release_buffer(&titlebar_button_ptr->focussed_released_wlr_buffer_ptr);
+    release_buffer(&titlebar_button_ptr->focussed_pressed_wlr_buffer_ptr);
+    release_buffer(&titlebar_button_ptr->blurred_wlr_buffer_ptr);
+    release_buffer(&titlebar_button_ptr->focussed_background_wlr_buffer_ptr);
+    release_buffer(&titlebar_button_ptr->blurred_background_wlr_buffer_ptr);
     free(titlebar_button_ptr);
 }
 
@@ -137,50 +151,60 @@ void wlmtk_titlebar_button_set_activated(
 /* ------------------------------------------------------------------------- */
 bool wlmtk_titlebar_button_redraw(
     wlmtk_titlebar_button_t *titlebar_button_ptr,
-    bs_gfxbuf_t *focussed_gfxbuf_ptr,
-    bs_gfxbuf_t *blurred_gfxbuf_ptr,
+    struct wlr_buffer *focussed_wlr_buffer_ptr,
+    struct wlr_buffer *blurred_wlr_buffer_ptr,
     int position,
     const wlmtk_titlebar_style_t *style_ptr)
 {
-    BS_ASSERT(focussed_gfxbuf_ptr->width == blurred_gfxbuf_ptr->width);
-    BS_ASSERT(focussed_gfxbuf_ptr->height == blurred_gfxbuf_ptr->height);
-    BS_ASSERT(style_ptr->height == focussed_gfxbuf_ptr->height);
-    BS_ASSERT(position + style_ptr->height <= focussed_gfxbuf_ptr->width);
-
-    struct wlr_buffer *focussed_released_ptr = create_buf(
-        focussed_gfxbuf_ptr, position, false, true, style_ptr,
-        titlebar_button_ptr->draw);
-    struct wlr_buffer *focussed_pressed_ptr = create_buf(
-        focussed_gfxbuf_ptr, position, true, true, style_ptr,
-        titlebar_button_ptr->draw);
-    struct wlr_buffer *blurred_ptr = create_buf(
-        blurred_gfxbuf_ptr, position, false, false, style_ptr,
-        titlebar_button_ptr->draw);
-
-    if (NULL != focussed_released_ptr &&
-        NULL != focussed_pressed_ptr &&
-        NULL != blurred_ptr) {
-        wlr_buffer_drop_nullify(
-            &titlebar_button_ptr->focussed_released_wlr_buffer_ptr);
-        wlr_buffer_drop_nullify(
-            &titlebar_button_ptr->focussed_pressed_wlr_buffer_ptr);
-        wlr_buffer_drop_nullify(
-            &titlebar_button_ptr->blurred_wlr_buffer_ptr);
-
-        titlebar_button_ptr->focussed_released_wlr_buffer_ptr =
-            focussed_released_ptr;
-        titlebar_button_ptr->focussed_pressed_wlr_buffer_ptr =
-            focussed_pressed_ptr;
-        titlebar_button_ptr->blurred_wlr_buffer_ptr = blurred_ptr;
-
-        update_buffers(titlebar_button_ptr);
-        return true;
+    BS_ASSERT(NULL == focussed_wlr_buffer_ptr ||
+              (int)style_ptr->height == focussed_wlr_buffer_ptr->height);
+    BS_ASSERT(NULL == blurred_wlr_buffer_ptr ||
+              (int)style_ptr->height == blurred_wlr_buffer_ptr->height);
+    BS_ASSERT(NULL == focussed_wlr_buffer_ptr ||
+              1 == focussed_wlr_buffer_ptr->width ||
+              position + (int)style_ptr->height <=
+              focussed_wlr_buffer_ptr->width);
+    BS_ASSERT(NULL == blurred_wlr_buffer_ptr ||
+              1 == blurred_wlr_buffer_ptr->width ||
+              position + (int)style_ptr->height <=
+              blurred_wlr_buffer_ptr->width);
+
+    release_buffer(&titlebar_button_ptr->focussed_background_wlr_buffer_ptr);
+    if (NULL != focussed_wlr_buffer_ptr) {
+        titlebar_button_ptr->focussed_background_wlr_buffer_ptr =
+            wlr_buffer_lock(focussed_wlr_buffer_ptr);
+    }
+    release_buffer(&titlebar_button_ptr->blurred_background_wlr_buffer_ptr);
+    if (NULL != blurred_wlr_buffer_ptr) {
+        titlebar_button_ptr->blurred_background_wlr_buffer_ptr =
+            wlr_buffer_lock(blurred_wlr_buffer_ptr);
+    }
+    titlebar_button_ptr->position = position;
+    titlebar_button_ptr->style_ptr = style_ptr;
+
+    // Drops all variants. Draws only the one shown, the other on demand.
+    release_buffer(&titlebar_button_ptr->focussed_released_wlr_buffer_ptr);
+    release_buffer(&titlebar_button_ptr->focussed_pressed_wlr_buffer_ptr);
+    release_buffer(&titlebar_button_ptr->blurred_wlr_buffer_ptr);
+    if (NULL != shown_background(titlebar_button_ptr) &&
+        !draw_variant(titlebar_button_ptr, titlebar_button_ptr->activated)) {
+        return false;
     }
 
-    wlr_buffer_drop_nullify(&focussed_released_ptr);
-    wlr_buffer_drop_nullify(&focussed_pressed_ptr);
-    wlr_buffer_drop_nullify(&blurred_ptr);
-    return false;
+    update_buffers(titlebar_button_ptr);
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_titlebar_button_release_inactive(
+    wlmtk_titlebar_button_t *titlebar_button_ptr)
+{
+    if (titlebar_button_ptr->activated) {
+        release_buffer(&titlebar_button_ptr->blurred_wlr_buffer_ptr);
+    } else {
+        release_buffer(&titlebar_button_ptr->focussed_released_wlr_buffer_ptr);
+        release_buffer(&titlebar_button_ptr->focussed_pressed_wlr_buffer_ptr);
+    }
 }
 
 /* ------------------------------------------------------------------------- */
@@ -215,10 +239,14 @@ void titlebar_button_clicked(wlmtk_button_t *button_ptr)
 /** Updates the button's buffer depending on activation status. */
 void update_buffers(wlmtk_titlebar_button_t *titlebar_button_ptr)
 {
-    // No buffer: Nothing to update.
-    if (NULL == titlebar_button_ptr->focussed_released_wlr_buffer_ptr ||
-        NULL == titlebar_button_ptr->focussed_pressed_wlr_buffer_ptr ||
-        NULL == titlebar_button_ptr->blurred_wlr_buffer_ptr) return;
+    // No background: Nothing to draw from, nothing to update.
+    if (NULL == shown_background(titlebar_button_ptr)) return;
+
+    if (!draw_variant(titlebar_button_ptr, titlebar_button_ptr->activated)) {
+        bs_log(BS_WARNING, "Failed to draw titlebar button %p",
+               titlebar_button_ptr);
+        return;
+    }
 
     if (titlebar_button_ptr->activated) {
         wlmtk_button_set(
@@ -234,7 +262,79 @@ void update_buffers(wlmtk_titlebar_button_t *titlebar_button_ptr)
 }
 
 /* ------------------------------------------------------------------------- */
-/** Helper: Creates a WLR buffer for the button. */
+/** Returns the background for the variant currently shown, or NULL. */
+struct wlr_buffer *shown_background(
+    wlmtk_titlebar_button_t *titlebar_button_ptr)
+{
+    return titlebar_button_ptr->activated ?
+        titlebar_button_ptr->focussed_background_wlr_buffer_ptr :
+        titlebar_button_ptr->blurred_background_wlr_buffer_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Draws the focussed (released & pressed) or the blurred variant of the
+ * button, unless it is already drawn.
+ *
+ * @param titlebar_button_ptr
+ * @param focussed
+ *
+ * @return true on success.
+ */
+bool draw_variant(
+    wlmtk_titlebar_button_t *titlebar_button_ptr,
+    bool focussed)
+{
+    if (!focussed) {
+        if (NULL != titlebar_button_ptr->blurred_wlr_buffer_ptr) return true;
+        titlebar_button_ptr->blurred_wlr_buffer_ptr = create_buf(
+            bs_gfxbuf_from_wlr_buffer(
+                titlebar_button_ptr->blurred_background_wlr_buffer_ptr),
+            titlebar_button_ptr->position, false, false,
+            titlebar_button_ptr->style_ptr, titlebar_button_ptr->draw);
+        return NULL != titlebar_button_ptr->blurred_wlr_buffer_ptr;
+    }
+
+    if (NULL != titlebar_button_ptr->focussed_released_wlr_buffer_ptr &&
+        NULL != titlebar_button_ptr->focussed_pressed_wlr_buffer_ptr) {
+        return true;
+    }
+    bs_gfxbuf_t *gfxbuf_ptr = bs_gfxbuf_from_wlr_buffer(
+        titlebar_button_ptr->focussed_background_wlr_buffer_ptr);
+    struct wlr_buffer *released_ptr = create_buf(
+        gfxbuf_ptr, titlebar_button_ptr->position, false, true,
+        titlebar_button_ptr->style_ptr, titlebar_button_ptr->draw);
+    struct wlr_buffer *pressed_ptr = create_buf(
+        gfxbuf_ptr, titlebar_button_ptr->position, true, true,
+        titlebar_button_ptr->style_ptr, titlebar_button_ptr->draw);
+    if (NULL == released_ptr || NULL == pressed_ptr) {
+        release_buffer(&released_ptr);
+        release_buffer(&pressed_ptr);
+        return false;
+    }
+
+    release_buffer(&titlebar_button_ptr->focussed_released_wlr_buffer_ptr);
+    titlebar_button_ptr->focussed_released_wlr_buffer_ptr = released_ptr;
+    release_buffer(&titlebar_button_ptr->focussed_pressed_wlr_buffer_ptr);
+    titlebar_button_ptr->focussed_pressed_wlr_buffer_ptr = pressed_ptr;
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Unlocks the buffer at `*wlr_buffer_ptr_ptr`, if any, and clears it. */
+void release_buffer(struct wlr_buffer **wlr_buffer_ptr_ptr)
+{
+    if (NULL == *wlr_buffer_ptr_ptr) return;
+    wlr_buffer_unlock(*wlr_buffer_ptr_ptr);
+    *wlr_buffer_ptr_ptr = NULL;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Helper: Creates a WLR buffer for the button.
+ *
+ * @return A locked WLR buffer, to be released by `wlr_buffer_unlock`.
+ */
 struct wlr_buffer *create_buf(
     bs_gfxbuf_t *gfxbuf_ptr,
     int position,
@@ -247,7 +347,7 @@ struct wlr_buffer *create_buf(
         style_ptr->height, style_ptr->height);
     if (NULL == wlr_buffer_ptr) return NULL;
 
-    bs_gfxbuf_copy_area(
+    wlmaker_primitives_copy_area(
         bs_gfxbuf_from_wlr_buffer(wlr_buffer_ptr), 0, 0,
         gfxbuf_ptr, position, 0, style_ptr->height, style_ptr->height);
 
@@ -263,7 +363,9 @@ struct wlr_buffer *create_buf(
     draw(cairo_ptr, style_ptr->height, color);
     cairo_destroy(cairo_ptr);
 
-    return wlr_buffer_ptr;
+    struct wlr_buffer *locked_wlr_buffer_ptr = wlr_buffer_lock(wlr_buffer_ptr);
+    wlr_buffer_drop(wlr_buffer_ptr);
+    return locked_wlr_buffer_ptr;
 }
 
 /* == Unit tests =========================================================== */
@@ -299,15 +401,17 @@ void test_button(bs_test_t *test_ptr)
         .blurred_text_color = 0xffe0c0a0,
         .bezel_width = 1
     };
-    bs_gfxbuf_t *f_ptr = bs_gfxbuf_create(100, 22);
-    bs_gfxbuf_clear(f_ptr, 0xff4040c0);
-    bs_gfxbuf_t *b_ptr = bs_gfxbuf_create(100, 22);
-    bs_gfxbuf_clear(b_ptr, 0xff303030);
+    struct wlr_buffer *f_ptr = bs_gfxbuf_create_wlr_buffer(100, 22);
+    bs_gfxbuf_clear(bs_gfxbuf_from_wlr_buffer(f_ptr), 0xff4040c0);
+    struct wlr_buffer *b_ptr = bs_gfxbuf_create_wlr_buffer(100, 22);
+    bs_gfxbuf_clear(bs_gfxbuf_from_wlr_buffer(b_ptr), 0xff303030);
     BS_TEST_VERIFY_TRUE(
         test_ptr,
         wlmtk_titlebar_button_redraw(button_ptr, f_ptr, b_ptr, 30, &style));
-    bs_gfxbuf_destroy(b_ptr);
-    bs_gfxbuf_destroy(f_ptr);
+    // The button holds on to the backgrounds, for drawing on demand.
+    wlr_buffer_drop(b_ptr);
+    wlr_buffer_drop(f_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, button_ptr->blurred_wlr_buffer_ptr);
     BS_TEST_VERIFY_GFXBUF_EQUALS_PNG(
         test_ptr,
         bs_gfxbuf_from_wlr_buffer(super_buffer_ptr->wlr_buffer_ptr),
@@ -361,6 +465,23 @@ void test_button(bs_test_t *test_ptr)
         test_ptr,
         bs_gfxbuf_from_wlr_buffer(super_buffer_ptr->wlr_buffer_ptr),
         "toolkit/title_button_blurred.png");
+    BS_TEST_VERIFY_NEQ(test_ptr, NULL,
+                       button_ptr->focussed_released_wlr_buffer_ptr);
+
+    // Release the inactive variant: Keeps just the blurred one.
+    wlmtk_titlebar_button_release_inactive(button_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, NULL,
+                      button_ptr->focussed_released_wlr_buffer_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, NULL,
+                      button_ptr->focussed_pressed_wlr_buffer_ptr);
+    BS_TEST_VERIFY_NEQ(test_ptr, NULL, button_ptr->blurred_wlr_buffer_ptr);
+
+    // Re-activating draws the focussed variant again.
+    wlmtk_titlebar_button_set_activated(button_ptr, true);
+    BS_TEST_VERIFY_GFXBUF_EQUALS_PNG(
+        test_ptr,
+        bs_gfxbuf_from_wlr_buffer(super_buffer_ptr->wlr_buffer_ptr),
+        "toolkit/title_button_focussed_released.png");
 
     wlmtk_element_destroy(element_ptr);
     wlmtk_fake_window_destroy(fake_window_ptr);
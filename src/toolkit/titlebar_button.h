@@ -28,6 +28,9 @@ typedef struct _wlmtk_titlebar_button_t wlmtk_titlebar_button_t;
 
 #include "titlebar.h"
 
+/** Forward declaration. */
+struct wlr_buffer;
+
 #ifdef __cplusplus
 extern "C" {
 #endif  // __cplusplus
@@ -73,21 +76,38 @@ void wlmtk_titlebar_button_set_activated(
 /**
  * Redraws the titlebar button for given textures, position and style.
  *
+ * Only the variant (focussed or blurred) currently shown is drawn right away.
+ * The other variant is drawn once @ref wlmtk_titlebar_button_set_activated
+ * needs it.
+ *
  * @param titlebar_button_ptr
- * @param focussed_gfxbuf_ptr
- * @param blurred_gfxbuf_ptr
+ * @param focussed_wlr_buffer_ptr Titlebar background when focussed. Must be
+ *                            created by @ref bs_gfxbuf_create_wlr_buffer.
+ *                            Will be locked by the button. May be 1 pixel
+ *                            wide, for a columnar fill that gets stretched.
+ * @param blurred_wlr_buffer_ptr Titlebar background when blurred. Same as
+ *                            for `focussed_wlr_buffer_ptr`. The background
+ *                            of the variant not shown may be NULL.
  * @param position
- * @param style_ptr
+ * @param style_ptr           Must outlive the button.
  *
  * @return true on success.
  */
 bool wlmtk_titlebar_button_redraw(
     wlmtk_titlebar_button_t *titlebar_button_ptr,
-    bs_gfxbuf_t *focussed_gfxbuf_ptr,
-    bs_gfxbuf_t *blurred_gfxbuf_ptr,
+    struct wlr_buffer *focussed_wlr_buffer_ptr,
+    struct wlr_buffer *blurred_wlr_buffer_ptr,
     int position,
     const wlmtk_titlebar_style_t *style_ptr);
 
+/**
+ * Releases the buffers of the variant (focussed or blurred) not shown.
+ *
+ * @param titlebar_button_ptr
+ */
+void wlmtk_titlebar_button_release_inactive(
+    wlmtk_titlebar_button_t *titlebar_button_ptr);
+
 /**
  * Returns the titlebar button's super element.
  *
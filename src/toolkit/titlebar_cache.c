@@ -0,0 +1,558 @@
+/* ========================================================================= */
+/**
+ * @file titlebar_cache.c
+ *
+ * @copyright
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "titlebar_cache.h"
+
+#include "gfxbuf.h"
+
+#define WLR_USE_UNSTABLE
+#include <wlr/interfaces/wlr_buffer.h>
+#undef WLR_USE_UNSTABLE
+
+/* == Declarations ========================================================= */
+
+/** State of the titlebar cache. */
+struct _wlmtk_titlebar_cache_t {
+    /** Entries, as @ref wlmtk_titlebar_cache_entry_t, sorted by key. */
+    bs_avltree_t              *tree_ptr;
+    /** Entries in order of use. The head is the most recently used. */
+    bs_dllist_t               lru;
+    /** Total size of all cached buffers, in bytes. */
+    size_t                    bytes;
+    /** Limit for @ref wlmtk_titlebar_cache_t::bytes. */
+    size_t                    max_bytes;
+    /** Number of lookups that found an entry. */
+    uint64_t                  hits;
+    /** Number of lookups that did not find an entry. */
+    uint64_t                  misses;
+};
+
+/** An entry of the titlebar cache. */
+typedef struct {
+    /** Node of @ref wlmtk_titlebar_cache_t::tree_ptr. */
+    bs_avltree_node_t         avlnode;
+    /** Node of @ref wlmtk_titlebar_cache_t::lru. */
+    bs_dllist_node_t          dlnode;
+    /** The key. Owns a copy of the title, if any, and of the style. */
+    wlmtk_titlebar_cache_key_t key;
+    /** Copy of the style, referenced by the key. */
+    wlmtk_titlebar_style_t    style;
+    /** The cached buffer. Locked by the entry. */
+    struct wlr_buffer         *wlr_buffer_ptr;
+    /** Size of the buffer, in bytes. */
+    size_t                    bytes;
+} wlmtk_titlebar_cache_entry_t;
+
+static wlmtk_titlebar_cache_entry_t *_wlmtk_titlebar_cache_entry_create(
+    const wlmtk_titlebar_cache_key_t *key_ptr,
+    struct wlr_buffer *wlr_buffer_ptr);
+static void _wlmtk_titlebar_cache_entry_destroy(
+    wlmtk_titlebar_cache_entry_t *entry_ptr);
+static void _wlmtk_titlebar_cache_remove(
+    wlmtk_titlebar_cache_t *cache_ptr,
+    wlmtk_titlebar_cache_entry_t *entry_ptr);
+static int _wlmtk_titlebar_cache_node_cmp(
+    const bs_avltree_node_t *node_ptr,
+    const void *key_ptr);
+static void _wlmtk_titlebar_cache_node_destroy(bs_avltree_node_t *node_ptr);
+static uint64_t _wlmtk_titlebar_hash(
+    uint64_t hash,
+    const void *data_ptr,
+    size_t size);
+static uint64_t _wlmtk_titlebar_hash_fill(
+    uint64_t hash,
+    const wlmtk_style_fill_t *fill_ptr);
+static int _wlmtk_titlebar_style_cmp(
+    const wlmtk_titlebar_style_t *s1_ptr,
+    const wlmtk_titlebar_style_t *s2_ptr);
+static int _wlmtk_titlebar_fill_cmp(
+    const wlmtk_style_fill_t *f1_ptr,
+    const wlmtk_style_fill_t *f2_ptr);
+static int _wlmtk_titlebar_cmp(uint64_t v1, uint64_t v2);
+
+/* == Exported methods ===================================================== */
+
+/* ------------------------------------------------------------------------- */
+wlmtk_titlebar_cache_t *wlmtk_titlebar_cache_create(size_t max_bytes)
+{
+    wlmtk_titlebar_cache_t *cache_ptr = logged_calloc(
+        1, sizeof(wlmtk_titlebar_cache_t));
+    if (NULL == cache_ptr) return NULL;
+    cache_ptr->max_bytes = max_bytes;
+
+    cache_ptr->tree_ptr = bs_avltree_create(
+        _wlmtk_titlebar_cache_node_cmp,
+        _wlmtk_titlebar_cache_node_destroy);
+    if (NULL == cache_ptr->tree_ptr) {
+        wlmtk_titlebar_cache_destroy(cache_ptr);
+        return NULL;
+    }
+    return cache_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_titlebar_cache_destroy(wlmtk_titlebar_cache_t *cache_ptr)
+{
+    if (NULL != cache_ptr->tree_ptr) {
+        bs_avltree_destroy(cache_ptr->tree_ptr);
+        cache_ptr->tree_ptr = NULL;
+    }
+    free(cache_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+struct wlr_buffer *wlmtk_titlebar_cache_lookup(
+    wlmtk_titlebar_cache_t *cache_ptr,
+    const wlmtk_titlebar_cache_key_t *key_ptr)
+{
+    bs_avltree_node_t *avlnode_ptr = bs_avltree_lookup(
+        cache_ptr->tree_ptr, key_ptr);
+    if (NULL == avlnode_ptr) {
+        ++cache_ptr->misses;
+        return NULL;
+    }
+    ++cache_ptr->hits;
+
+    wlmtk_titlebar_cache_entry_t *entry_ptr = BS_CONTAINER_OF(
+        avlnode_ptr, wlmtk_titlebar_cache_entry_t, avlnode);
+    bs_dllist_remove(&cache_ptr->lru, &entry_ptr->dlnode);
+    bs_dllist_push_front(&cache_ptr->lru, &entry_ptr->dlnode);
+    return wlr_buffer_lock(entry_ptr->wlr_buffer_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+bool wlmtk_titlebar_cache_insert(
+    wlmtk_titlebar_cache_t *cache_ptr,
+    const wlmtk_titlebar_cache_key_t *key_ptr,
+    struct wlr_buffer *wlr_buffer_ptr)
+{
+    bs_avltree_node_t *avlnode_ptr = bs_avltree_lookup(
+        cache_ptr->tree_ptr, key_ptr);
+    if (NULL != avlnode_ptr) {
+        _wlmtk_titlebar_cache_remove(
+            cache_ptr,
+            BS_CONTAINER_OF(avlnode_ptr, wlmtk_titlebar_cache_entry_t,
+                            avlnode));
+    }
+
+    wlmtk_titlebar_cache_entry_t *entry_ptr =
+        _wlmtk_titlebar_cache_entry_create(key_ptr, wlr_buffer_ptr);
+    if (NULL == entry_ptr) return false;
+    if (!bs_avltree_insert(cache_ptr->tree_ptr, &entry_ptr->key,
+                           &entry_ptr->avlnode, false)) {
+        _wlmtk_titlebar_cache_entry_destroy(entry_ptr);
+        return false;
+    }
+    bs_dllist_push_front(&cache_ptr->lru, &entry_ptr->dlnode);
+    cache_ptr->bytes += entry_ptr->bytes;
+
+    // Evict least recently used entries, until within the limit.
+    while (cache_ptr->bytes > cache_ptr->max_bytes &&
+           NULL != cache_ptr->lru.tail_ptr) {
+        _wlmtk_titlebar_cache_remove(
+            cache_ptr,
+            BS_CONTAINER_OF(cache_ptr->lru.tail_ptr,
+                            wlmtk_titlebar_cache_entry_t, dlnode));
+    }
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+uint64_t wlmtk_titlebar_style_hash(const wlmtk_titlebar_style_t *style_ptr)
+{
+    // FNV-1a offset basis.
+    uint64_t hash = UINT64_C(0xcbf29ce484222325);
+    hash = _wlmtk_titlebar_hash_fill(hash, &style_ptr->focussed_fill);
+    hash = _wlmtk_titlebar_hash_fill(hash, &style_ptr->blurred_fill);
+    hash = _wlmtk_titlebar_hash(hash, &style_ptr->focussed_text_color,
+                                sizeof(style_ptr->focussed_text_color));
+    hash = _wlmtk_titlebar_hash(hash, &style_ptr->blurred_text_color,
+                                sizeof(style_ptr->blurred_text_color));
+    hash = _wlmtk_titlebar_hash(hash, &style_ptr->height,
+                                sizeof(style_ptr->height));
+    hash = _wlmtk_titlebar_hash(hash, &style_ptr->bezel_width,
+                                sizeof(style_ptr->bezel_width));
+    hash = _wlmtk_titlebar_hash(
+        hash, style_ptr->font.face,
+        strnlen(style_ptr->font.face, WLMTK_STYLE_FONT_FACE_LENGTH));
+    hash = _wlmtk_titlebar_hash(hash, &style_ptr->font.weight,
+                                sizeof(style_ptr->font.weight));
+    hash = _wlmtk_titlebar_hash(hash, &style_ptr->font.size,
+                                sizeof(style_ptr->font.size));
+    return hash;
+}
+
+/* == Local (static) methods =============================================== */
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Creates a cache entry. Copies the key's title and locks the buffer.
+ *
+ * @param key_ptr
+ * @param wlr_buffer_ptr
+ *
+ * @return Pointer to the entry, or NULL on error.
+ */
+wlmtk_titlebar_cache_entry_t *_wlmtk_titlebar_cache_entry_create(
+    const wlmtk_titlebar_cache_key_t *key_ptr,
+    struct wlr_buffer *wlr_buffer_ptr)
+{
+    wlmtk_titlebar_cache_entry_t *entry_ptr = logged_calloc(
+        1, sizeof(wlmtk_titlebar_cache_entry_t));
+    if (NULL == entry_ptr) return NULL;
+
+    entry_ptr->key = *key_ptr;
+    entry_ptr->style = *key_ptr->style_ptr;
+    entry_ptr->key.style_ptr = &entry_ptr->style;
+    if (NULL != key_ptr->title_ptr) {
+        entry_ptr->key.title_ptr = logged_strdup(key_ptr->title_ptr);
+        if (NULL == entry_ptr->key.title_ptr) {
+            free(entry_ptr);
+            return NULL;
+        }
+    }
+
+    entry_ptr->wlr_buffer_ptr = wlr_buffer_lock(wlr_buffer_ptr);
+    entry_ptr->bytes = (size_t)wlr_buffer_ptr->width *
+        (size_t)wlr_buffer_ptr->height * sizeof(uint32_t);
+    return entry_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Destroys the entry. Unlocks the buffer. */
+void _wlmtk_titlebar_cache_entry_destroy(
+    wlmtk_titlebar_cache_entry_t *entry_ptr)
+{
+    if (NULL != entry_ptr->wlr_buffer_ptr) {
+        wlr_buffer_unlock(entry_ptr->wlr_buffer_ptr);
+        entry_ptr->wlr_buffer_ptr = NULL;
+    }
+    if (NULL != entry_ptr->key.title_ptr) {
+        // Safe: We own the copy, see _wlmtk_titlebar_cache_entry_create.
+        free((char*)entry_ptr->key.title_ptr);
+        entry_ptr->key.title_ptr = NULL;
+    }
+    free(entry_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Removes the entry from the cache, and destroys it. */
+void _wlmtk_titlebar_cache_remove(
+    wlmtk_titlebar_cache_t *cache_ptr,
+    wlmtk_titlebar_cache_entry_t *entry_ptr)
+{
+    bs_avltree_delete(cache_ptr->tree_ptr, &entry_ptr->key);
+    bs_dllist_remove(&cache_ptr->lru, &entry_ptr->dlnode);
+    cache_ptr->bytes -= entry_ptr->bytes;
+    _wlmtk_titlebar_cache_entry_destroy(entry_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Comparator for @ref wlmtk_titlebar_cache_t::tree_ptr nodes. */
+int _wlmtk_titlebar_cache_node_cmp(
+    const bs_avltree_node_t *node_ptr,
+    const void *key_ptr)
+{
+    const wlmtk_titlebar_cache_key_t *k1_ptr = &BS_CONTAINER_OF(
+        node_ptr, wlmtk_titlebar_cache_entry_t, avlnode)->key;
+    const wlmtk_titlebar_cache_key_t *k2_ptr = key_ptr;
+
+    if (k1_ptr->style_hash != k2_ptr->style_hash) {
+        return k1_ptr->style_hash < k2_ptr->style_hash ? -1 : 1;
+    }
+    // Same hash: Guard against collisions.
+    int rv = _wlmtk_titlebar_style_cmp(k1_ptr->style_ptr, k2_ptr->style_ptr);
+    if (0 != rv) return rv;
+    if (k1_ptr->activated != k2_ptr->activated) {
+        return k1_ptr->activated ? 1 : -1;
+    }
+    if (k1_ptr->titlebar_width != k2_ptr->titlebar_width) {
+        return k1_ptr->titlebar_width < k2_ptr->titlebar_width ? -1 : 1;
+    }
+    if (k1_ptr->position != k2_ptr->position) {
+        return k1_ptr->position < k2_ptr->position ? -1 : 1;
+    }
+    if (k1_ptr->width != k2_ptr->width) {
+        return k1_ptr->width < k2_ptr->width ? -1 : 1;
+    }
+
+    // Backgrounds (NULL title) sort before all titles.
+    if (NULL == k1_ptr->title_ptr || NULL == k2_ptr->title_ptr) {
+        return (NULL != k1_ptr->title_ptr) - (NULL != k2_ptr->title_ptr);
+    }
+    return strcmp(k1_ptr->title_ptr, k2_ptr->title_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Destructor for @ref wlmtk_titlebar_cache_t::tree_ptr nodes. */
+void _wlmtk_titlebar_cache_node_destroy(bs_avltree_node_t *node_ptr)
+{
+    _wlmtk_titlebar_cache_entry_destroy(BS_CONTAINER_OF(
+        node_ptr, wlmtk_titlebar_cache_entry_t, avlnode));
+}
+
+/* ------------------------------------------------------------------------- */
+/** Continues the FNV-1a hash `hash` over `size` bytes at `data_ptr`. */
+uint64_t _wlmtk_titlebar_hash(uint64_t hash, const void *data_ptr, size_t size)
+{
+    const uint8_t *bytes_ptr = data_ptr;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes_ptr[i];
+        hash *= UINT64_C(0x100000001b3);
+    }
+    return hash;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Continues `hash` over the fill's type and the colors relevant to it. */
+uint64_t _wlmtk_titlebar_hash_fill(
+    uint64_t hash,
+    const wlmtk_style_fill_t *fill_ptr)
+{
+    hash = _wlmtk_titlebar_hash(hash, &fill_ptr->type, sizeof(fill_ptr->type));
+    if (WLMTK_STYLE_COLOR_SOLID == fill_ptr->type) {
+        return _wlmtk_titlebar_hash(hash, &fill_ptr->param.solid,
+                                    sizeof(fill_ptr->param.solid));
+    }
+    // All gradients share the same layout.
+    return _wlmtk_titlebar_hash(hash, &fill_ptr->param.hgradient,
+                                sizeof(fill_ptr->param.hgradient));
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Compares the styles over the same attributes that
+ * @ref wlmtk_titlebar_style_hash covers.
+ *
+ * @param s1_ptr
+ * @param s2_ptr
+ *
+ * @return -1, 0 or 1, if `s1_ptr` is less, equal or greater than `s2_ptr`.
+ */
+int _wlmtk_titlebar_style_cmp(
+    const wlmtk_titlebar_style_t *s1_ptr,
+    const wlmtk_titlebar_style_t *s2_ptr)
+{
+    if (s1_ptr == s2_ptr) return 0;
+
+    int rv = _wlmtk_titlebar_fill_cmp(
+        &s1_ptr->focussed_fill, &s2_ptr->focussed_fill);
+    if (0 != rv) return rv;
+    rv = _wlmtk_titlebar_fill_cmp(&s1_ptr->blurred_fill, &s2_ptr->blurred_fill);
+    if (0 != rv) return rv;
+    rv = _wlmtk_titlebar_cmp(s1_ptr->focussed_text_color,
+                             s2_ptr->focussed_text_color);
+    if (0 != rv) return rv;
+    rv = _wlmtk_titlebar_cmp(s1_ptr->blurred_text_color,
+                             s2_ptr->blurred_text_color);
+    if (0 != rv) return rv;
+    rv = _wlmtk_titlebar_cmp(s1_ptr->height, s2_ptr->height);
+    if (0 != rv) return rv;
+    rv = _wlmtk_titlebar_cmp(s1_ptr->bezel_width, s2_ptr->bezel_width);
+    if (0 != rv) return rv;
+    rv = strncmp(s1_ptr->font.face, s2_ptr->font.face,
+                 WLMTK_STYLE_FONT_FACE_LENGTH);
+    if (0 != rv) return rv < 0 ? -1 : 1;
+    rv = _wlmtk_titlebar_cmp(s1_ptr->font.weight, s2_ptr->font.weight);
+    if (0 != rv) return rv;
+    return _wlmtk_titlebar_cmp(s1_ptr->font.size, s2_ptr->font.size);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Compares the fill's type and the colors relevant to it. */
+int _wlmtk_titlebar_fill_cmp(
+    const wlmtk_style_fill_t *f1_ptr,
+    const wlmtk_style_fill_t *f2_ptr)
+{
+    int rv = _wlmtk_titlebar_cmp(f1_ptr->type, f2_ptr->type);
+    if (0 != rv) return rv;
+    if (WLMTK_STYLE_COLOR_SOLID == f1_ptr->type) {
+        return _wlmtk_titlebar_cmp(f1_ptr->param.solid.color,
+                                   f2_ptr->param.solid.color);
+    }
+    // All gradients share the same layout.
+    rv = _wlmtk_titlebar_cmp(f1_ptr->param.hgradient.from,
+                             f2_ptr->param.hgradient.from);
+    if (0 != rv) return rv;
+    return _wlmtk_titlebar_cmp(f1_ptr->param.hgradient.to,
+                               f2_ptr->param.hgradient.to);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Returns -1, 0 or 1, if `v1` is less, equal or greater than `v2`. */
+int _wlmtk_titlebar_cmp(uint64_t v1, uint64_t v2)
+{
+    if (v1 == v2) return 0;
+    return v1 < v2 ? -1 : 1;
+}
+
+/* == Unit tests =========================================================== */
+
+static void test_lookup_evict(bs_test_t *test_ptr);
+static void test_style_hash(bs_test_t *test_ptr);
+static void test_style_collision(bs_test_t *test_ptr);
+
+const bs_test_case_t wlmtk_titlebar_cache_test_cases[] = {
+    { 1, "lookup_evict", test_lookup_evict },
+    { 1, "style_hash", test_style_hash },
+    { 1, "style_collision", test_style_collision },
+    { 0, NULL, NULL }
+};
+
+/* ------------------------------------------------------------------------- */
+/** Exercises lookup, insertion and LRU eviction. */
+void test_lookup_evict(bs_test_t *test_ptr)
+{
+    // Room for two 10x10 buffers.
+    wlmtk_titlebar_cache_t *cache_ptr = wlmtk_titlebar_cache_create(800);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, cache_ptr);
+
+    const wlmtk_titlebar_style_t style = { .height = 10 };
+    wlmtk_titlebar_cache_key_t bg_key = {
+        .style_hash = 42, .style_ptr = &style, .activated = true,
+        .titlebar_width = 10, .width = 10 };
+    wlmtk_titlebar_cache_key_t title_key = {
+        .style_hash = 42, .style_ptr = &style, .activated = true,
+        .titlebar_width = 10, .width = 10, .title_ptr = "title" };
+    wlmtk_titlebar_cache_key_t blurred_key = {
+        .style_hash = 42, .style_ptr = &style, .activated = false,
+        .titlebar_width = 10, .width = 10, .title_ptr = "title" };
+
+    struct wlr_buffer *b1_ptr = bs_gfxbuf_create_wlr_buffer(10, 10);
+    struct wlr_buffer *b2_ptr = bs_gfxbuf_create_wlr_buffer(10, 10);
+    struct wlr_buffer *b3_ptr = bs_gfxbuf_create_wlr_buffer(10, 10);
+
+    BS_TEST_VERIFY_EQ(test_ptr, NULL,
+                      wlmtk_titlebar_cache_lookup(cache_ptr, &bg_key));
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, wlmtk_titlebar_cache_insert(cache_ptr, &bg_key, b1_ptr));
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, wlmtk_titlebar_cache_insert(cache_ptr, &title_key, b2_ptr));
+    BS_TEST_VERIFY_EQ(test_ptr, 800, cache_ptr->bytes);
+
+    // Title key is distinct from background key, and uses a copy of title.
+    char title[] = "title";
+    title_key.title_ptr = title;
+    struct wlr_buffer *wlr_buffer_ptr = wlmtk_titlebar_cache_lookup(
+        cache_ptr, &title_key);
+    BS_TEST_VERIFY_EQ(test_ptr, b2_ptr, wlr_buffer_ptr);
+    wlr_buffer_unlock(wlr_buffer_ptr);
+    wlr_buffer_ptr = wlmtk_titlebar_cache_lookup(cache_ptr, &bg_key);
+    BS_TEST_VERIFY_EQ(test_ptr, b1_ptr, wlr_buffer_ptr);
+    wlr_buffer_unlock(wlr_buffer_ptr);
+
+    // Background was used most recently. Title strip gets evicted.
+    BS_TEST_VERIFY_TRUE(
+        test_ptr,
+        wlmtk_titlebar_cache_insert(cache_ptr, &blurred_key, b3_ptr));
+    BS_TEST_VERIFY_EQ(test_ptr, 800, cache_ptr->bytes);
+    BS_TEST_VERIFY_EQ(test_ptr, NULL,
+                      wlmtk_titlebar_cache_lookup(cache_ptr, &title_key));
+    wlr_buffer_ptr = wlmtk_titlebar_cache_lookup(cache_ptr, &blurred_key);
+    BS_TEST_VERIFY_EQ(test_ptr, b3_ptr, wlr_buffer_ptr);
+    wlr_buffer_unlock(wlr_buffer_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 3, cache_ptr->hits);
+    BS_TEST_VERIFY_EQ(test_ptr, 2, cache_ptr->misses);
+
+    // Replacing an entry keeps the size.
+    BS_TEST_VERIFY_TRUE(
+        test_ptr,
+        wlmtk_titlebar_cache_insert(cache_ptr, &blurred_key, b2_ptr));
+    BS_TEST_VERIFY_EQ(test_ptr, 800, cache_ptr->bytes);
+    wlr_buffer_ptr = wlmtk_titlebar_cache_lookup(cache_ptr, &blurred_key);
+    BS_TEST_VERIFY_EQ(test_ptr, b2_ptr, wlr_buffer_ptr);
+    wlr_buffer_unlock(wlr_buffer_ptr);
+
+    wlr_buffer_drop(b3_ptr);
+    wlr_buffer_drop(b2_ptr);
+    wlr_buffer_drop(b1_ptr);
+    wlmtk_titlebar_cache_destroy(cache_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Verifies the style hash covers rendering attributes, but not padding. */
+void test_style_hash(bs_test_t *test_ptr)
+{
+    wlmtk_titlebar_style_t s1 = {
+        .focussed_fill = {
+            .type = WLMTK_STYLE_COLOR_SOLID,
+            .param = { .solid = { .color = 0xff102030 } } },
+        .height = 22,
+        .font = { .face = "Helvetica", .size = 15 }
+    };
+    wlmtk_titlebar_style_t s2 = s1;
+    BS_TEST_VERIFY_EQ(test_ptr,
+                      wlmtk_titlebar_style_hash(&s1),
+                      wlmtk_titlebar_style_hash(&s2));
+
+    // Bytes beyond the face's terminating NUL do not matter.
+    s2.font.face[WLMTK_STYLE_FONT_FACE_LENGTH - 1] = 'x';
+    BS_TEST_VERIFY_EQ(test_ptr,
+                      wlmtk_titlebar_style_hash(&s1),
+                      wlmtk_titlebar_style_hash(&s2));
+
+    s2 = s1;
+    s2.blurred_text_color = 0xff808080;
+    BS_TEST_VERIFY_NEQ(test_ptr,
+                       wlmtk_titlebar_style_hash(&s1),
+                       wlmtk_titlebar_style_hash(&s2));
+
+    s2 = s1;
+    s2.focussed_fill.type = WLMTK_STYLE_COLOR_HGRADIENT;
+    BS_TEST_VERIFY_NEQ(test_ptr,
+                       wlmtk_titlebar_style_hash(&s1),
+                       wlmtk_titlebar_style_hash(&s2));
+}
+
+/* ------------------------------------------------------------------------- */
+/** Verifies that distinct styles with colliding hashes are kept apart. */
+void test_style_collision(bs_test_t *test_ptr)
+{
+    wlmtk_titlebar_cache_t *cache_ptr = wlmtk_titlebar_cache_create(800);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, cache_ptr);
+
+    wlmtk_titlebar_style_t s1 = { .height = 10 };
+    wlmtk_titlebar_style_t s2 = { .height = 10, .bezel_width = 1 };
+    wlmtk_titlebar_cache_key_t k1 = {
+        .style_hash = 42, .style_ptr = &s1, .titlebar_width = 10,
+        .width = 10 };
+    wlmtk_titlebar_cache_key_t k2 = k1;
+    k2.style_ptr = &s2;
+
+    struct wlr_buffer *b_ptr = bs_gfxbuf_create_wlr_buffer(10, 10);
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, wlmtk_titlebar_cache_insert(cache_ptr, &k1, b_ptr));
+    BS_TEST_VERIFY_EQ(test_ptr, NULL,
+                      wlmtk_titlebar_cache_lookup(cache_ptr, &k2));
+
+    // An equal style at another address hits. The cache kept a copy.
+    wlmtk_titlebar_style_t s3 = s1;
+    s1.height = 20;
+    k2.style_ptr = &s3;
+    struct wlr_buffer *wlr_buffer_ptr = wlmtk_titlebar_cache_lookup(
+        cache_ptr, &k2);
+    BS_TEST_VERIFY_EQ(test_ptr, b_ptr, wlr_buffer_ptr);
+    if (NULL != wlr_buffer_ptr) wlr_buffer_unlock(wlr_buffer_ptr);
+
+    wlr_buffer_drop(b_ptr);
+    wlmtk_titlebar_cache_destroy(cache_ptr);
+}
+
+/* == End of titlebar_cache.c ============================================== */
@@ -0,0 +1,124 @@
+/* ========================================================================= */
+/**
+ * @file titlebar_cache.h
+ *
+ * @copyright
+ * Copyright 2025 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __WLMTK_TITLEBAR_CACHE_H__
+#define __WLMTK_TITLEBAR_CACHE_H__
+
+/** Forward declaration: Cache of rendered titlebar buffers. */
+typedef struct _wlmtk_titlebar_cache_t wlmtk_titlebar_cache_t;
+
+#include <stdbool.h>
+#include <libbase/libbase.h>
+
+#include "titlebar.h"
+
+/** Forward declaration. */
+struct wlr_buffer;
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+/**
+ * Key for a rendered titlebar buffer: Either a background (`title_ptr` is
+ * NULL), or a title strip cut out of the background and with text drawn.
+ */
+typedef struct {
+    /** Hash of the style, see @ref wlmtk_titlebar_style_hash. */
+    uint64_t                  style_hash;
+    /** The style. Compared in full, if the hashes match. */
+    const wlmtk_titlebar_style_t *style_ptr;
+    /** Whether this is the focussed (true) or blurred (false) variant. */
+    bool                      activated;
+    /** Width of the titlebar background. */
+    unsigned                  titlebar_width;
+    /** Position of the title strip within the background. 0 for background. */
+    unsigned                  position;
+    /** Width of the title strip. Equals `titlebar_width` for background. */
+    unsigned                  width;
+    /** Title drawn on the strip. NULL for background. */
+    const char                *title_ptr;
+} wlmtk_titlebar_cache_key_t;
+
+/**
+ * Creates a cache of rendered titlebar buffers, bounded by size.
+ *
+ * Entries are evicted in least-recently-used order, once the total size of
+ * the cached buffers exceeds `max_bytes`. Evicted buffers remain valid for
+ * as long as they are locked elsewhere.
+ *
+ * @param max_bytes
+ *
+ * @return Pointer to the cache, or NULL on error. Must be destroyed by
+ *     calling @ref wlmtk_titlebar_cache_destroy.
+ */
+wlmtk_titlebar_cache_t *wlmtk_titlebar_cache_create(size_t max_bytes);
+
+/**
+ * Destroys the cache. Unlocks all cached buffers.
+ *
+ * @param cache_ptr
+ */
+void wlmtk_titlebar_cache_destroy(wlmtk_titlebar_cache_t *cache_ptr);
+
+/**
+ * Looks up a buffer in the cache, and marks it as most recently used.
+ *
+ * @param cache_ptr
+ * @param key_ptr
+ *
+ * @return A `struct wlr_buffer` that is locked for the caller, and must be
+ *     released by calling `wlr_buffer_unlock`. Or NULL, if not found.
+ */
+struct wlr_buffer *wlmtk_titlebar_cache_lookup(
+    wlmtk_titlebar_cache_t *cache_ptr,
+    const wlmtk_titlebar_cache_key_t *key_ptr);
+
+/**
+ * Stores a buffer in the cache. Replaces any buffer stored at the same key.
+ *
+ * @param cache_ptr
+ * @param key_ptr
+ * @param wlr_buffer_ptr      The cache will hold a lock on the buffer.
+ *
+ * @return true on success.
+ */
+bool wlmtk_titlebar_cache_insert(
+    wlmtk_titlebar_cache_t *cache_ptr,
+    const wlmtk_titlebar_cache_key_t *key_ptr,
+    struct wlr_buffer *wlr_buffer_ptr);
+
+/**
+ * Computes a hash over all attributes of the style that affect rendering.
+ *
+ * @param style_ptr
+ *
+ * @return The hash.
+ */
+uint64_t wlmtk_titlebar_style_hash(const wlmtk_titlebar_style_t *style_ptr);
+
+/** Unit test cases. */
+extern const bs_test_case_t wlmtk_titlebar_cache_test_cases[];
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif /* __WLMTK_TITLEBAR_CACHE_H__ */
+/* == End of titlebar_cache.h ============================================== */
@@ -27,6 +27,10 @@ typedef struct _wlmtk_titlebar_title_t wlmtk_titlebar_title_t;
 #include <libbase/libbase.h>
 
 #include "titlebar.h"
+#include "titlebar_cache.h"
+
+/** Forward declaration. */
+struct wlr_buffer;
 
 #ifdef __cplusplus
 extern "C" {
@@ -55,29 +59,44 @@ void wlmtk_titlebar_title_destroy(
 /**
  * Redraws the title section of the title bar.
  *
+ * Only the variant matching `activated` is drawn right away. The other
+ * variant is drawn once @ref wlmtk_titlebar_title_set_activated needs it.
+ *
  * @param titlebar_title_ptr
- * @param focussed_gfxbuf_ptr Titlebar background when focussed.
- * @param blurred_gfxbuf_ptr  Titlebar background when blurred.
+ * @param focussed_wlr_buffer_ptr Titlebar background when focussed. Must be
+ *                            created by @ref bs_gfxbuf_create_wlr_buffer.
+ *                            Will be locked by the title. May be 1 pixel
+ *                            wide, for a columnar fill that gets stretched.
+ * @param blurred_wlr_buffer_ptr Titlebar background when blurred. Same as
+ *                            for `focussed_wlr_buffer_ptr`. The background
+ *                            not matching `activated` may be NULL.
  * @param position            Position of title telative to titlebar.
  * @param width               Width of title.
  * @param activated           Whether the title bar should start focussed.
  * @param title_ptr           Title, or NULL.
  * @param style_ptr
+ * @param style_hash          Hash of `style_ptr`, see
+ *                            @ref wlmtk_titlebar_style_hash. Only used as
+ *                            key for `cache_ptr`.
+ * @param cache_ptr           Cache for rendered titles, or NULL.
  *
  * @return true on success.
  */
 bool wlmtk_titlebar_title_redraw(
     wlmtk_titlebar_title_t *titlebar_title_ptr,
-    bs_gfxbuf_t *focussed_gfxbuf_ptr,
-    bs_gfxbuf_t *blurred_gfxbuf_ptr,
+    struct wlr_buffer *focussed_wlr_buffer_ptr,
+    struct wlr_buffer *blurred_wlr_buffer_ptr,
     int position,
     int width,
     bool activated,
     const char *title_ptr,
-    const wlmtk_titlebar_style_t *style_ptr);
+    const wlmtk_titlebar_style_t *style_ptr,
+    uint64_t style_hash,
+    wlmtk_titlebar_cache_t *cache_ptr);
 
 /**
- * Sets activation status of the titlebar's title.
+ * Sets activation status of the titlebar's title. Draws the corresponding
+ * variant, if not drawn yet.
  *
  * @param titlebar_title_ptr
  * @param activated
@@ -86,6 +105,14 @@ void wlmtk_titlebar_title_set_activated(
     wlmtk_titlebar_title_t *titlebar_title_ptr,
     bool activated);
 
+/**
+ * Releases the buffer of the variant (focussed or blurred) not shown.
+ *
+ * @param titlebar_title_ptr
+ */
+void wlmtk_titlebar_title_release_inactive(
+    wlmtk_titlebar_title_t *titlebar_title_ptr);
+
 /**
  * Returns the superclass @ref wlmtk_element_t for the titlebar title.
  *
@@ -40,7 +40,10 @@
 #include "element.h"
 #include "env.h"
 #include "fsm.h"
+#include "icon_theme.h"
 #include "image.h"
+#include "image_cache.h"
+#include "image_loader.h"
 #include "input.h"
 #include "lock.h"
 #include "menu.h"
@@ -48,14 +51,17 @@
 #include "panel.h"
 #include "popup.h"
 #include "popup_menu.h"
+#include "raster_cache.h"
 #include "rectangle.h"
 #include "resizebar.h"
 #include "resizebar_area.h"
 #include "root.h"
 #include "surface.h"
+#include "text_cache.h"
 #include "tile.h"
 #include "titlebar.h"
 #include "titlebar_button.h"
+#include "titlebar_cache.h"
 #include "titlebar_title.h"
 #include "util.h"
 #include "window.h"
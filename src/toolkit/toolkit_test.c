@@ -30,19 +30,25 @@ const bs_test_set_t toolkit_tests[] = {
     { 1, "dock", wlmtk_dock_test_cases },
     { 1, "element", wlmtk_element_test_cases },
     { 1, "fsm", wlmtk_fsm_test_cases },
+    { 1, "icon_theme", wlmtk_icon_theme_test_cases },
     { 1, "image", wlmtk_image_test_cases },
+    { 1, "image_cache", wlmtk_image_cache_test_cases },
+    { 1, "image_loader", wlmtk_image_loader_test_cases },
     { 1, "layer", wlmtk_layer_test_cases },
     { 1, "menu", wlmtk_menu_test_cases },
     { 1, "menu_item", wlmtk_menu_item_test_cases },
     { 1, "panel", wlmtk_panel_test_cases },
     { 1, "surface", wlmtk_surface_test_cases },
+    { 1, "raster_cache", wlmtk_raster_cache_test_cases },
     { 1, "rectangle", wlmtk_rectangle_test_cases },
     { 1, "resizebar", wlmtk_resizebar_test_cases },
     { 1, "resizebar_area", wlmtk_resizebar_area_test_cases },
     { 1, "root", wlmtk_root_test_cases },
+    { 1, "text_cache", wlmtk_text_cache_test_cases },
     { 1, "tile", wlmtk_tile_test_cases },
     { 1, "titlebar", wlmtk_titlebar_test_cases },
     { 1, "titlebar_button", wlmtk_titlebar_button_test_cases },
+    { 1, "titlebar_cache", wlmtk_titlebar_cache_test_cases },
     { 1, "titlebar_title", wlmtk_titlebar_title_test_cases },
     { 1, "util", wlmtk_util_test_cases },
     { 1, "window", wlmtk_window_test_cases },
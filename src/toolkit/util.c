@@ -20,6 +20,11 @@
 
 #include "util.h"
 
+#include <errno.h>
+#include <limits.h>
+#include <stdio.h>
+#include <sys/stat.h>
+
 /* == Declarations ========================================================= */
 
 static void _wlmtk_util_test_listener_handler(
@@ -75,6 +80,47 @@ void wlmtk_util_clear_test_listener(
     test_listener_ptr->last_data_ptr = NULL;
 }
 
+/* ------------------------------------------------------------------------- */
+bool wlmtk_util_mkdirs(const char *path_ptr)
+{
+    char path[PATH_MAX];
+    size_t len = strlen(path_ptr);
+    if (0 == len || len >= sizeof(path)) return false;
+    memcpy(path, path_ptr, len + 1);
+
+    for (char *c_ptr = path + 1; ; ++c_ptr) {
+        if ('/' != *c_ptr && '\0' != *c_ptr) continue;
+
+        char c = *c_ptr;
+        *c_ptr = '\0';
+        if (0 != mkdir(path, 0700) && EEXIST != errno) {
+            bs_log(BS_WARNING | BS_ERRNO, "Failed mkdir(%s, 0700)", path);
+            return false;
+        }
+        *c_ptr = c;
+        if ('\0' == c) return true;
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+bool wlmtk_util_cache_dir(char *path_ptr, size_t size)
+{
+    const char *xdg_cache_home_ptr = getenv("XDG_CACHE_HOME");
+    const char *home_ptr = getenv("HOME");
+    int rv;
+    // Relative paths in XDG_* are invalid and must be ignored.
+    if (NULL != xdg_cache_home_ptr && '/' == *xdg_cache_home_ptr) {
+        rv = snprintf(path_ptr, size, "%s/wlmaker", xdg_cache_home_ptr);
+    } else if (NULL != home_ptr) {
+        rv = snprintf(path_ptr, size, "%s/.cache/wlmaker", home_ptr);
+    } else {
+        bs_log(BS_WARNING, "Neither XDG_CACHE_HOME nor HOME are set.");
+        return false;
+    }
+    if (0 > rv || (size_t)rv >= size) return false;
+    return wlmtk_util_mkdirs(path_ptr);
+}
+
 /* == Local (static) methods =============================================== */
 
 /* ------------------------------------------------------------------------- */
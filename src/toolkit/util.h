@@ -103,6 +103,27 @@ void wlmtk_util_disconnect_test_listener(
 void wlmtk_util_clear_test_listener(
     wlmtk_util_test_listener_t *test_listener_ptr);
 
+/**
+ * Creates the directory `path_ptr`, and any missing parent directories.
+ *
+ * @param path_ptr
+ *
+ * @return true if the directory exists or was created.
+ */
+bool wlmtk_util_mkdirs(const char *path_ptr);
+
+/**
+ * Stores the path to wlmaker's cache directory in `path_ptr`, and creates
+ * the directory if needed. That is `$XDG_CACHE_HOME/wlmaker`, or
+ * `$HOME/.cache/wlmaker` if `XDG_CACHE_HOME` is not set.
+ *
+ * @param path_ptr
+ * @param size                Size of the buffer at `path_ptr`.
+ *
+ * @return true on success.
+ */
+bool wlmtk_util_cache_dir(char *path_ptr, size_t size);
+
 /** Unit test cases. */
 extern const bs_test_case_t wlmtk_util_test_cases[];
 
@@ -102,6 +102,10 @@ struct _wlmtk_window_t {
     wlmtk_popup_menu_t        *popup_menu_ptr;
     /** Listener for then the popup menu requests to be closed. */
     struct wl_listener        popup_menu_request_close_listener;
+    /** Style of the window menu. It is created only when first invoked. */
+    wlmtk_menu_style_t        menu_style;
+    /** Timer for destroying the window menu, once closed for a while. */
+    struct wl_event_source    *menu_release_timer_event_source_ptr;
 
     /** Window title. Set through @ref wlmtk_window_set_title. */
     char                      *title_ptr;
@@ -112,6 +116,24 @@ struct _wlmtk_window_t {
     bs_dllist_t               available_updates;
     /** Pre-alloocated updates. */
     wlmtk_pending_update_t    pre_allocated_updates[WLMTK_WINDOW_MAX_PENDING];
+    /** Whether to coalesce. See @ref wlmtk_window_set_coalesce_requests. */
+    bool                      coalesce_requests;
+    /** Whether @ref wlmtk_window_t::deferred_request holds a request. */
+    bool                      has_deferred_request;
+    /** Most recent request, held back while an update is pending. */
+    struct wlr_box            deferred_request;
+
+    /** Whether decoration redraw is deferred to the next frame. */
+    bool                      decoration_redraw_pending;
+    /** Width of the decoration, as last seen while deferring the redraw. */
+    int                       decoration_width;
+    /** Width the decoration was last drawn at. -1 when just created. */
+    int                       decoration_drawn_width;
+    /** Listener for @ref wlmtk_root_events_t::pre_frame, while deferred. */
+    struct wl_listener        pre_frame_listener;
+
+    /** Counters. See @ref wlmtk_window_get_stats. */
+    wlmtk_window_stats_t      stats;
 
     /** This window's properties. */
     uint32_t                  properties;
@@ -184,6 +206,13 @@ static void _wlmtk_window_create_resizebar(wlmtk_window_t *window_ptr);
 static void _wlmtk_window_destroy_titlebar(wlmtk_window_t *window_ptr);
 static void _wlmtk_window_destroy_resizebar(wlmtk_window_t *window_ptr);
 static void _wlmtk_window_apply_decoration(wlmtk_window_t *window_ptr);
+static void _wlmtk_window_set_decoration_width(
+    wlmtk_window_t *window_ptr,
+    int width);
+static bool _wlmtk_window_defer_decoration_redraw(
+    wlmtk_window_t *window_ptr,
+    int width);
+static void _wlmtk_window_flush_decoration_redraw(wlmtk_window_t *window_ptr);
 static void _wlmtk_window_request_position_and_size_decorated(
     wlmtk_window_t *window_ptr,
     int x,
@@ -194,15 +223,22 @@ static void _wlmtk_window_request_position_and_size_decorated(
     bool include_resizebar,
     bool include_extra);
 
+static void _wlmtk_window_flush_deferred_request(wlmtk_window_t *window_ptr);
 static wlmtk_pending_update_t *_wlmtk_window_prepare_update(
     wlmtk_window_t *window_ptr);
 static void _wlmtk_window_release_update(
     wlmtk_window_t *window_ptr,
     wlmtk_pending_update_t *update_ptr);
 
+static bool _wlmtk_window_create_menu(wlmtk_window_t *window_ptr);
+static void _wlmtk_window_destroy_menu(wlmtk_window_t *window_ptr);
+static int _wlmtk_window_handle_menu_release_timer(void *data_ptr);
 static void _wlmtk_window_popup_menu_request_close_handler(
     struct wl_listener *listener_ptr,
     void *data_ptr);
+static void _wlmtk_window_handle_pre_frame(
+    struct wl_listener *listener_ptr,
+    void *data_ptr);
 
 /* == Data ================================================================= */
 
@@ -250,21 +286,26 @@ wlmtk_window_t *wlmtk_window_create(
     window_ptr->content_ptr = content_ptr;
     wlmtk_content_set_window(content_ptr, window_ptr);
 
-    // Create the window menu. It is kept hidden until invoked.
-    window_ptr->popup_menu_ptr = wlmtk_popup_menu_create(
-        menu_style_ptr,
-        env_ptr);
-    if (NULL == window_ptr->popup_menu_ptr) {
-        _wlmtk_window_fini(window_ptr);
-        return false;
+    // The window menu is created when first invoked, and destroyed after
+    // having been closed for a while: Most windows never show their menu.
+    window_ptr->menu_style = *menu_style_ptr;
+    struct wl_event_loop *wl_event_loop_ptr = wlmtk_env_wl_event_loop(env_ptr);
+    if (0 < window_ptr->menu_style.release_delay &&
+        NULL != wl_event_loop_ptr) {
+        window_ptr->menu_release_timer_event_source_ptr =
+            wl_event_loop_add_timer(
+                wl_event_loop_ptr,
+                _wlmtk_window_handle_menu_release_timer,
+                window_ptr);
+        if (NULL == window_ptr->menu_release_timer_event_source_ptr) {
+            bs_log(BS_ERROR, "Failed wl_event_loop_add_timer(%p, %p, %p)",
+                   wl_event_loop_ptr,
+                   _wlmtk_window_handle_menu_release_timer,
+                   window_ptr);
+            wlmtk_window_destroy(window_ptr);
+            return NULL;
+        }
     }
-    wlmtk_content_add_wlmtk_popup(
-        window_ptr->content_ptr,
-        wlmtk_popup_menu_popup(window_ptr->popup_menu_ptr));
-    wlmtk_util_connect_listener_signal(
-        &wlmtk_popup_menu_events(window_ptr->popup_menu_ptr)->request_close,
-        &window_ptr->popup_menu_request_close_listener,
-        _wlmtk_window_popup_menu_request_close_handler);
 
     return window_ptr;
 }
@@ -564,6 +605,8 @@ void wlmtk_window_menu_set_enabled(
     bool enabled)
 {
     if (!window_ptr->activated) enabled = false;
+    if (NULL == window_ptr->popup_menu_ptr &&
+        (!enabled || !_wlmtk_window_create_menu(window_ptr))) return;
 
     // For convenience: Get the menu's element. Note: It must have a parent,
     // since it's contained within the window.
@@ -590,11 +633,20 @@ void wlmtk_window_menu_set_enabled(
             menu_element_ptr->parent_container_ptr,
             menu_element_ptr);
     }
+
+    // Disarms the timer while shown, and (re-)arms it when hidden.
+    if (NULL != window_ptr->menu_release_timer_event_source_ptr) {
+        wl_event_source_timer_update(
+            window_ptr->menu_release_timer_event_source_ptr,
+            enabled ? 0 : window_ptr->menu_style.release_delay);
+    }
 }
 
 /* ------------------------------------------------------------------------- */
 wlmtk_menu_t *wlmtk_window_menu(wlmtk_window_t *window_ptr)
 {
+    if (NULL == window_ptr->popup_menu_ptr &&
+        !_wlmtk_window_create_menu(window_ptr)) return NULL;
     return wlmtk_popup_menu_menu(window_ptr->popup_menu_ptr);
 }
 
@@ -663,16 +715,25 @@ void wlmtk_window_request_position_and_size(
     int width,
     int height)
 {
+    window_ptr->organic_size.x = x;
+    window_ptr->organic_size.y = y;
+    window_ptr->organic_size.width = width;
+    window_ptr->organic_size.height = height;
+
+    // While coalescing, hold back the request until the client acknowledged
+    // what is in flight. A newer request just replaces the deferred one.
+    if (window_ptr->coalesce_requests &&
+        NULL != window_ptr->pending_updates.head_ptr) {
+        window_ptr->deferred_request = window_ptr->organic_size;
+        window_ptr->has_deferred_request = true;
+        return;
+    }
+
     _wlmtk_window_request_position_and_size_decorated(
         window_ptr, x, y, width, height,
         NULL != window_ptr->titlebar_ptr,
         NULL != window_ptr->resizebar_ptr,
         true);
-
-    window_ptr->organic_size.x = x;
-    window_ptr->organic_size.y = y;
-    window_ptr->organic_size.width = width;
-    window_ptr->organic_size.height = height;
 }
 
 /* ------------------------------------------------------------------------- */
@@ -680,6 +741,9 @@ void wlmtk_window_serial(wlmtk_window_t *window_ptr, uint32_t serial)
 {
     bs_dllist_node_t *dlnode_ptr;
 
+    // Called for each commit of the content.
+    ++window_ptr->stats.commits;
+
     if (!window_ptr->inorganic_sizing &&
         NULL == window_ptr->pending_updates.head_ptr) {
         wlmtk_window_get_size(window_ptr,
@@ -701,6 +765,22 @@ void wlmtk_window_serial(wlmtk_window_t *window_ptr, uint32_t serial)
             pending_update_ptr->y);
         _wlmtk_window_release_update(window_ptr, pending_update_ptr);
     }
+
+    if (NULL == window_ptr->pending_updates.head_ptr) {
+        _wlmtk_window_flush_deferred_request(window_ptr);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_window_set_coalesce_requests(
+    wlmtk_window_t *window_ptr,
+    bool enabled)
+{
+    window_ptr->coalesce_requests = enabled;
+    if (!enabled) {
+        _wlmtk_window_flush_deferred_request(window_ptr);
+        _wlmtk_window_flush_decoration_redraw(window_ptr);
+    }
 }
 
 /* ------------------------------------------------------------------------- */
@@ -708,6 +788,8 @@ void wlmtk_window_set_workspace(
     wlmtk_window_t *window_ptr,
     wlmtk_workspace_t *workspace_ptr)
 {
+    // The deferred redraw is bound to the current workspace's root.
+    _wlmtk_window_flush_decoration_redraw(window_ptr);
     window_ptr->workspace_ptr = workspace_ptr;
 }
 
@@ -725,6 +807,12 @@ const wlmtk_util_client_t *wlmtk_window_get_client_ptr(
     return &window_ptr->content_ptr->client;
 }
 
+/* ------------------------------------------------------------------------- */
+const wlmtk_window_stats_t *wlmtk_window_get_stats(wlmtk_window_t *window_ptr)
+{
+    return &window_ptr->stats;
+}
+
 
 /* == Local (static) methods =============================================== */
 
@@ -784,6 +872,7 @@ bool _wlmtk_window_init(
     wlmtk_element_set_visible(element_ptr, true);
 
     wl_signal_init(&window_ptr->events.state_changed);
+    wl_signal_init(&window_ptr->events.menu_created);
     return true;
 }
 
@@ -795,15 +884,22 @@ bool _wlmtk_window_init(
  */
 void _wlmtk_window_fini(wlmtk_window_t *window_ptr)
 {
-    if (NULL != window_ptr->popup_menu_ptr) {
-        wlmtk_util_disconnect_listener(
-            &window_ptr->popup_menu_request_close_listener);
-        wlmtk_content_remove_wlmtk_popup(
-            window_ptr->content_ptr,
-            wlmtk_popup_menu_popup(window_ptr->popup_menu_ptr));
-        wlmtk_popup_menu_destroy(window_ptr->popup_menu_ptr);
-        window_ptr->popup_menu_ptr = NULL;
+    if (NULL != window_ptr->menu_release_timer_event_source_ptr) {
+        wl_event_source_remove(
+            window_ptr->menu_release_timer_event_source_ptr);
+        window_ptr->menu_release_timer_event_source_ptr = NULL;
+    }
+    _wlmtk_window_destroy_menu(window_ptr);
+
+    if (window_ptr->decoration_redraw_pending) {
+        wlmtk_util_disconnect_listener(&window_ptr->pre_frame_listener);
+        window_ptr->decoration_redraw_pending = false;
     }
+    bs_log(BS_DEBUG, "Window %p: %"PRIu64" commits, %"PRIu64" relayouts, "
+           "%"PRIu64" decoration redraws (%"PRIu64" saved).",
+           window_ptr, window_ptr->stats.commits, window_ptr->stats.relayouts,
+           window_ptr->stats.decoration_redraws,
+           window_ptr->stats.saved_decoration_redraws);
 
     wlmtk_window_set_server_side_decorated(window_ptr, false);
 
@@ -925,16 +1021,15 @@ void _wlmtk_window_container_update_layout(wlmtk_container_t *container_ptr)
         container_ptr, wlmtk_window_t, super_bordered.super_container);
 
     window_ptr->orig_super_container_vmt.update_layout(container_ptr);
+    ++window_ptr->stats.relayouts;
 
     if (NULL != window_ptr->content_ptr) {
         int width;
         wlmtk_content_get_size(window_ptr->content_ptr, &width, NULL);
-        if (NULL != window_ptr->titlebar_ptr) {
-            wlmtk_titlebar_set_width(window_ptr->titlebar_ptr, width);
-        }
-        if (NULL != window_ptr->resizebar_ptr) {
-            wlmtk_resizebar_set_width(window_ptr->resizebar_ptr, width);
-        }
+        // During an interactive resize, redraw at most once per frame.
+        if (window_ptr->coalesce_requests &&
+            _wlmtk_window_defer_decoration_redraw(window_ptr, width)) return;
+        _wlmtk_window_set_decoration_width(window_ptr, width);
     }
 }
 
@@ -973,6 +1068,7 @@ void _wlmtk_window_create_titlebar(wlmtk_window_t *window_ptr)
     if (NULL != window_ptr->titlebar_ptr) return;
 
     // Create decoration.
+    window_ptr->decoration_drawn_width = -1;
     window_ptr->titlebar_ptr = wlmtk_titlebar_create(
         window_ptr->super_bordered.super_container.super_element.env_ptr,
         window_ptr, &window_ptr->style.titlebar);
@@ -1006,6 +1102,7 @@ void _wlmtk_window_create_resizebar(wlmtk_window_t *window_ptr)
     // Guard clause: Don't add decoration.
     if (NULL != window_ptr->resizebar_ptr) return;
 
+    window_ptr->decoration_drawn_width = -1;
     window_ptr->resizebar_ptr = wlmtk_resizebar_create(
         window_ptr->super_bordered.super_container.super_element.env_ptr,
         window_ptr, &window_ptr->style.resizebar);
@@ -1140,6 +1237,109 @@ void _wlmtk_window_request_position_and_size_decorated(
     // the pending state should be applied right away.
 }
 
+/* ------------------------------------------------------------------------- */
+/**
+ * Sets the width of titlebar and resizebar, which redraws them on change.
+ *
+ * @param window_ptr
+ * @param width
+ */
+void _wlmtk_window_set_decoration_width(wlmtk_window_t *window_ptr, int width)
+{
+    if ((NULL != window_ptr->titlebar_ptr ||
+         NULL != window_ptr->resizebar_ptr) &&
+        width != window_ptr->decoration_drawn_width) {
+        ++window_ptr->stats.decoration_redraws;
+        window_ptr->decoration_drawn_width = width;
+    }
+
+    if (NULL != window_ptr->titlebar_ptr) {
+        wlmtk_titlebar_set_width(window_ptr->titlebar_ptr, width);
+    }
+    if (NULL != window_ptr->resizebar_ptr) {
+        wlmtk_resizebar_set_width(window_ptr->resizebar_ptr, width);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Defers redrawing the decoration to the next @ref wlmtk_root_pre_frame.
+ *
+ * Each further change of width before that frame is a redraw saved.
+ *
+ * @param window_ptr
+ * @param width
+ *
+ * @return false if there is no root to defer to. The caller must then redraw
+ *     right away.
+ */
+bool _wlmtk_window_defer_decoration_redraw(
+    wlmtk_window_t *window_ptr,
+    int width)
+{
+    if (NULL == window_ptr->workspace_ptr) return false;
+    wlmtk_root_t *root_ptr = wlmtk_workspace_get_root(
+        window_ptr->workspace_ptr);
+    if (NULL == root_ptr) return false;
+
+    // Already drawn at that width, and nothing pending: Nothing to defer.
+    // This includes the relayout triggered by flushing the redraw.
+    if (!window_ptr->decoration_redraw_pending &&
+        width == window_ptr->decoration_drawn_width) return true;
+
+    if (window_ptr->decoration_redraw_pending) {
+        if (width != window_ptr->decoration_width) {
+            ++window_ptr->stats.saved_decoration_redraws;
+        }
+    } else {
+        wlmtk_util_connect_listener_signal(
+            &wlmtk_root_events(root_ptr)->pre_frame,
+            &window_ptr->pre_frame_listener,
+            _wlmtk_window_handle_pre_frame);
+        window_ptr->decoration_redraw_pending = true;
+    }
+    window_ptr->decoration_width = width;
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Redraws the decoration now, if a redraw had been deferred.
+ *
+ * @param window_ptr
+ */
+void _wlmtk_window_flush_decoration_redraw(wlmtk_window_t *window_ptr)
+{
+    if (!window_ptr->decoration_redraw_pending) return;
+    wlmtk_util_disconnect_listener(&window_ptr->pre_frame_listener);
+    window_ptr->decoration_redraw_pending = false;
+
+    if (NULL == window_ptr->content_ptr) return;
+    int width;
+    wlmtk_content_get_size(window_ptr->content_ptr, &width, NULL);
+    _wlmtk_window_set_decoration_width(window_ptr, width);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Sends the request held back in @ref wlmtk_window_t::deferred_request, if
+ * there is any.
+ *
+ * @param window_ptr
+ */
+void _wlmtk_window_flush_deferred_request(wlmtk_window_t *window_ptr)
+{
+    if (!window_ptr->has_deferred_request) return;
+    window_ptr->has_deferred_request = false;
+
+    struct wlr_box *box_ptr = &window_ptr->deferred_request;
+    _wlmtk_window_request_position_and_size_decorated(
+        window_ptr, box_ptr->x, box_ptr->y, box_ptr->width, box_ptr->height,
+        NULL != window_ptr->titlebar_ptr,
+        NULL != window_ptr->resizebar_ptr,
+        true);
+}
+
 /* ------------------------------------------------------------------------- */
 /**
  * Prepares a positional update: Allocates an item and attach it to the end
@@ -1182,6 +1382,75 @@ void _wlmtk_window_release_update(
     bs_dllist_push_front(&window_ptr->available_updates, &update_ptr->dlnode);
 }
 
+/* ------------------------------------------------------------------------- */
+/**
+ * Creates the window menu and adds it to the content, hidden. Emits
+ * @ref wlmtk_window_events_t::menu_created, for populating it. Arms the
+ * release timer, for menus that are never shown.
+ *
+ * @param window_ptr
+ *
+ * @return true on success.
+ */
+bool _wlmtk_window_create_menu(wlmtk_window_t *window_ptr)
+{
+    window_ptr->popup_menu_ptr = wlmtk_popup_menu_create(
+        &window_ptr->menu_style,
+        window_ptr->env_ptr);
+    if (NULL == window_ptr->popup_menu_ptr) return false;
+    wlmtk_content_add_wlmtk_popup(
+        window_ptr->content_ptr,
+        wlmtk_popup_menu_popup(window_ptr->popup_menu_ptr));
+    wlmtk_util_connect_listener_signal(
+        &wlmtk_popup_menu_events(window_ptr->popup_menu_ptr)->request_close,
+        &window_ptr->popup_menu_request_close_listener,
+        _wlmtk_window_popup_menu_request_close_handler);
+
+    wl_signal_emit(&window_ptr->events.menu_created,
+                   wlmtk_popup_menu_menu(window_ptr->popup_menu_ptr));
+
+    if (NULL != window_ptr->menu_release_timer_event_source_ptr) {
+        wl_event_source_timer_update(
+            window_ptr->menu_release_timer_event_source_ptr,
+            window_ptr->menu_style.release_delay);
+    }
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Removes the window menu from the content, and destroys it. */
+void _wlmtk_window_destroy_menu(wlmtk_window_t *window_ptr)
+{
+    if (NULL == window_ptr->popup_menu_ptr) return;
+
+    wlmtk_util_disconnect_listener(
+        &window_ptr->popup_menu_request_close_listener);
+    wlmtk_content_remove_wlmtk_popup(
+        window_ptr->content_ptr,
+        wlmtk_popup_menu_popup(window_ptr->popup_menu_ptr));
+    wlmtk_popup_menu_destroy(window_ptr->popup_menu_ptr);
+    window_ptr->popup_menu_ptr = NULL;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Handles the menu release timer: Destroys the window menu, unless shown.
+ *
+ * @param data_ptr            Points to @ref wlmtk_window_t.
+ *
+ * @return 0.
+ */
+int _wlmtk_window_handle_menu_release_timer(void *data_ptr)
+{
+    wlmtk_window_t *window_ptr = data_ptr;
+    if (NULL != window_ptr->popup_menu_ptr &&
+        !wlmtk_popup_element(
+            wlmtk_popup_menu_popup(window_ptr->popup_menu_ptr))->visible) {
+        _wlmtk_window_destroy_menu(window_ptr);
+    }
+    return 0;
+}
+
 /* ------------------------------------------------------------------------- */
 /** Handles @ref wlmtk_popup_menu_events_t::request_close signals. */
 void _wlmtk_window_popup_menu_request_close_handler(
@@ -1193,6 +1462,17 @@ void _wlmtk_window_popup_menu_request_close_handler(
     wlmtk_window_menu_set_enabled(window_ptr, false);
 }
 
+/* ------------------------------------------------------------------------- */
+/** Handles @ref wlmtk_root_events_t::pre_frame: Redraws the decoration. */
+void _wlmtk_window_handle_pre_frame(
+    struct wl_listener *listener_ptr,
+    __UNUSED__ void *data_ptr)
+{
+    wlmtk_window_t *window_ptr = BS_CONTAINER_OF(
+        listener_ptr, wlmtk_window_t, pre_frame_listener);
+    _wlmtk_window_flush_decoration_redraw(window_ptr);
+}
+
 /* == Implementation of the fake window ==================================== */
 
 static void _wlmtk_fake_window_request_minimize(wlmtk_window_t *window_ptr);
@@ -1329,6 +1609,7 @@ void _wlmtk_fake_window_request_resize(
 /* == Unit tests =========================================================== */
 
 static void test_create_destroy(bs_test_t *test_ptr);
+static void test_menu(bs_test_t *test_ptr);
 static void test_set_title(bs_test_t *test_ptr);
 static void test_request_close(bs_test_t *test_ptr);
 static void test_set_activated(bs_test_t *test_ptr);
@@ -1338,10 +1619,14 @@ static void test_maximize(bs_test_t *test_ptr);
 static void test_fullscreen(bs_test_t *test_ptr);
 static void test_fullscreen_unmap(bs_test_t *test_ptr);
 static void test_shade(bs_test_t *test_ptr);
+static void test_coalesce(bs_test_t *test_ptr);
+static void test_throttle_decoration(bs_test_t *test_ptr);
+static void test_stats(bs_test_t *test_ptr);
 static void test_fake(bs_test_t *test_ptr);
 
 const bs_test_case_t wlmtk_window_test_cases[] = {
     { 1, "create_destroy", test_create_destroy },
+    { 1, "menu", test_menu },
     { 1, "set_title", test_set_title },
     { 1, "request_close", test_request_close },
     { 1, "set_activated", test_set_activated },
@@ -1352,6 +1637,9 @@ const bs_test_case_t wlmtk_window_test_cases[] = {
     { 1, "fullscreen", test_fullscreen },
     { 1, "fullscreen_unmap", test_fullscreen_unmap },
     { 1, "shade", test_shade },
+    { 1, "coalesce", test_coalesce },
+    { 1, "throttle_decoration", test_throttle_decoration },
+    { 1, "stats", test_stats },
     { 1, "fake", test_fake },
     { 0, NULL, NULL }
 };
@@ -1381,6 +1669,62 @@ void test_create_destroy(bs_test_t *test_ptr)
     wlmtk_fake_surface_destroy(fake_surface_ptr);
 }
 
+/* ------------------------------------------------------------------------- */
+/** Tests that the window menu is created on demand, and released. */
+void test_menu(bs_test_t *test_ptr)
+{
+    struct wl_event_loop *wl_event_loop_ptr = wl_event_loop_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, wl_event_loop_ptr);
+    wlmtk_env_t *env_ptr = wlmtk_env_create(
+        NULL, NULL, NULL, wl_event_loop_ptr);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, env_ptr);
+    wlmtk_fake_surface_t *fake_surface_ptr = wlmtk_fake_surface_create();
+    wlmtk_window_style_t s = {};
+    wlmtk_menu_style_t ms = { .release_delay = 1 };
+    wlmtk_content_t content;
+    wlmtk_content_init(
+        &content,
+        wlmtk_surface_element(&fake_surface_ptr->surface),
+        NULL);
+    wlmtk_window_t *window_ptr = wlmtk_window_create(
+        &content, &s, &ms, env_ptr);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, window_ptr);
+    wlmtk_util_test_listener_t l;
+    wlmtk_util_connect_test_listener(
+        &wlmtk_window_events(window_ptr)->menu_created, &l);
+
+    // Not created until requested.
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, window_ptr->popup_menu_ptr);
+    wlmtk_window_menu_set_enabled(window_ptr, false);
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, window_ptr->popup_menu_ptr);
+    wlmtk_menu_t *menu_ptr = wlmtk_window_menu(window_ptr);
+    BS_TEST_VERIFY_NEQ(test_ptr, NULL, menu_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, l.calls);
+    BS_TEST_VERIFY_EQ(test_ptr, menu_ptr, l.last_data_ptr);
+
+    // Released when never shown. And re-created.
+    BS_TEST_VERIFY_EQ(
+        test_ptr, 0, wl_event_loop_dispatch(wl_event_loop_ptr, 100));
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, window_ptr->popup_menu_ptr);
+    BS_TEST_VERIFY_NEQ(test_ptr, NULL, wlmtk_window_menu(window_ptr));
+    BS_TEST_VERIFY_EQ(test_ptr, 2, l.calls);
+
+    // Released after being hidden for a while. And re-created.
+    wlmtk_window_menu_set_enabled(window_ptr, false);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, 0, wl_event_loop_dispatch(wl_event_loop_ptr, 100));
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, window_ptr->popup_menu_ptr);
+    BS_TEST_VERIFY_NEQ(test_ptr, NULL, wlmtk_window_menu(window_ptr));
+    BS_TEST_VERIFY_EQ(test_ptr, 3, l.calls);
+
+    wlmtk_util_disconnect_test_listener(&l);
+    wlmtk_window_destroy(window_ptr);
+    wlmtk_content_fini(&content);
+    wlmtk_fake_surface_destroy(fake_surface_ptr);
+    wlmtk_env_destroy(env_ptr);
+    wl_event_loop_destroy(wl_event_loop_ptr);
+}
+
 /* ------------------------------------------------------------------------- */
 /** Tests title. */
 void test_set_title(bs_test_t *test_ptr)
@@ -1803,6 +2147,151 @@ void test_shade(bs_test_t *test_ptr)
     wlmtk_fake_window_destroy(fw_ptr);
 }
 
+/* ------------------------------------------------------------------------- */
+/** Tests that requests are coalesced while an update is pending. */
+void test_coalesce(bs_test_t *test_ptr)
+{
+    struct wlr_box box;
+    wlmtk_fake_window_t *fw_ptr = wlmtk_fake_window_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, fw_ptr);
+    wlmtk_fake_content_t *fc_ptr = fw_ptr->fake_content_ptr;
+    wlmtk_window_set_coalesce_requests(fw_ptr->window_ptr, true);
+
+    // First request is sent right away.
+    fc_ptr->serial = 1;
+    wlmtk_window_request_position_and_size(fw_ptr->window_ptr, 0, 0, 100, 50);
+    BS_TEST_VERIFY_EQ(test_ptr, 100, fc_ptr->requested_width);
+    BS_TEST_VERIFY_EQ(test_ptr, 50, fc_ptr->requested_height);
+
+    // Further requests are held back, only the latest one is kept.
+    fc_ptr->serial = 2;
+    wlmtk_window_request_position_and_size(fw_ptr->window_ptr, 5, 5, 110, 60);
+    wlmtk_window_request_position_and_size(fw_ptr->window_ptr, 10, 5, 120, 70);
+    BS_TEST_VERIFY_EQ(test_ptr, 100, fc_ptr->requested_width);
+    BS_TEST_VERIFY_EQ(test_ptr, 50, fc_ptr->requested_height);
+
+    // Acknowledging the first one sends the latest request.
+    wlmtk_content_commit(&fc_ptr->content, 100, 50, 1);
+    BS_TEST_VERIFY_EQ(test_ptr, 120, fc_ptr->requested_width);
+    BS_TEST_VERIFY_EQ(test_ptr, 70, fc_ptr->requested_height);
+    box = wlmtk_window_get_position_and_size(fw_ptr->window_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, box.x);
+
+    wlmtk_fake_window_commit_size(fw_ptr);
+    box = wlmtk_window_get_position_and_size(fw_ptr->window_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 10, box.x);
+    BS_TEST_VERIFY_EQ(test_ptr, 5, box.y);
+    BS_TEST_VERIFY_EQ(test_ptr, 120, box.width);
+    BS_TEST_VERIFY_EQ(test_ptr, 70, box.height);
+
+    // Disabling coalescing sends what was held back.
+    fc_ptr->serial = 3;
+    wlmtk_window_request_position_and_size(fw_ptr->window_ptr, 0, 0, 130, 80);
+    wlmtk_window_request_position_and_size(fw_ptr->window_ptr, 0, 0, 140, 90);
+    BS_TEST_VERIFY_EQ(test_ptr, 130, fc_ptr->requested_width);
+    wlmtk_window_set_coalesce_requests(fw_ptr->window_ptr, false);
+    BS_TEST_VERIFY_EQ(test_ptr, 140, fc_ptr->requested_width);
+    BS_TEST_VERIFY_EQ(test_ptr, 90, fc_ptr->requested_height);
+
+    wlmtk_fake_window_destroy(fw_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Tests that decoration redraws are deferred to the frame when coalescing. */
+void test_throttle_decoration(bs_test_t *test_ptr)
+{
+    struct wlr_scene *wlr_scene_ptr = wlr_scene_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, wlr_scene_ptr);
+    wlmtk_root_t *root_ptr = wlmtk_root_create(wlr_scene_ptr, NULL);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, root_ptr);
+    static const wlmtk_tile_style_t tstyle = {};
+    wlmtk_workspace_t *ws_ptr = wlmtk_workspace_create("1", &tstyle, NULL);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, ws_ptr);
+    wlmtk_root_add_workspace(root_ptr, ws_ptr);
+
+    wlmtk_fake_window_t *fw_ptr = wlmtk_fake_window_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, fw_ptr);
+    wlmtk_window_t *window_ptr = fw_ptr->window_ptr;
+    wlmtk_fake_content_t *fc_ptr = fw_ptr->fake_content_ptr;
+    wlmtk_window_set_server_side_decorated(window_ptr, true);
+    wlmtk_workspace_map_window(ws_ptr, window_ptr);
+
+    // Not coalescing: Redraws right away.
+    fc_ptr->requested_width = 100;
+    fc_ptr->requested_height = 50;
+    wlmtk_fake_window_commit_size(fw_ptr);
+    BS_TEST_VERIFY_FALSE(test_ptr, window_ptr->decoration_redraw_pending);
+
+    // Coalescing: Deferred until the frame. Each further width is saved.
+    wlmtk_window_set_coalesce_requests(window_ptr, true);
+    fc_ptr->requested_width = 110;
+    wlmtk_fake_window_commit_size(fw_ptr);
+    BS_TEST_VERIFY_TRUE(test_ptr, window_ptr->decoration_redraw_pending);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, window_ptr->stats.saved_decoration_redraws);
+    fc_ptr->requested_width = 120;
+    wlmtk_fake_window_commit_size(fw_ptr);
+    fc_ptr->requested_width = 130;
+    wlmtk_fake_window_commit_size(fw_ptr);
+    wlmtk_fake_window_commit_size(fw_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 2, window_ptr->stats.saved_decoration_redraws);
+
+    wlmtk_root_pre_frame(root_ptr, NULL);
+    BS_TEST_VERIFY_FALSE(test_ptr, window_ptr->decoration_redraw_pending);
+    BS_TEST_VERIFY_EQ(test_ptr, 130, window_ptr->decoration_drawn_width);
+
+    // A relayout at the width already drawn does not defer anything.
+    wlmtk_container_update_layout(&window_ptr->super_bordered.super_container);
+    BS_TEST_VERIFY_FALSE(test_ptr, window_ptr->decoration_redraw_pending);
+
+    // Ending the coalescing redraws what was deferred.
+    fc_ptr->requested_width = 140;
+    wlmtk_fake_window_commit_size(fw_ptr);
+    BS_TEST_VERIFY_TRUE(test_ptr, window_ptr->decoration_redraw_pending);
+    wlmtk_window_set_coalesce_requests(window_ptr, false);
+    BS_TEST_VERIFY_FALSE(test_ptr, window_ptr->decoration_redraw_pending);
+
+    wlmtk_workspace_unmap_window(ws_ptr, window_ptr);
+    wlmtk_fake_window_destroy(fw_ptr);
+    wlmtk_root_remove_workspace(root_ptr, ws_ptr);
+    wlmtk_workspace_destroy(ws_ptr);
+    wlmtk_root_destroy(root_ptr);
+    wlr_scene_node_destroy(&wlr_scene_ptr->tree.node);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Tests the window's counters, and that unchanged commits skip relayout. */
+void test_stats(bs_test_t *test_ptr)
+{
+    wlmtk_fake_window_t *fw_ptr = wlmtk_fake_window_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, fw_ptr);
+    const wlmtk_window_stats_t *stats_ptr = wlmtk_window_get_stats(
+        fw_ptr->window_ptr);
+    fw_ptr->fake_content_ptr->requested_width = 100;
+    fw_ptr->fake_content_ptr->requested_height = 50;
+
+    wlmtk_fake_window_commit_size(fw_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, stats_ptr->commits);
+    uint64_t relayouts = stats_ptr->relayouts;
+    BS_TEST_VERIFY_TRUE(test_ptr, 0 < relayouts);
+
+    // Same size: Counted as commit, but no relayout.
+    wlmtk_fake_window_commit_size(fw_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 2, stats_ptr->commits);
+    BS_TEST_VERIFY_EQ(test_ptr, relayouts, stats_ptr->relayouts);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, stats_ptr->decoration_redraws);
+
+    // With decoration: A change in width redraws it.
+    wlmtk_window_set_server_side_decorated(fw_ptr->window_ptr, true);
+    uint64_t redraws = stats_ptr->decoration_redraws;
+    BS_TEST_VERIFY_TRUE(test_ptr, 0 < redraws);
+    fw_ptr->fake_content_ptr->requested_width = 120;
+    wlmtk_fake_window_commit_size(fw_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, redraws + 1, stats_ptr->decoration_redraws);
+    BS_TEST_VERIFY_TRUE(test_ptr, relayouts < stats_ptr->relayouts);
+
+    wlmtk_fake_window_destroy(fw_ptr);
+}
+
 /* ------------------------------------------------------------------------- */
 /** Tests fake window ctor and dtor. */
 void test_fake(bs_test_t *test_ptr)
@@ -50,6 +50,15 @@ typedef struct {
      * - @ref wlmtk_window_is_shaded
      */
     struct wl_signal          state_changed;
+    /**
+     * Signals that the window menu was created, and is to be populated.
+     * Passes a pointer to the @ref wlmtk_menu_t.
+     *
+     * The window menu is created when first invoked, and destroyed after
+     * having been hidden for @ref wlmtk_menu_style_t::release_delay. It may
+     * thus get created several times.
+     */
+    struct wl_signal          menu_created;
 } wlmtk_window_events_t;
 
 /** Style options for the window. */
@@ -64,6 +73,18 @@ typedef struct {
     wlmtk_margin_style_t       margin;
 } wlmtk_window_style_t;
 
+/** Counters, to see what each window's client costs. */
+typedef struct {
+    /** Commits of the window's content. */
+    uint64_t                  commits;
+    /** Updates of the window's layout. */
+    uint64_t                  relayouts;
+    /** Redraws of titlebar and resizebar, due to a change in width. */
+    uint64_t                  decoration_redraws;
+    /** Decoration redraws saved by deferring them to the next frame. */
+    uint64_t                  saved_decoration_redraws;
+} wlmtk_window_stats_t;
+
 /** Window properties. */
 typedef enum {
     /** Can be resized. Server-side decorations will show resize-bar. */
@@ -366,7 +387,8 @@ void wlmtk_window_request_shaded(wlmtk_window_t *window_ptr, bool shaded);
 bool wlmtk_window_is_shaded(wlmtk_window_t *window_ptr);
 
 /**
- * Enables (shows) or disabled (hides) the window's menu.
+ * Enables (shows) or disabled (hides) the window's menu. Creates the menu,
+ * if not done yet.
  *
  * @param window_ptr
  * @param enabled
@@ -376,11 +398,13 @@ void wlmtk_window_menu_set_enabled(
     bool enabled);
 
 /**
- * Returns a pointer to the window menu's state.
+ * Returns a pointer to the window menu's state. Creates the menu, if not
+ * done yet.
  *
  * @param window_ptr
  *
- * @return A pointer to the @ref wlmtk_menu_t of the window menu.
+ * @return A pointer to the @ref wlmtk_menu_t of the window menu, or NULL on
+ *     error.
  */
 wlmtk_menu_t *wlmtk_window_menu(wlmtk_window_t *window_ptr);
 
@@ -437,6 +461,24 @@ void wlmtk_window_request_position_and_size(
  */
 void wlmtk_window_serial(wlmtk_window_t *window_ptr, uint32_t serial);
 
+/**
+ * Sets whether @ref wlmtk_window_request_position_and_size shall coalesce
+ * requests.
+ *
+ * When enabled, and while an earlier update is pending, a request is not sent
+ * to the client. Only the most recent one is kept, and it gets sent once
+ * @ref wlmtk_window_serial acknowledged all pending updates. Used during
+ * interactive resizes, so slow clients don't see a backlog of configures.
+ *
+ * Disabling sends any request that is held back.
+ *
+ * @param window_ptr
+ * @param enabled
+ */
+void wlmtk_window_set_coalesce_requests(
+    wlmtk_window_t *window_ptr,
+    bool enabled);
+
 /**
  * Sets @ref wlmtk_window_t::workspace_ptr.
  *
@@ -456,6 +498,9 @@ wlmtk_workspace_t *wlmtk_window_get_workspace(wlmtk_window_t *window_ptr);
 const wlmtk_util_client_t *wlmtk_window_get_client_ptr(
     wlmtk_window_t *window_ptr);
 
+/** @return Pointer to @ref wlmtk_window_t::stats. */
+const wlmtk_window_stats_t *wlmtk_window_get_stats(wlmtk_window_t *window_ptr);
+
 /* ------------------------------------------------------------------------- */
 
 /** State of the fake window, for tests. */
@@ -371,6 +371,8 @@ void wlmtk_workspace_set_extents(wlmtk_workspace_t *workspace_ptr,
     workspace_ptr->y1 = extents_ptr->y;
     workspace_ptr->x2 = extents_ptr->x + extents_ptr->width;
     workspace_ptr->y2 = extents_ptr->y + extents_ptr->height;
+    wlmtk_element_invalidate_parent_geometry(
+        &workspace_ptr->super_container.super_element);
 
     if (NULL != workspace_ptr->background_layer_ptr) {
         wlmtk_layer_reconfigure(workspace_ptr->background_layer_ptr);
@@ -932,6 +934,8 @@ bool pfsm_resize_begin(wlmtk_fsm_t *fsm_ptr, void *ud_ptr)
         &workspace_ptr->initial_width,
         &workspace_ptr->initial_height);
 
+    // Motion events outpace most clients. Keep just one configure in flight.
+    wlmtk_window_set_coalesce_requests(workspace_ptr->grabbed_window_ptr, true);
     return true;
 }
 
@@ -981,6 +985,10 @@ bool pfsm_reset(wlmtk_fsm_t *fsm_ptr, __UNUSED__ void *ud_ptr)
 {
     wlmtk_workspace_t *workspace_ptr = BS_CONTAINER_OF(
         fsm_ptr, wlmtk_workspace_t, fsm);
+    if (NULL != workspace_ptr->grabbed_window_ptr) {
+        wlmtk_window_set_coalesce_requests(
+            workspace_ptr->grabbed_window_ptr, false);
+    }
     workspace_ptr->grabbed_window_ptr = NULL;
     return true;
 }
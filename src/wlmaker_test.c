@@ -19,6 +19,7 @@
  */
 
 #include "action.h"
+#include "app_index.h"
 #include "clip.h"
 #include "config.h"
 #include "corner.h"
@@ -26,18 +27,25 @@
 #include "keyboard.h"
 #include "launcher.h"
 #include "layer_panel.h"
+#include "output.h"
+#include "subprocess_monitor.h"
+#include "subprocess_spawn.h"
 #include "xwl_content.h"
 
 /** WLMaker unit tests. */
 const bs_test_set_t wlmaker_tests[] = {
     { 1, "action", wlmaker_action_test_cases },
+    { 1, "app_index", wlmaker_app_index_test_cases },
     { 1, "clip", wlmaker_clip_test_cases },
     { 1, "config", wlmaker_config_test_cases },
     { 1, "corner", wlmaker_corner_test_cases },
     { 1, "dock", wlmaker_dock_test_cases },
     { 1, "launc her", wlmaker_launcher_test_cases},
     { 1, "layer_panel", wlmaker_layer_panel_test_cases },
+    { 1, "output", wlmaker_output_test_cases },
     { 1, "server", wlmaker_server_test_cases },
+    { 1, "subprocess_monitor", wlmaker_subprocess_monitor_test_cases },
+    { 1, "subprocess_spawn", wlmaker_subprocess_spawn_test_cases },
 #if defined(WLMAKER_HAVE_XWAYLAND)
     { 1, "xwl_content", wlmaker_xwl_content_test_cases },
 #endif  // defined(WLMAKER_HAVE_XWAYLAND)
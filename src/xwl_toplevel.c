@@ -99,6 +99,11 @@ wlmaker_xwl_toplevel_t *wlmaker_xwl_toplevel_create(
 void wlmaker_xwl_toplevel_destroy(
     wlmaker_xwl_toplevel_t *xwl_toplevel_ptr)
 {
+    if (NULL != xwl_toplevel_ptr->tl_menu_ptr) {
+        wlmaker_tl_menu_destroy(xwl_toplevel_ptr->tl_menu_ptr);
+        xwl_toplevel_ptr->tl_menu_ptr = NULL;
+    }
+
     if (NULL != xwl_toplevel_ptr->window_ptr) {
         wl_signal_emit(&xwl_toplevel_ptr->server_ptr->window_destroyed_event,
                        xwl_toplevel_ptr->window_ptr);
@@ -112,11 +117,6 @@ void wlmaker_xwl_toplevel_destroy(
     wl_list_remove(&xwl_toplevel_ptr->surface_unmap_listener.link);
     wl_list_remove(&xwl_toplevel_ptr->surface_map_listener.link);
 
-    if (NULL != xwl_toplevel_ptr->tl_menu_ptr) {
-        wlmaker_tl_menu_destroy(xwl_toplevel_ptr->tl_menu_ptr);
-        xwl_toplevel_ptr->tl_menu_ptr = NULL;
-    }
-
     free(xwl_toplevel_ptr);
 }
 